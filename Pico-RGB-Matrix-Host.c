@@ -0,0 +1,876 @@
+/* ============================================================================================================================================================= *\
+   Pico-RGB-Matrix-Host.c
+   St-Louys Andre - August 2022
+   astlouys@gmail.com
+   Langage: C with gcc (host build)
+
+   Raspberry Pi Pico Firmware to drive the Waveshare Pico-RGB-Matrix.
+   Host (Linux) simulator of the rendering code (drawing primitives, fonts, windows and scrolls).
+   Released under 3-Clause BSD License.
+
+   NOTES:
+   1) Built with CMakeLists.txt.Host (copy it to CMakeLists.txt), which compiles Pico-RGB-Matrix.c with HOST_SIMULATOR defined
+      and links it with this file. No Pico SDK is required.
+   2) Pico SDK functions used by the firmware are stubbed below. They act on a simulated state when it matters for rendering
+      (microseconds clock, GPIO outputs, flash memory) and do nothing otherwise.
+   3) Frames (FrameBuffer combined with ColorPlane) may be dumped to the terminal with ANSI colors and / or to a series of PPM
+      image files. A frame is dumped every time the firmware calls sleep_ms() or sleep_us() while the matrix content has changed
+      since the last dump, which captures window animations as they would be seen on the matrix.
+
+   4) Scenario <bench> prints the benchmark of the scan and drawing functions in CSV format (see benchmark_run()).
+   5) Scenario <ring> stress tests the ring buffer with two threads (see host_scenario_ring()). The exit status is 1 if it fails.
+
+   Usage: Pico-RGB-Matrix-Host [--ansi] [--ppm Prefix] [--scale N] [text] [window] [scroll] [layout] [bench] [ring]
+          When no scenario is specified, text, window, scroll and layout are executed.
+\* ============================================================================================================================================================= */
+
+#define FONT_DECLARATIONS_ONLY
+#include "font.h"
+#include "Pico-RGB-Matrix-Host.h"
+#include "Pico-RGB-Matrix.h"
+#include "inttypes.h"
+#include "pthread.h"
+#include "sched.h"
+#include "stdarg.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+
+
+
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                   Host simulator definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+#define HOST_DEFAULT_SCALE        8  // default size (in image pixels) of one LED in PPM files.
+#define HOST_RING_ELEMENTS  4000000  // number of elements sent through the ring buffer by the ring scenario.
+#define HOST_RING_SIZE           16  // number of elements of the ring buffer of the ring scenario (small, so that it is often full).
+#define HOST_SCROLL_MAX_STEPS 40000  // safety limit of scroll steps for the scroll scenario.
+
+/* Element of the ring buffer of the ring scenario. */
+struct host_ring_element
+{
+  UINT32 Sequence;                            // sequence number of the element.
+  UINT32 Check;                               // complement of Sequence, to detect torn elements.
+};
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                End of host simulator definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+
+
+
+/* $TITLE=Firmware references. */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                  Firmware functions and variables used by the host simulator.
+\* ============================================================================================================================================================= */
+extern struct active_scroll *ActiveScroll[MAX_ACTIVE_SCROLL];
+extern UINT64 ColorPlane[3][MAX_ROWS];
+extern UINT64 DebugBitMask;
+extern UINT64 FrameBuffer[MAX_ROWS];
+extern UINT32 TransitionRowMask;
+extern UINT32 LayoutCacheHits;
+extern UINT32 LayoutCacheMisses;
+extern struct window Window[MAX_WINDOWS];
+
+void   benchmark_run(void);
+void   layout_init(void);
+void   RGB_matrix_box(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn, UINT8 Color, UINT8 Action);
+void   RGB_matrix_cls(UINT64 *BufferPointer);
+UINT16 ring_count(struct ring *Ring);
+UINT8  ring_get(struct ring *Ring, void *Data);
+UINT8  ring_put(struct ring *Ring, const void *Data);
+UINT8  RGB_matrix_printf(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 FontType, UCHAR *Format, ...);
+void   RGB_matrix_scroll(UINT8 ScrollNumber);
+void   RGB_matrix_set_color(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn, UINT8 Color);
+UINT8  scroll_compose(void);
+UINT64 transition_row(UINT8 RowNumber, UINT64 *Plane, UINT64 *OverrideMask);
+UINT8  transition_tick(void);
+void   win_close(UINT8 WindowNumber);
+void   win_init();
+void   win_open(UINT8 WindowNumber, UINT8 FlagRestore);
+UINT8  win_printf(UINT8 WindowNumber, UINT8 StartRow, UINT8 StartColumn, UINT8 FontType, UCHAR *Format, ...);
+UINT8  win_printf_layout(UINT8 WindowNumber, UINT8 StartRow, UINT8 Flags, UINT8 FontType, UCHAR *Format, ...);
+void   win_part_cls(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow);
+UINT8  win_scroll(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow, UINT16 ScrollTimes, UINT8 ScrollSpeed, UINT8 FontType, UCHAR *Format, ...);
+
+
+
+
+
+/* $TITLE=Host simulator function prototypes. */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                              Host simulator function prototypes.
+\* ============================================================================================================================================================= */
+/* Dump current matrix content to the terminal, using ANSI background colors. */
+void host_dump_ansi(void);
+
+/* Dump current matrix content to all enabled outputs if it changed since last dump. */
+void host_dump_frame(void);
+
+/* Dump current matrix content to the next PPM image file. */
+void host_dump_ppm(void);
+
+/* Return the 3-bit color (RED / GREEN / BLUE) of the specified LED as displayed, BLACK if the LED is Off. */
+UINT8 host_led_color(UINT8 RowNumber, UINT8 ColumnNumber);
+
+/* Consumer thread of the ring buffer stress test. */
+void *host_ring_consumer(void *Argument);
+
+/* Producer thread of the ring buffer stress test. */
+void *host_ring_producer(void *Argument);
+
+/* Scenario: lay out text in windows (kerning, alignment, ellipsis and overflowing text promoted to a scroll). */
+void host_scenario_layout(void);
+
+/* Scenario: stress the ring buffer with a producer thread and a consumer thread, return the number of errors detected. */
+UINT32 host_scenario_ring(void);
+
+/* Scenario: scroll a long string in a window until the scroll is completed. */
+void host_scenario_scroll(void);
+
+/* Scenario: display text with every font and color, then a box. */
+void host_scenario_text(void);
+
+/* Scenario: open a window with each transition effect and print in it, then close it over two windows. */
+void host_scenario_window(void);
+
+
+
+
+
+/* $TITLE=Host simulator global variables. */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                              Host simulator global variables.
+\* ============================================================================================================================================================= */
+UCHAR  *HostPpmPrefix = NULL;                 // prefix of PPM file names (NULL when PPM output is Off).
+
+UINT8   HostFlagAnsi = FLAG_OFF;              // flag indicating that frames are dumped to the terminal.
+UINT8   HostFlagCapture = FLAG_OFF;           // flag indicating that sleep_ms() and sleep_us() must dump the frame.
+
+UINT16  HostPpmScale = HOST_DEFAULT_SCALE;    // size (in image pixels) of one LED in PPM files.
+
+UINT32  HostFrameNumber = 0;                  // number of frames dumped so far.
+UINT32  HostGpio = 0;                         // simulated state of GPIO outputs (bit 0 = GPIO 0).
+UINT32  HostRingErrors = 0;                   // number of errors detected by the ring scenario.
+
+UINT64  HostLastColor[3][MAX_ROWS];           // color planes as displayed (ColorPlane through the transitions in progress) at last dump.
+UINT64  HostLastFrame[MAX_ROWS];              // matrix rows as displayed (FrameBuffer through the transitions in progress) at last dump.
+UINT64  HostTimeUSec = 0ll;                   // simulated microseconds clock.
+
+struct host_ring_element HostRingElement[HOST_RING_SIZE];                              // storage of the ring buffer of the ring scenario.
+struct ring HostRing = RING_INITIALIZER(HostRingElement, HOST_RING_SIZE);             // ring buffer of the ring scenario.
+
+const absolute_time_t nil_time = 0;
+
+uint8_t  HostFlash[HOST_FLASH_SIZE];
+uint8_t  HostI2c[2];
+uint8_t  HostUart[2];
+uint32_t HostPpb[0x4000];
+
+
+
+
+
+/* $TITLE=main() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                                 Host simulator entry point.
+\* ============================================================================================================================================================= */
+int main(int argc, char *argv[])
+{
+  UINT8 FlagScenario;
+  UINT8 Loop1UInt8;
+
+  UINT32 Errors;
+
+
+  /* Flash memory is in erased state on entry. */
+  memset(HostFlash, 0xFF, sizeof(HostFlash));
+
+  Errors       = 0;
+  FlagScenario = FLAG_OFF;
+
+  /* Parse options first so that they apply to all scenarios. */
+  for (Loop1UInt8 = 1; Loop1UInt8 < argc; ++Loop1UInt8)
+  {
+    if (strcmp(argv[Loop1UInt8], "--ansi") == 0)
+    {
+      HostFlagAnsi = FLAG_ON;
+    }
+    else if ((strcmp(argv[Loop1UInt8], "--ppm") == 0) && (Loop1UInt8 + 1 < argc))
+    {
+      HostPpmPrefix = argv[++Loop1UInt8];
+    }
+    else if ((strcmp(argv[Loop1UInt8], "--scale") == 0) && (Loop1UInt8 + 1 < argc))
+    {
+      HostPpmScale = atoi(argv[++Loop1UInt8]);
+      if (HostPpmScale == 0) HostPpmScale = 1;
+    }
+    else if (argv[Loop1UInt8][0] == '-')
+    {
+      fprintf(stderr, "Usage: %s [--ansi] [--ppm Prefix] [--scale N] [text] [window] [scroll] [layout] [bench] [ring]\n", argv[0]);
+      return 1;
+    }
+    else
+    {
+      FlagScenario = FLAG_ON;
+    }
+  }
+
+  /* Same order as firmware power-up sequence. */
+  layout_init();
+  win_init();
+
+  for (Loop1UInt8 = 1; Loop1UInt8 < argc; ++Loop1UInt8)
+  {
+    if ((strcmp(argv[Loop1UInt8], "--ppm") == 0) || (strcmp(argv[Loop1UInt8], "--scale") == 0))
+    {
+      ++Loop1UInt8;  // skip option value.
+      continue;
+    }
+    if (argv[Loop1UInt8][0] == '-') continue;
+
+    if      (strcmp(argv[Loop1UInt8], "text")   == 0) host_scenario_text();
+    else if (strcmp(argv[Loop1UInt8], "window") == 0) host_scenario_window();
+    else if (strcmp(argv[Loop1UInt8], "scroll") == 0) host_scenario_scroll();
+    else if (strcmp(argv[Loop1UInt8], "layout") == 0) host_scenario_layout();
+    else if (strcmp(argv[Loop1UInt8], "bench")  == 0) benchmark_run();
+    else if (strcmp(argv[Loop1UInt8], "ring")   == 0) Errors += host_scenario_ring();
+    else
+    {
+      fprintf(stderr, "Unknown scenario: %s\n", argv[Loop1UInt8]);
+      return 1;
+    }
+  }
+
+  /* Execute all rendering scenarios when none has been specified. */
+  if (FlagScenario == FLAG_OFF)
+  {
+    host_scenario_text();
+    host_scenario_window();
+    host_scenario_scroll();
+    host_scenario_layout();
+  }
+
+  fprintf(stderr, "%u frame(s) dumped, %" PRIu64 " msec of simulated time.\n", HostFrameNumber, HostTimeUSec / 1000);
+
+  return (Errors == 0) ? 0 : 1;
+}
+
+
+
+
+
+/* $TITLE=host_dump_ansi() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                 Dump current matrix content to the terminal, using ANSI background colors.
+\* ============================================================================================================================================================= */
+void host_dump_ansi(void)
+{
+  UINT8 Color;
+  UINT8 ColumnNumber;
+  UINT8 RowNumber;
+
+
+  printf("Frame %u   (%" PRIu64 " usec)\n", HostFrameNumber, HostTimeUSec);
+  for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
+  {
+    for (ColumnNumber = 0; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
+    {
+      Color = host_led_color(RowNumber, ColumnNumber);
+
+      /* ANSI color number is red = 1, green = 2 and blue = 4, the reverse of matrix color bits. */
+      printf("\033[%um  ", 40 + (((Color & RED) ? 1 : 0) | ((Color & GREEN) ? 2 : 0) | ((Color & BLUE) ? 4 : 0)));
+    }
+    printf("\033[0m\n");
+  }
+  printf("\n");
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=host_dump_frame() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                 Dump current matrix content to all enabled outputs if it changed since last dump.
+\* ============================================================================================================================================================= */
+void host_dump_frame(void)
+{
+  UINT8 RowNumber;
+
+  UINT64 Color[3][MAX_ROWS];
+  UINT64 Frame[MAX_ROWS];
+  UINT64 OverrideMask;
+  UINT64 Plane[3];
+
+
+  /* Rows and colors as the scan would display them, including the keyframes of the window transitions in progress. */
+  for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
+  {
+    Frame[RowNumber] = transition_row(RowNumber, Plane, &OverrideMask);
+    Color[PLANE_RED][RowNumber]   = Plane[PLANE_RED];
+    Color[PLANE_GREEN][RowNumber] = Plane[PLANE_GREEN];
+    Color[PLANE_BLUE][RowNumber]  = Plane[PLANE_BLUE];
+  }
+
+  if ((memcmp(HostLastFrame, Frame, sizeof(HostLastFrame)) == 0) && (memcmp(HostLastColor, Color, sizeof(HostLastColor)) == 0)) return;
+
+  memcpy(HostLastFrame, Frame, sizeof(HostLastFrame));
+  memcpy(HostLastColor, Color, sizeof(HostLastColor));
+
+  if (HostFlagAnsi == FLAG_ON) host_dump_ansi();
+  if (HostPpmPrefix != NULL)   host_dump_ppm();
+
+  ++HostFrameNumber;
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=host_dump_ppm() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                           Dump current matrix content to the next PPM image file.
+\* ============================================================================================================================================================= */
+void host_dump_ppm(void)
+{
+  UCHAR FileName[256];
+
+  UINT8 Color;
+  UINT8 ColumnNumber;
+  UINT8 RowNumber;
+
+  UINT16 Loop1UInt16;
+  UINT16 Loop2UInt16;
+
+  FILE *PpmFile;
+
+
+  snprintf(FileName, sizeof(FileName), "%s-%4.4u.ppm", HostPpmPrefix, HostFrameNumber);
+  if ((PpmFile = fopen(FileName, "wb")) == NULL)
+  {
+    fprintf(stderr, "Unable to create PPM file %s\n", FileName);
+    return;
+  }
+
+  fprintf(PpmFile, "P6\n%u %u\n255\n", MAX_COLUMNS * HostPpmScale, MAX_ROWS * HostPpmScale);
+  for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
+  {
+    for (Loop1UInt16 = 0; Loop1UInt16 < HostPpmScale; ++Loop1UInt16)
+    {
+      for (ColumnNumber = 0; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
+      {
+        Color = host_led_color(RowNumber, ColumnNumber);
+        for (Loop2UInt16 = 0; Loop2UInt16 < HostPpmScale; ++Loop2UInt16)
+        {
+          fputc((Color & RED)   ? 0xFF : 0x00, PpmFile);
+          fputc((Color & GREEN) ? 0xFF : 0x00, PpmFile);
+          fputc((Color & BLUE)  ? 0xFF : 0x00, PpmFile);
+        }
+      }
+    }
+  }
+  fclose(PpmFile);
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=host_led_color() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                    Return the 3-bit color (RED / GREEN / BLUE) of the specified LED as displayed, BLACK if the LED is Off.
+\* ============================================================================================================================================================= */
+UINT8 host_led_color(UINT8 RowNumber, UINT8 ColumnNumber)
+{
+  UINT8 Color;
+
+
+  if ((HostLastFrame[RowNumber] & (0x01ll << ColumnNumber)) == 0) return BLACK;
+
+  Color = BLACK;
+  if (HostLastColor[PLANE_RED][RowNumber]   & (0x01ll << ColumnNumber)) Color |= RED;
+  if (HostLastColor[PLANE_GREEN][RowNumber] & (0x01ll << ColumnNumber)) Color |= GREEN;
+  if (HostLastColor[PLANE_BLUE][RowNumber]  & (0x01ll << ColumnNumber)) Color |= BLUE;
+
+  return Color;
+}
+
+
+
+
+
+/* $TITLE=host_ring_consumer() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                        Consumer thread of the ring buffer stress test (see host_scenario_ring()).
+\* ============================================================================================================================================================= */
+void *host_ring_consumer(void *Argument)
+{
+  UINT32 Expected;
+
+  struct host_ring_element Element;
+
+
+  for (Expected = 0; Expected < HOST_RING_ELEMENTS; )
+  {
+    /* Give the processor to the producer when the ring is empty (the host may have a single processor). */
+    if (ring_get(&HostRing, &Element) == FLAG_OFF)
+    {
+      sched_yield();
+      continue;
+    }
+
+    /* Elements must come out in the order they were put, each one exactly once and not torn by a concurrent write. */
+    if ((Element.Sequence != Expected) || (Element.Check != ~Element.Sequence))
+    {
+      if (HostRingErrors < 10)
+        fprintf(stderr, "Ring error: expected element %" PRIu32 ", got %" PRIu32 " (check 0x%8.8" PRIX32 ").\n", Expected, Element.Sequence, Element.Check);
+      ++HostRingErrors;
+
+      /* Resynchronize on the element received so that a single loss or duplicate is reported only once. */
+      Expected = Element.Sequence;
+    }
+    ++Expected;
+  }
+
+  return NULL;
+}
+
+
+
+
+
+/* $TITLE=host_ring_producer() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                        Producer thread of the ring buffer stress test (see host_scenario_ring()).
+   NOTE: When the ring is full, ring_put() counts an overflow and the same element is put again until it succeeds.
+\* ============================================================================================================================================================= */
+void *host_ring_producer(void *Argument)
+{
+  UINT32 Sequence;
+
+  struct host_ring_element Element;
+
+
+  for (Sequence = 0; Sequence < HOST_RING_ELEMENTS; ++Sequence)
+  {
+    Element.Sequence = Sequence;
+    Element.Check    = ~Sequence;
+    while (ring_put(&HostRing, &Element) == FLAG_OFF) sched_yield();
+  }
+
+  return NULL;
+}
+
+
+
+
+
+/* $TITLE=host_scenario_layout() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                           Scenario: lay out text in windows (kerning, alignment, ellipsis and overflowing text promoted to a scroll).
+\* ============================================================================================================================================================= */
+void host_scenario_layout(void)
+{
+  UCHAR String[16];
+
+  UINT8 FlagActive;
+  UINT8 Loop1UInt8;
+
+  UINT16 Step;
+
+  UINT32 CacheHits;
+  UINT32 CacheMisses;
+
+
+  RGB_matrix_cls(FrameBuffer);
+  win_open(WIN_DATE, FLAG_OFF);
+  win_open(WIN_TIME, FLAG_OFF);
+  while (TransitionRowMask != 0l) transition_tick();
+
+  /* Kerned and right-aligned text, then a text cut with an ellipsis. */
+  win_printf(WIN_DATE, 201, 99, FONT_5x7, "Tuesday");
+  win_printf_layout(WIN_DATE, 202, LAYOUT_RIGHT, FONT_5x7, "LT.");
+  host_dump_frame();
+
+  win_part_cls(WIN_DATE, 202, 202);
+  win_printf_layout(WIN_DATE, 202, LAYOUT_LEFT | LAYOUT_ELLIPSIS, FONT_5x7, "Ellipsis after this text");
+  host_dump_frame();
+
+  /* Clock ticking for a few seconds: the date is redrawn unchanged and found in the cache, the time changes and must be measured again. */
+  CacheHits   = LayoutCacheHits;
+  CacheMisses = LayoutCacheMisses;
+  for (Loop1UInt8 = 0; Loop1UInt8 < 3; ++Loop1UInt8)
+  {
+    sprintf(String, "12:34:%2.2u", 56 + Loop1UInt8);
+    win_printf(WIN_DATE, 201, 99, FONT_5x7, "Tuesday");
+    win_printf(WIN_TIME, 203, 99, FONT_8x10, "%s", String);
+    HostTimeUSec += 1000000ll;
+    host_dump_frame();
+  }
+  fprintf(stderr, "Layout cache over 3 seconds - hits: %u   misses: %u\n", LayoutCacheHits - CacheHits, LayoutCacheMisses - CacheMisses);
+
+  /* Centered text that does not fit in the window is scrolled instead. */
+  win_printf(WIN_TIME, 203, 99, FONT_8x10, "Too long for the window");
+  for (Step = 0; Step < HOST_SCROLL_MAX_STEPS; ++Step)
+  {
+    FlagActive = FLAG_OFF;
+    for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ACTIVE_SCROLL; ++Loop1UInt8)
+      if (ActiveScroll[Loop1UInt8] != 0x00l) FlagActive = FLAG_ON;
+    if (FlagActive == FLAG_OFF) break;
+
+    scroll_compose();
+
+    HostTimeUSec += SCROLL_TICK_USEC;
+    host_dump_frame();
+  }
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=host_scenario_ring() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                       Scenario: stress the single-producer / single-consumer ring buffer with a producer thread and a consumer thread.
+   NOTES:
+   1) The producer puts HOST_RING_ELEMENTS sequence numbers in a small ring while the consumer checks that they come out in order,
+      that none is lost or duplicated, and that no element is torn (each element also carries the complement of its sequence number).
+   2) Host threads run truly in parallel, like the two Pico cores, so this also exercises the memory barriers of ring_put() / ring_get().
+   3) Return the number of errors detected (0 when the test passes).
+\* ============================================================================================================================================================= */
+UINT32 host_scenario_ring(void)
+{
+  pthread_t Consumer;
+  pthread_t Producer;
+
+
+  HostRing.Head     = 0;
+  HostRing.Tail     = 0;
+  HostRing.Overflow = 0;
+  HostRingErrors    = 0;
+
+  if ((pthread_create(&Consumer, NULL, host_ring_consumer, NULL) != 0) || (pthread_create(&Producer, NULL, host_ring_producer, NULL) != 0))
+  {
+    fprintf(stderr, "Ring test: failed to create threads.\n");
+    exit(1);
+  }
+  pthread_join(Producer, NULL);
+  pthread_join(Consumer, NULL);
+
+  /* Everything that has been put must have been retrieved. */
+  if (ring_count(&HostRing) != 0) ++HostRingErrors;
+
+  /* Overflow is a free-running 16-bit counter: only its low bits are meaningful here, it just shows that the ring has been filled. */
+  fprintf(stderr, "Ring test: %u elements through a %u-element ring, %u error(s), overflow counter %u: %s.\n",
+          HOST_RING_ELEMENTS, HostRing.Mask + 1, HostRingErrors, HostRing.Overflow, (HostRingErrors == 0) ? "PASS" : "FAIL");
+
+  return HostRingErrors;
+}
+
+
+
+
+
+/* $TITLE=host_scenario_scroll() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                     Scenario: scroll texts concurrently in several windows and window lines until all scrolls are completed.
+\* ============================================================================================================================================================= */
+void host_scenario_scroll(void)
+{
+  UINT8 FlagActive;
+  UINT8 Loop1UInt8;
+
+  UINT16 Step;
+
+
+  RGB_matrix_cls(FrameBuffer);
+  win_open(WIN_DATE, FLAG_OFF);
+  win_open(WIN_TIME, FLAG_OFF);
+
+  /* Message band and date band of WIN_DATE, and WIN_TIME (whose box border must remain still), at different speeds. */
+  win_scroll(WIN_DATE, 201, 201, 1, SCROLL_SPEED_FAST,    FONT_5x7,  "Host simulator scrolling text...");
+  win_scroll(WIN_DATE, 202, 202, 1, SCROLL_SPEED_DEFAULT, FONT_5x7,  "Date band");
+  win_scroll(WIN_TIME, 203, 203, 1, SCROLL_SPEED_DEFAULT, FONT_8x10, "1234567890");
+
+  /* Same cadence as callback_scroll_timer(): each scroll moves by the pixels due at its speed at every scroll tick, while the opening
+     transitions of both windows are animated. */
+  for (Step = 0; Step < HOST_SCROLL_MAX_STEPS; ++Step)
+  {
+    FlagActive = FLAG_OFF;
+    for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ACTIVE_SCROLL; ++Loop1UInt8)
+      if (ActiveScroll[Loop1UInt8] != 0x00l) FlagActive = FLAG_ON;
+    if ((FlagActive == FLAG_OFF) && (TransitionRowMask == 0l)) break;
+
+    scroll_compose();
+    transition_tick();
+
+    HostTimeUSec += SCROLL_TICK_USEC;
+    host_dump_frame();
+  }
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=host_scenario_text() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                   Scenario: display text with every font and color, then a box.
+\* ============================================================================================================================================================= */
+void host_scenario_text(void)
+{
+  RGB_matrix_cls(FrameBuffer);
+  RGB_matrix_set_color(0,  0,  7, 63, RED);
+  RGB_matrix_set_color(8,  0, 15, 63, GREEN);
+  RGB_matrix_set_color(16, 0, 31, 31, BLUE);
+  RGB_matrix_set_color(16, 32, 31, 63, YELLOW);
+  RGB_matrix_printf(FrameBuffer, 0,  0, FONT_5x7, "12:34");
+  RGB_matrix_printf(FrameBuffer, 8,  0, FONT_4x7, "Host sim");
+  RGB_matrix_printf(FrameBuffer, 18, 2, FONT_8x10, "8x10");
+  host_dump_frame();
+
+  RGB_matrix_box(16, 0, 31, 63, MAGENTA, ACTION_DRAW);
+  host_dump_frame();
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=host_scenario_window() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                     Scenario: open a window with each transition effect and print in it, then close it over two windows.
+\* ============================================================================================================================================================= */
+void host_scenario_window(void)
+{
+  UINT8 Effect;
+
+
+  RGB_matrix_cls(FrameBuffer);
+  host_dump_frame();
+
+  for (Effect = TRANSITION_EXPLODE; Effect <= TRANSITION_DISSOLVE; ++Effect)
+  {
+    /* Window content is final as soon as win_open() returns, the transition is then animated at each scroll tick. */
+    Window[WIN_TEST].Transition = Effect;
+    win_open(WIN_TEST, FLAG_OFF);
+    win_printf(WIN_TEST, 201, 99, FONT_5x7, "Eff %u", Effect);
+
+    while (TransitionRowMask != 0l)
+    {
+      transition_tick();
+      HostTimeUSec += SCROLL_TICK_USEC;
+      host_dump_frame();
+    }
+    host_dump_frame();
+  }
+
+  /* Closing a window covering two others restores both of them, and their transitions are animated at the same time. */
+  win_open(WIN_DATE, FLAG_OFF);
+  win_open(WIN_TIME, FLAG_OFF);
+  Window[WIN_TEST].Transition = TRANSITION_WIPE;
+  win_open(WIN_TEST, FLAG_OFF);
+  while (TransitionRowMask != 0l) transition_tick();
+  host_dump_frame();
+
+  win_close(WIN_TEST);
+  while (TransitionRowMask != 0l)
+  {
+    transition_tick();
+    HostTimeUSec += SCROLL_TICK_USEC;
+    host_dump_frame();
+  }
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=host_time_nsec() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                Monotonic wall clock in nanoseconds, used as benchmark time base on host.
+\* ============================================================================================================================================================= */
+uint64_t host_time_nsec(void)
+{
+  struct timespec TimeSpec;
+
+
+  clock_gettime(CLOCK_MONOTONIC, &TimeSpec);
+
+  return ((uint64_t)TimeSpec.tv_sec * 1000000000ll) + TimeSpec.tv_nsec;
+}
+
+
+
+
+
+/* $TITLE=Stubbed Pico SDK functions. */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                             Stubbed Pico SDK functions (see Pico-RGB-Matrix-Host.h).
+\* ============================================================================================================================================================= */
+void __dmb(void) {__sync_synchronize(); return;}  // real barrier: the ring scenario runs producer and consumer on two host threads.
+void __sev(void) {return;}
+void __wfe(void) {HostTimeUSec += 1000ll; return;}  // simulated clock moves on as if woken up by next interrupt.
+int64_t absolute_time_diff_us(absolute_time_t From, absolute_time_t To) {return (int64_t)(To - From);}
+void adc_gpio_init(uint Gpio) {return;}
+void adc_init(void) {return;}
+uint16_t adc_read(void) {return 0x800;}
+void adc_select_input(uint Input) {return;}
+void adc_set_temp_sensor_enabled(bool Enable) {return;}
+
+bool add_repeating_timer_ms(int32_t DelayMSec, repeating_timer_callback_t Callback, void *UserData, repeating_timer_t *Timer)
+{
+  return add_repeating_timer_us((int64_t)DelayMSec * 1000ll, Callback, UserData, Timer);
+}
+
+/* Timers are recorded but never fire: the host simulator drives rendering functions directly. */
+bool add_repeating_timer_us(int64_t DelayUSec, repeating_timer_callback_t Callback, void *UserData, repeating_timer_t *Timer)
+{
+  Timer->delay_us  = DelayUSec;
+  Timer->callback  = Callback;
+  Timer->user_data = UserData;
+
+  return true;
+}
+
+/* There is a single simulated core, so alarm pools are the default one. */
+bool alarm_pool_add_repeating_timer_ms(alarm_pool_t *Pool, int32_t DelayMSec, repeating_timer_callback_t Callback, void *UserData, repeating_timer_t *Timer)
+{
+  return add_repeating_timer_us((int64_t)DelayMSec * 1000ll, Callback, UserData, Timer);
+}
+
+bool alarm_pool_add_repeating_timer_us(alarm_pool_t *Pool, int64_t DelayUSec, repeating_timer_callback_t Callback, void *UserData, repeating_timer_t *Timer)
+{
+  return add_repeating_timer_us(DelayUSec, Callback, UserData, Timer);
+}
+
+alarm_pool_t *alarm_pool_create(uint HardwareAlarmNumber, uint MaxTimers) {return NULL;}
+
+bool cancel_repeating_timer(repeating_timer_t *Timer) {Timer->callback = NULL; return true;}
+uint32_t clock_get_hz(enum clock_index ClockIndex) {return 125000000;}
+
+void flash_range_erase(uint32_t FlashOffset, size_t Count)
+{
+  if ((FlashOffset + Count) <= HOST_FLASH_SIZE) memset(&HostFlash[FlashOffset], 0xFF, Count);
+
+  return;
+}
+
+void flash_range_program(uint32_t FlashOffset, const uint8_t *Data, size_t Count)
+{
+  size_t Loop1Size;
+
+
+  /* Programming may only clear bits, as on real flash memory. */
+  if ((FlashOffset + Count) > HOST_FLASH_SIZE) return;
+  for (Loop1Size = 0; Loop1Size < Count; ++Loop1Size)
+    HostFlash[FlashOffset + Loop1Size] &= Data[Loop1Size];
+
+  return;
+}
+
+absolute_time_t get_absolute_time(void) {return HostTimeUSec;}
+uint get_core_num(void) {return 0;}
+int getchar_timeout_us(uint32_t TimeoutUSec) {HostTimeUSec += TimeoutUSec; return PICO_ERROR_TIMEOUT;}
+void gpio_acknowledge_irq(uint Gpio, uint32_t Events) {return;}
+bool gpio_get(uint Gpio) {return ((HostGpio >> Gpio) & 0x01);}
+void gpio_init(uint Gpio) {HostGpio &= ~(0x01 << Gpio); return;}
+void gpio_pull_up(uint Gpio) {return;}
+
+void gpio_put(uint Gpio, bool Value)
+{
+  if (Value)
+    HostGpio |= (0x01 << Gpio);
+  else
+    HostGpio &= ~(0x01 << Gpio);
+
+  return;
+}
+
+void gpio_put_masked(uint32_t Mask, uint32_t Value) {HostGpio = (HostGpio & ~Mask) | (Value & Mask); return;}
+void gpio_set_dir(uint Gpio, bool Out) {return;}
+void gpio_set_function(uint Gpio, enum gpio_function Function) {return;}
+void gpio_set_irq_enabled(uint Gpio, uint32_t Events, bool Enabled) {return;}
+void gpio_set_irq_enabled_with_callback(uint Gpio, uint32_t Events, bool Enabled, gpio_irq_callback_t Callback) {return;}
+void gpio_set_outover(uint Gpio, uint Value) {return;}
+int i2c_read_blocking(i2c_inst_t *I2c, uint8_t Address, uint8_t *Destination, size_t Length, bool NoStop) {memset(Destination, 0x00, Length); return (int)Length;}
+uint i2c_init(i2c_inst_t *I2c, uint Baudrate) {return Baudrate;}
+int i2c_write_blocking(i2c_inst_t *I2c, uint8_t Address, const uint8_t *Source, size_t Length, bool NoStop) {return (int)Length;}
+bool is_nil_time(absolute_time_t Time) {return (Time == nil_time);}
+uint32_t multicore_fifo_pop_blocking(void) {return 0;}
+void multicore_fifo_push_blocking(uint32_t Data) {return;}
+void multicore_launch_core1(void (*Entry)(void)) {return;}
+void pico_get_unique_board_id(pico_unique_board_id_t *BoardId) {memset(BoardId->id, 0x5A, sizeof(BoardId->id)); return;}
+uint pwm_gpio_to_channel(uint Gpio) {return (Gpio & 0x01);}
+uint pwm_gpio_to_slice_num(uint Gpio) {return ((Gpio >> 1) & 0x07);}
+void pwm_set_chan_level(uint Slice, uint Channel, uint16_t Level) {return;}
+void pwm_set_clkdiv(uint Slice, float Divider) {return;}
+void pwm_set_enabled(uint Slice, bool Enabled) {return;}
+void pwm_set_wrap(uint Slice, uint16_t Wrap) {return;}
+void reset_usb_boot(uint32_t GpioMask, uint32_t DisableInterfaceMask) {exit(0);}
+void restore_interrupts(uint32_t Status) {return;}
+uint32_t save_and_disable_interrupts(void) {return 0;}
+
+void sleep_ms(uint32_t MSec)
+{
+  HostTimeUSec += (MSec * 1000ll);
+  if (HostFlagCapture == FLAG_ON) host_dump_frame();
+
+  return;
+}
+
+void sleep_us(uint64_t USec)
+{
+  HostTimeUSec += USec;
+  if (HostFlagCapture == FLAG_ON) host_dump_frame();
+
+  return;
+}
+
+uint32_t spin_lock_blocking(spin_lock_t *Lock) {return 0;}
+int spin_lock_claim_unused(bool Required) {return 0;}
+spin_lock_t *spin_lock_init(uint LockNumber) {static spin_lock_t HostSpinLock[32]; return &HostSpinLock[LockNumber & 0x1F];}
+void spin_unlock(spin_lock_t *Lock, uint32_t Status) {return;}
+
+void stdio_set_chars_available_callback(void (*Callback)(void *Param), void *Param) {return;}
+bool stdio_init_all(void) {return true;}
+bool stdio_usb_connected(void) {return false;}
+uint32_t time_us_32(void) {return (uint32_t)HostTimeUSec;}
+uint64_t time_us_64(void) {return HostTimeUSec;}
+uint uart_init(uart_inst_t *Uart, uint Baudrate) {return Baudrate;}
+void uart_set_format(uart_inst_t *Uart, uint DataBits, uint StopBits, uart_parity_t Parity) {return;}
+void watchdog_enable(uint32_t DelayMSec, bool PauseOnDebug) {return;}
@@ -0,0 +1,178 @@
+/* ============================================================================================================================================================= *\
+   Pico-RGB-Matrix-Host.h
+   St-Louys Andre - August 2022
+   astlouys@gmail.com
+   Langage: C with gcc (host build)
+
+   Raspberry Pi Pico Firmware to drive the Waveshare Pico-RGB-Matrix.
+   Stubbed Pico SDK definitions used when Pico-RGB-Matrix.c is built for the host (Linux) simulator (HOST_SIMULATOR).
+   Released under 3-Clause BSD License.
+
+   NOTES:
+   1) Only the part of the SDK used by the firmware is declared here. Hardware functions are implemented in Pico-RGB-Matrix-Host.c
+      and either do nothing or act on a simulated state (GPIO outputs, flash memory, microseconds clock).
+   2) Time does not flow by itself: sleep_ms() and sleep_us() advance the simulated clock returned by time_us_64().
+\* ============================================================================================================================================================= */
+
+#ifndef __PICO_RGB_MATRIX_HOST_H
+#define __PICO_RGB_MATRIX_HOST_H
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+
+
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                   Pico SDK types and definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+typedef unsigned int uint;
+typedef uint64_t     absolute_time_t;
+
+typedef struct i2c_inst  i2c_inst_t;
+typedef struct uart_inst uart_inst_t;
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t events);
+
+struct repeating_timer;
+typedef bool (*repeating_timer_callback_t)(struct repeating_timer *rt);
+
+struct repeating_timer
+{
+  int64_t delay_us;
+  repeating_timer_callback_t callback;
+  void *user_data;
+};
+typedef struct repeating_timer repeating_timer_t;
+
+typedef struct alarm_pool alarm_pool_t;
+typedef volatile uint32_t spin_lock_t;
+
+#define PICO_UNIQUE_BOARD_ID_SIZE_BYTES  8
+typedef struct
+{
+  uint8_t id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES];
+}pico_unique_board_id_t;
+
+enum clock_index {clk_gpout0 = 0, clk_gpout1, clk_gpout2, clk_gpout3, clk_ref, clk_sys, clk_peri, clk_usb, clk_adc, clk_rtc};
+enum gpio_function {GPIO_FUNC_XIP = 0, GPIO_FUNC_SPI, GPIO_FUNC_UART, GPIO_FUNC_I2C, GPIO_FUNC_PWM, GPIO_FUNC_SIO, GPIO_FUNC_PIO0, GPIO_FUNC_PIO1, GPIO_FUNC_GPCK, GPIO_FUNC_USB, GPIO_FUNC_NULL = 0x1F};
+typedef enum {UART_PARITY_NONE, UART_PARITY_EVEN, UART_PARITY_ODD} uart_parity_t;
+
+#define GPIO_IN                  false
+#define GPIO_OUT                 true
+
+#define GPIO_IRQ_LEVEL_LOW       0x1u
+#define GPIO_IRQ_LEVEL_HIGH      0x2u
+#define GPIO_IRQ_EDGE_FALL       0x4u
+#define GPIO_IRQ_EDGE_RISE       0x8u
+
+#define GPIO_OVERRIDE_NORMAL     0
+#define GPIO_OVERRIDE_INVERT     1
+#define GPIO_OVERRIDE_LOW        2
+#define GPIO_OVERRIDE_HIGH       3
+
+#define PICO_ERROR_TIMEOUT       -1
+
+#define FLASH_PAGE_SIZE          (1u << 8)
+#define FLASH_SECTOR_SIZE        (1u << 12)
+#define HOST_FLASH_SIZE          (2 * 1024 * 1024)
+
+#define i2c0                     ((i2c_inst_t *)&HostI2c[0])
+#define i2c1                     ((i2c_inst_t *)&HostI2c[1])
+#define uart0                    ((uart_inst_t *)&HostUart[0])
+#define uart1                    ((uart_inst_t *)&HostUart[1])
+
+/* Memory-mapped areas are redirected to simulated memory. */
+#define XIP_BASE                 ((uintptr_t)HostFlash)
+#define PPB_BASE                 ((uintptr_t)HostPpb)
+
+#define NOP                      do {} while (0)
+
+extern const absolute_time_t nil_time;
+
+extern uint8_t  HostFlash[HOST_FLASH_SIZE];  // simulated flash memory (erased state on entry).
+extern uint8_t  HostI2c[2];                  // placeholders giving i2c0 / i2c1 distinct addresses.
+extern uint8_t  HostUart[2];                 // placeholders giving uart0 / uart1 distinct addresses.
+extern uint32_t HostPpb[0x4000];             // simulated Cortex-M0+ private peripheral bus registers.
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                               End of Pico SDK types and definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                    Stubbed Pico SDK functions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+void     __dmb(void);
+void     __sev(void);
+void     __wfe(void);
+int64_t  absolute_time_diff_us(absolute_time_t From, absolute_time_t To);
+void     adc_gpio_init(uint Gpio);
+void     adc_init(void);
+uint16_t adc_read(void);
+void     adc_select_input(uint Input);
+void     adc_set_temp_sensor_enabled(bool Enable);
+bool     add_repeating_timer_ms(int32_t DelayMSec, repeating_timer_callback_t Callback, void *UserData, repeating_timer_t *Timer);
+bool     add_repeating_timer_us(int64_t DelayUSec, repeating_timer_callback_t Callback, void *UserData, repeating_timer_t *Timer);
+bool     alarm_pool_add_repeating_timer_ms(alarm_pool_t *Pool, int32_t DelayMSec, repeating_timer_callback_t Callback, void *UserData, repeating_timer_t *Timer);
+bool     alarm_pool_add_repeating_timer_us(alarm_pool_t *Pool, int64_t DelayUSec, repeating_timer_callback_t Callback, void *UserData, repeating_timer_t *Timer);
+alarm_pool_t *alarm_pool_create(uint HardwareAlarmNumber, uint MaxTimers);
+bool     cancel_repeating_timer(repeating_timer_t *Timer);
+uint32_t clock_get_hz(enum clock_index ClockIndex);
+void     flash_range_erase(uint32_t FlashOffset, size_t Count);
+void     flash_range_program(uint32_t FlashOffset, const uint8_t *Data, size_t Count);
+absolute_time_t get_absolute_time(void);
+uint     get_core_num(void);
+int      getchar_timeout_us(uint32_t TimeoutUSec);
+void     gpio_acknowledge_irq(uint Gpio, uint32_t Events);
+bool     gpio_get(uint Gpio);
+void     gpio_init(uint Gpio);
+void     gpio_pull_up(uint Gpio);
+void     gpio_put(uint Gpio, bool Value);
+void     gpio_put_masked(uint32_t Mask, uint32_t Value);
+void     gpio_set_dir(uint Gpio, bool Out);
+void     gpio_set_function(uint Gpio, enum gpio_function Function);
+void     gpio_set_irq_enabled(uint Gpio, uint32_t Events, bool Enabled);
+void     gpio_set_irq_enabled_with_callback(uint Gpio, uint32_t Events, bool Enabled, gpio_irq_callback_t Callback);
+void     gpio_set_outover(uint Gpio, uint Value);
+int      i2c_read_blocking(i2c_inst_t *I2c, uint8_t Address, uint8_t *Destination, size_t Length, bool NoStop);
+uint     i2c_init(i2c_inst_t *I2c, uint Baudrate);
+int      i2c_write_blocking(i2c_inst_t *I2c, uint8_t Address, const uint8_t *Source, size_t Length, bool NoStop);
+bool     is_nil_time(absolute_time_t Time);
+uint32_t multicore_fifo_pop_blocking(void);
+void     multicore_fifo_push_blocking(uint32_t Data);
+void     multicore_launch_core1(void (*Entry)(void));
+void     pico_get_unique_board_id(pico_unique_board_id_t *BoardId);
+uint     pwm_gpio_to_channel(uint Gpio);
+uint     pwm_gpio_to_slice_num(uint Gpio);
+void     pwm_set_chan_level(uint Slice, uint Channel, uint16_t Level);
+void     pwm_set_clkdiv(uint Slice, float Divider);
+void     pwm_set_enabled(uint Slice, bool Enabled);
+void     pwm_set_wrap(uint Slice, uint16_t Wrap);
+void     reset_usb_boot(uint32_t GpioMask, uint32_t DisableInterfaceMask);
+void     restore_interrupts(uint32_t Status);
+uint32_t save_and_disable_interrupts(void);
+void     sleep_ms(uint32_t MSec);
+void     sleep_us(uint64_t USec);
+uint32_t spin_lock_blocking(spin_lock_t *Lock);
+int      spin_lock_claim_unused(bool Required);
+spin_lock_t *spin_lock_init(uint LockNumber);
+void     spin_unlock(spin_lock_t *Lock, uint32_t Status);
+void     stdio_set_chars_available_callback(void (*Callback)(void *Param), void *Param);
+bool     stdio_init_all(void);
+bool     stdio_usb_connected(void);
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+uint     uart_init(uart_inst_t *Uart, uint Baudrate);
+void     uart_set_format(uart_inst_t *Uart, uint DataBits, uint StopBits, uart_parity_t Parity);
+void     watchdog_enable(uint32_t DelayMSec, bool PauseOnDebug);
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                End of stubbed Pico SDK functions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+
+/* Monotonic wall clock in nanoseconds, used as benchmark time base on host (see BENCHMARK_NSEC()). */
+uint64_t host_time_nsec(void);
+
+#endif  // __PICO_RGB_MATRIX_HOST_H
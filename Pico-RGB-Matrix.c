@@ -178,6 +178,27 @@ GPIO 30  - - -    (not used).
 
 
 
+/* RGB matrix scan engine. When PIO_SCAN_SUPPORT is defined, matrix rows are shifted out by two PIO state machines fed by chained DMA channels,
+   without any CPU involvement. When it is commented out, the original bit-banged scan is done by the 1 msec callback (RGB_matrix_update()). */
+/// #define PIO_SCAN_SUPPORT
+#ifdef PIO_SCAN_SUPPORT
+#warning ===============> Built with PIO / DMA matrix scan engine.
+#endif  // PIO_SCAN_SUPPORT
+
+
+
+/* Binary-coded modulation color depth. When BCM_SUPPORT is defined, each pixel may be given a 24-bit color (see RGB_matrix_set_color_rgb())
+   that is displayed with BCM_DEPTH bits per color channel. Requires the PIO / DMA matrix scan engine. */
+/// #define BCM_SUPPORT
+#ifdef BCM_SUPPORT
+#ifndef PIO_SCAN_SUPPORT
+#error BCM_SUPPORT requires PIO_SCAN_SUPPORT.
+#endif  // PIO_SCAN_SUPPORT
+#warning ===============> Built with binary-coded modulation color depth.
+#endif  // BCM_SUPPORT
+
+
+
 /* Conditional compile used to bypass some tests to allow for a quicker power-up sequence by-passing some device tests. */
 /// #define QUICK_START  ///
 #ifdef QUICK_START
@@ -186,6 +207,17 @@ GPIO 30  - - -    (not used).
 
 
 
+/* Host (Linux) simulator build of the rendering code. HOST_SIMULATOR is defined by CMakeLists.txt.Host, never here.
+   Pico SDK is replaced by the stubs of Pico-RGB-Matrix-Host.h and options requiring real hardware are turned Off. */
+#ifdef HOST_SIMULATOR
+#undef NTP_SUPPORT
+#undef PIO_SCAN_SUPPORT
+#undef BCM_SUPPORT
+#warning ===============> Built for host simulator.
+#endif  // HOST_SIMULATOR
+
+
+
 /* NOTE: Parameters below are default configuration parameters that will be used if RGB matrix does not contain a valid configuration
          and / or if configuration becomes corrupted.  When the configuration is changed while the RGB matrix is running, the new
          parameters are saved to flash and become active all the time (until configuration becomes corrupted again, in which case
@@ -258,6 +290,9 @@ GPIO 30  - - -    (not used).
                                                                Definitions and include files
 \* ============================================================================================================================================================= */
 #include "font.h"
+#ifdef HOST_SIMULATOR
+#include "Pico-RGB-Matrix-Host.h"
+#else  // HOST_SIMULATOR
 #include "hardware/adc.h"
 #include "hardware/clocks.h"
 #include "hardware/flash.h"
@@ -267,11 +302,15 @@ GPIO 30  - - -    (not used).
 #include "hardware/sync.h"
 #include "hardware/uart.h"
 #include "hardware/watchdog.h"
+#endif  // HOST_SIMULATOR
 #include "Pico-RGB-Matrix.h"
+#ifndef HOST_SIMULATOR
 #include "pico/bootrom.h"
 #include "pico/multicore.h"
 #include "pico/stdlib.h"
 #include "pico/unique_id.h"
+#endif  // HOST_SIMULATOR
+#include "inttypes.h"
 #include "stdarg.h"
 #include "stdio.h"
 #include "stdlib.h"
@@ -282,6 +321,12 @@ GPIO 30  - - -    (not used).
 #include "PicoW-NTP-Client.h"
 #endif  // NTP_SUPPORT
 
+#ifdef PIO_SCAN_SUPPORT
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "Pico-RGB-Matrix.pio.h"
+#endif  // PIO_SCAN_SUPPORT
+
 
 
 #if LANGUAGE == ENGLISH
@@ -311,8 +356,20 @@ void auto_scroll_process(void);
 /* Make a number of beeps through the buzzer (to be used until the 50msec callback is initialized and may take over). */
 void beep_tone(UINT8 RepeatCount);
 
+/* Print the result of one benchmarked function as a CSV line. */
+void benchmark_report(UCHAR *FunctionName, UCHAR *Variant, UINT32 Iterations, UINT64 ElapsedNSec);
+
+/* Time the scan and drawing hot paths and print the results in CSV format. */
+void benchmark_run(void);
+
+/* Hand over the next queued local button / remote control button to ButtonBuffer[0] / IrBuffer[0]. */
+void button_deliver(void);
+
 /* Callback in charge of matrix scan. */
-bool callback_1msec_timer(struct repeating_timer *t);
+bool callback_scan_timer(struct repeating_timer *t);
+
+/* Callback in charge of text scrolling, at the speed of each active scroll, and of window transitions. */
+bool callback_scroll_timer(struct repeating_timer *t);
 
 /* Callback in charge of active buzzer sound queue and infrared remote control. */
 bool callback_50msec_timer(struct repeating_timer *t);
@@ -320,6 +377,18 @@ bool callback_50msec_timer(struct repeating_timer *t);
 /* One-second callback to update date and time on LED matrix. */
 bool callback_1000msec_timer(struct repeating_timer *t);
 
+/* Return the 99th percentile duration (in usec) of the specified callback. */
+UINT32 callback_stats_p99(const struct callback_stat *Stat);
+
+/* Reset duration statistics of all callbacks. */
+void callback_stats_reset(void);
+
+/* Update duration statistics of the specified callback. To be called just before the callback returns. */
+void callback_stats_update(UINT8 CallbackId, UINT64 StartTime, UINT32 PeriodUSec);
+
+/* Callback called by stdio when character(s) have been received from external terminal. */
+void callback_terminal_input(void *Param);
+
 /* Convert "HumanTime" to "tm_time".*/
 void convert_human_to_tm(struct human_time *HumanTime, struct tm *TmTime);
 
@@ -335,6 +404,12 @@ void convert_unix_time(time_t UnixTime, struct tm *TmTime, struct human_time *Hu
 /* Thread to to be run on Pico's core 1. */
 void core1_main(void);
 
+/* Retrieve the oldest message sent by core 0 (to be called on core 1 only). */
+UINT8 core_channel_get(struct core_message *Message);
+
+/* Send a message to core 1 (to be called on core 0 only). */
+UINT8 core_channel_put(UINT8 Command, UINT16 Param1, UINT16 Param2);
+
 /* Turn On a pixel for debugging purpose. */
 void debug_pixel(UINT8 RowNumber, UINT8 ColumnNumber, UINT8 Color);
 
@@ -344,6 +419,9 @@ void display_alarm(UINT8 AlarmNumber);
 /* Display specified auto-scroll number. */
 void display_auto_scroll(UINT8 AutoScrollNumber);
 
+/* Display duration statistics and histogram of the callbacks. */
+void display_callback_stats(void);
+
 /* Display current Unix time. */
 void display_current_unix_time(void);
 
@@ -362,6 +440,9 @@ void display_function_name(UINT16 FunctionId);
 /* Display given text, followed by human time whose pointer is given as a parameter. */
 void display_human_time(UCHAR *Text, struct human_time *HumanTime);
 
+/* Display busy / idle times, load averages and periodic tasks runtime statistics of the main endless loop. */
+void display_loop_stats(void);
+
 /* Display current content of specified matrix buffer. */
 void display_matrix_buffer(UINT64 *BufferPointer);
 
@@ -473,6 +554,9 @@ void function_brightness(void);
 /* Function to ajust brightness. */
 void function_brightness_set(void);
 
+/* Function to scroll callbacks duration statistics on LED matrix. */
+void function_callback_stats(void);
+
 /* Function to ajust hourly and half-hour chimes. */
 void function_chime_set(void);
 
@@ -606,6 +690,39 @@ void ir_display_timings(void);
 \* --------------------------------------------------------------------------------------------------------------------------- */
 #endif  // REMOTE_SUPPORT
 
+/* Return the pixel width of one character of the specified font type (without the blank column that follows it). */
+UINT8 layout_char_width(UINT8 FontType, UINT8 AsciiValue);
+
+/* Initialize the text layout engine. */
+void layout_init(void);
+
+/* Return the spacing adjustment between two consecutive characters of the specified font type (see kerning tables in font.h). */
+INT8 layout_kerning(UINT8 FontType, UINT8 Left, UINT8 Right);
+
+/* Return the pixel width of the specified string when displayed with the specified font type (kerning included). */
+UINT16 layout_measure(UINT8 FontType, UCHAR *String);
+
+/* Display a string that has been laid out by layout_text(). Return the column following the last character displayed. */
+UINT8 layout_print(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 FontType, UCHAR *String, struct layout *Layout);
+
+/* Lay out a string within the specified column range, according to layout flags. */
+void layout_text(UINT8 FontType, UCHAR *String, UINT8 StartColumn, UINT8 EndColumn, UINT8 Flags, struct layout *Layout);
+
+/* Retrieve the oldest event posted to the main endless loop. */
+UINT8 loop_event_get(struct loop_event *Event);
+
+/* Post a wakeup event to the main endless loop. May be called from interrupt handlers and callbacks. */
+void loop_event_post(UINT8 Type);
+
+/* Put the processor to sleep until an event is posted to the main endless loop or until the given deadline is reached. */
+void loop_event_wait(UINT64 Deadline);
+
+/* Reset busy / idle statistics of the main endless loop. */
+void loop_stats_reset(void);
+
+/* Accumulate busy and idle times of one main loop iteration and update the load averages. */
+void loop_stats_update(UINT32 BusyUSec, UINT32 IdleUSec);
+
 /* Set color for endless loop pilot LEDs. */
 void pilot_set_color(UINT8 Color);
 
@@ -657,9 +774,21 @@ void reminder1_ring(void);
 /* Test remote control. */
 void remote_control_test(void);
 
+/* Return the number of elements currently in a ring buffer. */
+UINT16 ring_count(struct ring *Ring);
+
+/* Retrieve the oldest element of a ring buffer (consumer side). */
+UINT8 ring_get(struct ring *Ring, void *Data);
+
+/* Add an element to a ring buffer (producer side). */
+UINT8 ring_put(struct ring *Ring, const void *Data);
+
 /* Blink all defined "blinking areas" in all active windows. */
 void RGB_matrix_blink();
 
+/* Copy a matrix area of one buffer to the specified position of another buffer. */
+void RGB_matrix_blit(UINT64 *DestinationBuffer, UINT8 DestinationRow, UINT8 DestinationColumn, UINT64 *SourceBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn);
+
 /* Draw or erase a box with specified borders. */
 void RGB_matrix_box(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn, UINT8 Color, UINT8 Action);
 
@@ -672,37 +801,120 @@ void RGB_matrix_clear_pixel(UINT64 *BufferPointer, UINT8 StartRow, UINT8 StartCo
 /* Clear LED matrix display. */
 void RGB_matrix_cls(UINT64 *BufferPointer);
 
+/* Copy the pixels of the specified matrix area from one buffer to the same area of another buffer. */
+void RGB_matrix_copy_pixel(UINT64 *DestinationBuffer, UINT64 *SourceBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn);
+
 /* Initialize RGB matrix gpio's. */
 void RGB_matrix_device_init(void);
 
+/* Flag the specified matrix rows as modified since last time they have been processed. */
+void RGB_matrix_dirty(UINT8 StartRow, UINT8 EndRow);
+
 /* Display specified ASCII character using specified variable-width font type and beginning at the specified matrix position (upper left of character). */
 UINT8 RGB_matrix_display(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 Char, UINT8 FontType, UINT8 FlagMore);
 
 /* Display date and time on LED matrix. */
 void RGB_matrix_display_time(void);
 
+/* Mark the beginning of a change to FrameBuffer / ColorPlane that must not be presented half-done. */
+void RGB_matrix_draw_begin(void);
+
+/* Mark the end of a change begun with RGB_matrix_draw_begin(). */
+void RGB_matrix_draw_end(void);
+
+/* Return the color of the specified matrix pixel. */
+UINT8 RGB_matrix_get_color(UINT8 RowNumber, UINT8 ColumnNumber);
+
+/* Return the colors of the specified scan row pixel pair in legacy DisplayRGB format (low nibble: top half, high nibble: bottom half). */
+UCHAR RGB_matrix_get_nibbles(UINT8 RowNumber, UINT8 ColumnNumber);
+
+/* Merge the bitmap of a glyph in the specified buffer, one whole character row at a time. */
+void RGB_matrix_glyph_blit(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 StartColumn, const UINT8 *GlyphRow, UINT8 GlyphHeight, UINT8 GlyphWidth, UINT8 CharWidth);
+
 /* LED matrix device integrity check. */
 void RGB_matrix_integrity_check(UINT8 FlagTerminal);
 
+/* Regenerate, in the back buffer, the "wire format" of the scan rows whose FrameBuffer or ColorPlane content changed since last call. */
+UINT8 RGB_matrix_pack(void);
+
+/* Convert one scan row (top and bottom halves) of FrameBuffer and ColorPlane to its "wire format". */
+void RGB_matrix_pack_row(UINT8 RowNumber);
+
+#ifdef PIO_SCAN_SUPPORT
+/* Initialize PIO state machines and DMA channels in charge of the LED matrix scan. */
+void RGB_matrix_pio_init(void);
+
+/* Build the control word of each scan row for the PIO scan engine, given current dwell time and brightness level. */
+void RGB_matrix_pio_row_control(void);
+#endif  // PIO_SCAN_SUPPORT
+
 /* Calculate the length of the string supplied when using the font type specified. */
 UINT8 RGB_matrix_pixel_length(UINT8 FontType, UCHAR *Format, ...);
 
 /* "Printf" specified string, using specified font type and beginning at the specified pixel row and specified pixel column (upper left of character). */
 UINT8 RGB_matrix_printf(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 FontType, UCHAR *Format, ...);
 
-/* Scroll the rows specified in the scroll structure for the target window one pixel to the left while managing the scroll ASCII buffer. */
+/* Pack FrameBuffer changes in the back buffer and request the scan to swap front and back buffers at the beginning of next frame. */
+void RGB_matrix_present(void);
+
+/* Scroll the rows specified in the scroll structure for the target window one pixel to the left while managing the scroll glyph strip. */
 void RGB_matrix_scroll(UINT8 ScrollNumber);
 
 /* Set matrix display color for the specified LED matrix area. */
 void RGB_matrix_set_color(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn, UINT8 Color);
 
+#ifdef BCM_SUPPORT
+/* Set 24-bit matrix display color (0x00RRGGBB) for the specified LED matrix area. */
+void RGB_matrix_set_color_rgb(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn, UINT32 Color);
+#endif  // BCM_SUPPORT
+
+/* Set the colors of the specified scan row pixel pair from legacy DisplayRGB format (low nibble: top half, high nibble: bottom half). */
+void RGB_matrix_set_nibbles(UINT8 RowNumber, UINT8 ColumnNumber, UCHAR Nibbles);
+
 /* Turn On the pixels in the specified LED matrix area of the specified LED matrix buffer. */
 void RGB_matrix_set_pixel(UINT64 *BufferPointer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn);
 
+/* Apply scan rate and per-row on-time trim from flash configuration to the matrix scan. */
+void RGB_matrix_set_scan_rate(void);
+
+/* Return the bitmask of a span of columns in a matrix row. */
+UINT64 RGB_matrix_span_mask(UINT8 StartColumn, UINT8 EndColumn);
+
+/* Toggle the pixels in the specified matrix area. */
+void RGB_matrix_toggle_pixel(UINT64 *BufferPointer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn);
+
 /* Scan the LED matrix rows / columns. */
 void RGB_matrix_update(UINT64 *FrameBuffer);
 
-void RGB_matrix_write_data(UINT8 high_data, UINT8 low_data, UCHAR DisplayRGBCount);
+/* Shift out the "wire format" of the specified scan row to the LED matrix. */
+void RGB_matrix_write_data(UINT8 RowNumber);
+
+/* Scroll compositor: advance every active scroll region whose owner window is currently displayed. */
+UINT8 scroll_compose(void);
+
+/* Take a free slot from the static scroll pool. */
+UINT8 scroll_pool_acquire(void);
+
+/* Initialize the static scroll pool. */
+void scroll_pool_init(void);
+
+/* Give back a slot to the static scroll pool. */
+void scroll_pool_release(UINT8 ScrollNumber);
+
+/* Clip a scroll region to the specified window (inside its box border if the border is kept on the matrix). */
+UINT8 scroll_region(UINT8 WindowNumber, UINT8 *StartRow, UINT8 *EndRow, UINT8 *StartColumn, UINT8 *EndColumn);
+
+/* Advance the specified active scroll by the number of pixels due at its speed for one scroll tick. */
+UINT8 scroll_step(UINT8 ScrollNumber);
+
+/* Render one character of the specified font type to pixel columns. Return the number of pixel columns of the character. */
+UINT8 scroll_strip_glyph(UINT8 AsciiValue, UINT8 FontType, UINT8 FlagMore, UINT16 *Column);
+
+/* Return the number of free characters in the text ring of the specified active scroll. */
+UINT16 scroll_text_free(UINT8 ScrollNumber);
+
+/* Append a string to the text ring of the specified active scroll. */
+UINT8 scroll_text_put(UINT8 ScrollNumber, UCHAR *String);
 
 /* Manage ambient light history and set automatic brightness if the configuration is set for auto-brightness. */
 void set_auto_brightness(void);
@@ -710,6 +922,45 @@ void set_auto_brightness(void);
 /* Restart the RGB Matrix Firmware by software reset (watchdog). */
 void software_reset(void);
 
+/* Periodic task: execute the auto-scrolls flagged by the one-second callback. */
+void task_auto_scroll(void);
+
+/* Periodic task: 10-seconds debug information (developer version only). */
+void task_debug_10sec(void);
+
+/* Periodic task: 30-seconds alarms and calendar events debug information. */
+void task_debug_30sec(void);
+
+/* Periodic task: save flash configuration if it has been changed. */
+void task_flash_check(void);
+
+/* Periodic task: one-minute housekeeping and heartbeat. */
+void task_heartbeat(void);
+
+/* Register the periodic tasks run by the main endless loop scheduler. */
+void task_init(void);
+
+/* Return the earliest deadline among the registered periodic tasks. */
+UINT64 task_next_deadline(void);
+
+/* Periodic task: handle network time protocol (NTP) synchronization when it is due. */
+void task_ntp(void);
+
+/* Periodic task: blink endless loop pilot and keep track of time spent in the one-second callback. */
+void task_pilot(void);
+
+/* Register a periodic task. Return the task number, or MAX_TASKS if the task table is full. */
+UINT8 task_register(UCHAR *Name, void (*Pointer)(void), UINT32 PeriodUSec, UINT8 Priority, UINT32 BudgetUSec);
+
+/* Run the most urgent periodic task whose deadline has been reached. Return FLAG_OFF if no task was due. */
+UINT8 task_run_next(void);
+
+/* Reset runtime statistics of all registered periodic tasks. */
+void task_stats_reset(void);
+
+/* Periodic task: tell the 1000 msec callback that the main endless loop is still alive. */
+void task_watchdog(void);
+
 /* Terminal submenu for alarm setup. */
 void term_alarm_setup(void);
 
@@ -746,6 +997,9 @@ void term_network_setup(void);
 /* Terminal submenu for reminders of type 1 setup. */
 void term_reminder1_setup(void);
 
+/* Terminal submenu for matrix scan rate setup. */
+void term_scan_rate_setup(void);
+
 /* Terminal submenu for <setup> selections. */
 void term_setup(void);
 
@@ -764,6 +1018,27 @@ void term_tools(void);
 /* Test chunks of code. */
 void test_zone(UINT TestNumber);
 
+/* Compose the pixels and the color planes of the specified matrix row as they must be displayed, given the transitions in progress. */
+UINT64 transition_compose(UINT8 RowNumber, UINT64 *Plane, UINT64 *OverrideMask);
+
+/* Initialize the window transition engine. */
+void transition_init(void);
+
+/* Compute the masks of the current keyframe of the specified transition in progress. */
+void transition_keyframe(struct transition *Slot);
+
+/* Return the pixels of the specified matrix row as they must be displayed, given the transitions in progress, and their color planes. */
+UINT64 transition_row(UINT8 RowNumber, UINT64 *Plane, UINT64 *OverrideMask);
+
+/* Start the transition of the specified window. */
+void transition_start(UINT8 WindowNumber, UINT8 Effect, UINT8 Box[][4], UINT8 BoxCount);
+
+/* Move each transition in progress to its next keyframe when it is due. Return FLAG_ON if the matrix must be updated. */
+UINT8 transition_tick(void);
+
+/* Update TransitionRowMask with the matrix rows covered by the transitions in progress. */
+void transition_update_mask(void);
+
 /* Send a string to terminal emulator. */
 void uart_send(UINT LineNumber, const UCHAR *FunctionName, UCHAR *Format, ...);
 
@@ -812,6 +1087,9 @@ void win_part_cls(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow);
 /* Print data in the specified window. */
 UINT8 win_printf(UINT8 WindowNumber, UINT8 StartRow, UINT8 StartColumn, UINT8 FontType, UCHAR *Format, ...);
 
+/* Display text aligned within the columns of the specified window, according to layout flags. */
+UINT8 win_printf_layout(UINT8 WindowNumber, UINT8 StartRow, UINT8 Flags, UINT8 FontType, UCHAR *Format, ...);
+
 /* Scroll the text in the specified window, on the specified line. Return ScrollNumber that has been assigned. */
 UINT8 win_scroll(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow, UINT16 ScrollTimes, UINT8 ScrollSpeed, UINT8 FontType, UCHAR *Format, ...);
 
@@ -833,12 +1111,12 @@ void win_set_color(UINT8 WindowNumber, UINT8 InsideColor, UINT8 BoxColor);
 /* ============================================================================================================================================================= *\
                                                              Global variables declaration / definition.
 \* ============================================================================================================================================================= */
-UCHAR DisplayRGB[HALF_ROWS][MAX_COLUMNS];
 UCHAR PicoUniqueId[40];                       // Pico Unique ID read from flash IC.
 UCHAR ScrollAsciiBuffer[3][1024];             // scroll ASCII buffer. 3 lines of 1024 characters each.
 
 UINT8  AutoScrollBitMask;                     // BitMask representing auto-scrolls that must be scrolled by main system loop.
-UINT8  ButtonBuffer[BUTTON_BUFFER_SIZE];      // buffer for buttons (local or remote) that have been pressed and not yet processed.
+volatile UINT8 ButtonBuffer[BUTTON_BUFFER_SIZE];  // buffer for buttons (local or remote) that have been pressed and not yet processed.
+UINT8  ButtonRingStorage[BUTTON_RING_SIZE];   // storage of ButtonRing.
 UINT8  FlagEndlessLoop = FLAG_OFF;            // flag indicating that we are in the context of the main system while loop.
 UINT8  FlagFrameBufferBusy;                   // flag indicating that FrameBuffer is currently being updated.
 UINT8 *FlashData;                             // pointer to an allocated RAM memory space used for flash operations.
@@ -847,12 +1125,19 @@ UINT8  IrCounter = 0;                         // counter of remote control keyst
 UINT8  OneSecondPointer;                      // pointer to the next slot in the circular buffer.
 UINT8  PicoType;                              // contain type of microcontroller used (TYPE_PICO or TYPE_PICOW).
 UINT8  RowScan = 0;                           // current matrix row being scanned.
+UINT8  TaskCount;                             // number of periodic tasks registered in Task[].
+volatile UINT8 DrawNesting   = 0;             // number of nested drawing functions in progress on core 0 (see RGB_matrix_draw_begin()).
+volatile UINT8 FlagPacking   = FLAG_OFF;      // flag indicating that RGB_matrix_present() is packing FrameBuffer into the back buffer.
+volatile UINT8 FlagWireStale = FLAG_OFF;      // flag indicating that the back buffer must be refreshed from the front buffer before packing.
+volatile UINT8 FlagWireSwap  = FLAG_OFF;      // flag indicating that a front / back buffer swap is pending until the beginning of next frame.
+volatile UINT8 WireFront     = 0;             // WireBuffer currently being displayed (the other one being the back buffer).
 UINT8  WinTop;                                // currently active window for top of matrix.
 UINT8  WinMid;                                // currently active window for middle of matrix.
 UINT8  WinBot;                                // currently active window for bottom of matrix.
 
 UINT16 AlarmBitMask;                          // bitmask of currently triggered alarms (when not already shut off by user).
 UINT16 AmbientLight[BRIGHTNESS_HYSTERESIS_SECONDS];  // ambient light readings for the last seconds.
+UINT16 RowDwell[HALF_ROWS];                   // dwell time of each scan row in microseconds, including its on-time trim.
 UINT16 AutoScrollScheduleMask;                // bitmask of the auto-scrolls to be currently processed.
 UINT16 AverageAmbientLight;                   // average ambient light value for the last "hysteresis" number of seconds.
 UINT16 FunctionHiLimit;                       // one more than the last defined function.
@@ -860,23 +1145,51 @@ UINT16 ServiceLightTimer;                     // count-down timer for service li
 UINT16 WatchdogCheck;                         // number being automatically incremented every second inside main system endless loop.
 UINT16 WatchdogMiss;
 
+volatile UINT32 DirtyRowMask;                 // bitmask of matrix rows modified in FrameBuffer or ColorPlane since last packing (bit 0 = row 0).
+volatile UINT32 TransitionRowMask;            // bitmask of matrix rows covered by a window transition in progress (bit 0 = row 0).
+
 INT64 Dum1Int64;
 INT64 OneSecondInterval[MAX_ONE_SECOND_INTERVALS];
 
+UINT64  CallbackStatStart;                    // time when callback statistics were last reset (power-up if never reset).
 UINT64  DebugBitMask;                         // bitmask identifying logical sections of code to debug through external monitor.
 UINT64  EventBitMask;                         // bitmask representing the calendar events that are triggered.
+UINT64  LoopStatStart;                        // time when main loop statistics were last reset (power-up if never reset).
 UINT64  Reminder1BitMask;                     // bitmask representing the reminders of type 1 that are currently active (their span period is not over).
 UINT64  TermModeTimer = 0ll;                  // timer when last time we exited from terminal menu.
 UINT64  BlinkBuffer[MAX_ROWS];                // temporary bitmask buffer of FrameBuffer LED positions being blinked.
 UINT64  CheckBuffer[MAX_ROWS];                // bitmask of active LED blinking area.
+UINT64  ColorPlane[3][MAX_ROWS];              // red, green and blue bit-planes of matrix color, one bit per LED as in FrameBuffer (see PLANE_RED).
 UINT64  FrameBuffer[MAX_ROWS];                // RGB matrix LED display framebuffer.
 
+UINT8   WireBuffer[2][WIRE_PLANES * HALF_ROWS][MAX_COLUMNS] __attribute__((aligned(4)));  // front / back "wire format" of each scan row (of each bitplane): one byte per column, ready to be shifted out.
+
+#ifdef BCM_SUPPORT
+UINT32  PixelColor[MAX_ROWS][MAX_COLUMNS];    // 24-bit color of each LED (0x00RRGGBB), displayed with BCM_DEPTH bits per channel.
+#endif  // BCM_SUPPORT
+
 absolute_time_t AbsoluteEntryTime;            // time stamp of an entry point (in a callback function).
 absolute_time_t AbsoluteExitTime;             // time stamp of an exit point  (in a callback function).
 
+#ifdef PIO_SCAN_SUPPORT
+/* PIO / DMA matrix scan engine global variables. */
+PIO    PioScan = pio0;                        // PIO block used for matrix scan (Pico W's CYW43 driver uses the other one).
+UINT   PioDataSm;                             // state machine shifting out column data.
+UINT   PioRowSm;                              // state machine selecting / latching scan rows.
+UINT   DmaDataChannel;                        // DMA channel feeding data state machine.
+UINT   DmaDataReload;                         // DMA channel restarting DmaDataChannel at the beginning of each frame.
+UINT   DmaRowChannel;                         // DMA channel feeding row state machine.
+UINT   DmaRowReload;                          // DMA channel restarting DmaRowChannel at the beginning of each frame.
+UINT32 PioRowControl[WIRE_PLANES * HALF_ROWS];  // one control word per scan row of each bitplane (row select lines, "on" and "off" time).
+UINT8  *PioPlaneAddress = &WireBuffer[0][0][0];  // read address reloaded in DmaDataChannel at the beginning of each frame.
+UINT32 *PioRowAddress   = PioRowControl;      // read address reloaded in DmaRowChannel at the beginning of each frame.
+#endif  // PIO_SCAN_SUPPORT
+
 #ifdef REMOTE_SUPPORT
 /* Infrared-related global variables. */
 volatile UINT8 IrBuffer[IR_BUFFER_SIZE];      // buffer for IR commands ("buttons") received from remote control.
+UINT8  IrRingStorage[IR_RING_SIZE];           // storage of IrRing.
+struct ring IrRing = RING_INITIALIZER(IrRingStorage, IR_RING_SIZE);  // remote control buttons decoded and waiting for IrBuffer[0] to be free.
 UINT8  IrIndicator;                           // second count-down for infrared indicator on RGB matrix.
 UINT16 IrStepCount;                           // number of "logic level changes" received from IR remote control in current data stream.
 UINT64 IrInitialValue[MAX_IR_READINGS];       // initial timer value when receiving edge change from remote control.
@@ -890,20 +1203,47 @@ UINT64 DataBuffer;                            // variable to hold the command re
 
 struct active_alarm ActiveAlarm[MAX_ALARMS];              // dynamic parameters for currently active alarms.
 struct active_reminder1 ActiveReminder1[MAX_REMINDERS1];  // reminders of type 1 currently active.
-struct active_scroll *ActiveScroll[MAX_ACTIVE_SCROLL];    // pointers to struct active_scroll to be malloc'ed
+struct active_scroll *ActiveScroll[MAX_ACTIVE_SCROLL];    // pointers to the slots of ScrollPool currently in use (NULL when free).
+struct callback_stat CallbackStat[MAX_CALLBACK_STATS];    // duration statistics of matrix scan, 50 msec, 1000 msec and scroll callbacks.
+struct core_message CoreChannelStorage[MAX_CORE_CHANNEL]; // storage of CoreChannel.
 struct flash_config1 FlashConfig1;                        // RGB matrix main configuration data.
 struct flash_config2 FlashConfig2;                        // reminders configuration saved to flash.
 struct function Function[300];                            // functions to execute in response to IR.
 struct human_time CurrentTime;                            // human time structure containing the time being displayed on RGB Matrix.
 struct human_time StartTime;                              // time the RGB Matrix was last powered On.
+struct loop_stat LoopStat;                                // busy / idle statistics of the main endless loop.
 struct pwm Pwm[2];                                        // PWM structures for matrix brightness and passive buzzer (not implemented yet).
-struct queue_active_sound QueueActiveSound;               // circular buffer to hold active buzzer sounds to be processed.
+struct loop_event LoopEventStorage[MAX_LOOP_EVENTS];      // storage of QueueLoopEvent.
+struct queue_active_sound_element ActiveSoundStorage[MAX_ACTIVE_SOUND_QUEUE];  // storage of QueueActiveSound.
+struct ring ButtonRing       = RING_INITIALIZER(ButtonRingStorage,  BUTTON_RING_SIZE);        // local buttons pressed and waiting for ButtonBuffer[0] to be free.
+struct ring CoreChannel      = RING_INITIALIZER(CoreChannelStorage, MAX_CORE_CHANNEL);        // messages sent from core 0 to core 1.
+struct ring QueueActiveSound = RING_INITIALIZER(ActiveSoundStorage, MAX_ACTIVE_SOUND_QUEUE);  // active buzzer sounds to be processed.
+struct ring QueueLoopEvent   = RING_INITIALIZER(LoopEventStorage,   MAX_LOOP_EVENTS);         // events posted to the main endless loop.
+struct scroll_pool ScrollPool;                            // static storage of active scrolls (the scroll engine never allocates memory).
+struct layout_cache LayoutCache[LAYOUT_CACHE_ENTRIES];    // texts most recently laid out (measured, aligned and cut) by layout_text().
+struct task Task[MAX_TASKS];                              // periodic tasks run by the main endless loop scheduler.
+struct transition Transition[MAX_TRANSITIONS];            // window transitions in progress (animated on core 1 by the scroll tick).
 struct window Window[MAX_WINDOWS];                        // windows definition and parameters.
 
-struct repeating_timer Handle1MSecTimer;
+struct repeating_timer HandleScanTimer;
+struct repeating_timer HandleScrollTimer;
 struct repeating_timer Handle50MSecTimer;
 struct repeating_timer Handle1000MSecTimer;
 
+alarm_pool_t *Core1AlarmPool;                             // alarm pool whose interrupts are serviced by core 1 (matrix scan and 50 msec callback).
+spin_lock_t  *CallbackStatLock;                           // hardware spin lock protecting CallbackStat, updated by callbacks running on both cores.
+spin_lock_t  *DirtyLock;                                  // hardware spin lock protecting DirtyRowMask, flagged from both cores and cleared by RGB_matrix_pack(), and DrawNesting / FlagPacking.
+spin_lock_t  *LayoutLock;                                 // hardware spin lock protecting LayoutCache, used by text display on both cores.
+spin_lock_t  *LoopEventLock;                              // hardware spin lock protecting QueueLoopEvent, which is fed from both cores.
+spin_lock_t  *ScrollPoolLock;                             // hardware spin lock protecting ScrollPool free slots, released from both cores.
+spin_lock_t  *ScrollTextLock;                             // hardware spin lock serializing win_scroll() calls appending to the text rings of active scrolls.
+spin_lock_t  *TransitionLock;                             // hardware spin lock protecting Transition[], started on core 0 and animated on core 1.
+
+UINT32 LayoutCacheClock;                                  // incremented on each layout cache lookup (used to find least recently used entry).
+UINT32 LayoutCacheHits;                                   // number of texts found already laid out in LayoutCache.
+UINT32 LayoutCacheMisses;                                 // number of texts that had to be measured.
+
+
 extern struct ntp_data NTPData;
 /// critical_section_t ThreadLock;
 
@@ -958,45 +1298,34 @@ UCHAR ButtonName[IR_HI_LIMIT][21] =
 
 
 
+#ifndef HOST_SIMULATOR
 /* ============================================================================================================================================================= *\
                                                                       Main program entry point.
 \* ============================================================================================================================================================= */
 int main(void)
 {
-  UCHAR String[128];
-
-  INT64 DeltaTime;
+  INT16 DataInput;        // keyboard scan during main endless loop.
 
   UINT8 ColumnNumber;
-  UINT8 DataInput;        // keyboard scan during main endless loop.
-  UINT8 Dum1UInt8;
   UINT8 Loop1UInt8;
   UINT8 RowNumber;
 
   UINT16 Delay;
   UINT16 Dum1UInt16;
-  UINT16 FunctionNumber;
   UINT16 PwmLevel;
   UINT16 Loop1UInt16;
-  UINT16 Loop2UInt16;
+
+  UINT32 LoopIdleUSec;
 
   UINT64 CurrentTimer;
-  UINT64 IrTimer;
-  UINT64 LastTimer1Sec;
-  UINT64 LastTimer2Sec;
-  UINT64 LastTimer5Sec;
-  UINT64 LastTimer10Sec;
-  UINT64 LastTimer30Sec;
-  UINT64 LastTimer1Min;
+  UINT64 Deadline;
+  UINT64 IdleTimer;
+  UINT64 LoopTimer;
   UINT64 TempBuffer[MAX_ROWS];
-  UINT64 WatchdogTimer;
-
-  time_t UnixTime;
 
   Framebuffer = (UINT8 *)FrameBuffer;  // original 8bits framebuffer.
 
-  struct human_time HumanTime;
-  struct tm TempTime;
+  struct loop_event LoopEvent;
 
 
 
@@ -1029,6 +1358,7 @@ int main(void)
   // DebugBitMask += DEBUG_SOUND_QUEUE; // debug queue engines.
   // DebugBitMask += DEBUG_STARTUP;     // debug startup sequence.
   // DebugBitMask += DEBUG_SUMMER_TIME; // debug summer-time related logic.
+  // DebugBitMask += DEBUG_TASK;        // debug main loop periodic tasks.
   // DebugBitMask += DEBUG_TEST;        // debug test section.
   // DebugBitMask += DEBUG_WATCHDOG;    // debug watchdog behavior.
   // DebugBitMask += DEBUG_WIFI;        // debug WiFi communications.
@@ -1056,6 +1386,12 @@ int main(void)
   /* Initialize GPIOs. */
   stdio_init_all();
   RGB_matrix_device_init();  // NOTE: brightness is set to 0 % during power-up sequence.
+
+  /* Matrix rows are flagged as modified from both cores (see RGB_matrix_dirty()), this must be ready before anything is drawn. */
+  DirtyLock = spin_lock_init(spin_lock_claim_unused(true));
+
+  /* Callbacks of both cores update their duration statistics (see callback_stats_update()), this must be ready before the first timer is started. */
+  CallbackStatLock = spin_lock_init(spin_lock_claim_unused(true));
 #if 0
   /* This part to be uncommented if it is important to get the full log of startup sequence. */
   if (DebugBitMask & DEBUG_STARTUP)
@@ -1069,15 +1405,27 @@ int main(void)
 
 
   /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                             Start 1 msec callback in charge of LED matrix scan.
+                              Start Pico's core 1 (second core), which begins with the callback in charge of LED matrix scan.
   \* --------------------------------------------------------------------------------------------------------------------------- */
   if (DebugBitMask & DEBUG_STARTUP)
   {
-    printf("[%4u]   Before launching 1-msec callback.\r", __LINE__);
+    printf("[%4u]   Before starting second core (matrix scan).\r", __LINE__);
     sleep_ms(1000);
   }
 
-  add_repeating_timer_ms(-1, callback_1msec_timer, NULL, &Handle1MSecTimer);
+  /* Flash configuration has not been read yet, scan will begin with default scan rate. */
+  RGB_matrix_set_scan_rate();
+
+#ifdef PIO_SCAN_SUPPORT
+  /* Hand over matrix GPIOs to PIO state machines, now that RGB_matrix_device_init() has setup the matrix driver ICs. */
+  RGB_matrix_pio_init();
+#endif  // PIO_SCAN_SUPPORT
+
+  /* Text layout engine is used by the first messages displayed on the matrix, well before windows are initialized. */
+  layout_init();
+
+  /* Core 1 owns matrix refresh, scrolling and active buzzer. Its next startup steps are given through the SIO FIFO below. */
+  multicore_launch_core1(core1_main);
 
 
 
@@ -1142,13 +1490,11 @@ int main(void)
     sleep_ms(1000);  // slow down startup sequence if required for debugging purposes.
   }
 
-  for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ACTIVE_SOUND_QUEUE; ++Loop1UInt16)
-  {
-    QueueActiveSound.Element[Loop1UInt16].MSec        = 0;
-    QueueActiveSound.Element[Loop1UInt16].RepeatCount = 0;
-  }
-  QueueActiveSound.Head = 0;
-  QueueActiveSound.Tail = 0;
+  /* NOTE: Sound queue, as all other ring buffers, is initialized statically (see RING_INITIALIZER()), so that it may be used
+           by either core at any time during startup. Sounds requested on core 0 go through the core-to-core channel. */
+
+  /* Main loop events are posted from both cores (buttons and infrared on core 1, terminal on core 0). */
+  LoopEventLock = spin_lock_init(spin_lock_claim_unused(true));
 
 
 
@@ -1252,6 +1598,7 @@ int main(void)
     BlinkBuffer[Loop1UInt8] = 0ll;
     CheckBuffer[Loop1UInt8] = 0xFFFFFFFFFFFFFFFFll;
   }
+  RGB_matrix_dirty(0, MAX_ROWS - 1);
 
 
 
@@ -1395,7 +1742,8 @@ int main(void)
     sleep_ms(1000);  // slow down startup sequence if required for debugging purposes.
   }
 
-  add_repeating_timer_ms(-50, callback_50msec_timer, NULL, &Handle50MSecTimer);
+  /* The 50 msec callback runs on core 1, along with matrix scan. */
+  multicore_fifo_push_blocking(CORE1_START_50MSEC);
 
 
 
@@ -1413,6 +1761,13 @@ int main(void)
 
 
 
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                    Wake up main endless loop when something is received from external terminal.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  stdio_set_chars_available_callback(callback_terminal_input, NULL);
+
+
+
   /* --------------------------------------------------------------------------------------------------------------------------- *\
                                         Display time and date for the first time on LED matrix.
   \* --------------------------------------------------------------------------------------------------------------------------- */
@@ -1454,6 +1809,9 @@ int main(void)
   flash_read_config1();
   flash_read_config2();
 
+  /* Apply matrix scan rate from flash configuration. */
+  RGB_matrix_set_scan_rate();
+
   /*** Add support for automatic flash configuration update from version to version. ***/
   sprintf(FlashConfig1.Version, "%s", FIRMWARE_VERSION);
   sprintf(FlashConfig2.Version, "%s", FIRMWARE_VERSION);
@@ -1619,6 +1977,10 @@ int main(void)
             uart_send(__LINE__, __func__, "Debug summer-time related logic.\r");
           break;
 
+          case DEBUG_TASK:
+            uart_send(__LINE__, __func__, "Debug main loop periodic tasks.\r");
+          break;
+
           case DEBUG_TEST:
             uart_send(__LINE__, __func__, "Debug test zone.\r");
           break;
@@ -1792,17 +2154,17 @@ int main(void)
 
 
   /* --------------------------------------------------------------------------------------------------------------------------- *\
-              Start the thread to run on Pico's core 1 (second Pico's core) to read the infrared data stream received
-             from remote control without interference from callback functions and other potential interrupts on core 0.
+              Let Pico's core 1 (second Pico's core) read the infrared data stream received from remote control and
+                 monitor local buttons without interference from callback functions and other interrupts on core 0.
   \* --------------------------------------------------------------------------------------------------------------------------- */
   if (DebugBitMask & DEBUG_STARTUP)
   {
-    printf("[%4u]   Before starting second core.\r", __LINE__);
+    printf("[%4u]   Before enabling inputs on second core.\r", __LINE__);
     debug_pixel(31, 29, BLUE);
     sleep_ms(1000);  // slow down startup sequence if required for debugging purposes.
   }
 
-  multicore_launch_core1(core1_main);
+  multicore_fifo_push_blocking(CORE1_START_INPUTS);
 
 
 
@@ -1822,14 +2184,8 @@ int main(void)
 
 
 
-  /* Initialize all timestep timers on entry. */
-  LastTimer1Sec  = time_us_64();
-  LastTimer2Sec  = LastTimer1Sec;
-  LastTimer5Sec  = LastTimer1Sec;
-  LastTimer10Sec = LastTimer1Sec;
-  LastTimer30Sec = LastTimer1Sec;
-  LastTimer1Min  = LastTimer1Sec;
-  IrTimer        = LastTimer1Sec;
+  /* Register periodic tasks of the main endless loop. */
+  task_init();
 
 
   /* Scroll Firmware Version number when starting Pico-RGB-Matrix. */
@@ -1837,7 +2193,7 @@ int main(void)
 
 
 #ifdef NO_SOUND
-  win_scroll(WIN_DATE, 201, 201, 1, 1, FONT_5x7, "WARNING - This Firmware has been built WITH ALL SOUNDS DISABLED");
+  win_scroll(WIN_DATE, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "WARNING - This Firmware has been built WITH ALL SOUNDS DISABLED");
 #endif  // NO_SOUND
 
 
@@ -1855,9 +2211,11 @@ int main(void)
   \* --------------------------------------------------------------------------------------------------------------------------- */
   if (DebugBitMask & DEBUG_FLOW) printf("Entering main endless loop\r");
   FlagEndlessLoop = FLAG_ON;
+  loop_stats_reset();
   while (1)
   {
     CurrentTimer = time_us_64();
+    LoopTimer    = CurrentTimer;  // beginning of this iteration for busy / idle accounting.
 
 
 
@@ -1872,10 +2230,30 @@ int main(void)
 
 
 
+    /* Flush the wakeup events posted by interrupt handlers and callbacks while the endless loop was waiting. */
+    /* NOTE: Events only wake up the endless loop, they carry no data. Each iteration checks the external terminal, ButtonBuffer[0]
+             and IrBuffer[0] below, since functions called from process_button() also read these buffers directly.
+             Buttons pressed while ButtonBuffer[0] / IrBuffer[0] are not yet free wait in ButtonRing / IrRing (see button_deliver()). */
+    while (loop_event_get(&LoopEvent) == FLAG_ON)
+    {
+      if (DebugBitMask & DEBUG_BUTTON) uart_send(__LINE__, __func__, "Main loop woken up by event type %u\r", LoopEvent.Type);
+    }
+
+
     /* If user pressed <Enter> on external terminal, branch to term_menu() function. */
     /* NOTE: Endless loop is suspended while user navigate the terminal menus / submenus. */
-    DataInput = getchar_timeout_us(50000l);
-    if (DataInput == 0x0D) term_menu();
+    do
+    {
+      DataInput = getchar_timeout_us(0);
+    } while ((DataInput != PICO_ERROR_TIMEOUT) && (DataInput != 0x0D));
+
+    if (DataInput == 0x0D)
+    {
+      term_menu();
+
+      /* Time spent in terminal menus is neither busy nor idle time of the endless loop. */
+      LoopTimer = time_us_64();
+    }
 
 
 
@@ -1953,481 +2331,121 @@ int main(void)
 
 
 
-#ifdef WATCHDOG_SUPPORT
     /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                             Watchdog timer.
+                      Run the most urgent periodic task that is due (see task_init() for the list of periodic tasks).
     \* --------------------------------------------------------------------------------------------------------------------------- */
-    if ((CurrentTimer - WatchdogTimer) > 999900ll)
-    {
-      WatchdogTimer = CurrentTimer;
+    /* NOTE: Only one task is run per iteration, so that buttons, remote control and terminal are handled between two tasks. */
+    task_run_next();
 
-      /* NOTE: Watchdog timer has been set slightly faster than one second. This is to make sure that the WatchdogCheck variable
-               will have been incremented when the callback tests its value and prevent a miss. In fact, one miss is not really
-               important and everything would return to normal within the next few cycles. The idea of making it a little faster
-               is to prevent a yellow LED that would turn On for a few seconds on the display if there is a miss. */
-      ++WatchdogCheck;
-    }
-#endif  // WATCHDOG_SUPPORT
 
 
     /* --------------------------------------------------------------------------------------------------------------------------- *\
-                    1-second timestep and schedule mark. Put here functions that we want to execute every second.
+                                Sleep until an event is posted or until the next periodic task deadline is reached.
     \* --------------------------------------------------------------------------------------------------------------------------- */
-    if ((CurrentTimer - LastTimer1Sec) > 1000000ll)
-    {
-      LastTimer1Sec = CurrentTimer;
+    /* NOTE: If another task is already due, loop_event_wait() returns immediately. */
+    Deadline = task_next_deadline();
 
-      /// debug_pixel(31, CurrentTimer % 63, BLUE);  ///
+    IdleTimer = time_us_64();
+    loop_event_wait(Deadline);
 
-      /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                  Manage endless loop pixel indicators pilot.
-      \* --------------------------------------------------------------------------------------------------------------------------- */
-      /* Blinking pixels to indicate that endless loop is still running. */
-      pilot_set_color(CYAN);
-      pilot_toggle();
+    /* Busy / idle accounting of this iteration. */
+    LoopIdleUSec = (UINT32)(time_us_64() - IdleTimer);
+    loop_stats_update((UINT32)(IdleTimer - LoopTimer), LoopIdleUSec);
+  }
 
+	return 0;
+}
+#endif  // HOST_SIMULATOR
 
-#ifdef NTP_SUPPORT
-      /* --------------------------------------------------------------------------------------------------------------------------- *\
-                              Manage color of the two "double-dots time separator" to indicate network health.
-      \* --------------------------------------------------------------------------------------------------------------------------- */
-      /* Indicate Wi-Fi network health with double dots time separator color. */
-      if (NTPData.FlagNTPHistory == FLAG_ON)  double_dots_set_color(GREEN);
-      if (NTPData.FlagNTPHistory == FLAG_OFF) double_dots_set_color(RED);
-#endif  // NTP_SUPPORT
 
 
-      /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                        Keep track of time spent in the one-second callback routine.
-      \* --------------------------------------------------------------------------------------------------------------------------- */
-      if (is_nil_time(AbsoluteExitTime) == false)
-      {
-        Dum1Int64 = absolute_time_diff_us(AbsoluteEntryTime, AbsoluteExitTime);
-        OneSecondInterval[OneSecondPointer] = Dum1Int64;
-        ++OneSecondPointer;
-        if (OneSecondPointer >= MAX_ONE_SECOND_INTERVALS) OneSecondPointer = 0;
-        AbsoluteEntryTime = nil_time;
-        AbsoluteExitTime  = nil_time;
-      }
 
+/* $TITLE=alarm_check() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                                   Check if some alarms must be triggered.
+\* ============================================================================================================================================================= */
+void alarm_check(void)
+{
+#ifdef RELEASE_VERSION
+  UINT8 FlagLocalDebug = FLAG_OFF;  // should be OFF all times
+#else  // RELEASE_VERSION
+  UINT8 FlagLocalDebug = FLAG_OFF;
+#endif  // RELEASE_VERSION
 
+  UCHAR String[31];
 
-      /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                Check if it is time to execute an auto-scroll now.
-      \* --------------------------------------------------------------------------------------------------------------------------- */
-      for (Loop1UInt16 = 0; Loop1UInt16 < MAX_AUTO_SCROLLS; ++Loop1UInt16)
-      {
-        /// uart_send(__LINE__, __func__, "Checking auto-scroll number %u\r", Loop1UInt16);
-        if (AutoScrollBitMask & (0x01 << Loop1UInt16))
-        {
-          /// uart_send(__LINE__, __func__, "Auto-scroll number %u flagged to be executed...\r", Loop1UInt16);
-          /* It is time to execute this auto-scroll. */
-          for (Loop2UInt16 = 0; Loop2UInt16 < MAX_ITEMS; ++Loop2UInt16)
-          {
-            /// uart_send(__LINE__, __func__, "Validating item %2u   FunctionId: %3u\r", Loop2UInt16, FlashConfig1.AutoScroll[Loop1UInt16].FunctionId[Loop2UInt16]);
-            if (FlashConfig1.AutoScroll[Loop1UInt16].FunctionId[Loop2UInt16] != 0)
-            {
-              /* This function ID is a valid one in this auto-scroll, execute it. */
-              FunctionNumber = get_function_number(FlashConfig1.AutoScroll[Loop1UInt16].FunctionId[Loop2UInt16], String);
-              if (FunctionNumber != MAX_FUNCTIONS)
-              {
-                /// if (DebugBitMask & DEBUG_SCROLL)
-                ///   uart_send(__LINE__, __func__, "Executing item  %2u   Function ID: %3u   Function number: %3u   FunctionName: %s   pointer: %p\r", Loop2UInt16, FlashConfig1.AutoScroll[Loop1UInt16].FunctionId[Loop2UInt16], FunctionNumber, Function[FunctionNumber].Name, Function[FunctionNumber].Pointer);
-                Function[FunctionNumber].Pointer();
-              }
-            }
-          }
-        }
-        /* Reset this function in the bitmask once this cycle is over. */
-        AutoScrollBitMask &= ~(0x01 << Loop1UInt16);
-      }
-    }
+  UINT8 TotalActiveAlarms;
 
+  UINT16 Loop1UInt16;
 
 
-    /* --------------------------------------------------------------------------------------------------------------------------- *\
-                    2-seconds timestep and schedule mark. Put here functions that we want to execute every 2 seconds.
-    \* --------------------------------------------------------------------------------------------------------------------------- */
-    if ((CurrentTimer - LastTimer2Sec) > 2000000ll)
-    {
-      LastTimer2Sec = CurrentTimer;
-    }
+  // if (FlagLocalDebug) printf("Entering alarm_check()\r");
 
+  /* Initialize total number of new active alarms. */
+  TotalActiveAlarms = 0;
 
 
-    /* --------------------------------------------------------------------------------------------------------------------------- *\
-                    5-seconds timestep and schedule mark. Put here functions that we want to execute every 5 seconds.
-    \* --------------------------------------------------------------------------------------------------------------------------- */
-    if ((CurrentTimer - LastTimer5Sec) > 5000000ll)
+  /* Scan all alarms to find those matching current time and day-of-week. */
+  for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ALARMS; ++Loop1UInt16)
+  {
+    if (FlashConfig1.Alarm[Loop1UInt16].FlagStatus != FLAG_ON)
+    {
+      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u Off (%2.2u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].FlagStatus);
+      continue;
+    }
+    else
     {
-      LastTimer5Sec = CurrentTimer;
+      /* Display alarm status for debug purpose. */
+      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u ON  (%2.2u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].FlagStatus);
+    }
 
 
-      /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                 Check if flash configuration has been changed.
-      \* --------------------------------------------------------------------------------------------------------------------------- */
-      /* Check if RGB Matrix flash configuration has been changed, more or less 30 seconds after exiting from terminal menu. */
-      if ((TermModeTimer != 0ll) && ((CurrentTimer - TermModeTimer) > 30000000ll))
-      {
-        flash_check_config(1);  // configuration 1 (main configuration data).
-        flash_check_config(2);  // configuration 2 (calendar events and reminders).
-        TermModeTimer = 0ll;
-      }
+    /* Check if today is a target day for this alarm. */
+    if ((FlashConfig1.Alarm[Loop1UInt16].DayMask & (1 << CurrentTime.DayOfWeek)) == 0)
+    {
+      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - DayMask does not match\r", Loop1UInt16);
+      continue;
+    }
+    else
+    {
+      /* Display alarm status for debug purpose. */
+      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - DayMask does match\r", Loop1UInt16);
     }
 
 
-
-    /* --------------------------------------------------------------------------------------------------------------------------- *\
-                   10-seconds timestep and schedule mark. Put here functions that we want to execute every 10 seconds.
-    \* --------------------------------------------------------------------------------------------------------------------------- */
-    if ((CurrentTimer - LastTimer10Sec) > 10000000ll)
+    if (FlashConfig1.Alarm[Loop1UInt16].Hour != CurrentTime.Hour)
+    {
+      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - Hour does not match (%u VS %u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].Hour, CurrentTime.Hour);
+      continue;
+    }
+    else
     {
-      LastTimer10Sec = CurrentTimer;
+      /* Display alarm status for debug purpose. */
+      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - Hour does match (%u VS %u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].Hour, CurrentTime.Hour);
+    }
 
-#ifdef DEVELOPER_VERSION
-      if (stdio_usb_connected())
-      {
-        /// uart_send(__LINE__, __func__, "10-seconds heartbeat... Absolute time reference: %6llu   WatchdogCheck: %4u\r", (time_us_64() / 1000000ll), WatchdogCheck);
 
-        if (DebugBitMask & DEBUG_REMINDER)
-        {
-          util_uint64_to_binary_string(Reminder1BitMask, MAX_REMINDERS1, String);
-          uart_send(__LINE__, __func__, "Reminder1BitMask:       0x%10.10llX   [%s]\r", Reminder1BitMask, String);
-        }
+    if (FlashConfig1.Alarm[Loop1UInt16].Minute != CurrentTime.Minute)
+    {
+      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - Minute does not match (%u VS %u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].Hour, CurrentTime.Hour);
+      continue;
+    }
+    else
+    {
+      /* Display alarm status for debug purpose. */
+      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - Minute does match (%u VS %u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].Hour, CurrentTime.Hour);
+    }
 
+    AlarmBitMask |= ((UINT16)0x01 << Loop1UInt16);
+    ActiveAlarm[Loop1UInt16].CountDown = FlashConfig1.Alarm[Loop1UInt16].RingDuration;  // global time alarm will be ringing.
+    if (FlagLocalDebug) uart_send(__LINE__, __func__, "Al: %u   Mask: 0x%2.2X   CD: %u   (%s)\r", Loop1UInt16, AlarmBitMask, ActiveAlarm[Loop1UInt16].CountDown, FlashConfig1.Alarm[Loop1UInt16].Message);
+  }
 
+  // if (FlagLocalDebug) printf("Exiting alarm_check()\r");
 
-        if (DebugBitMask & DEBUG_SCROLL)
-        {
-          Dum1UInt8 = get_scroll_number();
-          // uart_send(__LINE__, __func__, "Received %u from get_scroll_number)\r", Dum1UInt8);
-          if (Dum1UInt8 != MAX_ACTIVE_SCROLL)
-          {
-            uart_send(__LINE__, __func__, "Total length of scrolling message: %4u (active scroll number: %u     window: %s)\r", strlen(ActiveScroll[Dum1UInt8]->Message), Dum1UInt8, Window[ActiveScroll[Dum1UInt8]->Owner].Name);
-            sleep_ms(20);  // prevent communication override.
-            uart_send(__LINE__, __func__, "Current pointer in ASCII message:  %4u (remaining characters to be scrolled: %u)\r", ActiveScroll[Dum1UInt8]->AsciiBufferPointer, strlen(&ActiveScroll[Dum1UInt8]->Message[ActiveScroll[Dum1UInt8]->AsciiBufferPointer]));
-            sleep_ms(20);  // prevent communication override.
-            uart_send(__LINE__, __func__, "Text remaining to be scrolled:\r");
-            sleep_ms(20);  // prevent communication override.
-            printf("---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------\r");
-            sleep_ms(20);  // prevent communication override.
-            // printf("%s\r", ActiveScroll[Dum1UInt8]->Message);  // display complete message.
-            printf("%s\r", &ActiveScroll[Dum1UInt8]->Message[ActiveScroll[Dum1UInt8]->AsciiBufferPointer]);  // display what remains to be scrolled.
-            sleep_ms(20);  // prevent communication override.
-            printf("---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------\r\r\r\r");
-            sleep_ms(20);  // prevent communication override.
-          }
-        }
-
-
-
-        /***
-        if (DebugBitMask & DEBUG_NTP)
-        {
-          uart_send(__LINE__, __func__, "=========================================================\r");
-          uart_send(__LINE__, __func__, "               NTP info in the endless loop\r");
-          display_ntp_info();
-        }
-        ***/
-      }
-#endif  // DEVELOPER_VERSION
-    }
-
-
-
-    /* --------------------------------------------------------------------------------------------------------------------------- *\
-                   30-seconds timestep and schedule mark. Put here functions that we want to execute every 30 seconds.
-    \* --------------------------------------------------------------------------------------------------------------------------- */
-    if ((CurrentTimer - LastTimer30Sec) > 30000000ll)
-    {
-      LastTimer30Sec = CurrentTimer;
-
-      if (DebugBitMask & DEBUG_ALARM)
-      {
-        // Display alarms bitmask.
-        util_uint64_to_binary_string((UINT64)AlarmBitMask, MAX_ALARMS, String);
-        uart_send(__LINE__, __func__, "AlarmBitMask: [%s] (0x%4.4X)\r", String, AlarmBitMask);
-
-        /* Display alarm current count-down value for every alarm. */
-        for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ALARMS; ++Loop1UInt16)
-        {
-          uart_send(__LINE__, __func__, "ActiveAlarm[%u].CountDown: %4u\r", Loop1UInt16, ActiveAlarm[Loop1UInt16].CountDown);
-        }
-      }
-
-
-      if (DebugBitMask & DEBUG_EVENT)
-      {
-        /* Display triggered events bitmask. */
-        util_uint64_to_binary_string((UINT64)EventBitMask, MAX_EVENTS, String);
-        uart_send(__LINE__, __func__, "EventBitMask: [%s] (0x%16.16X)\r", String, EventBitMask);
-
-        /* Display Event data for triggered events. */
-        for (Loop1UInt16 = 0; Loop1UInt16 < MAX_EVENTS; ++Loop1UInt16)
-        {
-          if (Loop1UInt16 & (1 << Loop1UInt16))
-          {
-            uart_send(__LINE__, __func__, "Triggered event Number %u\r", Loop1UInt16);
-            uart_send(__LINE__, __func__, "Event day:    %u\r",    FlashConfig1.Event[Loop1UInt16].Day);
-            uart_send(__LINE__, __func__, "Event month:  %u\r",    FlashConfig1.Event[Loop1UInt16].Month);
-            uart_send(__LINE__, __func__, "Event jingle: %u\r",    FlashConfig1.Event[Loop1UInt16].Jingle);
-            uart_send(__LINE__, __func__, "Event message: <%s>\r", FlashConfig1.Event[Loop1UInt16].Message);
-          }
-        }
-      }
-    }
-
-
-
-    /* --------------------------------------------------------------------------------------------------------------------------- *\
-                     1-minute timestep and schedule mark. Put here functions that we want to execute every minute.
-    \* --------------------------------------------------------------------------------------------------------------------------- */
-    if ((CurrentTimer - LastTimer1Min) > 60000000ll)
-    {
-      LastTimer1Min = CurrentTimer;
-
-      /* Reset Row 31 original border color in case we used DEBUG_STARTUP which uses the last row as a startup sequence progress indicator. */
-      RGB_matrix_set_color(31, 0, 31, 63, Window[WIN_TIME].BorderColor);  /////
-
-#ifdef DEVELOPER_VERSION
-      if (stdio_usb_connected())
-      {
-        uart_send(__LINE__, __func__, "1-minute heartbeat... Absolute time reference: %6llu\r", time_us_64() / 1000000ll);
-
-
-        if (DebugBitMask & DEBUG_REMINDER)
-        {
-          util_uint64_to_binary_string(Reminder1BitMask, MAX_REMINDERS1, String);
-          uart_send(__LINE__, __func__, "Reminder1BitMask:                    0x%10.10llX   [%s]\r", Reminder1BitMask, String);
-        }
-
-
-#ifdef NTP_SUPPORT
-        /***
-        if (DebugBitMask & DEBUG_NTP)
-        {
-          uart_send(__LINE__, __func__, "=========================================================\r");
-          uart_send(__LINE__, __func__, "               NTP info in the endless loop\r");
-          display_ntp_info();
-        }
-        ***/
-#endif  // NTP_SUPPORT
-      }
-#endif  // DEVELOPER_VERSION
-    }
-
-
-
-#ifdef NTP_SUPPORT
-    /* Handle network time protocol (NTP) synchronization. */
-    DeltaTime = (absolute_time_diff_us(get_absolute_time(), NTPData.NTPUpdateTime) / 1000000ll);
-    if ((DeltaTime <= 0) || (is_nil_time(NTPData.NTPUpdateTime)))
-    {
-      if (DebugBitMask & DEBUG_NTP)
-      {
-        uart_send(__LINE__, __func__, "=========================================================\r");
-        uart_send(__LINE__, __func__, "            Network Time Protocol cycle start\r");
-        display_ntp_info();
-      }
-
-
-      if (NTPData.FlagNTPInit == FLAG_OFF)
-      {
-        if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, __func__, "Trying to initialize Wi-Fi connection...\r");
-        if (ntp_init(FlashConfig1.SSID, FlashConfig1.Password) == false)
-        {
-          uart_send(__LINE__, __func__, "=========================================================\r");
-          uart_send(__LINE__, __func__, "    ntp_init(): Failed to establish a Wi-Fi connection\r");
-          NTPData.FlagNTPInit = FLAG_OFF;  // request a new ntp_init();
-          display_ntp_info();
-        }
-      }
-      else
-      {
-        if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, __func__, "Requesting RGB Matrix synchronization through NTP.\r\r");
-
-        /* Initialize with invalid value on entry. */
-        NTPData.FlagNTPSuccess = 0xFF;
-        
-        /* Retrieve UTC time from Network Time Protocol server. */
-        ntp_get_time();
-
-        /* Wait for NTP to return result. */
-        for (Loop1UInt8 = 0; Loop1UInt8 < MAX_NTP_CHECKS; ++Loop1UInt8)
-        {
-          if (NTPData.FlagNTPSuccess == FLAG_POLL)
-          {
-            if (DebugBitMask & DEBUG_NTP)
-            {
-              uart_send(__LINE__, __func__, "\r\r\r\r");
-              uart_send(__LINE__, __func__, "=========================================================\r");
-              uart_send(__LINE__, __func__, "           Variables after successful NTP poll\r");
-              display_ntp_info();
-            }
-            break;  // get out of "for" loop.
-          }
-
-
-          if (NTPData.FlagNTPSuccess == FLAG_ON)
-          {
-            NTPData.FlagNTPHistory = NTPData.FlagNTPSuccess;
-
-            /* Convert UnixTime received from NTP server. */
-            convert_unix_time(NTPData.UnixTime, &TempTime, &HumanTime, FLAG_ON);
-
-            if (DebugBitMask & DEBUG_NTP)
-            {
-              uart_send(__LINE__, __func__, "\r\r\r\r");
-              uart_send(__LINE__, __func__, "=========================================================\r");
-              uart_send(__LINE__, __func__, "           Variables after successful NTP read\r");
-              display_ntp_info();
-              uart_send(__LINE__, __func__, "NTP synchronization succeeded (after %u retries)\r", Loop1UInt8);
-
-              UnixTime = convert_human_to_unix(&CurrentTime, FLAG_ON);
-
-              uart_send(__LINE__, __func__, "Current RGB-Matrix UnixTime:       %12llu\r", UnixTime);
-              uart_send(__LINE__, __func__, "UnixTime returned from NTP:        %12llu\r", NTPData.UnixTime);
-              uart_send(__LINE__, __func__, "Delta seconds between DS3231 and NTP server: %lld\r", NTPData.UnixTime - UnixTime);
-
-              display_human_time("RGB Matrix time before resync:        ", &CurrentTime);
-              display_human_time("HumanTime as decoded from NTP server: ", &HumanTime);
-            }
-
-
-            if (HumanTime.Second < 59)
-            {
-              /* Set time in the real-time clock IC while accounting for Internet latency. */
-              sleep_ms(1000 - (NTPData.NTPLatency / 1000));
-              ++HumanTime.Second;
-            }
-            ds3231_set_time(&HumanTime);
-
-            NTPData.FlagNTPResync = FLAG_OFF;
-            break;  // get out of "for" loop.
-          }
-
-          sleep_ms(500);
-        }
-
-
-        /* If current NTP update request failed. */
-        if (Loop1UInt8 >= MAX_NTP_CHECKS)
-        {
-          NTPData.FlagNTPResync  = FLAG_OFF;  // NTP resync error... postpone re-sync.
-          NTPData.FlagNTPHistory = NTPData.FlagNTPSuccess;
-          ++NTPData.NTPErrors;
-          if (DebugBitMask & DEBUG_NTP)
-          {
-            uart_send(__LINE__, __func__, "\r\r\r\r");
-            uart_send(__LINE__, __func__, "=========================================================\r");
-            uart_send(__LINE__, __func__, "           After failed NTP sync (%u retries)\r", Loop1UInt8);
-            display_ntp_info();
-          }
-
-          /* If ntp_get_time() didn't work, try to re-initialize ntp in case the SSID and / or password has been updated lately,
-             or in case network was down and is is back Up later. */
-          NTPData.FlagNTPInit   = FLAG_OFF;  // request a new ntp_init();
-          NTPData.NTPUpdateTime = delayed_by_ms(NTPData.NTPUpdateTime, ((UINT32)(NTP_REFRESH * 1000)));
-        }
-      }
-    }
-#endif  // NTP_SUPPORT
-
-	  sleep_ms(1);  // slow down main system loop.
-  }
-
-	return 0;
-}
-
-
-
-
-/* $TITLE=alarm_check() */
-/* $PAGE */
-/* ============================================================================================================================================================= *\
-                                                                   Check if some alarms must be triggered.
-\* ============================================================================================================================================================= */
-void alarm_check(void)
-{
-#ifdef RELEASE_VERSION
-  UINT8 FlagLocalDebug = FLAG_OFF;  // should be OFF all times
-#else  // RELEASE_VERSION
-  UINT8 FlagLocalDebug = FLAG_OFF;
-#endif  // RELEASE_VERSION
-
-  UCHAR String[31];
-
-  UINT8 TotalActiveAlarms;
-
-  UINT16 Loop1UInt16;
-
-
-  // if (FlagLocalDebug) printf("Entering alarm_check()\r");
-
-  /* Initialize total number of new active alarms. */
-  TotalActiveAlarms = 0;
-
-
-  /* Scan all alarms to find those matching current time and day-of-week. */
-  for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ALARMS; ++Loop1UInt16)
-  {
-    if (FlashConfig1.Alarm[Loop1UInt16].FlagStatus != FLAG_ON)
-    {
-      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u Off (%2.2u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].FlagStatus);
-      continue;
-    }
-    else
-    {
-      /* Display alarm status for debug purpose. */
-      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u ON  (%2.2u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].FlagStatus);
-    }
-
-
-    /* Check if today is a target day for this alarm. */
-    if ((FlashConfig1.Alarm[Loop1UInt16].DayMask & (1 << CurrentTime.DayOfWeek)) == 0)
-    {
-      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - DayMask does not match\r", Loop1UInt16);
-      continue;
-    }
-    else
-    {
-      /* Display alarm status for debug purpose. */
-      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - DayMask does match\r", Loop1UInt16);
-    }
-
-
-    if (FlashConfig1.Alarm[Loop1UInt16].Hour != CurrentTime.Hour)
-    {
-      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - Hour does not match (%u VS %u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].Hour, CurrentTime.Hour);
-      continue;
-    }
-    else
-    {
-      /* Display alarm status for debug purpose. */
-      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - Hour does match (%u VS %u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].Hour, CurrentTime.Hour);
-    }
-
-
-    if (FlashConfig1.Alarm[Loop1UInt16].Minute != CurrentTime.Minute)
-    {
-      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - Minute does not match (%u VS %u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].Hour, CurrentTime.Hour);
-      continue;
-    }
-    else
-    {
-      /* Display alarm status for debug purpose. */
-      // if (FlagLocalDebug) uart_send(__LINE__, __func__, "Alarm %u - Minute does match (%u VS %u)\r", Loop1UInt16, FlashConfig1.Alarm[Loop1UInt16].Hour, CurrentTime.Hour);
-    }
-
-    AlarmBitMask |= ((UINT16)0x01 << Loop1UInt16);
-    ActiveAlarm[Loop1UInt16].CountDown = FlashConfig1.Alarm[Loop1UInt16].RingDuration;  // global time alarm will be ringing.
-    if (FlagLocalDebug) uart_send(__LINE__, __func__, "Al: %u   Mask: 0x%2.2X   CD: %u   (%s)\r", Loop1UInt16, AlarmBitMask, ActiveAlarm[Loop1UInt16].CountDown, FlashConfig1.Alarm[Loop1UInt16].Message);
-  }
-
-  // if (FlagLocalDebug) printf("Exiting alarm_check()\r");
-
-  return;
-}
+  return;
+}
 
 
 
@@ -2473,7 +2491,7 @@ void alarm_ring(void)
           /* It is time to feed this ringer and repeat the scroll. */
           queue_add_active(FlashConfig1.Alarm[Loop1UInt16].BeepMSec, FlashConfig1.Alarm[Loop1UInt16].NumberOfBeeps);
           queue_add_active(2000, SILENT);
-          win_scroll(WIN_DATE, 201, 201, 1, 1, FONT_5x7, "%s", FlashConfig1.Alarm[Loop1UInt16].Message);
+          win_scroll(WIN_DATE, 201, 201, 1, SCROLL_SPEED_FAST, FONT_5x7, "%s", FlashConfig1.Alarm[Loop1UInt16].Message);  // alarm messages are long, scroll them faster.
 
 
           if (FlashConfig1.Alarm[Loop1UInt16].RepeatPeriod > ActiveAlarm[Loop1UInt16].CountDown)
@@ -2543,72 +2561,327 @@ void beep_tone(UINT8 RepeatCount)
 
 
 
-/* $TITLE=callback_1msec_timer() */
+/* $TITLE=benchmark_report() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                                  Callback in charge of LED matrix scan.
+                                                          Print the result of one benchmarked function as a CSV line.
 \* ============================================================================================================================================================= */
-bool callback_1msec_timer(struct repeating_timer *t)
+void benchmark_report(UCHAR *FunctionName, UCHAR *Variant, UINT32 Iterations, UINT64 ElapsedNSec)
 {
-  RGB_matrix_update(FrameBuffer);
+  UCHAR Platform[8];
 
-  return true;
+
+#ifdef HOST_SIMULATOR
+  sprintf(Platform, "Host");
+#else  // HOST_SIMULATOR
+  sprintf(Platform, "%s", (PicoType == TYPE_PICOW) ? "PicoW" : "Pico");
+#endif  // HOST_SIMULATOR
+
+  if (Iterations == 0) Iterations = 1;
+
+  /* CSV lines end with "\n" instead of "\r" so that the output may be fed as is to spreadsheets and scripts. */
+  printf("%s,%s,%s,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n", Platform, FIRMWARE_VERSION, FunctionName, Variant, (UINT64)Iterations, ElapsedNSec, ElapsedNSec / Iterations);
+
+  return;
 }
 
 
 
 
 
-/* $TITLE=callback_50msec_timer() */
+/* $TITLE=benchmark_run() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                           Callback in charge of following activities:
-                                                          - Remote control infrared reception.
-                                                          - Text Scrolling.
-                                                          - Active buzzer sound queue.
+                                           Time the scan and drawing hot paths and print the results in CSV format.
+                         NOTES:
+                         1) Called from the terminal <tools> menu on target and from the <bench> scenario of the host simulator.
+                         2) Drawing is done in a private buffer when the function allows it. FrameBuffer, colors and active windows
+                            are restored on exit.
+                         3) The scroll tick (core 1) is paused while scroll and transition functions are called directly from core 0,
+                            so that both cores do not step the same scroll or transition. Active scrolls resume where they were on exit.
+                         4) win_open() only starts a transition: each win_open() is timed along with the transition_tick() calls that
+                            bring its transition to completion (CPU time only, the tick period is not waited for).
 \* ============================================================================================================================================================= */
-bool callback_50msec_timer(struct repeating_timer *t)
+void benchmark_run(void)
 {
-  UCHAR String[128];
+  UCHAR FontName[MAX_FONTS][5] = {"4x7", "5x7", "8x10"};
 
-  UINT8 IrButton;    // remote control button decoded from infrared data stream.
-  UINT8 Loop1UInt8;
-  UINT8 RowNumber;
+  UINT8 FontType;
+  UINT8 ScrollNumber;
+  UINT8 WinBotSave;
+  UINT8 WinMidSave;
+  UINT8 WinTopSave;
 
-  UINT64 Timer1;
-  UINT64 Timer2;
+  UINT32 Loop1UInt32;
 
-  static UINT8 IrCycleCount;
-  static UINT8 FlagActiveSound;
-  static UINT8 FlagLocalDebug = FLAG_OFF;
-  /// static UINT8  FlagPassiveSound;
+  UINT64 BenchBuffer[MAX_ROWS];
+  UINT64 ColorPlaneSave[3][MAX_ROWS];
+  UINT64 FrameBufferSave[MAX_ROWS];
+  UINT64 StartTime;
 
-  static UINT16 ActiveMSeconds;
-  static UINT16 ActiveMSecCounter;
-  static UINT16 ActiveRepeatCount;
-  static UINT16 CurrentRepeat;
-  /// static UINT16 Frequency;
-  /// static UINT16 PassiveMSeconds;
-  /// static UINT16 PassiveMSecCounter;
 
+  /* Save what is currently displayed. */
+  memcpy(FrameBufferSave, FrameBuffer, sizeof(FrameBufferSave));
+  memcpy(ColorPlaneSave,  ColorPlane,  sizeof(ColorPlaneSave));
+  WinTopSave = WinTop;
+  WinMidSave = WinMid;
+  WinBotSave = WinBot;
 
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                 Manage infrared data stream reception.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-#ifdef REMOTE_SUPPORT
-  if (IrStepCount)
-  {
-    /* If there is an infrared data stream now coming in, increment IrCycleCount, IR data stream will be decoded
-       when IrCycleCount reaches the count of 3, to make sure data stream has been sent in its entirety. */
-    ++IrCycleCount;
+  RGB_matrix_cls(BenchBuffer);
 
-    // Debug line below should not be used inside callback context.
-    // if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "\rIncrementing IrCycleCount to %u\r", IrCycleCount);
+  /* Scroll tick is paused until the end of the benchmark (see NOTES above). */
+  cancel_repeating_timer(&HandleScrollTimer);
 
-    /* If IrCycleCount reaches the value of 3, data stream began at least 100 msec ago, so it must be completed by now and ready to be processed. */
-    if (IrCycleCount >= 3)
-    {
-      IrCycleCount = 0;  // reset IrCycleCount when infrared data stream has been entirely received to get ready for next IR data stream.
+  printf("platform,version,function,variant,iterations,total_ns,ns_per_call\n");
+
+
+#ifndef PIO_SCAN_SUPPORT
+  /* Scan callback is stopped while the scan functions are called directly, so that both do not compete for the matrix GPIOs. */
+  cancel_repeating_timer(&HandleScanTimer);
+
+  StartTime = BENCHMARK_NSEC();
+  for (Loop1UInt32 = 0; Loop1UInt32 < BENCHMARK_ITERATIONS; ++Loop1UInt32)
+    RGB_matrix_update(FrameBuffer);
+  benchmark_report("RGB_matrix_update", "one row", BENCHMARK_ITERATIONS, BENCHMARK_NSEC() - StartTime);
+
+  StartTime = BENCHMARK_NSEC();
+  for (Loop1UInt32 = 0; Loop1UInt32 < BENCHMARK_ITERATIONS; ++Loop1UInt32)
+    RGB_matrix_write_data(Loop1UInt32 % HALF_ROWS);
+  benchmark_report("RGB_matrix_write_data", "one row", BENCHMARK_ITERATIONS, BENCHMARK_NSEC() - StartTime);
+
+  /* Scan callback is restarted in core 1 alarm pool, so that its interrupts are still serviced by core 1, with the dwell time of the next row to scan. */
+  alarm_pool_add_repeating_timer_us(Core1AlarmPool, -(INT64)RowDwell[RowScan], callback_scan_timer, NULL, &HandleScanTimer);
+#endif  // PIO_SCAN_SUPPORT
+
+
+  for (FontType = 0; FontType < MAX_FONTS; ++FontType)
+  {
+    StartTime = BENCHMARK_NSEC();
+    for (Loop1UInt32 = 0; Loop1UInt32 < BENCHMARK_ITERATIONS; ++Loop1UInt32)
+      RGB_matrix_display(BenchBuffer, 0, 0, '0' + (Loop1UInt32 % 10), FontType, FLAG_ON);
+    benchmark_report("RGB_matrix_display", FontName[FontType], BENCHMARK_ITERATIONS, BENCHMARK_NSEC() - StartTime);
+  }
+
+  StartTime = BENCHMARK_NSEC();
+  for (Loop1UInt32 = 0; Loop1UInt32 < BENCHMARK_ITERATIONS; ++Loop1UInt32)
+    RGB_matrix_printf(BenchBuffer, 1, 1, FONT_5x7, "%2.2u:%2.2u", Loop1UInt32 % 24, Loop1UInt32 % 60);
+  benchmark_report("RGB_matrix_printf", "5x7 hh:mm", BENCHMARK_ITERATIONS, BENCHMARK_NSEC() - StartTime);
+
+
+  /* Scroll is done on FrameBuffer rows of WIN_TEST. Stop counting if the scroll completes before the number of iterations. */
+  ScrollNumber = win_scroll(WIN_TEST, 201, 201, 100, SCROLL_SPEED_DEFAULT, FONT_5x7, "Benchmark of the scroll engine - 0123456789");
+  if (ScrollNumber < MAX_ACTIVE_SCROLL)
+  {
+    StartTime = BENCHMARK_NSEC();
+    for (Loop1UInt32 = 0; (Loop1UInt32 < BENCHMARK_ITERATIONS) && (ActiveScroll[ScrollNumber] != 0x00l); ++Loop1UInt32)
+      RGB_matrix_scroll(ScrollNumber);
+    benchmark_report("RGB_matrix_scroll", "5x7 one pixel", Loop1UInt32, BENCHMARK_NSEC() - StartTime);
+
+    if (ActiveScroll[ScrollNumber] != 0x00l) win_scroll_off(ScrollNumber);
+  }
+
+
+  /* Restore mode leaves window back links untouched. Each transition is ticked until its last keyframe. */
+  StartTime = BENCHMARK_NSEC();
+  for (Loop1UInt32 = 0; Loop1UInt32 < BENCHMARK_WIN_OPEN_ITERATIONS; ++Loop1UInt32)
+  {
+    win_open(WIN_TEST, FLAG_ON);
+    while (TransitionRowMask != 0l) transition_tick();
+  }
+  benchmark_report("win_open", "WIN_TEST + transition", BENCHMARK_WIN_OPEN_ITERATIONS, BENCHMARK_NSEC() - StartTime);
+
+
+  StartTime = BENCHMARK_NSEC();
+  for (Loop1UInt32 = 0; Loop1UInt32 < BENCHMARK_ITERATIONS; ++Loop1UInt32)
+    set_auto_brightness();
+  benchmark_report("set_auto_brightness", "-", BENCHMARK_ITERATIONS, BENCHMARK_NSEC() - StartTime);
+
+
+  /* Restore what was displayed before the benchmark. */
+  WinTop = WinTopSave;
+  WinMid = WinMidSave;
+  WinBot = WinBotSave;
+  memcpy(ColorPlane,  ColorPlaneSave,  sizeof(ColorPlane));
+  memcpy(FrameBuffer, FrameBufferSave, sizeof(FrameBuffer));
+  RGB_matrix_dirty(0, MAX_ROWS - 1);
+
+  alarm_pool_add_repeating_timer_us(Core1AlarmPool, -SCROLL_TICK_USEC, callback_scroll_timer, NULL, &HandleScrollTimer);
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=button_deliver() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                 Hand over the next queued local button / remote control button to ButtonBuffer[0] / IrBuffer[0] and wake up the main endless loop.
+   NOTES:
+   1) Button presses are queued in ButtonRing / IrRing so that a second press is not lost while the main endless loop is still
+      processing the previous one. The main endless loop (and the functions it calls) reset ButtonBuffer[0] / IrBuffer[0] to
+      BUTTON_NONE when they are done, which lets the next button in.
+   2) Called on core 1 from the GPIO interrupt handler and from the 50 msec callback. Both run at the same interrupt priority and
+      can not interrupt each other, so they act as a single consumer of each ring.
+\* ============================================================================================================================================================= */
+void button_deliver(void)
+{
+  UINT8 ButtonCode;
+
+
+  if ((ButtonBuffer[0] == BUTTON_NONE) && (ring_get(&ButtonRing, &ButtonCode) == FLAG_ON))
+  {
+    ButtonBuffer[0] = ButtonCode;
+    loop_event_post(LOOP_EVENT_BUTTON);
+  }
+
+#ifdef REMOTE_SUPPORT
+  if ((IrBuffer[0] == BUTTON_NONE) && (ring_get(&IrRing, &ButtonCode) == FLAG_ON))
+  {
+    IrBuffer[0] = ButtonCode;
+    loop_event_post(LOOP_EVENT_IR);
+  }
+#endif  // REMOTE_SUPPORT
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=callback_scan_timer() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                                  Callback in charge of LED matrix scan.
+                                      NOTES: Not started with PIO_SCAN_SUPPORT, since the scan is then done by PIO / DMA.
+                                             Next callback is scheduled according to the dwell time of the row just latched.
+\* ============================================================================================================================================================= */
+bool callback_scan_timer(struct repeating_timer *t)
+{
+  UINT64 StartTime;
+
+
+  StartTime = time_us_64();
+
+  RGB_matrix_update(FrameBuffer);
+
+  t->delay_us = -(INT64)RowDwell[RowScan];
+
+  callback_stats_update(CALLBACK_SCAN, StartTime, RowDwell[RowScan]);
+
+  return true;
+}
+
+
+
+
+
+/* $TITLE=callback_scroll_timer() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                          Callback in charge of text scrolling, at the speed of each active scroll (runs on core 1).
+   NOTES:
+   1) The scroll tick is independent of the 50 msec callback. At each tick, every active scroll accumulates the fraction of pixel due
+      at its own speed (see scroll_step()), so that scrolls may move at different speeds, smoothly, and faster than 20 pixels per second.
+   2) All scroll regions displayed on the matrix move concurrently (see scroll_compose()).
+   3) The window transition in progress, if any, is also animated from here (see transition_tick()).
+\* ============================================================================================================================================================= */
+bool callback_scroll_timer(struct repeating_timer *t)
+{
+  UINT8 FlagChanged;
+
+  UINT64 StartTime;
+
+
+  StartTime = time_us_64();
+
+  FlagChanged = FLAG_OFF;
+  if (scroll_compose())  FlagChanged = FLAG_ON;
+  if (transition_tick()) FlagChanged = FLAG_ON;
+
+  /* Present scrolled pixels and transition keyframes to the scan right away, without waiting for the 50 msec callback. */
+  if (FlagChanged) RGB_matrix_present();
+
+  callback_stats_update(CALLBACK_SCROLL, StartTime, SCROLL_TICK_USEC);
+
+  return true;
+}
+
+
+
+
+
+/* $TITLE=callback_50msec_timer() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                  Callback in charge of following activities (runs on core 1):
+                                                          - Messages sent by core 0.
+                                                          - Remote control infrared reception.
+                                                          - Matrix front / back buffer swap.
+                                                          - Active buzzer sound queue.
+\* ============================================================================================================================================================= */
+bool callback_50msec_timer(struct repeating_timer *t)
+{
+  UCHAR String[128];
+
+  UINT8 IrButton;    // remote control button decoded from infrared data stream.
+  UINT8 RowNumber;
+
+  UINT64 StartTime;
+  UINT64 Timer1;
+  UINT64 Timer2;
+
+  static UINT8 IrCycleCount;
+  static UINT8 FlagActiveSound;
+  /// static UINT8  FlagPassiveSound;
+
+  static UINT16 ActiveMSeconds;
+  static UINT16 ActiveMSecCounter;
+  static UINT16 ActiveRepeatCount;
+  static UINT16 CurrentRepeat;
+  /// static UINT16 Frequency;
+  /// static UINT16 PassiveMSeconds;
+  /// static UINT16 PassiveMSecCounter;
+
+  struct core_message CoreMessage;
+
+
+  StartTime = time_us_64();
+
+
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                       Process messages sent by core 0 (this callback runs on core 1).
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  while (core_channel_get(&CoreMessage) == FLAG_ON)
+  {
+    switch (CoreMessage.Command)
+    {
+      case (CORE_CMD_SOUND):
+        queue_add_active(CoreMessage.Param1, CoreMessage.Param2);
+      break;
+    }
+  }
+
+
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                 Manage infrared data stream reception.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+#ifdef REMOTE_SUPPORT
+  if (IrStepCount)
+  {
+    /* If there is an infrared data stream now coming in, increment IrCycleCount, IR data stream will be decoded
+       when IrCycleCount reaches the count of 3, to make sure data stream has been sent in its entirety. */
+    ++IrCycleCount;
+
+    // Debug line below should not be used inside callback context.
+    // if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "\rIncrementing IrCycleCount to %u\r", IrCycleCount);
+
+    /* If IrCycleCount reaches the value of 3, data stream began at least 100 msec ago, so it must be completed by now and ready to be processed. */
+    if (IrCycleCount >= 3)
+    {
+      IrCycleCount = 0;  // reset IrCycleCount when infrared data stream has been entirely received to get ready for next IR data stream.
 
       /* Discard all spurious infrared bursts. */
       if (IrStepCount < 67)
@@ -2621,12 +2894,12 @@ bool callback_50msec_timer(struct repeating_timer *t)
         /* If the number of IrStepCount seems valid, proceed with IR command decoding. */
         if (ir_decode_button(&IrButton) != IR_HI_LIMIT)
         {
-          IrBuffer[0] = IrButton;  // put the button decoded in the IR buffer.
+          ring_put(&IrRing, &IrButton);  // queue the button decoded, it will be handed over to IrBuffer[0] by button_deliver() below.
           ++IrCounter;
           if (DebugBitMask & DEBUG_IR)
           {
             printf("\r");
-            uart_send(__LINE__, __func__, "Assign IrBuffer[0] = %u <%s>  (0x%2.2X)\r", IrButton, ButtonName[IrButton], IrButton);
+            uart_send(__LINE__, __func__, "Queue IR button %u <%s>  (0x%2.2X)\r", IrButton, ButtonName[IrButton], IrButton);
           }
         }
       }
@@ -2634,36 +2907,15 @@ bool callback_50msec_timer(struct repeating_timer *t)
   }
 #endif  // REMOTE_CONTROL
 
+  /* Hand over next queued button, if any, once the main endless loop has processed the previous one. */
+  button_deliver();
+
 
 
   /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                 Manage active scrolling if there is one.
+                            Present matrix changes (scroll or others) to the scan, which will display them from the next frame on.
   \* --------------------------------------------------------------------------------------------------------------------------- */
-  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ACTIVE_SCROLL; ++Loop1UInt8)
-  {
-    if (ActiveScroll[Loop1UInt8] != 0x00l)
-    {
-      /* This ActiveScroll structure has been allocated, check who's the owner. */
-      if (ActiveScroll[Loop1UInt8]->Owner == WinTop)
-      {
-        if (FlagLocalDebug) printf("<<< %u - %u >>>\r", Loop1UInt8, ActiveScroll[Loop1UInt8]->Owner);
-        RGB_matrix_scroll(Loop1UInt8);
-      }
-      /***
-      if (ActiveScroll[Loop1UInt8]->Owner == WinMid)
-      {
-        printf("++ 2 (%u - %u) ++  ", Loop1UInt8, ActiveScroll[Loop1UInt8]->Owner);
-        // RGB_matrix_scroll(Loop1UInt8);
-      }
-      if (ActiveScroll[Loop1UInt8]->Owner == WinBot)
-      {
-        printf("++ 3 (%u - %u) ++  ", Loop1UInt8, ActiveScroll[Loop1UInt8]->Owner);
-        // RGB_matrix_scroll(Loop1UInt8);
-      }
-      printf("\r");
-      ***/
-    }
-  }
+  RGB_matrix_present();
 
 
 
@@ -2848,6 +3100,8 @@ bool callback_50msec_timer(struct repeating_timer *t)
   }
   ***/
 
+  callback_stats_update(CALLBACK_50MSEC, StartTime, 50000);
+
   return true;
 }
 
@@ -2902,6 +3156,11 @@ bool callback_1000msec_timer(struct repeating_timer *t)
 
   UINT32 LocalCurrentTimer;
 
+  UINT64 StartTime;
+
+
+  StartTime = time_us_64();
+
 
   /* --------------------------------------------------------------------------------------------------------------------------- *\
                              Mechanism to evaluate the actual time spent in the 1000MSec callback function.
@@ -3118,7 +3377,7 @@ bool callback_1000msec_timer(struct repeating_timer *t)
           if (FlagLocalDebug) printf("%4u   15\r", __LINE__);
 
           /* Scroll message for this triggered event on RGB matrix. */
-          win_scroll(WIN_DATE, 201, 201, 3, 1, FONT_5x7, "%s", FlashConfig1.Event[Loop1UInt16].Message);
+          win_scroll(WIN_DATE, 201, 201, 3, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", FlashConfig1.Event[Loop1UInt16].Message);
         }
       }
     }
@@ -3184,6 +3443,8 @@ bool callback_1000msec_timer(struct repeating_timer *t)
     AbsoluteExitTime = get_absolute_time();
   }
 
+  callback_stats_update(CALLBACK_1000MSEC, StartTime, 1000000);
+
   return true;
 }
 
@@ -3192,6 +3453,137 @@ bool callback_1000msec_timer(struct repeating_timer *t)
 
 
 /* $PAGE */
+/* $TITLE=callback_stats_p99() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                        Return the 99th percentile duration (in usec) of the specified callback.
+                         NOTE: The value is the upper limit of the histogram bucket where the 99th percentile lies, bounded by the
+                               longest duration observed.
+\* ============================================================================================================================================================= */
+UINT32 callback_stats_p99(const struct callback_stat *Stat)
+{
+  UINT8 Bucket;
+
+  UINT32 Cumulative;
+  UINT32 Target;
+  UINT32 UpperLimit;
+
+
+  if (Stat->Count == 0) return 0;
+
+  /* Number of calls that must be covered (99 percent of them). */
+  Target = Stat->Count - (Stat->Count / 100);
+
+  Cumulative = 0;
+  for (Bucket = 0; Bucket < (CALLBACK_BUCKETS - 1); ++Bucket)
+  {
+    Cumulative += Stat->Histogram[Bucket];
+    if (Cumulative >= Target) break;
+  }
+
+  /* Last bucket has no upper limit. */
+  if (Bucket == (CALLBACK_BUCKETS - 1)) return Stat->MaxUSec;
+
+  UpperLimit = (0x01 << Bucket) - 1;
+  if (UpperLimit > Stat->MaxUSec) UpperLimit = Stat->MaxUSec;
+
+  return UpperLimit;
+}
+
+
+
+
+
+/* $TITLE=callback_stats_reset() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                       Reset duration statistics of all callbacks.
+\* ============================================================================================================================================================= */
+void callback_stats_reset(void)
+{
+  UINT32 InterruptMask;
+
+
+  /* Callbacks update their statistics from interrupt context on both cores. */
+  InterruptMask = spin_lock_blocking(CallbackStatLock);
+  memset(CallbackStat, 0x00, sizeof(CallbackStat));
+  CallbackStatStart = time_us_64();
+  spin_unlock(CallbackStatLock, InterruptMask);
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=callback_stats_update() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                   Update duration statistics of the specified callback. To be called just before the callback returns.
+                         NOTES:
+                         1) A call is "late" when it starts later than CALLBACK_LATE_PERCENT of the period expected after previous call.
+                         2) A call "overruns" when it lasts longer than its own period, thus delaying the following ones.
+                         3) Callbacks run on both cores, so CallbackStat is updated with CallbackStatLock held.
+\* ============================================================================================================================================================= */
+void callback_stats_update(UINT8 CallbackId, UINT64 StartTime, UINT32 PeriodUSec)
+{
+  UINT8 Bucket;
+
+  UINT32 Duration;
+  UINT32 InterruptMask;
+  UINT32 Interval;
+
+
+  Duration = (UINT32)(time_us_64() - StartTime);
+
+  /* Histogram bucket is the number of significant bits of the duration. */
+  for (Bucket = 0; ((Duration >> Bucket) != 0) && (Bucket < (CALLBACK_BUCKETS - 1)); ++Bucket);
+
+  InterruptMask = spin_lock_blocking(CallbackStatLock);
+
+  /* Check if this call started late compared to the period expected after previous call. */
+  if (CallbackStat[CallbackId].LastStart != 0ll)
+  {
+    Interval = (UINT32)(StartTime - CallbackStat[CallbackId].LastStart);
+    if (Interval > (CallbackStat[CallbackId].PeriodUSec + ((CallbackStat[CallbackId].PeriodUSec * CALLBACK_LATE_PERCENT) / 100))) ++CallbackStat[CallbackId].LateCount;
+  }
+  CallbackStat[CallbackId].LastStart  = StartTime;
+  CallbackStat[CallbackId].PeriodUSec = PeriodUSec;
+
+  if (Duration > PeriodUSec) ++CallbackStat[CallbackId].OverrunCount;
+
+  if ((CallbackStat[CallbackId].Count == 0) || (Duration < CallbackStat[CallbackId].MinUSec)) CallbackStat[CallbackId].MinUSec = Duration;
+  if (Duration > CallbackStat[CallbackId].MaxUSec) CallbackStat[CallbackId].MaxUSec = Duration;
+  CallbackStat[CallbackId].TotalUSec += Duration;
+  ++CallbackStat[CallbackId].Count;
+  ++CallbackStat[CallbackId].Histogram[Bucket];
+
+  spin_unlock(CallbackStatLock, InterruptMask);
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=callback_terminal_input() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                 Callback called by stdio when character(s) have been received from external terminal. Wakes up the main endless loop.
+\* ============================================================================================================================================================= */
+void callback_terminal_input(void *Param)
+{
+  loop_event_post(LOOP_EVENT_TERMINAL);
+
+  return;
+}
+
+
+
+
+
 /* $TITLE=convert_human_to_tm() */
 /* ============================================================================================================================================================= *\
                                                                   Convert "HumanTime" to "tm_time".
@@ -3328,27 +3720,67 @@ void convert_unix_time(time_t UnixTime, struct tm *TmTime, struct human_time *Hu
 /* $TITLE=core1_main() */
 /* ============================================================================================================================================================= *\
                                                           Thread to be run on Pico's core 1 (second core).
-                           Core 1 is in charge of receiving infrared data streams and monitoring hardware interrupts for local buttons.
+                                Core 1 owns matrix refresh, text scrolling and active buzzer sound queue. It is also in charge
+                                         of receiving infrared data streams and monitoring hardware interrupts for local buttons.
+   NOTES:
+   1) Repeating timers are added to an alarm pool created here, so that their interrupts are serviced by core 1 instead of core 0.
+   2) Core 0 gives the startup steps through the SIO FIFO, so that each activity begins at the same point of startup sequence as before.
+   3) Once started, core 1 only reacts to interrupts. Core 0 talks to it through CoreChannel (see core_channel_put()).
 \* ============================================================================================================================================================= */
 void core1_main(void)
 {
+  UINT32 StartStep;
+
+
   if (DebugBitMask & DEBUG_CORE) printf("Entering core1_main()\r");
 
-  if (DebugBitMask & DEBUG_STARTUP)
-  {
-    printf("[%4u]   Before launching ISR for IR sensor.\r", __LINE__);
-    sleep_ms(1000);  // slow down startup sequence if required for debugging purposes.
-  }
+  /* Hardware alarm 3 is used by core 0 default alarm pool (PICO_TIME_DEFAULT_ALARM_POOL_HARDWARE_ALARM_NUM). */
+  Core1AlarmPool = alarm_pool_create(1, 16);
 
-  /* Let the IR sensor be initialized even if we don't use the remote control since it is
-     the base irq service routine eventual infrared glitches will simply be ignored. */
-  gpio_set_irq_enabled_with_callback(IR_RX, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, (gpio_irq_callback_t)&isr_signal_trap);
 
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                          Start the callback in charge of matrix scan.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+#ifndef PIO_SCAN_SUPPORT
+  alarm_pool_add_repeating_timer_us(Core1AlarmPool, -ROW_DWELL_DEFAULT, callback_scan_timer, NULL, &HandleScanTimer);
+#endif  // PIO_SCAN_SUPPORT
 
-  /* Since the gpio callback has been set above for infrared sensor, simply add other GPIO's to the same callback. */
-  if (DebugBitMask & DEBUG_STARTUP)
-  {
-    printf("[%4u]   Adding button <Set> to the ISR callback.\r", __LINE__);
+
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                   Start callbacks managing sound queue, infrared data stream and scrolling.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  do
+  {
+    StartStep = multicore_fifo_pop_blocking();
+  } while (StartStep != CORE1_START_50MSEC);
+
+  alarm_pool_add_repeating_timer_ms(Core1AlarmPool, -50, callback_50msec_timer, NULL, &Handle50MSecTimer);
+  alarm_pool_add_repeating_timer_us(Core1AlarmPool, -SCROLL_TICK_USEC, callback_scroll_timer, NULL, &HandleScrollTimer);
+
+
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                   Start ISR for infrared sensor and local buttons.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  do
+  {
+    StartStep = multicore_fifo_pop_blocking();
+  } while (StartStep != CORE1_START_INPUTS);
+
+  if (DebugBitMask & DEBUG_STARTUP)
+  {
+    printf("[%4u]   Before launching ISR for IR sensor.\r", __LINE__);
+    sleep_ms(1000);  // slow down startup sequence if required for debugging purposes.
+  }
+
+  /* Let the IR sensor be initialized even if we don't use the remote control since it is
+     the base irq service routine eventual infrared glitches will simply be ignored. */
+  gpio_set_irq_enabled_with_callback(IR_RX, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, (gpio_irq_callback_t)&isr_signal_trap);
+
+
+  /* Since the gpio callback has been set above for infrared sensor, simply add other GPIO's to the same callback. */
+  if (DebugBitMask & DEBUG_STARTUP)
+  {
+    printf("[%4u]   Adding button <Set> to the ISR callback.\r", __LINE__);
     sleep_ms(1000);  // slow down startup sequence if required for debugging purposes.
   }
   gpio_set_irq_enabled(BUTTON_SET_GPIO,  GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
@@ -3370,30 +3802,60 @@ void core1_main(void)
   gpio_set_irq_enabled(BUTTON_DOWN_GPIO, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
 
 
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                          Start the 1 msec callback in charge of matrix scan.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-  /// add_repeating_timer_ms(-1, callback_1msec_timer, NULL, &Handle1MSecTimer);
+  /* Keep the core 1 alive, sleeping between interrupts. */
+  while (1) __wfe();
+}
 
 
 
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                         Start the callback in charge of time update on RGB matrix.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-  /* One second callback for time update on LED matrix. */
-#if 0
-  if (DebugBitMask & DEBUG_STARTUP)
+
+
+/* $TITLE=core_channel_get() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                 Retrieve the oldest message sent by core 0. Return FLAG_OFF if there is none. To be called on core 1 only.
+\* ============================================================================================================================================================= */
+UINT8 core_channel_get(struct core_message *Message)
+{
+  if (ring_get(&CoreChannel, Message) == FLAG_OFF)
   {
-    printf("[%4u]   Before launching time update callback.\r", __LINE__);
-    debug_pixel(31, 17, BLUE);
-    sleep_ms(1000);  // slow down startup sequence if required for debugging purposes.
+    Message->Command = CORE_CMD_NONE;
+
+    return FLAG_OFF;
   }
-  add_repeating_timer_ms(-1000, callback_display_time, NULL, &Handle1000MSecTimer);
-#endif  // 0
 
+  return FLAG_ON;
+}
+
+
+
+
+
+/* $TITLE=core_channel_put() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                             Send a message to core 1 through CoreChannel ring buffer. To be called on core 0 only.
+                         NOTE: Core 0 main loop and core 0 callbacks may both send messages, so interrupts are disabled on core 0 while the message
+                               is queued, to keep a single producer (this does not affect core 1).
+\* ============================================================================================================================================================= */
+UINT8 core_channel_put(UINT8 Command, UINT16 Param1, UINT16 Param2)
+{
+  UINT8 ReturnCode;
+
+  UINT32 InterruptMask;
+
+  struct core_message Message;
+
+
+  Message.Command = Command;
+  Message.Param1  = Param1;
+  Message.Param2  = Param2;
+
+  InterruptMask = save_and_disable_interrupts();
+  ReturnCode    = ring_put(&CoreChannel, &Message);
+  restore_interrupts(InterruptMask);
 
-  /* Keep the core 1 alive. */
-  while(1) sleep_ms(1000);
+  return ReturnCode;
 }
 
 
@@ -3544,6 +4006,77 @@ void display_auto_scroll(UINT8 AutoScrollNumber)
 
 
 
+/* $TITLE=display_callback_stats() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                Display duration statistics and histogram of the callbacks.
+\* ============================================================================================================================================================= */
+void display_callback_stats(void)
+{
+  UCHAR CallbackName[MAX_CALLBACK_STATS][12] = {"Matrix scan", "50 msec", "1000 msec", "Scroll"};
+
+  UINT8 Bucket;
+  UINT8 Loop1UInt8;
+
+  UINT32 InterruptMask;
+
+  UINT64 ElapsedUSec;
+
+  struct callback_stat Stat[MAX_CALLBACK_STATS];
+
+
+  /* Take a coherent snapshot, since callbacks of both cores keep updating their statistics while we display them. */
+  InterruptMask = spin_lock_blocking(CallbackStatLock);
+  memcpy(Stat, CallbackStat, sizeof(Stat));
+  ElapsedUSec = time_us_64() - CallbackStatStart;
+  spin_unlock(CallbackStatLock, InterruptMask);
+
+  if (ElapsedUSec == 0) ElapsedUSec = 1;
+
+  printf("Statistics gathered over the last %llu seconds (durations are given in microseconds):\r\r", ElapsedUSec / 1000000ll);
+  printf("Callback          Calls      Min      Avg      Max      p99      Late   Overrun   CPU load\r");
+  printf("------------   ----------  -------  -------  -------  -------  --------  --------  --------\r");
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_CALLBACK_STATS; ++Loop1UInt8)
+  {
+    printf("%-12s   %10" PRIu32 "  %7" PRIu32 "  %7" PRIu64 "  %7" PRIu32 "  %7" PRIu32 "  %8" PRIu32 "  %8" PRIu32 "  %7.2f%%\r", CallbackName[Loop1UInt8], Stat[Loop1UInt8].Count, Stat[Loop1UInt8].MinUSec,
+           (Stat[Loop1UInt8].Count ? (Stat[Loop1UInt8].TotalUSec / Stat[Loop1UInt8].Count) : (UINT64)0), Stat[Loop1UInt8].MaxUSec, callback_stats_p99(&Stat[Loop1UInt8]),
+           Stat[Loop1UInt8].LateCount, Stat[Loop1UInt8].OverrunCount, (Stat[Loop1UInt8].TotalUSec * 100.0) / ElapsedUSec);
+  }
+
+
+  printf("\r\rDuration histogram (number of calls):\r\r");
+  printf("      Duration       ");
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_CALLBACK_STATS; ++Loop1UInt8)
+    printf("%12s ", CallbackName[Loop1UInt8]);
+  printf("\r");
+
+  for (Bucket = 0; Bucket < CALLBACK_BUCKETS; ++Bucket)
+  {
+    /* Skip buckets that are empty for all callbacks. */
+    for (Loop1UInt8 = 0; Loop1UInt8 < MAX_CALLBACK_STATS; ++Loop1UInt8)
+      if (Stat[Loop1UInt8].Histogram[Bucket] != 0) break;
+    if (Loop1UInt8 == MAX_CALLBACK_STATS) continue;
+
+    if (Bucket == 0)
+      printf("          < 1 usec   ");
+    else if (Bucket == (CALLBACK_BUCKETS - 1))
+      printf("  >= %7lu usec   ", (0x01ul << (Bucket - 1)));
+    else
+      printf("%7lu - %7lu   ", (0x01ul << (Bucket - 1)), (0x01ul << Bucket) - 1);
+
+    for (Loop1UInt8 = 0; Loop1UInt8 < MAX_CALLBACK_STATS; ++Loop1UInt8)
+      printf("%12" PRIu32 " ", Stat[Loop1UInt8].Histogram[Bucket]);
+    printf("\r");
+  }
+  printf("\r");
+
+  return;
+}
+
+
+
+
+
 /* $TITLE=display_event() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
@@ -3658,7 +4191,7 @@ void display_function_name(UINT16 FunctionId)
       win_part_cls(WIN_FUNCTION, 201, 201);
 
       /* Scroll function name on first line of RGB Matrix. */
-      win_scroll(WIN_FUNCTION, 201, 201, 1, 1, FONT_5x7, "%s", Function[Loop1UInt16].Name);  // function name too long, scroll it.
+      win_scroll(WIN_FUNCTION, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", Function[Loop1UInt16].Name);  // function name too long, scroll it.
 
       FunctionNumber = Function[Loop1UInt16].Number;
       break;
@@ -3707,6 +4240,60 @@ void display_human_time(UCHAR *Text, struct human_time *HumanTime)
 
 
 
+/* $TITLE=display_loop_stats() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                      Display busy / idle times, load averages and periodic tasks runtime statistics of the main endless loop.
+\* ============================================================================================================================================================= */
+void display_loop_stats(void)
+{
+  UINT8 Loop1UInt8;
+
+  UINT64 ElapsedUSec;
+  UINT64 TotalUSec;
+
+
+  ElapsedUSec = time_us_64() - LoopStatStart;
+  TotalUSec   = LoopStat.TotalBusyUSec + LoopStat.TotalIdleUSec;
+  if (TotalUSec == 0) TotalUSec = 1;
+
+  printf("Statistics gathered over the last %llu seconds (time spent in terminal menus is excluded):\r\r", ElapsedUSec / 1000000ll);
+  printf("Loop iterations:              %10" PRIu32 "\r",      LoopStat.Iterations);
+  printf("Total busy time:              %10llu msec (%5.2f%%)\r", LoopStat.TotalBusyUSec / 1000ll, (LoopStat.TotalBusyUSec * 100.0) / TotalUSec);
+  printf("Total idle time:              %10llu msec (%5.2f%%)\r", LoopStat.TotalIdleUSec / 1000ll, (LoopStat.TotalIdleUSec * 100.0) / TotalUSec);
+  printf("Longest busy iteration:       %10" PRIu32 " usec\r", LoopStat.MaxIterationUSec);
+  printf("Missed 1-second timesteps:    %10" PRIu32 "\r\r",    LoopStat.MissedSeconds);
+  printf("Load (last second):   %6.2f%%\r",   LoopStat.LoadLast);
+  printf("Load average:         %6.2f%% (1 min)   %6.2f%% (5 min)   %6.2f%% (15 min)\r\r", LoopStat.Load1Min, LoopStat.Load5Min, LoopStat.Load15Min);
+
+  printf("Ring buffer       Count   Size  Overflows\r");
+  printf("---------------   -----  -----  ---------\r");
+  printf("Main loop events  %5u  %5u  %9u\r", ring_count(&QueueLoopEvent),   QueueLoopEvent.Mask + 1,   QueueLoopEvent.Overflow);
+  printf("Core channel      %5u  %5u  %9u\r", ring_count(&CoreChannel),      CoreChannel.Mask + 1,      CoreChannel.Overflow);
+  printf("Sound queue       %5u  %5u  %9u\r", ring_count(&QueueActiveSound), QueueActiveSound.Mask + 1, QueueActiveSound.Overflow);
+  printf("Local buttons     %5u  %5u  %9u\r", ring_count(&ButtonRing),       ButtonRing.Mask + 1,       ButtonRing.Overflow);
+#ifdef REMOTE_SUPPORT
+  printf("Remote control    %5u  %5u  %9u\r", ring_count(&IrRing),           IrRing.Mask + 1,           IrRing.Overflow);
+#endif  // REMOTE_SUPPORT
+  printf("\r");
+
+  printf("Task       Prio  Period (ms)    Count     Last (usec)  Avg (usec)  Max (usec)  Budget (usec)  Over budget    Late  Max late (usec)\r");
+  printf("--------   ----  -----------  ----------  -----------  ----------  ----------  -------------  -----------  ------  ---------------\r");
+  for (Loop1UInt8 = 0; Loop1UInt8 < TaskCount; ++Loop1UInt8)
+  {
+    printf("%-8s   %4u  %11" PRIu32 "  %10" PRIu32 "  %11" PRIu32 "  %10" PRIu64 "  %10" PRIu32 "  %13" PRIu32 "  %11" PRIu32 "  %6" PRIu32 "  %15" PRIu32 "\r", Task[Loop1UInt8].Name, Task[Loop1UInt8].Priority, Task[Loop1UInt8].PeriodUSec / 1000,
+           Task[Loop1UInt8].Count, Task[Loop1UInt8].LastUSec, (Task[Loop1UInt8].Count ? (Task[Loop1UInt8].TotalUSec / Task[Loop1UInt8].Count) : (UINT64)0), Task[Loop1UInt8].MaxUSec,
+           Task[Loop1UInt8].BudgetUSec, Task[Loop1UInt8].OverBudgetCount, Task[Loop1UInt8].LateCount, Task[Loop1UInt8].MaxLateUSec);
+  }
+  printf("\r");
+
+  return;
+}
+
+
+
+
+
 /* $TITLE=display_matrix_buffer() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
@@ -3830,15 +4417,19 @@ void display_reminder1(UINT8 ReminderNumber)
 \* ============================================================================================================================================================= */
 void display_scroll(void)
 {
-  UCHAR String[65];
-
   UINT8 *Dum1Ptr;
   UINT8 Loop1UInt8;
-  UINT8 Loop2UInt8;
+
+  UINT16 Loop1UInt16;
 
 
-  /* Display the size of memory chunk that will be malloc'ed every time an active scroll is required. */
+  /* Display the size of each slot of the static scroll pool and its usage. */
   uart_send(__LINE__, __func__, "sizeof(struct active_scroll): %u (0x%2.2X)\r", sizeof(struct active_scroll), sizeof(struct active_scroll));
+  uart_send(__LINE__, __func__, "Scroll pool slots in use: %u / %u   high-water mark: %u   acquired: %" PRIu32 "   exhausted: %" PRIu32 "\r",
+            ScrollPool.InUse, MAX_ACTIVE_SCROLL, ScrollPool.HighWater, ScrollPool.AcquireCount, ScrollPool.ExhaustedCount);
+
+  uart_send(__LINE__, __func__, "Text layout cache hits: %" PRIu32 "   misses: %" PRIu32 "\r", LayoutCacheHits, LayoutCacheMisses);
+  printf("\r");
 
   /* Find first free memory chunk in the heap. */
   Dum1Ptr = malloc(sizeof(struct active_scroll));
@@ -3860,25 +4451,29 @@ void display_scroll(void)
       /* If this ActiveScroll structure is currently assigned. */
       uart_send(__LINE__, __func__, " [0x%p] ActiveScroll[%u]\r", ActiveScroll[Loop1UInt8], Loop1UInt8);
       uart_send(__LINE__, __func__, " [0x%p] Owner:              %3u    %s\r", &ActiveScroll[Loop1UInt8]->Owner,              ActiveScroll[Loop1UInt8]->Owner, Window[ActiveScroll[Loop1UInt8]->Owner].Name);
+      uart_send(__LINE__, __func__, " [0x%p] GlyphRow:           %3u\r",       &ActiveScroll[Loop1UInt8]->GlyphRow,           ActiveScroll[Loop1UInt8]->GlyphRow);
       uart_send(__LINE__, __func__, " [0x%p] StartRow:           %3u\r",       &ActiveScroll[Loop1UInt8]->StartRow,           ActiveScroll[Loop1UInt8]->StartRow);
       uart_send(__LINE__, __func__, " [0x%p] EndRow:             %3u\r",       &ActiveScroll[Loop1UInt8]->EndRow,             ActiveScroll[Loop1UInt8]->EndRow);
+      uart_send(__LINE__, __func__, " [0x%p] StartColumn:        %3u\r",       &ActiveScroll[Loop1UInt8]->StartColumn,        ActiveScroll[Loop1UInt8]->StartColumn);
+      uart_send(__LINE__, __func__, " [0x%p] EndColumn:          %3u\r",       &ActiveScroll[Loop1UInt8]->EndColumn,          ActiveScroll[Loop1UInt8]->EndColumn);
       uart_send(__LINE__, __func__, " [0x%p] ScrollTimes:        %3u\r",       &ActiveScroll[Loop1UInt8]->ScrollTimes,        ActiveScroll[Loop1UInt8]->ScrollTimes);
       uart_send(__LINE__, __func__, " [0x%p] ScrollSpeed:        %3u\r",       &ActiveScroll[Loop1UInt8]->ScrollSpeed,        ActiveScroll[Loop1UInt8]->ScrollSpeed);
+      uart_send(__LINE__, __func__, " [0x%p] SpeedAccumulator: %5u\r",       &ActiveScroll[Loop1UInt8]->SpeedAccumulator,   ActiveScroll[Loop1UInt8]->SpeedAccumulator);
       uart_send(__LINE__, __func__, " [0x%p] PixelCountCurrent:  %3u\r",       &ActiveScroll[Loop1UInt8]->PixelCountCurrent,  ActiveScroll[Loop1UInt8]->PixelCountCurrent);
-      uart_send(__LINE__, __func__, " [0x%p] PixelCountBuffer:   %3u\r",       &ActiveScroll[Loop1UInt8]->PixelCountBuffer,   ActiveScroll[Loop1UInt8]->PixelCountBuffer);
-      uart_send(__LINE__, __func__, " [0x%p] AsciiBufferPointer: %3u\r",       &ActiveScroll[Loop1UInt8]->AsciiBufferPointer, ActiveScroll[Loop1UInt8]->AsciiBufferPointer);
+      uart_send(__LINE__, __func__, " [0x%p] TextHead:         %5u\r",       &ActiveScroll[Loop1UInt8]->TextHead,           ActiveScroll[Loop1UInt8]->TextHead);
+      uart_send(__LINE__, __func__, " [0x%p] TextTail:         %5u\r",       &ActiveScroll[Loop1UInt8]->TextTail,           ActiveScroll[Loop1UInt8]->TextTail);
+      uart_send(__LINE__, __func__, " [0x%p] TextStart:        %5u\r",       &ActiveScroll[Loop1UInt8]->TextStart,          ActiveScroll[Loop1UInt8]->TextStart);
+      uart_send(__LINE__, __func__, " [0x%p] TextOverflow:     %5u\r",       &ActiveScroll[Loop1UInt8]->TextOverflow,       ActiveScroll[Loop1UInt8]->TextOverflow);
+      uart_send(__LINE__, __func__, " [0x%p] StripColumn:        %3u\r",       &ActiveScroll[Loop1UInt8]->StripColumn,        ActiveScroll[Loop1UInt8]->StripColumn);
+      uart_send(__LINE__, __func__, " [0x%p] StripWidth:         %3u\r\r",     &ActiveScroll[Loop1UInt8]->StripWidth,         ActiveScroll[Loop1UInt8]->StripWidth);
 
 
-      for (Loop2UInt8 = 0; Loop2UInt8 < MAX_ROWS; ++Loop2UInt8)
-      {
-        util_uint64_to_binary_string((UINT64)ActiveScroll[Loop1UInt8]->BitmapBuffer[Loop2UInt8], 64, String);
-        uart_send(__LINE__, __func__, " [0x%p]BitmapBuffer[%2u]:   0x%8.8llX  %s\r", &ActiveScroll[Loop1UInt8]->BitmapBuffer[Loop2UInt8], Loop2UInt8, ActiveScroll[Loop1UInt8]->BitmapBuffer[Loop2UInt8], String);
-        sleep_ms(50);  // to prevent communication overrun.
-      }
-      uart_send(__LINE__, __func__, " [0x%p] to [0x%p] Complete text being scrolled:\r", &ActiveScroll[Loop1UInt8]->Message[0], &ActiveScroll[Loop1UInt8]->Message[sizeof(ActiveScroll[Loop1UInt8]->Message)]);
+      /* Text kept in the text ring, from first character kept for repeat cycles (limited to the first 200 characters). */
+      uart_send(__LINE__, __func__, " [0x%p] to [0x%p] Text being scrolled:\r", &ActiveScroll[Loop1UInt8]->Text[0], &ActiveScroll[Loop1UInt8]->Text[MAX_SCROLL_TEXT]);
       printf("---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------\r");
-      printf("%s\r", &ActiveScroll[Loop1UInt8]->Message);
-      // printf("%s\r", &ActiveScroll[Loop1UInt8]->Message[ActiveScroll[Loop1UInt8]->AsciiBufferPointer]);  // part of text remaining to be scrolled.
+      for (Loop1UInt16 = ActiveScroll[Loop1UInt8]->TextStart; (Loop1UInt16 != ActiveScroll[Loop1UInt8]->TextHead) && ((UINT16)(Loop1UInt16 - ActiveScroll[Loop1UInt8]->TextStart) < 200); ++Loop1UInt16)
+        printf("%c", ActiveScroll[Loop1UInt8]->Text[Loop1UInt16 & (MAX_SCROLL_TEXT - 1)]);
+      printf("\r");
       printf("---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------\r\r\r\r");
     }
     printf("\r\r");
@@ -4157,7 +4752,8 @@ void display_windows(void)
 
     uart_send(__LINE__, __func__, "FlagTopScroll:  0x%2.2X\r",   Window[Loop1UInt8].FlagTopScroll);
     uart_send(__LINE__, __func__, "FlagMidScroll:  0x%2.2X\r",   Window[Loop1UInt8].FlagMidScroll);
-    uart_send(__LINE__, __func__, "FlagBotScroll:  0x%2.2X\r\r", Window[Loop1UInt8].FlagBotScroll);
+    uart_send(__LINE__, __func__, "FlagBotScroll:  0x%2.2X\r",   Window[Loop1UInt8].FlagBotScroll);
+    uart_send(__LINE__, __func__, "Transition:     %u\r\r",      Window[Loop1UInt8].Transition);
   }
 
   printf("\r\r");
@@ -5197,7 +5793,7 @@ UINT8 flash_display_config1(void)
   uart_send(__LINE__, __func__, "[%X] Variable16FuturUse4:             %2.2u\r",                                       &FlashConfig1.Variable16FuturUse4,   FlashConfig1.Variable16FuturUse4);
   uart_send(__LINE__, __func__, "[%X] Variable16FuturUse3:             %2.2u\r",                                       &FlashConfig1.Variable16FuturUse3,   FlashConfig1.Variable16FuturUse3);
   uart_send(__LINE__, __func__, "[%X] Variable16FuturUse2:             %2.2u\r",                                       &FlashConfig1.Variable16FuturUse2,   FlashConfig1.Variable16FuturUse2);
-  uart_send(__LINE__, __func__, "[%X] Variable16FuturUse1:             %2.2u\r",                                       &FlashConfig1.Variable16FuturUse1,   FlashConfig1.Variable16FuturUse1);
+  uart_send(__LINE__, __func__, "[%X] RowDwellUSec:                    %3u    (matrix scan row dwell time in usec)\r",    &FlashConfig1.RowDwellUSec,          FlashConfig1.RowDwellUSec);
   uart_send(__LINE__, __func__, "[%X] Variable32FuturUse2:             %2.2lu\r",                                      &FlashConfig1.Variable32FuturUse2,   FlashConfig1.Variable32FuturUse2);
   uart_send(__LINE__, __func__, "[%X] Variable32FuturUse1:             %2.2lu\r",                                      &FlashConfig1.Variable32FuturUse1,   FlashConfig1.Variable32FuturUse1);
   printf("\r");
@@ -5324,6 +5920,14 @@ UINT8 flash_display_config1(void)
 
 
 
+  /* Display matrix scan row on-time trims. */
+  for (Loop1UInt16 = 0; Loop1UInt16 < HALF_ROWS; ++Loop1UInt16)
+    uart_send(__LINE__, __func__, "[%X] RowTrim[%2.2u]:                     %3d %%\r", &FlashConfig1.RowTrim[Loop1UInt16], Loop1UInt16, FlashConfig1.RowTrim[Loop1UInt16]);
+  printf("\r");
+  sleep_ms(30);  // prevent communication override.
+
+
+
   /* Display Reserved data. */
   uart_send(__LINE__, __func__, "[%X] Reserved - size: 0x%2.2X (%3u):\r", &FlashConfig1.Reserved, sizeof(FlashConfig1.Reserved), sizeof(FlashConfig1.Reserved));
   uart_send(__LINE__, __func__, "[%8.8X] ", &FlashConfig1.Reserved);
@@ -5633,7 +6237,7 @@ UINT8 flash_read_config1(void)
   FlashConfig1.Variable16FuturUse4   = 0;                     // placeholder 16-bits variable reserved for future use.
   FlashConfig1.Variable16FuturUse3   = 0;                     // placeholder 16-bits variable reserved for future use.
   FlashConfig1.Variable16FuturUse2   = 0;                     // placeholder 16-bits variable reserved for future use.
-  FlashConfig1.Variable16FuturUse1   = 0;                     // placeholder 16-bits variable reserved for future use.
+  FlashConfig1.RowDwellUSec          = ROW_DWELL_DEFAULT;     // matrix scan row dwell time in microseconds.
   FlashConfig1.Variable32FuturUse2   = 0l;                    // placeholder 32-bits variable reserved for future use.
   FlashConfig1.Variable32FuturUse1   = 0l;                    // placeholder 32-bits variable reserved for future use.
 
@@ -5696,6 +6300,11 @@ UINT8 flash_read_config1(void)
   FlashConfig1.AutoScroll[0].FunctionId[4] = 202;  // Temperature.
 
 
+  /* No on-time trim for matrix scan rows. */
+  for (Loop1UInt16 = 0; Loop1UInt16 < HALF_ROWS; ++Loop1UInt16)
+    FlashConfig1.RowTrim[Loop1UInt16] = 0;
+
+
   /* Make provision for future parameters. */
   for (Loop1UInt16 = 0; Loop1UInt16 < sizeof(FlashConfig1.Reserved); ++Loop1UInt16)
     FlashConfig1.Reserved[Loop1UInt16] = 0xFF;
@@ -6181,7 +6790,7 @@ void function_alarms(void)
     break;
   }
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, String);
 
   return;
 }
@@ -6202,7 +6811,7 @@ void function_alarm_set(void)
   uart_send(__LINE__, __func__, "Entering function_alarm_set()\r");
   uart_send(__LINE__, __func__, "To be completed\r\r\r");
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "alarm_set() - to be completed...");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "alarm_set() - to be completed...");
 
   if (DebugBitMask & DEBUG_FLOW) printf("Exiting function_alarm_set()\r");
 
@@ -6237,7 +6846,7 @@ void function_auto_scroll(void)
       sprintf(String, "Auto-scroll %u active - Period: %u minutes   ", Loop1UInt8 + 1, FlashConfig1.AutoScroll[Loop1UInt8].Period);
 
       /* Scroll this part on first line of LED matrix. */
-      win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+      win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
       String[0] = 0x00;  // reinitialize as null string.
 
       for (Loop2UInt8 = 0; Loop2UInt8 < MAX_ITEMS; ++Loop2UInt8)
@@ -6248,7 +6857,7 @@ void function_auto_scroll(void)
       }
 
       /* Add this text to the text sent to the scroll engine above. */
-      win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+      win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
     }
   }
 
@@ -6269,7 +6878,7 @@ void function_bootsel(void)
   UINT32 IdleTime;
 
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "Make a long press on the <Set> button to reset the Pico in bootsel mode");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "Make a long press on the <Set> button to reset the Pico in bootsel mode");
 
   /* Initializations. */
   IdleTime = 0l;
@@ -6356,7 +6965,7 @@ void function_brightness(void)
 
 
   /* Scroll everything on first line of LED matrix. */
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
   if (DebugBitMask & DEBUG_FLOW) printf("Exiting function_brightness()\r");  ///
 
@@ -6379,7 +6988,7 @@ void function_brightness_set(void)
   uart_send(__LINE__, __func__, "Entering function_brightness_set()\r");
   uart_send(__LINE__, __func__, "To be completed\r\r\r");
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "function_brightness_set() - to be completed.");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "function_brightness_set() - to be completed.");
 
   if (DebugBitMask & DEBUG_FLOW) printf("Exiting function_brightness_set()\r");
 
@@ -6390,6 +6999,38 @@ void function_brightness_set(void)
 
 
 
+/* $PAGE */
+/* $TITLE=function_callback_stats() */
+/* ============================================================================================================================================================= *\
+                                                   Function to scroll callbacks duration statistics on LED matrix.
+\* ============================================================================================================================================================= */
+void function_callback_stats(void)
+{
+  UCHAR CallbackName[MAX_CALLBACK_STATS][7] = {"Scan", "50ms", "1s", "Scroll"};
+  UCHAR String[384];
+
+  UINT8 Loop1UInt8;
+
+
+  String[0] = 0x00;
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_CALLBACK_STATS; ++Loop1UInt8)
+  {
+    if (CallbackStat[Loop1UInt8].Count == 0) continue;
+
+    sprintf(&String[strlen(String)], "%s: avg %" PRIu64 " max %" PRIu32 " p99 %" PRIu32 " usec  late %" PRIu32 "  overrun %" PRIu32 "    ", CallbackName[Loop1UInt8],
+            CallbackStat[Loop1UInt8].TotalUSec / CallbackStat[Loop1UInt8].Count, CallbackStat[Loop1UInt8].MaxUSec, callback_stats_p99(&CallbackStat[Loop1UInt8]),
+            CallbackStat[Loop1UInt8].LateCount, CallbackStat[Loop1UInt8].OverrunCount);
+  }
+
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
+
+  return;
+}
+
+
+
+
+
 /* $PAGE */
 /* $TITLE=function_chime_set() */
 /* ============================================================================================================================================================= *\
@@ -6402,7 +7043,7 @@ void function_chime_set(void)
   uart_send(__LINE__, __func__, "Entering function_chime_set()\r");
   uart_send(__LINE__, __func__, "To be completed\r\r\r");
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "function_chime_set() - to be completed.");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "function_chime_set() - to be completed.");
 
   if (DebugBitMask & DEBUG_FLOW) printf("Exiting function_chime_set()\r");
 
@@ -6425,7 +7066,7 @@ void function_countdown_timer(void)
   uart_send(__LINE__, __func__, "Entering function_countdown_timer()\r");
   uart_send(__LINE__, __func__, "To be completed\r\r\r");
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "function_countdown_timer() - to be completed.");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "function_countdown_timer() - to be completed.");
 
   if (DebugBitMask & DEBUG_FLOW) printf("Exiting function_countdown_timer()\r");
 
@@ -6448,7 +7089,7 @@ void function_countup_timer(void)
   uart_send(__LINE__, __func__, "Entering function_countup_timer()\r");
   uart_send(__LINE__, __func__, "To be completed\r\r\r");
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "function_countup_timer() - to be completed.");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "function_countup_timer() - to be completed.");
 
   if (DebugBitMask & DEBUG_FLOW) printf("Exiting function_countup_timer()\r");
 
@@ -6472,7 +7113,7 @@ void function_date_set(void)
 
   win_printf(WIN_SETUP, 1, 99, FONT_5x7, Function[1].Name);
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "function_date_set() - to be completed.");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "function_date_set() - to be completed.");
 
   if (DebugBitMask & DEBUG_FLOW) printf("Exiting function_date_set()\r");
 
@@ -6521,7 +7162,7 @@ void function_display(UINT16 FunctionNumber)
 void function_dst(void)
 {
   /* Scroll current settings for daylight saving time (DST) and timezone. */
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "Daylight Saving Time country: %u   Timezone: %d", FlashConfig1.DSTCountry, FlashConfig1.Timezone);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "Daylight Saving Time country: %u   Timezone: %d", FlashConfig1.DSTCountry, FlashConfig1.Timezone);
 
   return;
 }
@@ -6795,7 +7436,7 @@ void function_event_set(void)
   uart_send(__LINE__, __func__, "Entering function_event_set()\r");
   uart_send(__LINE__, __func__, "To be completed\r\r\r");
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "function_event_set() - to be completed.");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "function_event_set() - to be completed.");
 
   if (DebugBitMask & DEBUG_FLOW) printf("Exiting function_event_set()\r");
 
@@ -6827,7 +7468,7 @@ void function_events_day(void)
     if (FlashConfig1.Event[Loop1UInt16].Month != CurrentTime.Month)  continue;
     ++EventCounter16;
     sprintf(String, "%2.2u-%s: %s   ", FlashConfig1.Event[Loop1UInt16].Day, ShortMonth[FlashConfig1.Event[Loop1UInt16].Month], FlashConfig1.Event[Loop1UInt16].Jingle, FlashConfig1.Event[Loop1UInt16].Message);
-    win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+    win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
   }
 
   switch (EventCounter16)
@@ -6844,7 +7485,7 @@ void function_events_day(void)
       sprintf(String, "%u events defined for today", EventCounter16);
     break;
   }
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
   return;
 }
@@ -6873,7 +7514,7 @@ void function_events_month(void)
     if (FlashConfig1.Event[Loop1UInt16].Month != CurrentTime.Month)  continue;
     ++EventCounter16;
     sprintf(String, "%2.2u-%s: %s   ", FlashConfig1.Event[Loop1UInt16].Day, ShortMonth[FlashConfig1.Event[Loop1UInt16].Month], FlashConfig1.Event[Loop1UInt16].Message);
-    win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+    win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
   }
 
   switch (EventCounter16)
@@ -6890,7 +7531,7 @@ void function_events_month(void)
       sprintf(String, "%u events defined for this month", EventCounter16);
     break;
   }
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
   return;
 }
@@ -6945,7 +7586,7 @@ void function_events_week(void)
 
   /* Scroll the date of the first day of the week (Sunday) that has been found. */
   sprintf(String, "Events of week beginning %s %2.2u-%s-%u", DayName[HumanTime.DayOfWeek], HumanTime.DayOfMonth, ShortMonth[HumanTime.Month], HumanTime.Year);
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
 
 
@@ -6968,7 +7609,7 @@ void function_events_week(void)
         if (DebugBitMask & DEBUG_EVENT) uart_send(__LINE__, __func__, "Match found !\r");
         sprintf(String, "%s %2.2u-%s  %s", DayName[HumanTime.DayOfWeek], FlashConfig1.Event[Loop2UInt16].Day, ShortMonth[FlashConfig1.Event[Loop2UInt16].Month], FlashConfig1.Event[Loop2UInt16].Message);
         ++EventCounter16;  // one more event found.
-        win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+        win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
       }
     }
     if (DebugBitMask & DEBUG_EVENT) printf("\r\r");
@@ -7004,7 +7645,7 @@ void function_events_week(void)
     break;
   }
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
   return;
 }
@@ -7033,7 +7674,7 @@ void function_events_year(void)
     String[0] = 0x00;  // initialize as null string.
     ++EventCounter16;
     sprintf(String, "%2.2u-%s: %s   ", FlashConfig1.Event[Loop1UInt16].Day, ShortMonth[FlashConfig1.Event[Loop1UInt16].Month], FlashConfig1.Event[Loop1UInt16].Message);
-    win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+    win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
   }
 
   switch (EventCounter16)
@@ -7050,7 +7691,7 @@ void function_events_year(void)
       sprintf(String, "%u events defined in the system", EventCounter16);
     break;
   }
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
   return;
 }
@@ -7066,7 +7707,7 @@ void function_events_year(void)
 \* ============================================================================================================================================================= */
 void function_firmware_version(void)
 {
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s %s", $FIRMWARE_VERSION, FIRMWARE_VERSION);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s %s", $FIRMWARE_VERSION, FIRMWARE_VERSION);
 
   return;
 }
@@ -7091,7 +7732,7 @@ void function_free_heap(void)
   /// uart_send(__LINE__, __func__, "First free heap memory chunk: 0x%p\r\r\r", Dum1Ptr);
 
   /* Scroll first free heap memory chunk pointer on WinTop window. */
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "Free heap pointer 0x%p", Dum1Ptr);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "Free heap pointer 0x%p", Dum1Ptr);
 
   return;
 }
@@ -7221,11 +7862,11 @@ void function_idle_time(void)
   UCHAR String[128];
 
 
-  /* Scroll current setting for daylight saving time and timezone. */
-  sprintf(String, "System Idle Time Monitor - to be implemented");
+  /* Scroll main endless loop load averages. */
+  sprintf(String, "Load: %.1f%% (1 min)  %.1f%% (5 min)  %.1f%% (15 min)   Missed seconds: %" PRIu32, LoopStat.Load1Min, LoopStat.Load5Min, LoopStat.Load15Min, LoopStat.MissedSeconds);
 
   /* Scroll the info on WinFunction window. */
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
   return;
 }
@@ -7428,6 +8069,12 @@ void function_init(void)
   sprintf(Function[CounterFunction].Name, $UP_TIME);
   Function[CounterFunction].Pointer = function_up_time;
 
+  ++CounterId;
+  ++CounterFunction;
+  Function[CounterFunction].Id = CounterId;
+  sprintf(Function[CounterFunction].Name, $CALLBACK_STATS);
+  Function[CounterFunction].Pointer = function_callback_stats;
+
 
 
   /* --------------------------------------------------------------------------------------------------------------------------- *\
@@ -7496,10 +8143,10 @@ void function_network_credentials(void)
 
 
 #ifndef NTP_SUPPORT
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "Network not supported in this version of Firmware");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "Network not supported in this version of Firmware");
 #else  // NTP_SUPPORT
   /* Scroll current network credentials (SSID and password) on WinFunction window. */
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "Network credentials - SSID: <%s>   Password: <%s>", FlashConfig1.SSID, FlashConfig1.Password);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "Network credentials - SSID: <%s>   Password: <%s>", FlashConfig1.SSID, FlashConfig1.Password);
 #endif  // NTP_SUPPORT
 
   return;
@@ -7520,7 +8167,7 @@ void function_network_data(void)
 
 
 #ifndef NTP_SUPPORT
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "Network not supported in this version of Firmware");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "Network not supported in this version of Firmware");
 #else  // NTP_SUPPORT
   /* Scroll network health status. */
   if (NTPData.FlagNTPHistory == 0x01)
@@ -7528,7 +8175,7 @@ void function_network_data(void)
   else
     strcpy(String, "Problem");
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "Network health: %s - %lu - %lu - %lu", String, NTPData.NTPErrors, NTPData.NTPReadCycles, NTPData.NTPPollCycles);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "Network health: %s - %lu - %lu - %lu", String, NTPData.NTPErrors, NTPData.NTPReadCycles, NTPData.NTPPollCycles);
 #endif  // NTP_SUPPORT
 
   return;
@@ -7548,12 +8195,12 @@ void function_network_set(void)
   if (DebugBitMask & DEBUG_FLOW) printf("Entering function_network_set()\r");
 
 #ifndef NTP_SUPPORT
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "Network not supported in this version of Firmware");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "Network not supported in this version of Firmware");
 #else  // NTP_SUPPORT
   uart_send(__LINE__, __func__, "Entering function_network_set()\r");
   uart_send(__LINE__, __func__, "To be completed\r\r\r");
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "function_network_set() - to be completed.");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "function_network_set() - to be completed.");
 #endif  // NTP_SUPPORT
   if (DebugBitMask & DEBUG_FLOW) printf("Exiting function_network_set()\r");
 
@@ -7581,7 +8228,7 @@ void function_pico_type(void)
   else
     sprintf(String, "%s PicoW", $PICO_TYPE);
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s   Pico Unique ID:  %s", String, PicoUniqueId);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s   Pico Unique ID:  %s", String, PicoUniqueId);
 
   if (DebugBitMask & DEBUG_FLOW) uart_send(__LINE__, __func__, "Exiting function_pico_type()...\r");  ///
 
@@ -7646,6 +8293,7 @@ void function_police(void)
         FrameBuffer[(MAX_ROWS / 2) + Loop2UInt8] = 0xFFFFFFFFFFFFFFFFll;
       }
     }
+    RGB_matrix_dirty(0, MAX_ROWS - 1);
 
     for (Loop1UInt8 = 0; Loop1UInt8 < Flashes; ++Loop1UInt8)
     {
@@ -7715,7 +8363,7 @@ void function_silence(void)
   sprintf(String, "Silence period - to be implemented");
 
   /* Scroll the info on WinFunction window. */
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
   return;
 }
@@ -7757,7 +8405,7 @@ void function_temperature(void)
     sprintf(&String[strlen(String)], "DS3231 temp: %2.2f", DegreeF);
   }
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
   if (DebugBitMask & DEBUG_FLOW) uart_send(__LINE__, __func__, "Exiting function_temperature()...\r");
 
@@ -8125,7 +8773,7 @@ void function_up_time(void)
   /* Scroll date and time of last power-on. */
   sprintf(String, "RGB Matrix On: %2.2u-%s-%4.4u at %2.2u:%2.2u:%2.2u",
           StartTime.DayOfMonth, ShortMonth[StartTime.Month], StartTime.Year, StartTime.Hour, StartTime.Minute, StartTime.Second);
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
 
 
@@ -8150,7 +8798,7 @@ void function_up_time(void)
 
   sprintf(&String[strlen(String)], "  %u sec", Seconds);
 
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "%s", String);
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", String);
 
   if (DebugBitMask & DEBUG_FLOW) uart_send(__LINE__, __func__, "Exiting function_up_time()...\r");
 
@@ -8939,49 +9587,54 @@ void ir_display_timings(void)
 
 
 
+/* $TITLE=layout_char_width() */
 /* $PAGE */
-/* $TITLE=pilot_set_color() */
 /* ============================================================================================================================================================= *\
-                                                           Set color for endless loop pixel indicators pilot.
+                              Return the pixel width of one character of the specified font type (without the blank column that follows it).
 \* ============================================================================================================================================================= */
-void pilot_set_color(UINT8 Color)
+UINT8 layout_char_width(UINT8 FontType, UINT8 AsciiValue)
 {
-  /* Set color for left and right pixel indicators pilot. */
-  RGB_matrix_set_color(0,  0,  0,  2, Color);  // left part.
-  RGB_matrix_set_color(0, 61,  0, 63, Color);  // right part.
+  switch (FontType)
+  {
+    case (FONT_4x7):
+      if (AsciiValue > 0x7F) AsciiValue = 0;  // only first 128 ASCII characters are defined for 4x7 font.
+      return Font4x7[AsciiValue].Width;
+    break;
 
-  return;
+    case (FONT_5x7):
+    default:
+      return Font5x7[AsciiValue].Width;
+    break;
+
+    case (FONT_8x10):
+      if (AsciiValue > 0x7F) AsciiValue = 0;  // only first 128 ASCII characters are defined for 8x10 font.
+      return Font8x10[AsciiValue].Width;
+    break;
+  }
 }
 
 
 
 
 
+/* $TITLE=layout_init() */
 /* $PAGE */
-/* $TITLE=pilot_toggle() */
 /* ============================================================================================================================================================= *\
-                                                       Toggle endless loop pixel indicators pilot On / Off.
-                                                                      Double-dot pixels:
+                                                                  Initialize the text layout engine.
 \* ============================================================================================================================================================= */
-void pilot_toggle(void)
+void layout_init(void)
 {
-  UINT8 Loop1UInt8;
+  UINT8 EntryNumber;
 
-  static UINT8 FlagPilot;
 
+  if (LayoutLock == NULL) LayoutLock = spin_lock_init(spin_lock_claim_unused(true));
 
-  if (FlagPilot)
-  {
-    /* "Endless loop" pilot indicators are On, turn them Off on top of RGB-Matrix line, left and right. */
-    FrameBuffer[0] &= ~(0xE000000000000007);
-    FlagPilot = FLAG_OFF;
-  }
-  else
-  {
-    /* "Endless loop" pilot indicators are Off, turn them On on top of RGB-Matrix line, left and right. */
-    FrameBuffer[0] |= 0xE000000000000007;
-    FlagPilot = FLAG_ON;
-  }
+  for (EntryNumber = 0; EntryNumber < LAYOUT_CACHE_ENTRIES; ++EntryNumber)
+    LayoutCache[EntryNumber].LastUse = 0;
+
+  LayoutCacheClock  = 0;
+  LayoutCacheHits   = 0;
+  LayoutCacheMisses = 0;
 
   return;
 }
@@ -8990,336 +9643,2291 @@ void pilot_toggle(void)
 
 
 
+/* $TITLE=layout_kerning() */
 /* $PAGE */
-/* $TITLE=process_button() */
 /* ============================================================================================================================================================= *\
-                      Function to process a button-press received either from local RGB matrix buttons and / of from remote control buttons.
+                        Return the spacing adjustment between two consecutive characters of the specified font type (see kerning tables in font.h).
+   NOTES:
+   1) Kerning tables are sorted by left character, so the search stops as soon as a greater left character is found.
 \* ============================================================================================================================================================= */
-void process_button(UINT8 CommandId)
+INT8 layout_kerning(UINT8 FontType, UINT8 Left, UINT8 Right)
 {
-  UCHAR String[31];            // command buffer (just as a security... should not really be required).
-  UCHAR FunctionIdString[31];  // function Id digits components.
+  const struct kerning *Pair;
 
-  UINT8 Counter;          // local counter of buttons (local or remote) received so far.
-  UINT8 DisplayPoint;     // pointer to next character to be displayed on RGB matrix.
-  UINT8 Dum1UInt8;
-  UINT8 FlagFirstPass;    // first pass in while loop.
 
-  UINT16 Dum1UInt16;
-  UINT16 FunctionId;      // function ID entered by user.
-  UINT16 FunctionNumber;  // function number corresponding to the function ID entered by user.
-  UINT16 Loop1UInt16;
+  switch (FontType)
+  {
+    case (FONT_5x7):
+      Pair = Kerning5x7;
+    break;
 
-  UINT32 IdleTime;        // current delay waiting for next button (local or remote).
+    case (FONT_8x10):
+      Pair = Kerning8x10;
+    break;
 
+    default:
+      return 0;  // no kerning table for this font type.
+    break;
+  }
 
-  if (DebugBitMask & DEBUG_FLOW) printf("Entering process_button()\r");
+  for (; (Pair->Left != 0x00) && (Pair->Left <= Left); ++Pair)
+    if ((Pair->Left == Left) && (Pair->Right == Right)) return Pair->Adjust;
 
-  if (DebugBitMask & DEBUG_IR)
-  {
-    printf("\r\r");
-    uart_send(__LINE__, __func__, "Button pressed: <%s>   0x%2.2X\r", ButtonName[CommandId], CommandId);
-  }
+  return 0;
+}
 
 
-  Counter       = 0;
-  FlagFirstPass = FLAG_ON;
-  IdleTime      = 0l;
 
-  do
-  {
-    switch (CommandId)
-    {
-      case (BUTTON_SET):
-        IdleTime = 0l;  // reset idle time when receiving a new button press (local or remote).
 
-        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive function number or "Set" again to execute current function.
-        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
-        CommandId       = BUTTON_NONE;
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Received button <Function / Set>\r");
 
-        if (FlagFirstPass)
-        {
-          FlagFirstPass = FLAG_OFF;
-          if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Turning Off FlagFirstPass\r");
+/* $TITLE=layout_measure() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                  Return the pixel width of the specified string when displayed with the specified font type (kerning included).
+\* ============================================================================================================================================================= */
+UINT16 layout_measure(UINT8 FontType, UCHAR *String)
+{
+  UINT16 Loop1UInt16;
+  UINT16 TotalColumns;
 
-          /* Assign initial function number. */
-          FunctionId     = 200;  // function ID 200 is guaranteed to be defined ("time set").
-          FunctionNumber = get_function_number(FunctionId, String);
-          sprintf(FunctionIdString, "%3.3u", FunctionId);
-          if (DebugBitMask & DEBUG_FUNCTION)
-          {
-            function_display(FunctionNumber);
-            /// uart_send(__LINE__, __func__, "Current Function number: %u     Function ID: %3.3u     Function name: <%s>     Function pointer: %p\r", Number, Function[FunctionNumber].Id, Function[FunctionNumber].Name, Function[FunctionNumber].Pointer);
-          }
 
-          win_open(WIN_FUNCTION, FLAG_OFF);  // explode WIN_FUNCTION window.
+  /* One blank pixel column (kerned) between consecutive characters, none after last character. */
+  TotalColumns = 0;
+  for (Loop1UInt16 = 0; String[Loop1UInt16]; ++Loop1UInt16)
+  {
+    TotalColumns += layout_char_width(FontType, String[Loop1UInt16]);
+    if (String[Loop1UInt16 + 1]) TotalColumns += 1 + layout_kerning(FontType, String[Loop1UInt16], String[Loop1UInt16 + 1]);
+  }
 
-          /* Display function name of current function ID on LED matrix. */
-          win_part_cls(WIN_FUNCTION, 201, 201);
-          if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Before printing function name (length = %u)\r", RGB_matrix_pixel_length(FONT_5x7, "%s", Function[FunctionNumber].Name));
-          win_scroll(WIN_FUNCTION, 201, 201, 1, 1, FONT_5x7, "%s", Function[FunctionNumber].Name);
+  return TotalColumns;
+}
 
-          /* Display header <F-> to prepare reception of the function number. */
-          if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Before displaying function ID\r");
-          win_printf(WIN_FUNCTION, 9, 19, FONT_5x7, "F-%3.3u  ", Function[FunctionNumber].Id);
-        }
-        else
-        {
-          /* User pressed "Function / Set" to enter currently displayed function. */
-          if (DebugBitMask & DEBUG_FUNCTION)
-          {
-            function_display(FunctionNumber);
-            /// uart_send(__LINE__, __func__, "Current FunctionNumber: %u     FunctionId: %3.3u     FunctionName: <%s>     FunctionPointer: %p\r", FunctionNumber, Function[FunctionNumber].FunctionId, Function[FunctionNumber].FunctionName, Function[FunctionNumber].FunctionPointer);
-          }
 
-          /* If there is currently a scroll going on, cancel it and add a few character spaces to introduce new scrolling. */
-          win_scroll_cancel(WIN_FUNCTION, 201, 201);
 
-          /* If we're going to execute a setup function, we'll use a full-matrix window. */
-          if ((Function[FunctionNumber].Id > 0) && (Function[FunctionNumber].Id < 200))
-          {
-            /* This is a setup function, we'll use a "full-matrix window". */
-            win_close(WIN_FUNCTION);
-            win_open(WIN_SETUP, FLAG_OFF);
-          }
 
-          /* Execute this function (jump to function pointer). */
-          Function[FunctionNumber].Pointer();
-          IdleTime = (BUTTON_TIME_OUT * 1000);  // force a time-out to get out of switch and do loop.
-        }
-      break;
 
-      case (IR_0):
-      case (IR_1):
-      case (IR_2):
-      case (IR_3):
-      case (IR_4):
-      case (IR_5):
-      case (IR_6):
-      case (IR_7):
-      case (IR_8):
-      case (IR_9):
-        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+/* $TITLE=layout_print() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                             Display a string that has been laid out by layout_text(). Return the column following the last character displayed.
+   NOTES:
+   1) String must be the same string that has been given to layout_text(). It is cut at the break point found by layout_text().
+\* ============================================================================================================================================================= */
+UINT8 layout_print(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 FontType, UCHAR *String, struct layout *Layout)
+{
+  UCHAR *Ellipsis;
 
-        /* Slide digits one position to the left and make digit just received the last digit of function ID. */
-        if (DebugBitMask & DEBUG_FUNCTION) printf("Function ID before: %u  (%s)\r", FunctionId, FunctionIdString);
-        for (Loop1UInt16 = 0; Loop1UInt16 < (MAX_FUNCTION_DIGITS - 1); ++Loop1UInt16)
-          FunctionIdString[Loop1UInt16] = FunctionIdString[Loop1UInt16 + 1];
-        FunctionIdString[MAX_FUNCTION_DIGITS - 1] = IrBuffer[0] + 36;  // convert IR code received to ASCII digit.
-        FunctionId = atoi(FunctionIdString);      // translate current value of function ID.
-        if (DebugBitMask & DEBUG_IR)
-        {
-          uart_send(__LINE__, __func__, "Function ID after: %u  (%s)\r", FunctionId, FunctionIdString);
-          uart_send(__LINE__, __func__, "Current status of function digits: %u %u %u %u %u\r", FunctionIdString[0], FunctionIdString[1], FunctionIdString[2], FunctionIdString[3], FunctionIdString[4]);
-          uart_send(__LINE__, __func__, "Received digit number %u: IR%u\r", Counter, (IrBuffer[0]));
-          uart_send(__LINE__, __func__, "Received one more function digit: %u  (0x%2.2X)   FunctionId: %u\r", IrBuffer[0], IrBuffer[0], FunctionId);
-        }
+  UINT8 CurrentColumn;
+  UINT8 Loop1UInt8;
+  UINT8 NextChar;
 
-        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
-        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
-        CommandId       = BUTTON_NONE;
-        DisplayPoint = win_printf(WIN_FUNCTION, 9, 19, FONT_5x7, "F-%3.3u  ", FunctionId);
 
-        /* Check if this FunctionId exists. */
-        FunctionNumber = function_search(FunctionId);
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Found next valid function number: %u\r", FunctionNumber);
+  Ellipsis      = (Layout->FlagEllipsis) ? LAYOUT_ELLIPSIS_TEXT : "";
+  CurrentColumn = Layout->Column;
 
-        if (FunctionNumber == MAX_FUNCTIONS)
-        {
-          win_part_cls(WIN_FUNCTION, 201, 201);
-          win_printf(WIN_FUNCTION, 1, 99, FONT_5x7, "Not found");
-        }
-        else
-        {
-          /* Display function name of current function ID on LED matrix. */
-          display_function_name(FunctionId);
-        }
-      break;
+  /* The whole string is presented at once (see RGB_matrix_draw_begin()). */
+  RGB_matrix_draw_begin();
 
-      case (BUTTON_DOWN):
-        /* User pressed the <Down> button (on remote or local button). */
-        IdleTime        = 0l;           // reset idle time when receiving a new button press.
-        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer.
-        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer.
-        CommandId       = BUTTON_NONE;  // reset CommandId.
+  /* Display the characters that fit, followed by the ellipsis if there is one. */
+  for (Loop1UInt8 = 0; Loop1UInt8 < Layout->Length; ++Loop1UInt8)
+  {
+    NextChar      = (Loop1UInt8 + 1 < Layout->Length) ? String[Loop1UInt8 + 1] : Ellipsis[0];
+    CurrentColumn = RGB_matrix_display(DisplayBuffer, StartRow, CurrentColumn, String[Loop1UInt8], FontType, NextChar);
+  }
 
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <BUTTON_DOWN> while choice was function number %u <%s>\r", FunctionNumber, Function[FunctionNumber].Name);
-        Dum1UInt16 = FunctionNumber;  // keep track of where we are in the function stack.
-        do
-        {
-          /* Find previous valid function number and its corresponding ID and Name. */
-          if (FunctionNumber == 0) FunctionNumber = MAX_FUNCTIONS;  // revert to the end of stack when reaching zero.
-          --FunctionNumber;
-          if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Checking FunctionNumber: %3u   FunctionId: %3u\r", FunctionNumber, Function[FunctionNumber].Id);
-          if (FunctionNumber == Dum1UInt16) break;  // we went back to the starting point without finding a valid function ID.
-        } while (Function[FunctionNumber].Id == 0);
+  for (Loop1UInt8 = 0; Ellipsis[Loop1UInt8]; ++Loop1UInt8)
+    CurrentColumn = RGB_matrix_display(DisplayBuffer, StartRow, CurrentColumn, Ellipsis[Loop1UInt8], FontType, Ellipsis[Loop1UInt8 + 1]);
 
+  RGB_matrix_draw_end();
 
-        /* If there is currently a scroll going on, cancel it and add a few character spaces to introduce new scrolling. */
-        win_scroll_cancel(WIN_FUNCTION, 201, 201);
+  return CurrentColumn;
+}
 
-        /* Display function ID on RGB matrix. */
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "FunctionId: %u   FunctionNumber: %u   Dum1UInt16: %u\r", Function[FunctionNumber].Id, FunctionNumber, Dum1UInt16);
-        win_part_cls(WIN_FUNCTION, 201, 201);
-        if ((Function[FunctionNumber].Id == 9999) || (FunctionNumber == Dum1UInt16))
-        {
-          win_printf(WIN_FUNCTION, 1, 99, FONT_5x7, "Not found");
-        }
-        else
-        {
-          /* Display function name and current function ID on LED matrix. */
-          display_function_name(Function[FunctionNumber].Id);
-          win_printf(WIN_FUNCTION, 9, 19, FONT_5x7, "F-%3.3u  ", Function[FunctionNumber].Id);
-        }
-      break;
 
-      case (BUTTON_UP):
-        /* User pressed the <Up> button (on remote or local button). */
-        IdleTime        = 0l;           // reset idle time when receiving a new button press.
-        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer.
-        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer.
-        CommandId       = BUTTON_NONE;
 
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <BUTTON_UP> while choice was function number %u <%s>\r", FunctionNumber, Function[FunctionNumber].Name);
-        Dum1UInt16 = FunctionNumber;  // keep track of where we are in the function stack.
-        do
-        {
-          /* Find next valid function number and its corresponding ID and Name. */
-          ++FunctionNumber;
-          if (FunctionNumber >= MAX_FUNCTIONS) FunctionNumber = 0;  // revert to zero when reaching out-of-bound.
-          if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Checking FunctionNumber: %3u   FunctionId: %3u\r", FunctionNumber, Function[FunctionNumber].Id);
-          if (FunctionNumber == Dum1UInt16) break;  // we went back to the starting point without finding a valid function ID.
-        } while (Function[FunctionNumber].Id == 9999);
 
 
-        /* If there is currently a scroll going on, cancel it and add a few character spaces to introduce new scrolling. */
-        win_scroll_cancel(WIN_FUNCTION, 201, 201);
+/* $TITLE=layout_text() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                             Lay out a string within the specified column range, according to layout flags.
+   NOTES:
+   1) The string is measured once, character by character (kerning included), to find its pixel width and, if it does not fit in the
+      column range, its break point: the number of characters that fit, leaving room for LAYOUT_ELLIPSIS_TEXT when LAYOUT_ELLIPSIS is set.
+   2) Text that fits is aligned as requested. Text that does not fit always begins on the start column.
+   3) The last LAYOUT_CACHE_ENTRIES layouts are kept in LayoutCache, keyed by text, font type, column range and flags, so that text
+      redrawn over and over (date and time redrawn every second) is not measured again. Texts longer than LAYOUT_CACHE_TEXT are not kept.
+   4) Text may be displayed from both cores, so LayoutLock protects LayoutCache. The text is measured outside of the lock.
+\* ============================================================================================================================================================= */
+void layout_text(UINT8 FontType, UCHAR *String, UINT8 StartColumn, UINT8 EndColumn, UINT8 Flags, struct layout *Layout)
+{
+  UCHAR *Text;
 
-        /* Display function ID on RGB matrix. */
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "FunctionId: %u   FunctionNumber: %u   Dum1UInt16: %u\r", Function[FunctionNumber].Id, FunctionNumber, Dum1UInt16);
-        win_part_cls(WIN_FUNCTION, 201, 201);
-        if ((Function[FunctionNumber].Id == 9999) || (FunctionNumber == Dum1UInt16))
-        {
-          win_printf(WIN_FUNCTION, 1, 99, FONT_5x7, "Not found");
-        }
-        else
-        {
-          /* Display function name and current function ID on LED matrix. */
-          display_function_name(Function[FunctionNumber].Id);
-          win_printf(WIN_FUNCTION, 9, 19, FONT_5x7, "F-%3.3u  ", Function[FunctionNumber].Id);
-        }
-      break;
+  UINT8 EllipsisWidth;
+  UINT8 EntryNumber;
+  UINT8 NextChar;
 
-      case (BUTTON_UP_LONG):
-        /* User made a long-press pressed on the Up button, add one minute to service light timer. */
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <BUTTON_UP_LONG_PRESS>\r");
-        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
-        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
-        CommandId       = BUTTON_NONE;
-        if (ServiceLightTimer < 300) ServiceLightTimer += 60;
-        pwm_set_level(PWM_ID_BRIGHTNESS, 1300);  // set RGB Matrix to highest brightness.
-      break;
+  INT16 Advance;
+  INT16 Needed;
+  INT16 Shown;
+  INT16 Width;
 
-      case (IR_EQ):
-        /* Received <Enter> from remote control, execute the decoded function. */
-        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+  UINT16 Length;
+  UINT16 Loop1UInt16;
 
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <IR_ENTER> (EQ)\r");
-        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
-        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
-        CommandId       = BUTTON_NONE;
-        Function[FunctionNumber].Pointer;
-      break;
+  UINT32 Hash;
+  UINT32 InterruptMask;
 
-      case (IR_VOL_MINUS):
-        /* Received <Minus> from remote control. */
-        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+  struct layout_cache *Entry;
 
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <IR_MINUS>\r");
-        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
-        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
-        CommandId       = BUTTON_NONE;
-      break;
 
-      case (IR_VOL_PLUS):
-        /* Received <PLUS> from remote control. */
-        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+  /* FNV-1a hash of the text. */
+  Hash = 2166136261ul;
+  for (Text = String; *Text; ++Text)
+    Hash = (Hash ^ *Text) * 16777619ul;
+  Length = Text - String;
 
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <IR_PLUS>\r");
-        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
-        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
-        CommandId       = BUTTON_NONE;
-      break;
 
-      case (IR_100):
-        /* Received <100+> from remote control. */
-        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+  /* Look for this layout in the layout cache. */
+  InterruptMask = spin_lock_blocking(LayoutLock);
+  ++LayoutCacheClock;
+  for (EntryNumber = 0; EntryNumber < LAYOUT_CACHE_ENTRIES; ++EntryNumber)
+  {
+    Entry = &LayoutCache[EntryNumber];
+    if ((Entry->LastUse != 0) && (Entry->Hash == Hash) && (Entry->FontType == FontType) && (Entry->StartColumn == StartColumn) &&
+        (Entry->EndColumn == EndColumn) && (Entry->Flags == Flags) && (strcmp(Entry->Text, String) == 0))
+    {
+      Entry->LastUse = LayoutCacheClock;
+      *Layout        = Entry->Layout;
+      ++LayoutCacheHits;
+      spin_unlock(LayoutLock, InterruptMask);
 
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <IR_100> (100+)\r");
-        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
-        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
-        CommandId       = BUTTON_NONE;
+      return;
+    }
+  }
+  ++LayoutCacheMisses;
+  spin_unlock(LayoutLock, InterruptMask);
 
-      break;
 
-      case (IR_200):
-        /* Received <200+> from remote control. */
-        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+  /* Not found, measure the text. */
+  Width = (EndColumn >= StartColumn) ? (EndColumn - StartColumn + 1) : 0;
+  Layout->PixelLength  = layout_measure(FontType, String);
+  Layout->Length       = (Length > 0xFF) ? 0xFF : Length;
+  Layout->FlagEllipsis = FLAG_OFF;
+  Layout->FlagOverflow = (Layout->PixelLength > Width) ? FLAG_ON : FLAG_OFF;
+  Shown                = Layout->PixelLength;
 
-        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <IR_200+>\r");
-        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
-        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
-        CommandId       = BUTTON_NONE;
-      break;
+  if (Layout->FlagOverflow)
+  {
+    /* Find the break point. <Advance> is the column (relative to StartColumn) where the current character begins. */
+    EllipsisWidth = (Flags & LAYOUT_ELLIPSIS) ? layout_measure(FontType, LAYOUT_ELLIPSIS_TEXT) : 0;
+    Layout->Length       = 0;
+    Layout->FlagEllipsis = (Flags & LAYOUT_ELLIPSIS) ? FLAG_ON : FLAG_OFF;
+    Shown                = EllipsisWidth;
+    Advance              = 0;
+    for (Loop1UInt16 = 0; (String[Loop1UInt16]) && (Loop1UInt16 < 0xFF); ++Loop1UInt16)
+    {
+      Needed = Advance + layout_char_width(FontType, String[Loop1UInt16]);
+      if (Flags & LAYOUT_ELLIPSIS) Needed += 1 + layout_kerning(FontType, String[Loop1UInt16], LAYOUT_ELLIPSIS_TEXT[0]) + EllipsisWidth;
+      if (Needed > Width) break;
 
-      case (IR_LO_LIMIT):
-        /* No new remote control button received, pause and increment idle time. */
-        sleep_ms(200);
-        IdleTime += 200l;
+      Layout->Length = Loop1UInt16 + 1;
+      Shown          = Needed;
 
-        /***/
-        if (DebugBitMask & DEBUG_IR)
-          if ((IdleTime % 1000l) == 0)
-            uart_send(__LINE__, __func__, "IrBuffer[Counter] is still IR_LO_LIMIT... Increment delay...(%5lu VS %5u)\r", IdleTime, (BUTTON_TIME_OUT * 1000));
-        /// for (Loop1UInt8 = 0; Loop1UInt8 < sizeof(String); ++Loop1UInt8)
-        /// {
-        ///   printf("%2u - [%2.2u] <%c>   ", Loop1UInt8, String[Loop1UInt8], String[Loop1UInt8]);
-        ///   if (((Loop1UInt8 + 1) % 8) == 0) printf("\r");
-        /// }
-        /// printf("\r\r");
-        /***/
-      break;
+      NextChar = String[Loop1UInt16 + 1];
+      Advance += layout_char_width(FontType, String[Loop1UInt16]) + 1 + layout_kerning(FontType, String[Loop1UInt16], NextChar);
     }
+  }
 
-    if (IdleTime >= (BUTTON_TIME_OUT * 1000))
-    {
-      if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Reached IdleTime timeout...%u VS %u\r", IdleTime, (BUTTON_TIME_OUT * 1000));
-      IrBuffer[0] = IR_LO_LIMIT;  // reset IR buffer to receive next data.
 
-      /* Wait until current scroll is complete before closing <Function> window. */
-      while ((Window[WinTop].FlagTopScroll) || (Window[WinMid].FlagMidScroll))
-      {
-        for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ACTIVE_SCROLL; ++Loop1UInt16)
-        {
-          if (ActiveScroll[Loop1UInt16]->Owner == WinTop) Dum1UInt16 = ActiveScroll[Loop1UInt16]->PixelCountCurrent;
-        }
-        if (DebugBitMask & DEBUG_SCROLL) uart_send(__LINE__, __func__, "Waiting for scroll to complete... (%u pixels)\r", Dum1UInt16);
-        sleep_ms(1000);
-      }
+  /* Align the text in the column range. */
+  if ((Layout->FlagOverflow) || ((Flags & LAYOUT_ALIGN) == LAYOUT_LEFT))
+    Layout->Column = StartColumn;
+  else if ((Flags & LAYOUT_ALIGN) == LAYOUT_CENTER)
+    Layout->Column = StartColumn + ((Width - Shown) / 2);
+  else
+    Layout->Column = EndColumn - Shown + 1;
 
-      /* Waited IR_TIMEOUT seconds without receiving the <Enter> button (or time-out forced after function start). */
+  if (DebugBitMask & DEBUG_MATRIX) uart_send(__LINE__, __func__, "Layout of <%s>: %u pixels, %u characters from column %u (range %u to %u)\r", String, Layout->PixelLength, Layout->Length, Layout->Column, StartColumn, EndColumn);
+
+
+  /* Keep this layout in the least recently used entry if the text is short enough. */
+  if (Length < LAYOUT_CACHE_TEXT)
+  {
+    InterruptMask = spin_lock_blocking(LayoutLock);
+
+    Entry = &LayoutCache[0];
+    for (EntryNumber = 1; EntryNumber < LAYOUT_CACHE_ENTRIES; ++EntryNumber)
+      if (LayoutCache[EntryNumber].LastUse < Entry->LastUse) Entry = &LayoutCache[EntryNumber];
+
+    Entry->Hash        = Hash;
+    Entry->LastUse     = LayoutCacheClock;
+    Entry->FontType    = FontType;
+    Entry->StartColumn = StartColumn;
+    Entry->EndColumn   = EndColumn;
+    Entry->Flags       = Flags;
+    Entry->Layout      = *Layout;
+    strcpy(Entry->Text, String);
+
+    spin_unlock(LayoutLock, InterruptMask);
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=loop_event_get() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                           Retrieve the oldest event posted to the main endless loop. Return FLAG_OFF if there is none.
+                         NOTE: The main endless loop is the only consumer, so no lock is required on this side.
+\* ============================================================================================================================================================= */
+UINT8 loop_event_get(struct loop_event *Event)
+{
+  if (ring_get(&QueueLoopEvent, Event) == FLAG_OFF)
+  {
+    Event->Type = LOOP_EVENT_NONE;
+
+    return FLAG_OFF;
+  }
+
+  return FLAG_ON;
+}
+
+
+
+
+
+/* $TITLE=loop_event_post() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                Post a wakeup event to the main endless loop. May be called from interrupt handlers and callbacks.
+                         NOTE: If the queue is full, the event is dropped (and counted in QueueLoopEvent.Overflow), but the main loop is still
+                               awakened. Nothing is lost, since events carry no data: the main loop checks the terminal and the button buffers.
+\* ============================================================================================================================================================= */
+void loop_event_post(UINT8 Type)
+{
+  UINT32 InterruptMask;
+
+  struct loop_event Event;
+
+
+  Event.Type = Type;
+
+  /* Events may be posted from different interrupt priorities and from both cores. The spin lock makes them a single producer. */
+  InterruptMask = spin_lock_blocking(LoopEventLock);
+  ring_put(&QueueLoopEvent, &Event);
+  spin_unlock(LoopEventLock, InterruptMask);
+
+  /* Wake up main endless loop if it is waiting in loop_event_wait() (__sev() also reaches the other core). */
+  __sev();
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=loop_event_wait() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                Put the processor to sleep until an event is posted to the main endless loop or until the given deadline is reached.
+                         NOTE: __wfe() also returns on every interrupt (matrix scan, callbacks), so the condition is simply checked again.
+\* ============================================================================================================================================================= */
+void loop_event_wait(UINT64 Deadline)
+{
+  while ((ring_count(&QueueLoopEvent) == 0) && (time_us_64() < Deadline))
+    __wfe();
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=loop_stats_reset() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                       Reset busy / idle statistics of the main endless loop, including periodic tasks runtime statistics.
+\* ============================================================================================================================================================= */
+void loop_stats_reset(void)
+{
+  memset(&LoopStat, 0x00, sizeof(LoopStat));
+  task_stats_reset();
+  LoopStatStart = time_us_64();
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=loop_stats_update() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                               Accumulate busy and idle times of one main loop iteration and update the load averages at the end of each sampling window.
+                         NOTES:
+                         1) Idle time is the time spent sleeping in loop_event_wait() at the end of each iteration. Everything
+                            else (including blocking waits inside the timesteps) is considered busy time.
+                         2) Load averages are exponentially decayed averages of the load of each sampling window, the same way Unix load averages
+                            are computed. With a one-second window, they represent roughly the last 1, 5 and 15 minutes.
+\* ============================================================================================================================================================= */
+void loop_stats_update(UINT32 BusyUSec, UINT32 IdleUSec)
+{
+  ++LoopStat.Iterations;
+  if (BusyUSec > LoopStat.MaxIterationUSec) LoopStat.MaxIterationUSec = BusyUSec;
+
+  /* An iteration kept busy for more than one second made the 1-second timestep miss at least one second. */
+  LoopStat.MissedSeconds += (BusyUSec / 1000000l);
+
+  LoopStat.TotalBusyUSec  += BusyUSec;
+  LoopStat.TotalIdleUSec  += IdleUSec;
+  LoopStat.WindowBusyUSec += BusyUSec;
+  LoopStat.WindowIdleUSec += IdleUSec;
+
+  if ((LoopStat.WindowBusyUSec + LoopStat.WindowIdleUSec) < LOOP_WINDOW_USEC) return;
+
+  LoopStat.LoadLast = (LoopStat.WindowBusyUSec * 100.0) / (LoopStat.WindowBusyUSec + LoopStat.WindowIdleUSec);
+
+  /* Load averages are initialized with the first window to prevent a long ramp-up from zero. */
+  if (LoopStat.TotalBusyUSec == LoopStat.WindowBusyUSec)
+  {
+    LoopStat.Load1Min  = LoopStat.LoadLast;
+    LoopStat.Load5Min  = LoopStat.LoadLast;
+    LoopStat.Load15Min = LoopStat.LoadLast;
+  }
+  else
+  {
+    LoopStat.Load1Min  += (LoopStat.LoadLast - LoopStat.Load1Min)  / 60.0;
+    LoopStat.Load5Min  += (LoopStat.LoadLast - LoopStat.Load5Min)  / 300.0;
+    LoopStat.Load15Min += (LoopStat.LoadLast - LoopStat.Load15Min) / 900.0;
+  }
+
+  LoopStat.WindowBusyUSec = 0l;
+  LoopStat.WindowIdleUSec = 0l;
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=pilot_set_color() */
+/* ============================================================================================================================================================= *\
+                                                           Set color for endless loop pixel indicators pilot.
+\* ============================================================================================================================================================= */
+void pilot_set_color(UINT8 Color)
+{
+  /* Set color for left and right pixel indicators pilot. */
+  RGB_matrix_set_color(0,  0,  0,  2, Color);  // left part.
+  RGB_matrix_set_color(0, 61,  0, 63, Color);  // right part.
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=pilot_toggle() */
+/* ============================================================================================================================================================= *\
+                                                       Toggle endless loop pixel indicators pilot On / Off.
+                                                                      Double-dot pixels:
+\* ============================================================================================================================================================= */
+void pilot_toggle(void)
+{
+  UINT8 Loop1UInt8;
+
+  static UINT8 FlagPilot;
+
+
+  if (FlagPilot)
+  {
+    /* "Endless loop" pilot indicators are On, turn them Off on top of RGB-Matrix line, left and right. */
+    FrameBuffer[0] &= ~(0xE000000000000007);
+    FlagPilot = FLAG_OFF;
+  }
+  else
+  {
+    /* "Endless loop" pilot indicators are Off, turn them On on top of RGB-Matrix line, left and right. */
+    FrameBuffer[0] |= 0xE000000000000007;
+    FlagPilot = FLAG_ON;
+  }
+  RGB_matrix_dirty(0, 0);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=process_button() */
+/* ============================================================================================================================================================= *\
+                      Function to process a button-press received either from local RGB matrix buttons and / of from remote control buttons.
+\* ============================================================================================================================================================= */
+void process_button(UINT8 CommandId)
+{
+  UCHAR String[31];            // command buffer (just as a security... should not really be required).
+  UCHAR FunctionIdString[31];  // function Id digits components.
+
+  UINT8 Counter;          // local counter of buttons (local or remote) received so far.
+  UINT8 DisplayPoint;     // pointer to next character to be displayed on RGB matrix.
+  UINT8 Dum1UInt8;
+  UINT8 FlagFirstPass;    // first pass in while loop.
+
+  UINT16 Dum1UInt16;
+  UINT16 FunctionId;      // function ID entered by user.
+  UINT16 FunctionNumber;  // function number corresponding to the function ID entered by user.
+  UINT16 Loop1UInt16;
+
+  UINT32 IdleTime;        // current delay waiting for next button (local or remote).
+
+
+  if (DebugBitMask & DEBUG_FLOW) printf("Entering process_button()\r");
+
+  if (DebugBitMask & DEBUG_IR)
+  {
+    printf("\r\r");
+    uart_send(__LINE__, __func__, "Button pressed: <%s>   0x%2.2X\r", ButtonName[CommandId], CommandId);
+  }
+
+
+  Counter       = 0;
+  FlagFirstPass = FLAG_ON;
+  IdleTime      = 0l;
+
+  do
+  {
+    switch (CommandId)
+    {
+      case (BUTTON_SET):
+        IdleTime = 0l;  // reset idle time when receiving a new button press (local or remote).
+
+        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive function number or "Set" again to execute current function.
+        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
+        CommandId       = BUTTON_NONE;
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Received button <Function / Set>\r");
+
+        if (FlagFirstPass)
+        {
+          FlagFirstPass = FLAG_OFF;
+          if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Turning Off FlagFirstPass\r");
+
+          /* Assign initial function number. */
+          FunctionId     = 200;  // function ID 200 is guaranteed to be defined ("time set").
+          FunctionNumber = get_function_number(FunctionId, String);
+          sprintf(FunctionIdString, "%3.3u", FunctionId);
+          if (DebugBitMask & DEBUG_FUNCTION)
+          {
+            function_display(FunctionNumber);
+            /// uart_send(__LINE__, __func__, "Current Function number: %u     Function ID: %3.3u     Function name: <%s>     Function pointer: %p\r", Number, Function[FunctionNumber].Id, Function[FunctionNumber].Name, Function[FunctionNumber].Pointer);
+          }
+
+          win_open(WIN_FUNCTION, FLAG_OFF);  // explode WIN_FUNCTION window.
+
+          /* Display function name of current function ID on LED matrix. */
+          win_part_cls(WIN_FUNCTION, 201, 201);
+          if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Before printing function name (length = %u)\r", RGB_matrix_pixel_length(FONT_5x7, "%s", Function[FunctionNumber].Name));
+          win_scroll(WIN_FUNCTION, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", Function[FunctionNumber].Name);
+
+          /* Display header <F-> to prepare reception of the function number. */
+          if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Before displaying function ID\r");
+          win_printf(WIN_FUNCTION, 9, 19, FONT_5x7, "F-%3.3u  ", Function[FunctionNumber].Id);
+        }
+        else
+        {
+          /* User pressed "Function / Set" to enter currently displayed function. */
+          if (DebugBitMask & DEBUG_FUNCTION)
+          {
+            function_display(FunctionNumber);
+            /// uart_send(__LINE__, __func__, "Current FunctionNumber: %u     FunctionId: %3.3u     FunctionName: <%s>     FunctionPointer: %p\r", FunctionNumber, Function[FunctionNumber].FunctionId, Function[FunctionNumber].FunctionName, Function[FunctionNumber].FunctionPointer);
+          }
+
+          /* If there is currently a scroll going on, cancel it and add a few character spaces to introduce new scrolling. */
+          win_scroll_cancel(WIN_FUNCTION, 201, 201);
+
+          /* If we're going to execute a setup function, we'll use a full-matrix window. */
+          if ((Function[FunctionNumber].Id > 0) && (Function[FunctionNumber].Id < 200))
+          {
+            /* This is a setup function, we'll use a "full-matrix window". */
+            win_close(WIN_FUNCTION);
+            win_open(WIN_SETUP, FLAG_OFF);
+          }
+
+          /* Execute this function (jump to function pointer). */
+          Function[FunctionNumber].Pointer();
+          IdleTime = (BUTTON_TIME_OUT * 1000);  // force a time-out to get out of switch and do loop.
+        }
+      break;
+
+      case (IR_0):
+      case (IR_1):
+      case (IR_2):
+      case (IR_3):
+      case (IR_4):
+      case (IR_5):
+      case (IR_6):
+      case (IR_7):
+      case (IR_8):
+      case (IR_9):
+        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+
+        /* Slide digits one position to the left and make digit just received the last digit of function ID. */
+        if (DebugBitMask & DEBUG_FUNCTION) printf("Function ID before: %u  (%s)\r", FunctionId, FunctionIdString);
+        for (Loop1UInt16 = 0; Loop1UInt16 < (MAX_FUNCTION_DIGITS - 1); ++Loop1UInt16)
+          FunctionIdString[Loop1UInt16] = FunctionIdString[Loop1UInt16 + 1];
+        FunctionIdString[MAX_FUNCTION_DIGITS - 1] = IrBuffer[0] + 36;  // convert IR code received to ASCII digit.
+        FunctionId = atoi(FunctionIdString);      // translate current value of function ID.
+        if (DebugBitMask & DEBUG_IR)
+        {
+          uart_send(__LINE__, __func__, "Function ID after: %u  (%s)\r", FunctionId, FunctionIdString);
+          uart_send(__LINE__, __func__, "Current status of function digits: %u %u %u %u %u\r", FunctionIdString[0], FunctionIdString[1], FunctionIdString[2], FunctionIdString[3], FunctionIdString[4]);
+          uart_send(__LINE__, __func__, "Received digit number %u: IR%u\r", Counter, (IrBuffer[0]));
+          uart_send(__LINE__, __func__, "Received one more function digit: %u  (0x%2.2X)   FunctionId: %u\r", IrBuffer[0], IrBuffer[0], FunctionId);
+        }
+
+        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
+        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
+        CommandId       = BUTTON_NONE;
+        DisplayPoint = win_printf(WIN_FUNCTION, 9, 19, FONT_5x7, "F-%3.3u  ", FunctionId);
+
+        /* Check if this FunctionId exists. */
+        FunctionNumber = function_search(FunctionId);
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Found next valid function number: %u\r", FunctionNumber);
+
+        if (FunctionNumber == MAX_FUNCTIONS)
+        {
+          win_part_cls(WIN_FUNCTION, 201, 201);
+          win_printf(WIN_FUNCTION, 1, 99, FONT_5x7, "Not found");
+        }
+        else
+        {
+          /* Display function name of current function ID on LED matrix. */
+          display_function_name(FunctionId);
+        }
+      break;
+
+      case (BUTTON_DOWN):
+        /* User pressed the <Down> button (on remote or local button). */
+        IdleTime        = 0l;           // reset idle time when receiving a new button press.
+        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer.
+        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer.
+        CommandId       = BUTTON_NONE;  // reset CommandId.
+
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <BUTTON_DOWN> while choice was function number %u <%s>\r", FunctionNumber, Function[FunctionNumber].Name);
+        Dum1UInt16 = FunctionNumber;  // keep track of where we are in the function stack.
+        do
+        {
+          /* Find previous valid function number and its corresponding ID and Name. */
+          if (FunctionNumber == 0) FunctionNumber = MAX_FUNCTIONS;  // revert to the end of stack when reaching zero.
+          --FunctionNumber;
+          if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Checking FunctionNumber: %3u   FunctionId: %3u\r", FunctionNumber, Function[FunctionNumber].Id);
+          if (FunctionNumber == Dum1UInt16) break;  // we went back to the starting point without finding a valid function ID.
+        } while (Function[FunctionNumber].Id == 0);
+
+
+        /* If there is currently a scroll going on, cancel it and add a few character spaces to introduce new scrolling. */
+        win_scroll_cancel(WIN_FUNCTION, 201, 201);
+
+        /* Display function ID on RGB matrix. */
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "FunctionId: %u   FunctionNumber: %u   Dum1UInt16: %u\r", Function[FunctionNumber].Id, FunctionNumber, Dum1UInt16);
+        win_part_cls(WIN_FUNCTION, 201, 201);
+        if ((Function[FunctionNumber].Id == 9999) || (FunctionNumber == Dum1UInt16))
+        {
+          win_printf(WIN_FUNCTION, 1, 99, FONT_5x7, "Not found");
+        }
+        else
+        {
+          /* Display function name and current function ID on LED matrix. */
+          display_function_name(Function[FunctionNumber].Id);
+          win_printf(WIN_FUNCTION, 9, 19, FONT_5x7, "F-%3.3u  ", Function[FunctionNumber].Id);
+        }
+      break;
+
+      case (BUTTON_UP):
+        /* User pressed the <Up> button (on remote or local button). */
+        IdleTime        = 0l;           // reset idle time when receiving a new button press.
+        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer.
+        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer.
+        CommandId       = BUTTON_NONE;
+
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <BUTTON_UP> while choice was function number %u <%s>\r", FunctionNumber, Function[FunctionNumber].Name);
+        Dum1UInt16 = FunctionNumber;  // keep track of where we are in the function stack.
+        do
+        {
+          /* Find next valid function number and its corresponding ID and Name. */
+          ++FunctionNumber;
+          if (FunctionNumber >= MAX_FUNCTIONS) FunctionNumber = 0;  // revert to zero when reaching out-of-bound.
+          if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Checking FunctionNumber: %3u   FunctionId: %3u\r", FunctionNumber, Function[FunctionNumber].Id);
+          if (FunctionNumber == Dum1UInt16) break;  // we went back to the starting point without finding a valid function ID.
+        } while (Function[FunctionNumber].Id == 9999);
+
+
+        /* If there is currently a scroll going on, cancel it and add a few character spaces to introduce new scrolling. */
+        win_scroll_cancel(WIN_FUNCTION, 201, 201);
+
+        /* Display function ID on RGB matrix. */
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "FunctionId: %u   FunctionNumber: %u   Dum1UInt16: %u\r", Function[FunctionNumber].Id, FunctionNumber, Dum1UInt16);
+        win_part_cls(WIN_FUNCTION, 201, 201);
+        if ((Function[FunctionNumber].Id == 9999) || (FunctionNumber == Dum1UInt16))
+        {
+          win_printf(WIN_FUNCTION, 1, 99, FONT_5x7, "Not found");
+        }
+        else
+        {
+          /* Display function name and current function ID on LED matrix. */
+          display_function_name(Function[FunctionNumber].Id);
+          win_printf(WIN_FUNCTION, 9, 19, FONT_5x7, "F-%3.3u  ", Function[FunctionNumber].Id);
+        }
+      break;
+
+      case (BUTTON_UP_LONG):
+        /* User made a long-press pressed on the Up button, add one minute to service light timer. */
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <BUTTON_UP_LONG_PRESS>\r");
+        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
+        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
+        CommandId       = BUTTON_NONE;
+        if (ServiceLightTimer < 300) ServiceLightTimer += 60;
+        pwm_set_level(PWM_ID_BRIGHTNESS, 1300);  // set RGB Matrix to highest brightness.
+      break;
+
+      case (IR_EQ):
+        /* Received <Enter> from remote control, execute the decoded function. */
+        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <IR_ENTER> (EQ)\r");
+        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
+        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
+        CommandId       = BUTTON_NONE;
+        Function[FunctionNumber].Pointer;
+      break;
+
+      case (IR_VOL_MINUS):
+        /* Received <Minus> from remote control. */
+        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <IR_MINUS>\r");
+        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
+        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
+        CommandId       = BUTTON_NONE;
+      break;
+
+      case (IR_VOL_PLUS):
+        /* Received <PLUS> from remote control. */
+        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <IR_PLUS>\r");
+        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
+        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
+        CommandId       = BUTTON_NONE;
+      break;
+
+      case (IR_100):
+        /* Received <100+> from remote control. */
+        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <IR_100> (100+)\r");
+        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
+        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
+        CommandId       = BUTTON_NONE;
+
+      break;
+
+      case (IR_200):
+        /* Received <200+> from remote control. */
+        IdleTime = 0l;  // reset idle time when receiving a new infrared data stream.
+
+        if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "User pressed <IR_200+>\r");
+        IrBuffer[0]     = BUTTON_NONE;  // reset IR buffer to receive next data.
+        ButtonBuffer[0] = BUTTON_NONE;  // reset local button buffer to prepare for next button press.
+        CommandId       = BUTTON_NONE;
+      break;
+
+      case (IR_LO_LIMIT):
+        /* No new remote control button received, pause and increment idle time. */
+        sleep_ms(200);
+        IdleTime += 200l;
+
+        /***/
+        if (DebugBitMask & DEBUG_IR)
+          if ((IdleTime % 1000l) == 0)
+            uart_send(__LINE__, __func__, "IrBuffer[Counter] is still IR_LO_LIMIT... Increment delay...(%5lu VS %5u)\r", IdleTime, (BUTTON_TIME_OUT * 1000));
+        /// for (Loop1UInt8 = 0; Loop1UInt8 < sizeof(String); ++Loop1UInt8)
+        /// {
+        ///   printf("%2u - [%2.2u] <%c>   ", Loop1UInt8, String[Loop1UInt8], String[Loop1UInt8]);
+        ///   if (((Loop1UInt8 + 1) % 8) == 0) printf("\r");
+        /// }
+        /// printf("\r\r");
+        /***/
+      break;
+    }
+
+    if (IdleTime >= (BUTTON_TIME_OUT * 1000))
+    {
+      if (DebugBitMask & DEBUG_IR) uart_send(__LINE__, __func__, "Reached IdleTime timeout...%u VS %u\r", IdleTime, (BUTTON_TIME_OUT * 1000));
+      IrBuffer[0] = IR_LO_LIMIT;  // reset IR buffer to receive next data.
+
+      /* Wait until current scroll is complete before closing <Function> window. */
+      while ((Window[WinTop].FlagTopScroll) || (Window[WinMid].FlagMidScroll))
+      {
+        for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ACTIVE_SCROLL; ++Loop1UInt16)
+        {
+          if (ActiveScroll[Loop1UInt16]->Owner == WinTop) Dum1UInt16 = ActiveScroll[Loop1UInt16]->PixelCountCurrent;
+        }
+        if (DebugBitMask & DEBUG_SCROLL) uart_send(__LINE__, __func__, "Waiting for scroll to complete... (%u pixels)\r", Dum1UInt16);
+        sleep_ms(1000);
+      }
+
+      /* Waited IR_TIMEOUT seconds without receiving the <Enter> button (or time-out forced after function start). */
       win_close(WIN_FUNCTION);
 
-      break;
-    }
+      break;
+    }
+
+    /* Check if we received another command either from remote control, either from local buttons. */
+    if (IrBuffer[0]     != BUTTON_NONE) CommandId = IrBuffer[0];
+    if (ButtonBuffer[0] != BUTTON_NONE) CommandId = ButtonBuffer[0];
+  } while (IdleTime < (BUTTON_TIME_OUT * 1000));
+
+  if (DebugBitMask & DEBUG_FLOW) printf("Exiting process_button()\r");
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=isr_signal_trap() */
+/* ============================================================================================================================================================= *\
+                                                      Interrupt handler for signal received from remote control.
+\* ============================================================================================================================================================= */
+gpio_irq_callback_t isr_signal_trap(UINT8 gpio, UINT32 Events)
+{
+  static UINT32 ButtonSetOnTime;
+  static UINT32 ButtonDownOnTime;
+  static UINT32 ButtonUpOnTime;
+  static UINT32 Dum1UInt32;
+
+  UINT8 ButtonCode;
+
+
+  /* Handle interrupts from infrared sensor. */
+  if (gpio == IR_RX)
+  {
+    /* Check if interrupt is generated by the GPIO line changing from High to Low (38 kHz infrared burst changing from Off to On). */
+    if (Events & GPIO_IRQ_EDGE_FALL)
+    {
+      /* This is the beginning of a 38kHz infrared burst. */
+      if (IrStepCount > 0)
+      {
+        /* If this is not the first infrared burst for this data stream, keep track of timing information of the previous silent period length and pulse distance. */
+        IrFinalValue[IrStepCount]  =  time_us_64();                                                      // this is the final timer value for the ending "silence"
+        IrResultValue[IrStepCount] = (UINT32)(IrFinalValue[IrStepCount] - IrInitialValue[IrStepCount]);  // calculate duration of the ending "silence" period.
+        IrLevel[IrStepCount]       = 1;                                                                  // ending period is a logical High level.
+
+        /* Calculate the Pulse distance of the previous pulse that is ending now (Pulse distance = length of infrared burst + length of the "silence" period that follows). */
+        IrPulseDistance[IrStepCount] = IrResultValue[IrStepCount - 1] + IrResultValue[IrStepCount];
+
+        ++IrStepCount;  // start next logic level.
+      }
+      else
+      {
+        IrIndicator = 2;  // LED indicator on RGB matrix indicating we received an IR burst. */
+
+        /* Turn On infrared LED indicators on RGB matrix when the infrared data stream begins. */
+        RGB_matrix_set_pixel(FrameBuffer, IR_INDICATOR_START_ROW, IR_INDICATOR_START_COLUMN, IR_INDICATOR_END_ROW, IR_INDICATOR_END_COLUMN);
+        RGB_matrix_set_color(IR_INDICATOR_START_ROW, IR_INDICATOR_START_COLUMN, IR_INDICATOR_END_ROW, IR_INDICATOR_END_COLUMN, BLUE);
+      }
+
+      IrInitialValue[IrStepCount] = time_us_64();  // this is also start timer of next Low level.
+
+      gpio_acknowledge_irq(IR_RX, GPIO_IRQ_EDGE_FALL);
+    }
+
+
+    /* Check if interrupt is generated by the GPIO line changing from Low to High (38kHz infrared burst changing from On to Off). */
+    if (Events & GPIO_IRQ_EDGE_RISE)
+    {
+      /* This is the end of a 38kHz infrared burst, the beginning of the "silence" period. */
+      IrFinalValue[IrStepCount]  = time_us_64();                                                       // this is the final timer value for the ending infrared burst.
+      IrResultValue[IrStepCount] = (UINT32)(IrFinalValue[IrStepCount] - IrInitialValue[IrStepCount]);  // calculate duration of the ending infrared burst.
+      IrLevel[IrStepCount]       = 0;                                                                  // ending period is a logical Low level.
+      ++IrStepCount;                                                                                   // go on to next logic level.
+
+      /* Keep track of timer value at the beginning of this "silence" period. */
+      IrInitialValue[IrStepCount] = time_us_64();                                                       // this is also start timer of next High level.
+
+      gpio_acknowledge_irq(IR_RX, GPIO_IRQ_EDGE_RISE);
+    }
+  }
+
+
+
+  /* Handle interrupts from RGB matrix <Set> buttons */
+  if (gpio == BUTTON_SET_GPIO)
+  {
+    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
+    if (Events & GPIO_IRQ_EDGE_FALL)
+    {
+      /* This is the beginning of the <Set> button press. */
+      ButtonSetOnTime = time_us_32();
+      gpio_acknowledge_irq(BUTTON_SET_GPIO, GPIO_IRQ_EDGE_FALL);
+    }
+
+
+    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
+    if (Events & GPIO_IRQ_EDGE_RISE)
+    {
+      /* This is the end of the <Set> button press. */
+      gpio_acknowledge_irq(BUTTON_SET_GPIO, GPIO_IRQ_EDGE_RISE);
+
+      /* Determine if this <Set> button press is a quick press ("normal") or long press. */
+      Dum1UInt32 = time_us_32();
+      if ((Dum1UInt32 - ButtonSetOnTime) > BUTTON_LONG_PRESS_TIME)
+      {
+        ButtonCode = BUTTON_SET_LONG;
+        if (DebugBitMask & DEBUG_FUNCTION)
+        {
+          printf("\r");
+          uart_send(__LINE__, __func__, "Button <Set>  On time: %10lu     Button <Set>  Off time: %10lu     Button <Set>  long press length: %8lu\r", ButtonSetOnTime, Dum1UInt32, (Dum1UInt32 - ButtonSetOnTime));
+        }
+      }
+      else
+      {
+        ButtonCode = BUTTON_SET;
+        if (DebugBitMask & DEBUG_FUNCTION)
+        {
+          printf("\r");
+          uart_send(__LINE__, __func__, "Button <Set>  On time: %10lu     Button <Set>  Off time: %10lu     Button <Set>  quick press length: %8lu\r", ButtonSetOnTime, Dum1UInt32, (Dum1UInt32 - ButtonSetOnTime));
+        }
+      }
+
+      ButtonSetOnTime = 0l;  // reset button press On time.
+
+      /* Queue this button press and wake up main endless loop to process it. */
+      ring_put(&ButtonRing, &ButtonCode);
+      button_deliver();
+
+      /* Button audible feedback. */
+      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
+        queue_add_active(50, 1);
+    }
+  }
+
+
+
+  /* Handle interrupts from RGB matrix <Down> button. */
+  if (gpio == BUTTON_DOWN_GPIO)
+  {
+    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
+    if (Events & GPIO_IRQ_EDGE_FALL)
+    {
+      /* This is the beginning of the <Down> button press. */
+      ButtonDownOnTime = time_us_32();
+      gpio_acknowledge_irq(BUTTON_DOWN_GPIO, GPIO_IRQ_EDGE_FALL);
+    }
+
+
+    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
+    if (Events & GPIO_IRQ_EDGE_RISE)
+    {
+      /* This is the end of the <Down> button press. */
+      gpio_acknowledge_irq(BUTTON_DOWN_GPIO, GPIO_IRQ_EDGE_RISE);
+
+      /* Determine if this <Down> button press is a quick press ("normal") or long press. */
+      Dum1UInt32 = time_us_32();
+      if ((Dum1UInt32 - ButtonDownOnTime) > BUTTON_LONG_PRESS_TIME)
+      {
+        ButtonCode = BUTTON_DOWN_LONG;
+        if (DebugBitMask & DEBUG_FUNCTION)
+        {
+          printf("\r");
+          uart_send(__LINE__, __func__, "Button <Down> On time: %10lu     Button <Down> Off time: %10lu     Button <Down> long press length: %8lu\r", ButtonDownOnTime, Dum1UInt32, (Dum1UInt32 - ButtonDownOnTime));
+        }
+      }
+      else
+      {
+        ButtonCode = BUTTON_DOWN;
+        if (DebugBitMask & DEBUG_FUNCTION)
+        {
+          printf("\r");
+          uart_send(__LINE__, __func__, "Button <Down> On time: %10lu     Button <Down> Off time: %10lu     Button <Down> quick press length: %8lu\r", ButtonDownOnTime, Dum1UInt32, (Dum1UInt32 - ButtonDownOnTime));
+        }
+      }
+
+      ButtonDownOnTime = 0l;
+
+      /* Queue this button press and wake up main endless loop to process it. */
+      ring_put(&ButtonRing, &ButtonCode);
+      button_deliver();
+
+      /* Button audible feedback. */
+      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
+        queue_add_active(50, 1);
+    }
+  }
+
+
+
+  /* Handle interrupts from RGB matrix <Up> button. */
+  if (gpio == BUTTON_UP_GPIO)
+  {
+    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
+    if (Events & GPIO_IRQ_EDGE_FALL)
+    {
+      /* This is the beginning of a <Up> button press. */
+      ButtonUpOnTime = time_us_32();
+      gpio_acknowledge_irq(BUTTON_UP_GPIO, GPIO_IRQ_EDGE_FALL);
+    }
+
+
+    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
+    if (Events & GPIO_IRQ_EDGE_RISE)
+    {
+      /* This is the end of the <Up> button press. */
+      gpio_acknowledge_irq(BUTTON_UP_GPIO, GPIO_IRQ_EDGE_RISE);
+
+      /* Determine if this <Up> button press is a quick press ("normal") or long press. */
+      Dum1UInt32 = time_us_32();
+      if ((Dum1UInt32 - ButtonUpOnTime) > BUTTON_LONG_PRESS_TIME)
+      {
+        ButtonCode = BUTTON_UP_LONG;
+        if (DebugBitMask & DEBUG_FUNCTION)
+        {
+          printf("\r");
+          uart_send(__LINE__, __func__, "Button <Up>   On time: %10lu     Button <Up>   Off time: %10lu     Button <Up>   long press length: %8lu\r", ButtonUpOnTime, Dum1UInt32, (Dum1UInt32 - ButtonUpOnTime));
+        }
+      }
+      else
+      {
+        ButtonCode = BUTTON_UP;
+        if (DebugBitMask & DEBUG_FUNCTION)
+        {
+          printf("\r");
+          uart_send(__LINE__, __func__, "Button <Up>   On time: %10lu     Button <Up>   Off time: %10lu     Button <Up>   quick press length: %8lu\r", ButtonUpOnTime, Dum1UInt32, (Dum1UInt32 - ButtonUpOnTime));
+        }
+      }
+
+      ButtonUpOnTime = 0l;
+
+      /* Queue this button press and wake up main endless loop to process it. */
+      ring_put(&ButtonRing, &ButtonCode);
+      button_deliver();
+
+      /* Button audible feedback. */
+      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
+        queue_add_active(50, 1);
+    }
+  }
+}
+
+
+
+
+
+#if 0
+/* $PAGE */
+/* $TITLE=isr_signal_trap() */
+/* ============================================================================================================================================================= *\
+                                                      Interrupt handler for signal received from remote control.
+\* ============================================================================================================================================================= */
+void isr_signal_trap(void)
+{
+  static UINT32 ButtonSetOnTime;
+  static UINT32 ButtonDownOnTime;
+  static UINT32 ButtonUpOnTime;
+  static UINT32 Dum1UInt32;
+
+
+  /* Handle interrupts from infrared sensor. */
+  /* Check if interrupt is generated by the GPIO line changing from High to Low (38 kHz infrared burst changing from Off to On). */
+  if (gpio_get_irq_event_mask(IR_RX) & GPIO_IRQ_EDGE_FALL)
+  {
+    /* This is the beginning of a 38kHz infrared burst. */
+    if (IrStepCount > 0)
+    {
+      /* If this is not the first infrared burst for this data stream, keep track of timing information of the previous silent period length and pulse distance. */
+      IrFinalValue[IrStepCount]  =  time_us_64();                                                      // this is the final timer value for the ending "silence"
+      IrResultValue[IrStepCount] = (UINT32)(IrFinalValue[IrStepCount] - IrInitialValue[IrStepCount]);  // calculate duration of the ending "silence" period.
+      IrLevel[IrStepCount]       = 1;                                                                  // ending period is a logical High level.
+
+      /* Calculate the Pulse distance of the previous pulse that is ending now (Pulse distance = length of infrared burst + length of the "silence" period that follows). */
+      IrPulseDistance[IrStepCount] = IrResultValue[IrStepCount - 1] + IrResultValue[IrStepCount];
+
+      ++IrStepCount;  // start next logic level.
+    }
+    else
+    {
+      IrIndicator = 2;  // LED indicator on RGB matrix indicating we received an IR burst. */
+
+      /* Turn On infrared LED indicators on RGB matrix when the infrared data stream begins. */
+      RGB_matrix_set_pixel(FrameBuffer, IR_INDICATOR_START_ROW, IR_INDICATOR_START_COLUMN, IR_INDICATOR_END_ROW, IR_INDICATOR_END_COLUMN);
+      RGB_matrix_set_color(IR_INDICATOR_START_ROW, IR_INDICATOR_START_COLUMN, IR_INDICATOR_END_ROW, IR_INDICATOR_END_COLUMN, BLUE);
+    }
+
+    IrInitialValue[IrStepCount] = time_us_64();  // this is also start timer of next Low level.
+
+    gpio_acknowledge_irq(IR_RX, GPIO_IRQ_EDGE_FALL);
+  }
+
+
+  /* Check if interrupt is generated by the GPIO line changing from Low to High (38kHz infrared burst changing from On to Off). */
+  if (gpio_get_irq_event_mask(IR_RX) & GPIO_IRQ_EDGE_FALL)
+  {
+    /* This is the end of a 38kHz infrared burst, the beginning of the "silence" period. */
+    IrFinalValue[IrStepCount]  = time_us_64();                                                       // this is the final timer value for the ending infrared burst.
+    IrResultValue[IrStepCount] = (UINT32)(IrFinalValue[IrStepCount] - IrInitialValue[IrStepCount]);  // calculate duration of the ending infrared burst.
+    IrLevel[IrStepCount]       = 0;                                                                  // ending period is a logical Low level.
+    ++IrStepCount;                                                                                   // go on to next logic level.
+
+    /* Keep track of timer value at the beginning of this "silence" period. */
+    IrInitialValue[IrStepCount] = time_us_64();                                                       // this is also start timer of next High level.
+
+    gpio_acknowledge_irq(IR_RX, GPIO_IRQ_EDGE_RISE);
+  }
+
+
+
+  /* Handle interrupts from RGB matrix <Set> buttons */
+  if (gpio == BUTTON_SET_GPIO)
+  {
+    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
+    if (Events & GPIO_IRQ_EDGE_FALL)
+    {
+      /* This is the beginning of the <Set> button press. */
+      ButtonSetOnTime = time_us_32();
+      gpio_acknowledge_irq(BUTTON_SET_GPIO, GPIO_IRQ_EDGE_FALL);
+    }
+
+
+    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
+    if (Events & GPIO_IRQ_EDGE_RISE)
+    {
+      /* This is the end of the <Set> button press. */
+      gpio_acknowledge_irq(BUTTON_SET_GPIO, GPIO_IRQ_EDGE_RISE);
+
+      /* Determine if this <Set> button press is a quick press ("normal") or long press. */
+      Dum1UInt32 = time_us_32();
+      if ((Dum1UInt32 - ButtonSetOnTime) > BUTTON_LONG_PRESS_TIME)
+      {
+        ButtonBuffer[0] = BUTTON_SET_LONG;
+        if (DebugBitMask & DEBUG_FUNCTION)
+        {
+          printf("\r");
+          uart_send(__LINE__, __func__, "Button <Set> On  time: %10lu     Button <Set> Off time: %10lu     Button <Set> long press length: %8lu\r", ButtonSetOnTime, Dum1UInt32, (Dum1UInt32 - ButtonSetOnTime));
+        }
+      }
+      else
+      {
+        ButtonBuffer[0] = BUTTON_SET;
+        if (DebugBitMask & DEBUG_FUNCTION)
+        {
+          printf("\r");
+          uart_send(__LINE__, __func__, "Button <Set> On  time: %10lu     Button <Set> Off time: %10lu     Button <Set> quick press length: %8lu\r", ButtonSetOnTime, Dum1UInt32, (Dum1UInt32 - ButtonSetOnTime));
+        }
+      }
+
+      ButtonSetOnTime = 0l;  // reset button press On time.
+
+      /* Button audible feedback. */
+      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
+        queue_add_active(50, 1);
+    }
+  }
+
+
+
+  /* Handle interrupts from RGB matrix <Down> button. */
+  if (gpio == BUTTON_DOWN_GPIO)
+  {
+    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
+    if (Events & GPIO_IRQ_EDGE_FALL)
+    {
+      /* This is the beginning of the <Down> button press. */
+      ButtonDownOnTime = time_us_32();
+      gpio_acknowledge_irq(BUTTON_DOWN_GPIO, GPIO_IRQ_EDGE_FALL);
+    }
+
+
+    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
+    if (Events & GPIO_IRQ_EDGE_RISE)
+    {
+      /* This is the end of the <Down> button press. */
+      gpio_acknowledge_irq(BUTTON_DOWN_GPIO, GPIO_IRQ_EDGE_RISE);
+
+      /* Determine if this <Down> button press is a quick press ("normal") or long press. */
+      Dum1UInt32 = time_us_32();
+      if ((Dum1UInt32 - ButtonDownOnTime) > BUTTON_LONG_PRESS_TIME)
+      {
+        ButtonBuffer[0] = BUTTON_DOWN_LONG;
+        printf("\r");
+        uart_send(__LINE__, __func__, "Button <Down> On  time: %10lu     Button <Down> Off time: %10lu     Button <Down> long press length: %8lu\r", ButtonDownOnTime, Dum1UInt32, (Dum1UInt32 - ButtonDownOnTime));
+      }
+      else
+      {
+        ButtonBuffer[0] = BUTTON_DOWN;
+        printf("\r");
+        uart_send(__LINE__, __func__, "Button <Down> On  time: %10lu     Button <Down> Off time: %10lu     Button <Down> quick press length: %8lu\r", ButtonDownOnTime, Dum1UInt32, (Dum1UInt32 - ButtonDownOnTime));
+      }
+
+      ButtonDownOnTime = 0l;
+
+      /* Button audible feedback. */
+      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
+        queue_add_active(50, 1);
+    }
+  }
+
+
+
+  /* Handle interrupts from RGB matrix <Up> button. */
+  if (gpio == BUTTON_UP_GPIO)
+  {
+    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
+    if (Events & GPIO_IRQ_EDGE_FALL)
+    {
+      /* This is the beginning of a <Up> button press. */
+      ButtonUpOnTime = time_us_32();
+      gpio_acknowledge_irq(BUTTON_UP_GPIO, GPIO_IRQ_EDGE_FALL);
+    }
+
+
+    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
+    if (Events & GPIO_IRQ_EDGE_RISE)
+    {
+      /* This is the end of the <Up> button press. */
+      gpio_acknowledge_irq(BUTTON_UP_GPIO, GPIO_IRQ_EDGE_RISE);
+
+      /* Determine if this <Up> button press is a quick press ("normal") or long press. */
+      Dum1UInt32 = time_us_32();
+      if ((Dum1UInt32 - ButtonUpOnTime) > BUTTON_LONG_PRESS_TIME)
+      {
+        ButtonBuffer[0] = BUTTON_UP_LONG;
+        printf("\r");
+        uart_send(__LINE__, __func__, "Button <Up> On  time: %10lu     Button <Up> Off time: %10lu     Button <Up> long press length: %8lu\r", ButtonUpOnTime, Dum1UInt32, (Dum1UInt32 - ButtonUpOnTime));
+      }
+      else
+      {
+        ButtonBuffer[0] = BUTTON_UP;
+        printf("\r");
+        uart_send(__LINE__, __func__, "Button <Up> On  time: %10lu     Button <Up> Off time: %10lu     Button <Up> quick press length: %8lu\r", ButtonUpOnTime, Dum1UInt32, (Dum1UInt32 - ButtonUpOnTime));
+      }
+
+      ButtonUpOnTime = 0l;
+
+      /* Button audible feedback. */
+      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
+        queue_add_active(50, 1);
+    }
+  }
+}
+#endif  // 0
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=process_function() */
+/* ============================================================================================================================================================= *\
+                                                                 Process a function number.
+\* ============================================================================================================================================================= */
+void process_function(UINT16 FunctionNumber)
+{
+  if (DebugBitMask & DEBUG_FLOW) printf("Entering process_function()\r");
+
+  uart_send(__LINE__, __func__, "Entering process_function()\r\r");
+
+  if (DebugBitMask & DEBUG_FLOW) printf("Exiting process_function()\r");
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=pwm_display_parameters() */
+/* ============================================================================================================================================================= *\
+                                            Display PWM parameters for all PWM signals used in the RGB Matrix project.
+\* ============================================================================================================================================================= */
+void pwm_display_parameters(void)
+{
+  UINT8 Loop1UInt8;
+
+
+  if (DebugBitMask & DEBUG_FLOW) printf("Entering pwm_display_parameters\r");
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < PWM_ID_HI_LIMIT; ++Loop1UInt8)
+  {
+    switch (Loop1UInt8)
+    {
+      case (PWM_ID_BRIGHTNESS):
+        uart_send(__LINE__, __func__, "PWM for brightness control (PWM ID: %u)\r", PWM_ID_BRIGHTNESS);
+      break;
+
+      default:
+        uart_send(__LINE__, __func__, "Undefined PWM (number %u)\r", Loop1UInt8);
+      break;
+    }
+
+    uart_send(__LINE__, __func__, "SystemClock:    %lu\r",    clock_get_hz(clk_sys));
+    uart_send(__LINE__, __func__, "PWM ID:         %u\r",     Loop1UInt8);
+    uart_send(__LINE__, __func__, "GPIO:           %u\r",     Pwm[Loop1UInt8].Gpio);
+    uart_send(__LINE__, __func__, "Slice:          %u\r",     Pwm[Loop1UInt8].Slice);
+    uart_send(__LINE__, __func__, "Channel:        %u\r",     Pwm[Loop1UInt8].Channel);
+    uart_send(__LINE__, __func__, "ClockDivider:   %f\r",     Pwm[Loop1UInt8].ClockDivider);
+    uart_send(__LINE__, __func__, "Clock:          %lu\r",    Pwm[Loop1UInt8].Clock);
+    uart_send(__LINE__, __func__, "Frequency:      %lu\r",    Pwm[Loop1UInt8].Frequency);
+    uart_send(__LINE__, __func__, "Wrap:           %u\r",     Pwm[Loop1UInt8].Wrap);
+    // uart_send(__LINE__, __func__, "DutyCycle:      %u\r",     Pwm[Loop1UInt8].DutyCycle);
+    uart_send(__LINE__, __func__, "Level:          %u\r\r\r", Pwm[Loop1UInt8].Level);
+  }
+
+  if (DebugBitMask & DEBUG_FLOW) printf("Exiting pwm_display_parameters()\r");
+
+  return;
+}
+
+
+
+
+/* $PAGE */
+/* $TITLE=pwm_initialize() */
+/* ============================================================================================================================================================= *\
+                                                                            Initialize PWM:
+                                                                    For display matrix brightness.
+\* ============================================================================================================================================================= */
+void pwm_initialize(void)
+{
+  UCHAR String[128];
+
+  UINT8 Loop1UInt8;
+
+  UINT32 SystemClock;
+
+
+  if (DebugBitMask & DEBUG_PWM) printf("Entering pwm_initialize()\r");
+
+  /* Retrieve system clock (Pico is 125 MHz). */
+  SystemClock = clock_get_hz(clk_sys);
+
+
+  /* Initialize all GPIOs requiring PWM. */
+  for (Loop1UInt8 = PWM_ID_LO_LIMIT; Loop1UInt8 < PWM_ID_HI_LIMIT; ++Loop1UInt8)
+  {
+    /* Initialize the specified GPIO as a PWM output. */
+    gpio_init(Pwm[Loop1UInt8].Gpio);
+    gpio_set_function(Pwm[Loop1UInt8].Gpio, GPIO_FUNC_PWM);
+
+    /* Get PWM slice number for this PWM, depending on which GPIO it is connected to (for RGB Matrix, OE = GPIO 13 = Slice 6). */
+    Pwm[Loop1UInt8].Slice = pwm_gpio_to_slice_num(Pwm[Loop1UInt8].Gpio);
+
+    /* Get PWM channel number for this PWM, depending on which GPIO it is connected to (for RGB Matrix, OE = GPIO 13 = Channel 1). */
+    Pwm[Loop1UInt8].Channel = pwm_gpio_to_channel(Pwm[Loop1UInt8].Gpio);
+
+
+    /* For passive buzzer, slow down the 125 MHz system clock to get a PWM clock that is more flexible to reach lower frequencies for audio sounds with the counter / wrap. */
+    Pwm[Loop1UInt8].ClockDivider = SystemClock / 100000000.0;  // ClockDivider will be 1.25000, ending up with a 100 MHz clock.
+    Pwm[Loop1UInt8].Clock        = (UINT32)(SystemClock / Pwm[Loop1UInt8].ClockDivider);  // keep track of resulting clock value.
+    pwm_set_clkdiv(Pwm[Loop1UInt8].Slice, Pwm[Loop1UInt8].ClockDivider);  // slow down the clock for this PWM slice.
+
+
+    /* Complete initialization specific with each PWM. */
+    switch (Loop1UInt8)
+    {
+      case (PWM_ID_BRIGHTNESS):
+        /* Set current values in PWM structure. */
+        Pwm[Loop1UInt8].Frequency = 50000;
+        Pwm[Loop1UInt8].Wrap      = (UINT16)(Pwm[Loop1UInt8].Clock / (Pwm[Loop1UInt8].Frequency - 1));  // counter will wrap around to provide the wanted frequency.
+        Pwm[Loop1UInt8].DutyCycle = 0;  // set duty cycle at 0% (blank) on entry, during power-up sequence.
+        Pwm[Loop1UInt8].Level     = (UINT16)(Pwm[Loop1UInt8].Wrap * ((100 - Pwm[Loop1UInt8].DutyCycle) / 100.0));  // since OE is active low, reverse the duty cycle.
+
+        CLK_HIGH;
+
+        /* Set PWM frequency by setting a counter wrap value. */
+        pwm_set_wrap(Pwm[Loop1UInt8].Slice, Pwm[Loop1UInt8].Wrap);
+
+        /* Set PWM duty cycle given the Divider, Counter and Frequency current values. */
+        pwm_set_chan_level(Pwm[Loop1UInt8].Slice, Pwm[Loop1UInt8].Channel, Pwm[Loop1UInt8].Level);
+
+        /* Start PWM. */
+        pwm_set_enabled(Pwm[Loop1UInt8].Slice, TRUE);
+
+        CLK_LOW;
+      break;
+    }
+  }
+
+  if (DebugBitMask & DEBUG_PWM) printf("Exiting pwm_initialize()\r");
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=pwm_on_off() */
+/* ============================================================================================================================================================= *\
+                                                       Turn On or Off the PWM signal specified in argument.
+\* ============================================================================================================================================================= */
+void pwm_on_off(UINT8 PwmNumber, UINT8 FlagSwitch)
+{
+  UCHAR String[256];
+
+
+  if (DebugBitMask & DEBUG_FLOW) printf("Entering pwm_on_off()\r");
+
+  Pwm[PwmNumber].OnOff = FlagSwitch;
+
+  if (Pwm[PwmNumber].OnOff == FLAG_ON)
+  {
+    /* Turn On PWM signal. */
+    /// uart_send(__LINE__, __func__, "Turning On  PWM signal %u  Slice: %u\r", PwmNumber, Pwm[PwmNumber].Slice);
+    pwm_set_enabled(Pwm[PwmNumber].Slice, TRUE);
+  }
+  else
+  {
+    /* Turn Off PWM signal. */
+    /// uart_send(__LINE__, __func__, "Turning Off PWM signal %u  Slice: %u\r", PwmNumber, Pwm[PwmNumber].Slice);
+    pwm_set_enabled(Pwm[PwmNumber].Slice, FALSE);
+  }
+
+  if (DebugBitMask & DEBUG_FLOW) printf("Exiting pwm_on_off()\r");
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=pwm_set_duty_cycle() */
+/* ============================================================================================================================================================= *\
+                                             Set the duty cycle for the PWM controlling the display matrix brightness.
+                            NOTES:
+                            Duty cycle is given as a percentage. For example, a value of "50" means 50% for duty cycle
+                            Since "Output Enable" (OE) is active low, a duty cycle of 75% means that PWM signal means that PWM line must be "Low@
+                            for 25% of its time. So, we have to reverse the value sent to the Pico.
+\* ============================================================================================================================================================= */
+void pwm_set_duty_cycle(UINT8 DutyCycle)
+{
+  UINT8 Loop1UInt8;
+
+
+  /* Validate value specified for duty cycle. */
+  if (DutyCycle > 99) DutyCycle = 99;
+
+  /* Compute the PWM Level required to have the desired duty cycle. */
+  Pwm[PWM_ID_BRIGHTNESS].Level = (UINT16)(Pwm[PWM_ID_BRIGHTNESS].Wrap * ((100 - DutyCycle) / 100.0));
+
+  CLK_HIGH;
+
+  /* Set PWM duty cycle given the Divider, Counter and Frequency current values. */
+  pwm_set_chan_level(Pwm[PWM_ID_BRIGHTNESS].Slice, Pwm[PWM_ID_BRIGHTNESS].Channel, Pwm[PWM_ID_BRIGHTNESS].Level);
+
+  /* Set new values in PWM structure. */
+  Pwm[PWM_ID_BRIGHTNESS].DutyCycle = DutyCycle;
+
+  CLK_LOW;
+
+#ifdef PIO_SCAN_SUPPORT
+  /* OE is driven by the PIO scan engine, which applies brightness through its row control words. */
+  RGB_matrix_pio_row_control();
+#endif  // PIO_SCAN_SUPPORT
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=pwm_set_frequency() */
+/* ============================================================================================================================================================= *\
+                                                          Set the frequency for the specified PWM.
+\* ============================================================================================================================================================= */
+void pwm_set_frequency(UINT8 PwmNumber, UINT32 Frequency)
+{
+  /* Indicate current PWM values. */
+  Pwm[PwmNumber].Frequency = Frequency;
+  Pwm[PwmNumber].Wrap      = (UINT16)(Pwm[PwmNumber].Clock / Pwm[PwmNumber].Frequency);
+
+  /* Set PWM frequency by setting a counter wrap value. */
+  pwm_set_wrap(Pwm[PwmNumber].Slice, Pwm[PwmNumber].Wrap);
+
+  /* Since we change the frequency, adjust duty cycle accordingly. */
+  Pwm[PwmNumber].Level = (UINT16)(Pwm[PwmNumber].Wrap * (Pwm[PwmNumber].DutyCycle / 100.0));
+
+  /* Set PWM duty cycle given the Divider, Counter and Frequency current values. */
+  pwm_set_chan_level(Pwm[PwmNumber].Slice, Pwm[PwmNumber].Channel, Pwm[PwmNumber].Level);
+
+  return;
+}
+
+
+
+
+/* $PAGE */
+/* $TITLE=pwm_set_level() */
+/* ============================================================================================================================================================= *\
+                                                          Set the PWM "Level" for the specified PWM.
+\* ============================================================================================================================================================= */
+void pwm_set_level(UINT8 PwmNumber, UINT16 Level)
+{
+  /* Validation of Level value given in argument. */
+  if (Level < PWM_LO_LIMIT) Level = PWM_LO_LIMIT;
+  if (Level > PWM_HI_LIMIT) Level = PWM_HI_LIMIT;
+
+  /* Indicate current PWM values. */
+  Pwm[PwmNumber].Level = Level;
+
+  /* Set PWM level. */
+  CLK_HIGH;
+  pwm_set_chan_level(Pwm[PwmNumber].Slice, Pwm[PwmNumber].Channel, Pwm[PwmNumber].Level);
+  CLK_LOW;
+
+#ifdef PIO_SCAN_SUPPORT
+  /* OE is driven by the PIO scan engine, which applies brightness through its row control words. */
+  if (PwmNumber == PWM_ID_BRIGHTNESS) RGB_matrix_pio_row_control();
+#endif  // PIO_SCAN_SUPPORT
+
+  return;
+}
+
+
+
+
+/* $TITLE=queue_add_active() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                        Queue the given sound in the active buzzer sound queue. Return MAX_ACTIVE_SOUND_QUEUE if the queue is full.
+                    NOTE: The sound queue belongs to core 1. When called on core 0, the sound is forwarded to core 1 through the core-to-core channel.
+\* ============================================================================================================================================================= */
+UINT16 queue_add_active(UINT16 MSeconds, UINT16 RepeatCount)
+{
+  struct queue_active_sound_element Sound;
+
+
+  if (get_core_num() == 0)
+  {
+    if (core_channel_put(CORE_CMD_SOUND, MSeconds, RepeatCount) == FLAG_OFF) return MAX_ACTIVE_SOUND_QUEUE;
+
+    return 0;
+  }
+
+
+  Sound.MSec        = MSeconds;
+  Sound.RepeatCount = RepeatCount;
+
+  /* Check if the active buzzer sound queue is full. */
+  if (ring_put(&QueueActiveSound, &Sound) == FLAG_OFF)
+  {
+    /* Sound queue is full, return error code. */
+    return MAX_ACTIVE_SOUND_QUEUE;
+  }
+
+  if (DebugBitMask & DEBUG_SOUND_QUEUE)
+    uart_send(__LINE__, __func__, "- A-Queueing:            %5u   %5u\r", MSeconds, RepeatCount);
+
+  return 0;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=queue_free_active() */
+/* ============================================================================================================================================================= *\
+                                                    Return the number of free slots in active sound queue.
+                         NOTE: Sounds still in transit from core 0 in CoreChannel are accounted for, as if they were already queued.
+\* ============================================================================================================================================================= */
+UINT8 queue_free_active(void)
+{
+  UINT16 RemainingSlots;
+
+
+  RemainingSlots = MAX_ACTIVE_SOUND_QUEUE - ring_count(&QueueActiveSound);
+  if (RemainingSlots > ring_count(&CoreChannel))
+    RemainingSlots -= ring_count(&CoreChannel);
+  else
+    RemainingSlots = 0;
+
+  if (DebugBitMask & DEBUG_SOUND_QUEUE)
+    uart_send(__LINE__, __func__, "Active queue remaining space: %5u  Head: %5u  Tail: %5u\r", RemainingSlots, QueueActiveSound.Head, QueueActiveSound.Tail);
+
+  return RemainingSlots;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=queue_remove_active() */
+/* ============================================================================================================================================================= *\
+                                                    Unqueue next sound from the active buzzer sound queue.
+\* ============================================================================================================================================================= */
+UINT8 queue_remove_active(UINT16 *MSeconds, UINT16 *RepeatCount)
+{
+  struct queue_active_sound_element Sound;
+
+
+  /* Check if active sound queue is empty. */
+  if (ring_get(&QueueActiveSound, &Sound) == FLAG_OFF)
+  {
+    /* In case of empty queue or queue error, return 0 as milliseconds and repeat count. */
+    *MSeconds    = 0;
+    *RepeatCount = 0;
+
+    return 0xFF;
+  }
+
+  if (DebugBitMask & DEBUG_SOUND_QUEUE)
+    uart_send(__LINE__, __func__, "- A-NotEmpty:            %5u   %5u\r", QueueActiveSound.Head, QueueActiveSound.Tail);
+
+  if ((Sound.MSec != 0) && (Sound.RepeatCount <= 100))
+  {
+    /* The sound found in this slot is valid. */
+    *MSeconds    = Sound.MSec;
+    *RepeatCount = Sound.RepeatCount;
+
+    return 0;
+  }
+
+
+  /* Sound in this slot was invalid. */
+  if (DebugBitMask & DEBUG_SOUND_QUEUE)
+  {
+    uart_send(__LINE__, __func__, "- A-Invalid slot: %5u\r", QueueActiveSound.Tail - 1);
+    uart_send(__LINE__, __func__, "- MSec: %3u   RepeatCount: %3u\r", Sound.MSec, Sound.RepeatCount);
+  }
+
+  /* In case of empty queue or queue error, return 0 as milliseconds and repeat count. */
+  *MSeconds    = 0;
+  *RepeatCount = 0;
+
+  /* Clean all active sound queue. */
+  while (ring_get(&QueueActiveSound, &Sound) == FLAG_ON);
+
+  if (DebugBitMask & DEBUG_SOUND_QUEUE)
+    uart_send(__LINE__, __func__, "- A-Done:                %5u   %5u\r", QueueActiveSound.Head, QueueActiveSound.Tail);
+
+  return 0xFF;
+}
+
+
+
+
+
+/* $TITLE=reminder1_check() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                            Scan all reminders1 to find those that must be triggered.
+\* ============================================================================================================================================================= */
+void reminder1_check(void)
+{
+#ifdef RELEASE_VERSION
+  UINT8 FlagLocalDebug = FLAG_OFF;  // should be OFF all times
+#else  // RELEASE_VERSION
+  UINT8 FlagLocalDebug = FLAG_ON;
+#endif  // RELEASE_VERSION
+
+  UCHAR String[31];
+
+  UINT8 TotalActiveReminders;
+
+  UINT16 Loop1UInt16;
+
+  time_t UnixTime;
+
+
+  /// if (FlagLocalDebug) printf("Entering reminder1_check()\r");
+
+  /* Initialize total number of active reminders. */
+  TotalActiveReminders = 0;
+
+
+  /* Find current Unix time. */
+  UnixTime = convert_human_to_unix(&CurrentTime, FLAG_ON);
+
+  /* Scan all reminders to find those matching current time and day-of-week. */
+  for (Loop1UInt16 = 0; Loop1UInt16 < MAX_REMINDERS1; ++Loop1UInt16)
+  {
+    if (FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime >= UnixTime)
+    {
+      if ((Reminder1BitMask & (0x01ll << Loop1UInt16)) == 0)
+      {
+        /* This reminder1 was inactive and becomes active. */
+        if (FlagLocalDebug) uart_send(__LINE__, __func__, "Reminder1 %u becomes active\r", Loop1UInt16 + 1);
+        Reminder1BitMask |= (0x01ll << Loop1UInt16);
+        continue;
+      }
+      else
+      {
+        /* This reminder1 was already active. */
+        if (FlagLocalDebug) uart_send(__LINE__, __func__, "Reminder1 %u already active\r", Loop1UInt16 + 1);
+      }
+    }
+    else
+    {
+      /* Display reminder1 status for debug purpose. */
+      /// if (FlagLocalDebug) uart_send(__LINE__, __func__, "Reminder1 inactive\r", Loop1UInt16 + 1);
+    }
+  }
+
+
+  /// if (FlagLocalDebug) printf("Exiting reminder1_check()\r");
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=reminder1_ring() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                     Feed reminder1 ringer for currently active ("triggered") reminders1.
+\* ============================================================================================================================================================= */
+void reminder1_ring(void)
+{
+#ifdef RELEASE_VERSION
+  UINT8 FlagLocalDebug = FLAG_OFF;  // should be OFF all times
+#else  // RELEASE_VERSION
+  UINT8 FlagLocalDebug = FLAG_OFF;
+#endif  // RELEASE_VERSION
+
+  UINT16 Loop1UInt16;
+
+  UINT32 CurrentTimer;
+
+
+  /// if (FlagLocalDebug) printf("Entering reminder1_ring()\r");
+
+  /* When a reminder1 becomes active, reminder_check() will raise its bit in Reminder1BitMask. */
+  if (Reminder1BitMask)
+  {
+    /* If some reminders are active, we'll need current timer to evaluate if it is time to feed ringer. */
+    CurrentTimer = time_us_32();
+
+    /* Scan reminders1 to find those requiring ringer repeat. */
+    for (Loop1UInt16 = 0; Loop1UInt16 < MAX_REMINDERS1; ++Loop1UInt16)
+    {
+      /* Check if this reminder1 is active (global ring duration). */
+      if (ActiveReminder1[Loop1UInt16].CountDown > 0)
+      {
+        /* Display details for first active reminder1 number for debug purpose. */
+        if (FlagLocalDebug) uart_send(__LINE__, __func__, "0x%llX - %u - %3u - %3u - %9lu - %9lu - %4u\r", Reminder1BitMask, Loop1UInt16, FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime, ActiveReminder1[Loop1UInt16].CountDown, CurrentTimer, ActiveReminder1[Loop1UInt16].PreviousTimer, (UINT16)((CurrentTimer - ActiveReminder1[Loop1UInt16].PreviousTimer) / 1000000ll));
+
+        if (((CurrentTimer - ActiveReminder1[Loop1UInt16].PreviousTimer) / 1000000ll) >= FlashConfig2.Reminder1[Loop1UInt16].RingRepeatTimeSeconds)
+        {
+          if (FlagLocalDebug) uart_send(__LINE__, __func__, "1) %4u - %3u", (UINT16)((CurrentTimer - ActiveReminder1[Loop1UInt16].PreviousTimer) / 1000000ll), FlashConfig2.Reminder1[Loop1UInt16].RingRepeatTimeSeconds);
+          /* It is time to feed this ringer and repeat the scroll. */
+          queue_add_active(150, 4);
+          queue_add_active(2000, SILENT);
+          win_scroll(WIN_DATE, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "%s", FlashConfig2.Reminder1[Loop1UInt16].Message);
+
+
+          if (FlashConfig2.Reminder1[Loop1UInt16].RingRepeatTimeSeconds > ActiveReminder1[Loop1UInt16].CountDown)
+          {
+            /* Next ring would be beyond the global ringing period, reset it after current ring above. */
+            ActiveReminder1[Loop1UInt16].CountDown     = 0;
+            ActiveReminder1[Loop1UInt16].PreviousTimer = 0l;
+            Reminder1BitMask &= ~(0x01ll << Loop1UInt16);  // turn Off this reminder1 number in the bitmask of active reminders1.
+          }
+          else
+          {
+            ActiveReminder1[Loop1UInt16].CountDown -= FlashConfig2.Reminder1[Loop1UInt16].RingRepeatTimeSeconds;  // "FlashConfig2.Reminder1[Loop1UInt16].RingRepeatTimeSecond" seconds have elapsed since last pass.
+            if (ActiveReminder1[Loop1UInt16].CountDown > 0)
+            {
+              /* There are more rings to come. */
+              ActiveReminder1[Loop1UInt16].PreviousTimer = CurrentTimer;
+            }
+            else
+            {
+              /* This alarm is over now. */
+              ActiveReminder1[Loop1UInt16].PreviousTimer = 0l;
+              Reminder1BitMask &= ~(0x01ll << Loop1UInt16);  // turn Off this reminder1 number in the bitmask of active reminders1.
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /// if (FlagLocalDebug) printf("Exiting reminder1_ring()\r");
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=reminder1_update() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                               Check / update reminders of type 1.
+\* ============================================================================================================================================================= */
+void reminder1_update(void)
+{
+  UCHAR String[65];
+
+  UINT16 Loop1UInt16;
+
+  time_t UnixTime;
+
+  struct human_time HumanTime;
+  struct tm TempTime;
+
+
+  ds3231_get_time(&HumanTime);
+  UnixTime = convert_human_to_unix(&HumanTime, FLAG_ON);
+  convert_unix_time(UnixTime, &TempTime, &HumanTime, FLAG_ON);
+
+  if (DebugBitMask & DEBUG_REMINDER)
+  {
+    display_human_time("Current human time used to update reminders: \r\r", &HumanTime);
+    printf("\r");
+    uart_send(__LINE__, __func__, "Current UnixTime: %12llu\r\r", UnixTime);
+  }
+
+  for (Loop1UInt16 = 0; Loop1UInt16 < MAX_REMINDERS1; ++Loop1UInt16)
+  {
+    if (DebugBitMask & DEBUG_REMINDER)
+    {
+      uart_send(__LINE__, __func__, "Verifying Reminder number %2u     StartPeriod: %12llu   EndPeriod: %12llu\r",
+                Loop1UInt16 + 1, FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime, FlashConfig2.Reminder1[Loop1UInt16].EndPeriodUnixTime);
+      sleep_ms(50);  // prevent communication override.
+    }
+
+
+    /* Check if this reminder is initialized. */
+    if (FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime == 0ll)
+    {
+      if (DebugBitMask & DEBUG_REMINDER) printf("\r");
+      continue;
+    }
+
+    /* Check if this reminder is over now. */
+    if (UnixTime > FlashConfig2.Reminder1[Loop1UInt16].EndPeriodUnixTime)
+    {
+      if (DebugBitMask & DEBUG_REMINDER) uart_send(__LINE__, __func__, "Reminder %2u is over, adding NextReminderDelaySeconds %12llu\r", Loop1UInt16 + 1, FlashConfig2.Reminder1[Loop1UInt16].NextReminderDelaySeconds);
+      FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime += FlashConfig2.Reminder1[Loop1UInt16].NextReminderDelaySeconds;
+      FlashConfig2.Reminder1[Loop1UInt16].EndPeriodUnixTime   += FlashConfig2.Reminder1[Loop1UInt16].NextReminderDelaySeconds;
+    }
+
+    /* Check if this reminder is valid. */
+    if ((UnixTime > FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime) && (UnixTime < FlashConfig2.Reminder1[Loop1UInt16].EndPeriodUnixTime))
+    {
+      if (DebugBitMask & DEBUG_REMINDER) uart_send(__LINE__, __func__, "Reminder %2u is valid, set its corresponding bit in the bitmask          ************\r\r", Loop1UInt16 + 1);
+      Reminder1BitMask |= (0x01ll << Loop1UInt16);
+    }
+    else
+    {
+      if (DebugBitMask & DEBUG_REMINDER) uart_send(__LINE__, __func__, "Reminder %2u is not valid, reset its corresponding bit in the bitmask\r\r", Loop1UInt16 + 1);
+      Reminder1BitMask &= ~(0x01ll << Loop1UInt16);
+    }
+  }
+
+  if (DebugBitMask & DEBUG_REMINDER)
+  {
+    util_uint64_to_binary_string(Reminder1BitMask, 40, String);
+    printf("\r");
+    uart_send(__LINE__, __func__, "Reminder1BitMask while exiting reminder1_update(): 0x%10.10llX [%s]\r\r\r", Reminder1BitMask, String);
+  }
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=remote_control_test() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                                      Test remote control.
+\* ============================================================================================================================================================= */
+void remote_control_test(void)
+{
+  UINT8 FlagDone;
+
+  UINT16 SecondsLeft;
+
+
+  printf("                 Remote control test.\r\r");
+  printf("Press a remote control button to display its decimal code and button name...\r");
+  printf("You can watch the RGB Matrix IR indicator to see if the infrared data stream is properly received.\r");
+  printf("Press a local button to exit test before the timeout period.\r\r");
+
+  FlagDone    = FLAG_OFF;
+  SecondsLeft = WATCHDOG_SECONDS - WatchdogMiss;
+
+  while (SecondsLeft)
+  {
+    if (IrBuffer[0] == IR_LO_LIMIT)
+    {
+      sleep_ms(100);
+      SecondsLeft = WATCHDOG_SECONDS - WatchdogMiss;
+      if ((SecondsLeft % 5) == 0)
+      {
+        if (FlagDone == FLAG_OFF)
+        {
+          FlagDone = FLAG_ON;
+          printf("Time left: %4u seconds\r", SecondsLeft);
+        }
+
+        /* User may abort the test by pressing a local button on the RGB Matrix. */
+        if (ButtonBuffer[0] != BUTTON_NONE)
+        {
+          ButtonBuffer[0] = BUTTON_NONE;
+          return;
+        }
+      }
+      else
+      {
+        FlagDone = FLAG_OFF;
+      }
+      continue;
+    }
+    else
+    {
+      printf("User pressed remote control code %u, button name: <%s>\r\r", IrBuffer[0], ButtonName[IrBuffer[0]]);
+      IrBuffer[0] = BUTTON_NONE;
+    }
+  }
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=ring_count() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                          Return the number of elements currently in a ring buffer.
+                         NOTE: May be called from either side. The result is exact for the caller's own side and conservative for the other one.
+\* ============================================================================================================================================================= */
+UINT16 ring_count(struct ring *Ring)
+{
+  return (UINT16)(Ring->Head - Ring->Tail);
+}
+
+
+
+
+
+/* $TITLE=ring_get() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                   Retrieve the oldest element of a ring buffer. Return FLAG_OFF if the ring is empty. To be called by the consumer only.
+\* ============================================================================================================================================================= */
+UINT8 ring_get(struct ring *Ring, void *Data)
+{
+  UINT16 Tail;
+
+
+  Tail = Ring->Tail;
+  if (Ring->Head == Tail) return FLAG_OFF;
+
+  /* Element must not be read before Head has been seen updated by the producer. */
+  __dmb();
+  memcpy(Data, &Ring->Element[(Tail & Ring->Mask) * Ring->ElementSize], Ring->ElementSize);
+
+  /* Element must be completely read before its slot is given back to the producer. */
+  __dmb();
+  Ring->Tail = Tail + 1;
+
+  return FLAG_ON;
+}
+
+
+
+
+
+/* $TITLE=ring_put() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                           Add an element to a ring buffer. Return FLAG_OFF (and count an overflow) if the ring is full. To be called by the producer only.
+   NOTES:
+   1) Producer and consumer may run in different interrupt contexts or on different cores without any lock, as long as there is
+      a single producer and a single consumer. When several contexts may produce, the caller must serialize them (see loop_event_post()).
+   2) The memory barriers make sure the element is completely written before the consumer may see it, and completely read
+      before the producer may overwrite it.
+\* ============================================================================================================================================================= */
+UINT8 ring_put(struct ring *Ring, const void *Data)
+{
+  UINT16 Head;
+
+
+  Head = Ring->Head;
+  if ((UINT16)(Head - Ring->Tail) > Ring->Mask)
+  {
+    ++Ring->Overflow;
+
+    return FLAG_OFF;
+  }
+
+  /* Slot must not be overwritten before Tail has been seen updated by the consumer. */
+  __dmb();
+  memcpy(&Ring->Element[(Head & Ring->Mask) * Ring->ElementSize], Data, Ring->ElementSize);
+
+  /* Element must be completely written before the consumer may see the new Head. */
+  __dmb();
+  Ring->Head = Head + 1;
+
+  return FLAG_ON;
+}
+
+
+
+
+
+/* $TITLE=RGB_matrix_blink() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                             Blink all blinking areas in active windows.
+\* ============================================================================================================================================================= */
+void RGB_matrix_blink()
+{
+  static UINT16 CycleNumber;
+
+  UINT16 RowNumber;
+
+
+  if (DebugBitMask & DEBUG_FLOW) printf("Entering RGB_matrix_blink()\r");
+
+
+  if ((Window[WinTop].FlagBlink == FLAG_OFF) && (Window[WinMid].FlagBlink == FLAG_OFF) && (Window[WinBot].FlagBlink == FLAG_OFF))
+  {
+    if (DebugBitMask & DEBUG_BLINK) uart_send(__LINE__, __func__, "Entering RGB_matrix_blink(FLAG_OFF)\r");
+    return;
+  }
+
+
+  if (DebugBitMask & DEBUG_BLINK)
+  {
+    if (CycleNumber % 2)
+      uart_send(__LINE__, __func__, "Entering RGB_matrix_blink(blank)\r");
+    else
+      uart_send(__LINE__, __func__, "Entering RGB_matrix_blink(restore)\r");
+  }
+
+
+  if (CycleNumber % 2)
+  {
+    if (DebugBitMask & DEBUG_BLINK) printf("Cycle to blank blink area\r");
+
+    /* It is time to blank the blink area. */
+    for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
+    {
+      if (CheckBuffer[RowNumber] != 0xFFFFFFFFFFFFFFFFll)
+      {
+        /* There is an active blink area on this line: blank it with a single mask operation. */
+        FrameBuffer[RowNumber] &= CheckBuffer[RowNumber];
+        RGB_matrix_dirty(RowNumber, RowNumber);
+      }
+    }
+    if (Window[WinTop].FlagBlink == FLAG_ON) Window[WinTop].BlinkOnTimer = 0l;
+    if (Window[WinMid].FlagBlink == FLAG_ON) Window[WinMid].BlinkOnTimer = 0l;
+    if (Window[WinBot].FlagBlink == FLAG_ON) Window[WinBot].BlinkOnTimer = 0l;
+  }
+  else
+  {
+    if (DebugBitMask & DEBUG_BLINK) printf("Cycle to restore blink area\r");
+
+    /* It is time to restore the blink area. */
+    for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
+    {
+      if (CheckBuffer[RowNumber] != 0xFFFFFFFFFFFFFFFFll)
+      {
+        /* There is an active blink area on this line: copy it back from BlinkBuffer with a single mask operation. */
+        FrameBuffer[RowNumber] = (FrameBuffer[RowNumber] & CheckBuffer[RowNumber]) | (BlinkBuffer[RowNumber] & ~CheckBuffer[RowNumber]);
+        RGB_matrix_dirty(RowNumber, RowNumber);
+      }
+    }
+    if (Window[WinTop].FlagBlink == FLAG_ON) Window[WinTop].BlinkOnTimer = time_us_32();
+    if (Window[WinMid].FlagBlink == FLAG_ON) Window[WinMid].BlinkOnTimer = time_us_32();
+    if (Window[WinBot].FlagBlink == FLAG_ON) Window[WinBot].BlinkOnTimer = time_us_32();
+  }
+
+  ++CycleNumber;
+
+  if (DebugBitMask & DEBUG_FLOW) printf("Exiting RGB_matrix_blink()\r");
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=RGB_matrix_blit() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                 Copy a matrix area of SourceBuffer to DestinationBuffer, its top left corner going to DestinationRow / DestinationColumn.
+                 NOTES:
+                 1) The area is moved with one mask operation per row. Parts falling outside of the matrix are clipped.
+                 2) Source and destination may be the same buffer, even with overlapping areas.
+\* ============================================================================================================================================================= */
+void RGB_matrix_blit(UINT64 *DestinationBuffer, UINT8 DestinationRow, UINT8 DestinationColumn, UINT64 *SourceBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn)
+{
+  INT8   RowStep;
+
+  UINT8  Loop1UInt8;
+  UINT8  RowCount;
+  UINT8  RowNumber;
+
+  UINT64 DestinationMask;
+  UINT64 SourceMask;
+  UINT64 RowData;
+
+
+  /* Validate provided coordinates. */
+  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
+  if ((DestinationRow >= MAX_ROWS) || (DestinationColumn >= MAX_COLUMNS)) return;
+  if (EndRow >= MAX_ROWS) EndRow = MAX_ROWS - 1;
+
+  /* Clip rows going past the bottom of destination buffer. */
+  RowCount = EndRow - StartRow + 1;
+  if ((DestinationRow + RowCount) > MAX_ROWS) RowCount = MAX_ROWS - DestinationRow;
+
+  SourceMask = RGB_matrix_span_mask(StartColumn, EndColumn);
+  if (DestinationColumn >= StartColumn)
+    DestinationMask = SourceMask << (DestinationColumn - StartColumn);
+  else
+    DestinationMask = SourceMask >> (StartColumn - DestinationColumn);
+
+  /* When moving an area down in the same buffer, begin with the last row so that source rows are not overwritten before being copied. */
+  if ((DestinationBuffer == SourceBuffer) && (DestinationRow > StartRow))
+  {
+    RowNumber = RowCount - 1;
+    RowStep   = -1;
+  }
+  else
+  {
+    RowNumber = 0;
+    RowStep   = 1;
+  }
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < RowCount; ++Loop1UInt8)
+  {
+    RowData = SourceBuffer[StartRow + RowNumber] & SourceMask;
+    if (DestinationColumn >= StartColumn)
+      RowData <<= (DestinationColumn - StartColumn);
+    else
+      RowData >>= (StartColumn - DestinationColumn);
+
+    DestinationBuffer[DestinationRow + RowNumber] = (DestinationBuffer[DestinationRow + RowNumber] & ~DestinationMask) | RowData;
+    RowNumber += RowStep;
+  }
+
+  if (DestinationBuffer == FrameBuffer) RGB_matrix_dirty(DestinationRow, DestinationRow + RowCount - 1);
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=RGB_matrix_box() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                             Draw or erase a box with specified borders.
+\* ============================================================================================================================================================= */
+void RGB_matrix_box(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn, UINT8 Color, UINT8 Action)
+{
+  UINT8  RowNumber;
+
+  UINT64 BorderMask;
+  UINT64 SideMask;
+
+
+  /* Validate provided coordinates. */
+  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
+
+  RGB_matrix_draw_begin();
+
+
+  /* Set color for top, bottom, left and right borders. */
+  RGB_matrix_set_color(StartRow, StartColumn, StartRow, EndColumn, Color);
+  RGB_matrix_set_color(EndRow,   StartColumn, EndRow,   EndColumn, Color);
+  RGB_matrix_set_color(StartRow, StartColumn, EndRow, StartColumn, Color);
+  RGB_matrix_set_color(StartRow, EndColumn,   EndRow, EndColumn,   Color);
+
+  /* Top and bottom borders span the whole box width, intermediate rows only have their left and right pixels. */
+  BorderMask = RGB_matrix_span_mask(StartColumn, EndColumn);
+  SideMask   = RGB_matrix_span_mask(StartColumn, StartColumn) | RGB_matrix_span_mask(EndColumn, EndColumn);
+
+  /* Turn On or Off pixels for the box borders. */
+  for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
+  {
+    if (Action == ACTION_DRAW)
+      FrameBuffer[RowNumber] |=  (((RowNumber == StartRow) || (RowNumber == EndRow)) ? BorderMask : SideMask);
+    else
+      FrameBuffer[RowNumber] &= ~(((RowNumber == StartRow) || (RowNumber == EndRow)) ? BorderMask : SideMask);
+  }
+
+  RGB_matrix_dirty(StartRow, EndRow);
+
+  RGB_matrix_draw_end();
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=RGB_matrix_check_coord() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                          Check order of coordinates (start and end Row and Column and re-order if required.
+\* ============================================================================================================================================================= */
+void RGB_matrix_check_coord(UINT8 *StartRow, UINT8 *StartColumn, UINT8 *EndRow, UINT8 *EndColumn)
+{
+  UINT8 TempValue;
+
+
+  /* Extract / filter requests for standard window lines. */
+  switch (*StartRow)
+  {
+    case (201):
+      *StartRow = 1;
+      *EndRow   = 7;
+    break;
+
+    case (202):
+      *StartRow =  9;
+      *EndRow   = 15;
+    break;
+
+    case (203):
+      *StartRow = 20;
+      *EndRow   = 29;
+    break;
+  }
+
+
+  /* Re-order start and end points if required. */
+  if (*EndRow < *StartRow)
+  {
+    TempValue  = *StartRow;
+    *StartRow  = *EndRow;
+    *EndRow    = TempValue;
+  }
+
+  if ((*StartColumn != 99) && (*EndColumn < *StartColumn))
+  {
+    TempValue    = *StartColumn;
+    *StartColumn = *EndColumn;
+    *EndColumn   = TempValue;
+  }
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=RGB_matrix_clear_pixel() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                          Turn Off the pixels in the specified matrix area.
+\* ============================================================================================================================================================= */
+void RGB_matrix_clear_pixel(UINT64 *BufferPointer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn)
+{
+  UINT8  RowNumber;
+
+  UINT64 ColumnMask;
+
+
+  /* Validate provided coordinates. */
+  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
+
+  /* Turn Off pixels in the specified matrix buffer area, one whole row span at a time. */
+  ColumnMask = RGB_matrix_span_mask(StartColumn, EndColumn);
+  for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
+    BufferPointer[RowNumber] &= ~ColumnMask;
+
+  if (BufferPointer == FrameBuffer) RGB_matrix_dirty(StartRow, EndRow);
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=RGB_matrix_cls() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                                        Clear LED matrix.
+        NOTE: If there is an opened window with an "ACTION_DRAW" border, RGB_matrix_cls() will erase that border and it will have to be manuelly refreshed.
+              Turning Off the brightness with PWM Level may be a better solution to consider in some cases.
+\* ============================================================================================================================================================= */
+void RGB_matrix_cls(UINT64 *FrameBuffer)
+{
+  /* Clear LED display matrix. */
+  RGB_matrix_draw_begin();
+  memset(FrameBuffer, 0x00, (MAX_ROWS * MAX_COLUMNS / 8));
+  RGB_matrix_dirty(0, MAX_ROWS - 1);
+  RGB_matrix_draw_end();
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=RGB_matrix_copy_pixel() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                              Copy the pixels of the specified matrix area from SourceBuffer to the same area of DestinationBuffer.
+\* ============================================================================================================================================================= */
+void RGB_matrix_copy_pixel(UINT64 *DestinationBuffer, UINT64 *SourceBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn)
+{
+  UINT8  RowNumber;
+
+  UINT64 ColumnMask;
+
+
+  /* Validate provided coordinates. */
+  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
 
-    /* Check if we received another command either from remote control, either from local buttons. */
-    if (IrBuffer[0]     != BUTTON_NONE) CommandId = IrBuffer[0];
-    if (ButtonBuffer[0] != BUTTON_NONE) CommandId = ButtonBuffer[0];
-  } while (IdleTime < (BUTTON_TIME_OUT * 1000));
+  /* Copy pixels of the specified matrix area, one whole row span at a time. */
+  ColumnMask = RGB_matrix_span_mask(StartColumn, EndColumn);
+  for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
+    DestinationBuffer[RowNumber] = (DestinationBuffer[RowNumber] & ~ColumnMask) | (SourceBuffer[RowNumber] & ColumnMask);
 
-  if (DebugBitMask & DEBUG_FLOW) printf("Exiting process_button()\r");
+  if (DestinationBuffer == FrameBuffer) RGB_matrix_dirty(StartRow, EndRow);
 
   return;
 }
@@ -9328,557 +11936,621 @@ void process_button(UINT8 CommandId)
 
 
 
+/* $TITLE=RGB_matrix_device_init() */
 /* $PAGE */
-/* $TITLE=isr_signal_trap() */
 /* ============================================================================================================================================================= *\
-                                                      Interrupt handler for signal received from remote control.
+                                                      Initialize GPIO for most devices used in RGB matrix.
+                                               NOTE: PWM for matrix brightness is initialized in its own routine.
 \* ============================================================================================================================================================= */
-gpio_irq_callback_t isr_signal_trap(UINT8 gpio, UINT32 Events)
+void RGB_matrix_device_init(void)
 {
-  static UINT32 ButtonSetOnTime;
-  static UINT32 ButtonDownOnTime;
-  static UINT32 ButtonUpOnTime;
-  static UINT32 Dum1UInt32;
+  /* Initialize RGB matrix button devices and GPIOs. */
+  gpio_init(BUTTON_SET_GPIO);
+  gpio_init(BUTTON_DOWN_GPIO);
+  gpio_init(BUTTON_UP_GPIO);
 
+  gpio_set_dir(BUTTON_SET_GPIO,  GPIO_IN);
+  gpio_set_dir(BUTTON_DOWN_GPIO, GPIO_IN);
+  gpio_set_dir(BUTTON_UP_GPIO,   GPIO_IN);
 
-  /* Handle interrupts from infrared sensor. */
-  if (gpio == IR_RX)
-  {
-    /* Check if interrupt is generated by the GPIO line changing from High to Low (38 kHz infrared burst changing from Off to On). */
-    if (Events & GPIO_IRQ_EDGE_FALL)
-    {
-      /* This is the beginning of a 38kHz infrared burst. */
-      if (IrStepCount > 0)
-      {
-        /* If this is not the first infrared burst for this data stream, keep track of timing information of the previous silent period length and pulse distance. */
-        IrFinalValue[IrStepCount]  =  time_us_64();                                                      // this is the final timer value for the ending "silence"
-        IrResultValue[IrStepCount] = (UINT32)(IrFinalValue[IrStepCount] - IrInitialValue[IrStepCount]);  // calculate duration of the ending "silence" period.
-        IrLevel[IrStepCount]       = 1;                                                                  // ending period is a logical High level.
+  gpio_pull_up(BUTTON_SET_GPIO);
+  gpio_pull_up(BUTTON_DOWN_GPIO);
+  gpio_pull_up(BUTTON_UP_GPIO);
 
-        /* Calculate the Pulse distance of the previous pulse that is ending now (Pulse distance = length of infrared burst + length of the "silence" period that follows). */
-        IrPulseDistance[IrStepCount] = IrResultValue[IrStepCount - 1] + IrResultValue[IrStepCount];
 
-        ++IrStepCount;  // start next logic level.
-      }
-      else
-      {
-        IrIndicator = 2;  // LED indicator on RGB matrix indicating we received an IR burst. */
+  /* Initialize on-board Pico LED gpio. */
+  gpio_init(PICO_LED);
+  gpio_set_dir(PICO_LED, GPIO_OUT);
+  gpio_put(PICO_LED, 0);
 
-        /* Turn On infrared LED indicators on RGB matrix when the infrared data stream begins. */
-        RGB_matrix_set_pixel(FrameBuffer, IR_INDICATOR_START_ROW, IR_INDICATOR_START_COLUMN, IR_INDICATOR_END_ROW, IR_INDICATOR_END_COLUMN);
-        RGB_matrix_set_color(IR_INDICATOR_START_ROW, IR_INDICATOR_START_COLUMN, IR_INDICATOR_END_ROW, IR_INDICATOR_END_COLUMN, BLUE);
-      }
 
-      IrInitialValue[IrStepCount] = time_us_64();  // this is also start timer of next Low level.
+  /* Initialize RGB matrix integrated active buzzer. */
+#ifndef NO_SOUND
+  gpio_init(BUZZER);
+  gpio_set_dir(BUZZER, GPIO_OUT);
+  gpio_put(BUZZER, 0);
+#endif  // NO_SOUND
 
-      gpio_acknowledge_irq(IR_RX, GPIO_IRQ_EDGE_FALL);
-    }
 
+#ifdef REMOTE_SUPPORT
+  /* Initialize infrared sensor gpio. */
+  gpio_init(IR_RX);
 
-    /* Check if interrupt is generated by the GPIO line changing from Low to High (38kHz infrared burst changing from On to Off). */
-    if (Events & GPIO_IRQ_EDGE_RISE)
-    {
-      /* This is the end of a 38kHz infrared burst, the beginning of the "silence" period. */
-      IrFinalValue[IrStepCount]  = time_us_64();                                                       // this is the final timer value for the ending infrared burst.
-      IrResultValue[IrStepCount] = (UINT32)(IrFinalValue[IrStepCount] - IrInitialValue[IrStepCount]);  // calculate duration of the ending infrared burst.
-      IrLevel[IrStepCount]       = 0;                                                                  // ending period is a logical Low level.
-      ++IrStepCount;                                                                                   // go on to next logic level.
+  /* IR sensor will receive IR command from remote control. */
+  gpio_set_dir(IR_RX, GPIO_IN);
 
-      /* Keep track of timer value at the beginning of this "silence" period. */
-      IrInitialValue[IrStepCount] = time_us_64();                                                       // this is also start timer of next High level.
+  /* Line will remain at High level until a signal is received. */
+  gpio_pull_up(IR_RX);
+#endif  // REMOTE_SUPPORT
 
-      gpio_acknowledge_irq(IR_RX, GPIO_IRQ_EDGE_RISE);
-    }
-  }
 
 
+  /* Initialize Pico's UART0 used to send information to a terminal emulator for terminal menu and / or debugging purposes. */
+  gpio_init(UART_TX_PIN);
+  gpio_init(UART_RX_PIN);
+  gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
+  gpio_set_function(UART_RX_PIN, GPIO_FUNC_UART);
+  uart_init(uart0, 921600);
+  uart_set_format(uart0, 8, 1, UART_PARITY_NONE);
 
-  /* Handle interrupts from RGB matrix <Set> buttons */
-  if (gpio == BUTTON_SET_GPIO)
-  {
-    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
-    if (Events & GPIO_IRQ_EDGE_FALL)
-    {
-      /* This is the beginning of the <Set> button press. */
-      ButtonSetOnTime = time_us_32();
-      gpio_acknowledge_irq(BUTTON_SET_GPIO, GPIO_IRQ_EDGE_FALL);
-    }
 
 
-    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
-    if (Events & GPIO_IRQ_EDGE_RISE)
-    {
-      /* This is the end of the <Set> button press. */
-      gpio_acknowledge_irq(BUTTON_SET_GPIO, GPIO_IRQ_EDGE_RISE);
+  /* LEDs matrix related devices and GPIOs. */
+  gpio_init(R1);
+  gpio_init(G1);
+  gpio_init(B1);
+  gpio_init(R2);
+  gpio_init(G2);
+  gpio_init(B2);
 
-      /* Determine if this <Set> button press is a quick press ("normal") or long press. */
-      Dum1UInt32 = time_us_32();
-      if ((Dum1UInt32 - ButtonSetOnTime) > BUTTON_LONG_PRESS_TIME)
-      {
-        ButtonBuffer[0] = BUTTON_SET_LONG;
-        if (DebugBitMask & DEBUG_FUNCTION)
-        {
-          printf("\r");
-          uart_send(__LINE__, __func__, "Button <Set>  On time: %10lu     Button <Set>  Off time: %10lu     Button <Set>  long press length: %8lu\r", ButtonSetOnTime, Dum1UInt32, (Dum1UInt32 - ButtonSetOnTime));
-        }
-      }
-      else
-      {
-        ButtonBuffer[0] = BUTTON_SET;
-        if (DebugBitMask & DEBUG_FUNCTION)
-        {
-          printf("\r");
-          uart_send(__LINE__, __func__, "Button <Set>  On time: %10lu     Button <Set>  Off time: %10lu     Button <Set>  quick press length: %8lu\r", ButtonSetOnTime, Dum1UInt32, (Dum1UInt32 - ButtonSetOnTime));
-        }
-      }
+  gpio_init(A);
+  gpio_init(B);
+  gpio_init(C);
+  gpio_init(D);
+  gpio_init(E);
 
-      ButtonSetOnTime = 0l;  // reset button press On time.
+  gpio_init(CLK);
 
-      /* Button audible feedback. */
-      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
-        queue_add_active(50, 1);
-    }
-  }
+  gpio_init(STB);
 
 
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                          Initialize PWM for clock display brightness.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  /* Set GPIO for RGB matrix brightness ("Output Enable"). */
+  Pwm[PWM_ID_BRIGHTNESS].Gpio = OE;
 
-  /* Handle interrupts from RGB matrix <Down> button. */
-  if (gpio == BUTTON_DOWN_GPIO)
-  {
-    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
-    if (Events & GPIO_IRQ_EDGE_FALL)
-    {
-      /* This is the beginning of the <Down> button press. */
-      ButtonDownOnTime = time_us_32();
-      gpio_acknowledge_irq(BUTTON_DOWN_GPIO, GPIO_IRQ_EDGE_FALL);
-    }
+  /* Initialize pulse-width-modulation (PWM) signals. */
+  pwm_initialize();
 
+  gpio_set_dir(R1,  GPIO_OUT);
+  gpio_set_dir(G1,  GPIO_OUT);
+  gpio_set_dir(B1,  GPIO_OUT);
+  gpio_set_dir(R2,  GPIO_OUT);
+  gpio_set_dir(G2,  GPIO_OUT);
+  gpio_set_dir(B2,  GPIO_OUT);
 
-    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
-    if (Events & GPIO_IRQ_EDGE_RISE)
-    {
-      /* This is the end of the <Down> button press. */
-      gpio_acknowledge_irq(BUTTON_DOWN_GPIO, GPIO_IRQ_EDGE_RISE);
+  gpio_set_dir(A,   GPIO_OUT);
+  gpio_set_dir(B,   GPIO_OUT);
+  gpio_set_dir(C,   GPIO_OUT);
+  gpio_set_dir(D,   GPIO_OUT);
+  gpio_set_dir(E,   GPIO_OUT);
+  gpio_set_dir(CLK, GPIO_OUT);
+  gpio_set_dir(STB, GPIO_OUT);
+  STB_LOW;
+  CLK_LOW;
 
-      /* Determine if this <Down> button press is a quick press ("normal") or long press. */
-      Dum1UInt32 = time_us_32();
-      if ((Dum1UInt32 - ButtonDownOnTime) > BUTTON_LONG_PRESS_TIME)
-      {
-        ButtonBuffer[0] = BUTTON_DOWN_LONG;
-        if (DebugBitMask & DEBUG_FUNCTION)
-        {
-          printf("\r");
-          uart_send(__LINE__, __func__, "Button <Down> On time: %10lu     Button <Down> Off time: %10lu     Button <Down> long press length: %8lu\r", ButtonDownOnTime, Dum1UInt32, (Dum1UInt32 - ButtonDownOnTime));
-        }
-      }
-      else
-      {
-        ButtonBuffer[0] = BUTTON_DOWN;
-        if (DebugBitMask & DEBUG_FUNCTION)
-        {
-          printf("\r");
-          uart_send(__LINE__, __func__, "Button <Down> On time: %10lu     Button <Down> Off time: %10lu     Button <Down> quick press length: %8lu\r", ButtonDownOnTime, Dum1UInt32, (Dum1UInt32 - ButtonDownOnTime));
-        }
-      }
+  int MaxLed = 64;
 
-      ButtonDownOnTime = 0l;
+  int C12[16] = {0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+  int C13[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0};
 
-      /* Button audible feedback. */
-      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
-        queue_add_active(50, 1);
+  for (int l = 0; l < MaxLed; l++)
+  {
+    int y = l % 16;
+
+    R1_LOW;
+    G1_LOW;
+    B1_LOW;
+    R2_LOW;
+    G2_LOW;
+    B2_LOW;
+
+    if (C12[y] == 1)
+    {
+      R1_HIGH;
+      G1_HIGH;
+      B1_HIGH;
+      R2_HIGH;
+      G2_HIGH;
+      B2_HIGH;
+    }
+
+    if (l > MaxLed - 12)
+    {
+      STB_HIGH;
+    }
+    else
+    {
+      STB_LOW;
     }
+
+    CLK_HIGH;
+    sleep_us(2);
+    CLK_LOW;
   }
+  STB_LOW;
+  CLK_LOW;
+
+  /* Send Data to control register 12. */
+  for (int l = 0; l < MaxLed; l++)
+  {
+    int y = l % 16;
 
+    R1_LOW;
+    G1_LOW;
+    B1_LOW;
+    R2_LOW;
+    G2_LOW;
+    B2_LOW;
 
+    if (C13[y] == 1)
+    {
+      R1_HIGH;
+      G1_HIGH;
+      B1_HIGH;
+      R2_HIGH;
+      G2_HIGH;
+      B2_HIGH;
+    }
 
-  /* Handle interrupts from RGB matrix <Up> button. */
-  if (gpio == BUTTON_UP_GPIO)
-  {
-    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
-    if (Events & GPIO_IRQ_EDGE_FALL)
+    if (l > MaxLed - 13)
     {
-      /* This is the beginning of a <Up> button press. */
-      ButtonUpOnTime = time_us_32();
-      gpio_acknowledge_irq(BUTTON_UP_GPIO, GPIO_IRQ_EDGE_FALL);
+      STB_HIGH;
+    }
+    else
+    {
+      STB_LOW;
     }
 
+    CLK_HIGH;
+    sleep_us(2);
+    CLK_LOW;
+  }
+  STB_LOW;
+  CLK_LOW;
 
-    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
-    if (Events & GPIO_IRQ_EDGE_RISE)
-    {
-      /* This is the end of the <Up> button press. */
-      gpio_acknowledge_irq(BUTTON_UP_GPIO, GPIO_IRQ_EDGE_RISE);
 
-      /* Determine if this <Up> button press is a quick press ("normal") or long press. */
-      Dum1UInt32 = time_us_32();
-      if ((Dum1UInt32 - ButtonUpOnTime) > BUTTON_LONG_PRESS_TIME)
-      {
-        ButtonBuffer[0] = BUTTON_UP_LONG;
-        if (DebugBitMask & DEBUG_FUNCTION)
-        {
-          printf("\r");
-          uart_send(__LINE__, __func__, "Button <Up>   On time: %10lu     Button <Up>   Off time: %10lu     Button <Up>   long press length: %8lu\r", ButtonUpOnTime, Dum1UInt32, (Dum1UInt32 - ButtonUpOnTime));
-        }
-      }
-      else
-      {
-        ButtonBuffer[0] = BUTTON_UP;
-        if (DebugBitMask & DEBUG_FUNCTION)
-        {
-          printf("\r");
-          uart_send(__LINE__, __func__, "Button <Up>   On time: %10lu     Button <Up>   Off time: %10lu     Button <Up>   quick press length: %8lu\r", ButtonUpOnTime, Dum1UInt32, (Dum1UInt32 - ButtonUpOnTime));
-        }
-      }
+  /* Initialize analog-to-digital converter to read ambient light relative value and power supply info. */
+  adc_init();
 
-      ButtonUpOnTime = 0l;
+  adc_gpio_init(ADC_LIGHT_SENSOR);  // RGB-Matrix ambient light detector.
+  adc_gpio_init(ADC_VCC);           // power supply voltage.
 
-      /* Button audible feedback. */
-      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
-        queue_add_active(50, 1);
-    }
-  }
+  adc_select_input(0);
+
+  return;
 }
 
 
 
 
 
-#if 0
+/* $TITLE=RGB_matrix_dirty() */
 /* $PAGE */
-/* $TITLE=isr_signal_trap() */
 /* ============================================================================================================================================================= *\
-                                                      Interrupt handler for signal received from remote control.
+                          Flag the specified matrix rows as modified in FrameBuffer or ColorPlane since they have last been processed.
+                          NOTE: Must be called by every function changing FrameBuffer or ColorPlane content, since RGB_matrix_pack()
+                                only regenerates the "wire format" of the rows flagged in DirtyRowMask.
 \* ============================================================================================================================================================= */
-void isr_signal_trap(void)
+void RGB_matrix_dirty(UINT8 StartRow, UINT8 EndRow)
 {
-  static UINT32 ButtonSetOnTime;
-  static UINT32 ButtonDownOnTime;
-  static UINT32 ButtonUpOnTime;
-  static UINT32 Dum1UInt32;
+  UINT32 InterruptMask;
+  UINT32 RowMask;
 
 
-  /* Handle interrupts from infrared sensor. */
-  /* Check if interrupt is generated by the GPIO line changing from High to Low (38 kHz infrared burst changing from Off to On). */
-  if (gpio_get_irq_event_mask(IR_RX) & GPIO_IRQ_EDGE_FALL)
-  {
-    /* This is the beginning of a 38kHz infrared burst. */
-    if (IrStepCount > 0)
-    {
-      /* If this is not the first infrared burst for this data stream, keep track of timing information of the previous silent period length and pulse distance. */
-      IrFinalValue[IrStepCount]  =  time_us_64();                                                      // this is the final timer value for the ending "silence"
-      IrResultValue[IrStepCount] = (UINT32)(IrFinalValue[IrStepCount] - IrInitialValue[IrStepCount]);  // calculate duration of the ending "silence" period.
-      IrLevel[IrStepCount]       = 1;                                                                  // ending period is a logical High level.
+  /* Validate provided rows. */
+  if (StartRow >= MAX_ROWS) return;
+  if (EndRow   >= MAX_ROWS) EndRow = MAX_ROWS - 1;
+  if (EndRow   <  StartRow) return;
 
-      /* Calculate the Pulse distance of the previous pulse that is ending now (Pulse distance = length of infrared burst + length of the "silence" period that follows). */
-      IrPulseDistance[IrStepCount] = IrResultValue[IrStepCount - 1] + IrResultValue[IrStepCount];
+  RowMask = (MATRIX_ALL_ROWS >> (31 - (EndRow - StartRow))) << StartRow;
 
-      ++IrStepCount;  // start next logic level.
-    }
-    else
-    {
-      IrIndicator = 2;  // LED indicator on RGB matrix indicating we received an IR burst. */
+  /* DirtyRowMask is updated from both cores (main loop on core 0, scroll tick and transitions on core 1). */
+  InterruptMask = spin_lock_blocking(DirtyLock);
+  DirtyRowMask |= RowMask;
+  spin_unlock(DirtyLock, InterruptMask);
 
-      /* Turn On infrared LED indicators on RGB matrix when the infrared data stream begins. */
-      RGB_matrix_set_pixel(FrameBuffer, IR_INDICATOR_START_ROW, IR_INDICATOR_START_COLUMN, IR_INDICATOR_END_ROW, IR_INDICATOR_END_COLUMN);
-      RGB_matrix_set_color(IR_INDICATOR_START_ROW, IR_INDICATOR_START_COLUMN, IR_INDICATOR_END_ROW, IR_INDICATOR_END_COLUMN, BLUE);
-    }
+  return;
+}
 
-    IrInitialValue[IrStepCount] = time_us_64();  // this is also start timer of next Low level.
 
-    gpio_acknowledge_irq(IR_RX, GPIO_IRQ_EDGE_FALL);
-  }
 
 
-  /* Check if interrupt is generated by the GPIO line changing from Low to High (38kHz infrared burst changing from On to Off). */
-  if (gpio_get_irq_event_mask(IR_RX) & GPIO_IRQ_EDGE_FALL)
-  {
-    /* This is the end of a 38kHz infrared burst, the beginning of the "silence" period. */
-    IrFinalValue[IrStepCount]  = time_us_64();                                                       // this is the final timer value for the ending infrared burst.
-    IrResultValue[IrStepCount] = (UINT32)(IrFinalValue[IrStepCount] - IrInitialValue[IrStepCount]);  // calculate duration of the ending infrared burst.
-    IrLevel[IrStepCount]       = 0;                                                                  // ending period is a logical Low level.
-    ++IrStepCount;                                                                                   // go on to next logic level.
 
-    /* Keep track of timer value at the beginning of this "silence" period. */
-    IrInitialValue[IrStepCount] = time_us_64();                                                       // this is also start timer of next High level.
+/* $TITLE=RGB_matrix_display() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                   Display specified ASCII character, beginning at specified matrix location (pixel row and pixel column), using the specified font type.
 
-    gpio_acknowledge_irq(IR_RX, GPIO_IRQ_EDGE_RISE);
-  }
+                                  WARNING - WARNING - WARNING - WARNING - WARNING - WARNING - WARNING - WARNING - WARNING - WARNING
+                                  - Debugging must be done only outside of callback functions, otherwise the firmware will crash.
+                                    If required, disable the callback updating date and time and use this function from a test area.
 
+                     NOTES:
+                            1) Rows (in pixels) are numbered from 0 to MAX_ROWS and columns (in pixels) are numbered from 0 to MAX_COLUMNS.
+                            2) StartRow and StartColumn correspond to the top-left position of the character to be displayed.
+                            3) ASCII positions below 0x20 are used to generate special foreign language character bitmaps that do not exist
+                               in the English language.
+                            4) If FlagMore is != 0, it means that more characters are to be displayed to the right of current character...
+                               in such a case, we make sure the next column to the right of current character is blank.
+                               FlagMore is the next character itself, so that the spacing between both characters may be kerned.
+                            5) This function returns the start column for an eventual next character.
+\* ============================================================================================================================================================= */
+UINT8 RGB_matrix_display(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 AsciiValue, UINT8 FontType, UINT8 FlagMore)
+{
+#ifdef DEVELOPER_VERSION
+  UCHAR String[64];
 
+  UINT8  ColumnNumber;
+#endif  // DEVELOPER_VERSION
 
-  /* Handle interrupts from RGB matrix <Set> buttons */
-  if (gpio == BUTTON_SET_GPIO)
-  {
-    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
-    if (Events & GPIO_IRQ_EDGE_FALL)
-    {
-      /* This is the beginning of the <Set> button press. */
-      ButtonSetOnTime = time_us_32();
-      gpio_acknowledge_irq(BUTTON_SET_GPIO, GPIO_IRQ_EDGE_FALL);
-    }
+  UINT8  CharHeight;
+  UINT8  CharWidth;
+  UINT8  GlyphWidth;
+  UINT8  RowNumber;
 
+  const UINT8 *GlyphRow;
 
-    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
-    if (Events & GPIO_IRQ_EDGE_RISE)
-    {
-      /* This is the end of the <Set> button press. */
-      gpio_acknowledge_irq(BUTTON_SET_GPIO, GPIO_IRQ_EDGE_RISE);
 
-      /* Determine if this <Set> button press is a quick press ("normal") or long press. */
-      Dum1UInt32 = time_us_32();
-      if ((Dum1UInt32 - ButtonSetOnTime) > BUTTON_LONG_PRESS_TIME)
-      {
-        ButtonBuffer[0] = BUTTON_SET_LONG;
-        if (DebugBitMask & DEBUG_FUNCTION)
-        {
-          printf("\r");
-          uart_send(__LINE__, __func__, "Button <Set> On  time: %10lu     Button <Set> Off time: %10lu     Button <Set> long press length: %8lu\r", ButtonSetOnTime, Dum1UInt32, (Dum1UInt32 - ButtonSetOnTime));
-        }
-      }
-      else
-      {
-        ButtonBuffer[0] = BUTTON_SET;
-        if (DebugBitMask & DEBUG_FUNCTION)
-        {
-          printf("\r");
-          uart_send(__LINE__, __func__, "Button <Set> On  time: %10lu     Button <Set> Off time: %10lu     Button <Set> quick press length: %8lu\r", ButtonSetOnTime, Dum1UInt32, (Dum1UInt32 - ButtonSetOnTime));
-        }
-      }
+  /* Initializations. */
+  switch (FontType)
+  {
+    case (FONT_4x7):
+      if (AsciiValue > 0x7F) AsciiValue = 0;  // only first 128 ASCII characters are defined for 4x7 font.
+      GlyphRow   = Font4x7[AsciiValue].Row;
+      GlyphWidth = Font4x7[AsciiValue].Width;
+      CharHeight = 7;
+    break;
 
-      ButtonSetOnTime = 0l;  // reset button press On time.
+    case (FONT_5x7):
+    default:
+      GlyphRow   = Font5x7[AsciiValue].Row;
+      GlyphWidth = Font5x7[AsciiValue].Width;
+      CharHeight = 7;
+    break;
 
-      /* Button audible feedback. */
-      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
-        queue_add_active(50, 1);
-    }
+    case (FONT_8x10):
+      if (AsciiValue > 0x7F) AsciiValue = 0;  // only first 128 ASCII characters are defined for 8x10 font.
+      GlyphRow   = Font8x10[AsciiValue].Row;
+      GlyphWidth = Font8x10[AsciiValue].Width;
+      CharHeight = 10;
+    break;
   }
+  CharWidth = GlyphWidth;
 
 
 
-  /* Handle interrupts from RGB matrix <Down> button. */
-  if (gpio == BUTTON_DOWN_GPIO)
+#ifdef DEVELOPER_VERSION
+  if (DebugBitMask & DEBUG_MATRIX)
   {
-    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
-    if (Events & GPIO_IRQ_EDGE_FALL)
-    {
-      /* This is the beginning of the <Down> button press. */
-      ButtonDownOnTime = time_us_32();
-      gpio_acknowledge_irq(BUTTON_DOWN_GPIO, GPIO_IRQ_EDGE_FALL);
-    }
-
-
-    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
-    if (Events & GPIO_IRQ_EDGE_RISE)
-    {
-      /* This is the end of the <Down> button press. */
-      gpio_acknowledge_irq(BUTTON_DOWN_GPIO, GPIO_IRQ_EDGE_RISE);
-
-      /* Determine if this <Down> button press is a quick press ("normal") or long press. */
-      Dum1UInt32 = time_us_32();
-      if ((Dum1UInt32 - ButtonDownOnTime) > BUTTON_LONG_PRESS_TIME)
-      {
-        ButtonBuffer[0] = BUTTON_DOWN_LONG;
-        printf("\r");
-        uart_send(__LINE__, __func__, "Button <Down> On  time: %10lu     Button <Down> Off time: %10lu     Button <Down> long press length: %8lu\r", ButtonDownOnTime, Dum1UInt32, (Dum1UInt32 - ButtonDownOnTime));
-      }
-      else
-      {
-        ButtonBuffer[0] = BUTTON_DOWN;
-        printf("\r");
-        uart_send(__LINE__, __func__, "Button <Down> On  time: %10lu     Button <Down> Off time: %10lu     Button <Down> quick press length: %8lu\r", ButtonDownOnTime, Dum1UInt32, (Dum1UInt32 - ButtonDownOnTime));
-      }
-
-      ButtonDownOnTime = 0l;
-
-      /* Button audible feedback. */
-      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
-        queue_add_active(50, 1);
-    }
-  }
+    uart_send(__LINE__, __func__, "AsciiValue: 0x%2.2X (%3u) ", AsciiValue, AsciiValue);
 
+    /* If this is a printable ASCII character, display it to log file. */
+    if (AsciiValue >= 0x20) uart_send(__LINE__, __func__, "- <%c> ", AsciiValue);
 
+    uart_send(__LINE__, __func__, "- FlagMore: %2.2X (%u) (will be <0> or <!= 0> - not necessarily <1>)\r", FlagMore, FlagMore);
+    uart_send(__LINE__, __func__, "Character StartRow: %2u     Character StartColumn: %2u\r", StartRow, StartColumn);
 
-  /* Handle interrupts from RGB matrix <Up> button. */
-  if (gpio == BUTTON_UP_GPIO)
-  {
-    /* Check if interrupt is generated by the GPIO line changing from High to Low. */
-    if (Events & GPIO_IRQ_EDGE_FALL)
-    {
-      /* This is the beginning of a <Up> button press. */
-      ButtonUpOnTime = time_us_32();
-      gpio_acknowledge_irq(BUTTON_UP_GPIO, GPIO_IRQ_EDGE_FALL);
+    /* Display bitmap for each character row. */
+    uart_send(__LINE__, __func__, "Character width: %u\r", GlyphWidth);
+    for (RowNumber = 0; RowNumber < CharHeight; ++RowNumber)
+    {
+      util_uint64_to_binary_string((UINT64)GlyphRow[RowNumber], GlyphWidth, String);
+      uart_send(__LINE__, __func__, "Row[%2u]: 0x%2.2X   <%s>\r", RowNumber, GlyphRow[RowNumber], String);
     }
+  }
+#endif  // DEVELOPER_VERSION
 
 
-    /* Check if interrupt is generated by the GPIO line changing from Low to High. */
-    if (Events & GPIO_IRQ_EDGE_RISE)
-    {
-      /* This is the end of the <Up> button press. */
-      gpio_acknowledge_irq(BUTTON_UP_GPIO, GPIO_IRQ_EDGE_RISE);
+  /* Check if we need to blank an extra column to the right of the character (because more characters will be displayed to the right).
+     If there are more characters to come, simulate that the character is one more column than it actually is (kerning included). */
+  if (FlagMore) CharWidth += 1 + layout_kerning(FontType, AsciiValue, FlagMore);
 
-      /* Determine if this <Up> button press is a quick press ("normal") or long press. */
-      Dum1UInt32 = time_us_32();
-      if ((Dum1UInt32 - ButtonUpOnTime) > BUTTON_LONG_PRESS_TIME)
-      {
-        ButtonBuffer[0] = BUTTON_UP_LONG;
-        printf("\r");
-        uart_send(__LINE__, __func__, "Button <Up> On  time: %10lu     Button <Up> Off time: %10lu     Button <Up> long press length: %8lu\r", ButtonUpOnTime, Dum1UInt32, (Dum1UInt32 - ButtonUpOnTime));
-      }
-      else
+
+#ifdef DEVELOPER_VERSION
+  if (DebugBitMask & DEBUG_MATRIX)
+  {
+    uart_send(__LINE__, __func__, "Adjusted character Width: %u\r", CharWidth);
+
+    /* Debug path: set pixels in the target display buffer one by one, waiting for user between each pixel. */
+    for (RowNumber = 0; RowNumber < CharHeight; ++RowNumber)
+    {
+      for (ColumnNumber = 0; ColumnNumber < CharWidth; ++ColumnNumber)
       {
-        ButtonBuffer[0] = BUTTON_UP;
-        printf("\r");
-        uart_send(__LINE__, __func__, "Button <Up> On  time: %10lu     Button <Up> Off time: %10lu     Button <Up> quick press length: %8lu\r", ButtonUpOnTime, Dum1UInt32, (Dum1UInt32 - ButtonUpOnTime));
+        uart_send(__LINE__, __func__, "StartColumn:  %3u     CharColumn:   %2u\r", StartColumn, ColumnNumber);
+
+        if ((ColumnNumber < GlyphWidth) && (GlyphRow[RowNumber] & (0x01 << (GlyphWidth - ColumnNumber - 1))))
+        {
+          /* This pixel must be turned On. */
+          DisplayBuffer[StartRow + RowNumber] |= (0x01ll << (StartColumn + ColumnNumber));
+          uart_send(__LINE__, __func__, "RowNumber: %2u     ColumnNumber: %2u   Pixel must be turned On\r", StartRow + RowNumber, StartColumn + ColumnNumber);
+        }
+        else
+        {
+          /* This pixel must be turned Off. */
+          DisplayBuffer[StartRow + RowNumber] &= ~(0x01ll << (StartColumn + ColumnNumber));
+          uart_send(__LINE__, __func__, "RowNumber: %2u     ColumnNumber: %2u   Pixel must be turned Off\r", StartRow + RowNumber, StartColumn + ColumnNumber);
+        }
+        uart_send(__LINE__, __func__, "Press <Enter> to continuer: ");
+        input_string(String);
       }
+    }
 
-      ButtonUpOnTime = 0l;
+    if (DisplayBuffer == FrameBuffer) RGB_matrix_dirty(StartRow, StartRow + CharHeight - 1);
 
-      /* Button audible feedback. */
-      if (FlashConfig1.FlagButtonFeedback == FLAG_ON)
-        queue_add_active(50, 1);
-    }
+    return StartColumn + CharWidth;
   }
+#endif  // DEVELOPER_VERSION
+
+
+  /* Set pixels in the target display buffer to match the bitmap of this ASCII character. */
+  RGB_matrix_glyph_blit(DisplayBuffer, StartRow, StartColumn, GlyphRow, CharHeight, GlyphWidth, CharWidth);
+
+  return StartColumn + CharWidth;
 }
-#endif  // 0
 
 
 
 
 
+/* $TITLE=RGB_matrix_display_time() */
 /* $PAGE */
-/* $TITLE=process_function() */
 /* ============================================================================================================================================================= *\
-                                                                 Process a function number.
+                                               Display data and time on LED matrix (usual matrix display).
+                                    NOTE: Matrix scanning will be stopped while data is sent through CDC USB
+                                          It's Ok to do it for debugging purposes for short periods of time but it should
+                                          not be done continuously because LEDs are then overbright (overvoltage).
+                                          This will shorten the life span of the LEDs.
 \* ============================================================================================================================================================= */
-void process_function(UINT16 FunctionNumber)
+void RGB_matrix_display_time(void)
 {
-  if (DebugBitMask & DEBUG_FLOW) printf("Entering process_function()\r");
+  static UINT8 CurrentColor;
 
-  uart_send(__LINE__, __func__, "Entering process_function()\r\r");
+  UINT8 FlagLocalDebug = FLAG_OFF;
 
-  if (DebugBitMask & DEBUG_FLOW) printf("Exiting process_function()\r");
+  UINT16 Loop1UInt16;
+  UINT16 PwmLevel;
+  UINT16 TargetDays;
 
-  return;
-}
+  struct tm TempTime;
 
 
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                              Read time from real-time clock IC (DS3231).
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  if (FlagLocalDebug) printf("%u   Before ds3231_get_time()\r", __LINE__);
+  ds3231_get_time(&CurrentTime);
 
 
 
-/* $PAGE */
-/* $TITLE=pwm_display_parameters() */
-/* ============================================================================================================================================================= *\
-                                            Display PWM parameters for all PWM signals used in the RGB Matrix project.
-\* ============================================================================================================================================================= */
-void pwm_display_parameters(void)
-{
-  UINT8 Loop1UInt8;
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                             Update day-of-week on first line of WIN_DATE.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  /* Update date only if WIN_DATE is the WinTop active window and if no scrolling is active. */
+  if (FlagLocalDebug) printf("%4u   Before updating day-of-week\r", __LINE__);
+  if (Window[WIN_DATE].FlagTopScroll == FLAG_OFF)
+  {
+    if (WinTop == WIN_DATE)
+    {
+      /* Update day-of-week only if WIN_DATE is the WinTop active window. */
+      ///// PwmLevel = Pwm[PWM_ID_BRIGHTNESS].Level;  // keep track of original PWM level on entry.
+      ///// pwm_set_level(PWM_ID_BRIGHTNESS, 2000);   // blank LED matrix before matrix update.
+      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_OFF);
+
+      /// critical_section_enter_blocking(&ThreadLock);
 
+      CLK_HIGH;
 
-  if (DebugBitMask & DEBUG_FLOW) printf("Entering pwm_display_parameters\r");
+      ///// win_part_cls(WIN_DATE, 201, 201);
+      win_printf(WIN_DATE, 201, 99, FONT_5x7, "%s", DayName[CurrentTime.DayOfWeek]);
 
-  for (Loop1UInt8 = 0; Loop1UInt8 < PWM_ID_HI_LIMIT; ++Loop1UInt8)
+      CLK_LOW;
+
+      /// critical_section_exit(&ThreadLock);
+
+      /* Restore original PWM level when done. */
+      ///// pwm_set_level(PWM_ID_BRIGHTNESS, PwmLevel);
+      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_ON);
+    }
+  }
+
+
+
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                               Update date on second line of WIN_DATE.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  if (FlagLocalDebug) printf("%4u   Before updating date\r", __LINE__);
+  if (Window[WIN_DATE].FlagMidScroll == FLAG_OFF)
   {
-    switch (Loop1UInt8)
+    if (WinMid == WIN_DATE)
     {
-      case (PWM_ID_BRIGHTNESS):
-        uart_send(__LINE__, __func__, "PWM for brightness control (PWM ID: %u)\r", PWM_ID_BRIGHTNESS);
-      break;
+      /* Update date only if WIN_DATE is the WinMid active window. */
+      ///// PwmLevel = Pwm[PWM_ID_BRIGHTNESS].Level;  // keep track of original PWM level on entry.
+      ///// pwm_set_level(PWM_ID_BRIGHTNESS, 2000);   // blank LED matrix before matrix update.
+      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_OFF);
 
-      default:
-        uart_send(__LINE__, __func__, "Undefined PWM (number %u)\r", Loop1UInt8);
-      break;
-    }
+      /// critical_section_enter_blocking(&ThreadLock);
 
-    uart_send(__LINE__, __func__, "SystemClock:    %lu\r",    clock_get_hz(clk_sys));
-    uart_send(__LINE__, __func__, "PWM ID:         %u\r",     Loop1UInt8);
-    uart_send(__LINE__, __func__, "GPIO:           %u\r",     Pwm[Loop1UInt8].Gpio);
-    uart_send(__LINE__, __func__, "Slice:          %u\r",     Pwm[Loop1UInt8].Slice);
-    uart_send(__LINE__, __func__, "Channel:        %u\r",     Pwm[Loop1UInt8].Channel);
-    uart_send(__LINE__, __func__, "ClockDivider:   %f\r",     Pwm[Loop1UInt8].ClockDivider);
-    uart_send(__LINE__, __func__, "Clock:          %lu\r",    Pwm[Loop1UInt8].Clock);
-    uart_send(__LINE__, __func__, "Frequency:      %lu\r",    Pwm[Loop1UInt8].Frequency);
-    uart_send(__LINE__, __func__, "Wrap:           %u\r",     Pwm[Loop1UInt8].Wrap);
-    // uart_send(__LINE__, __func__, "DutyCycle:      %u\r",     Pwm[Loop1UInt8].DutyCycle);
-    uart_send(__LINE__, __func__, "Level:          %u\r\r\r", Pwm[Loop1UInt8].Level);
-  }
+      CLK_HIGH;
 
-  if (DebugBitMask & DEBUG_FLOW) printf("Exiting pwm_display_parameters()\r");
+      ///// win_part_cls(WIN_DATE, 202, 202);
 
-  return;
-}
+      /* If golden age mode is On, alternate between date and period of the day. */
+      if ((FlashConfig1.FlagGoldenAge) && ((CurrentTime.Second % 10) < 5))
+      {
+        /* Display period of the day. */
+        if ((CurrentTime.Hour >= FlashConfig1.GoldenMorningStart)   && (CurrentTime.Hour < FlashConfig1.GoldenAfternoonStart))
+          win_printf(WIN_DATE, 202, 99, FONT_5x7, "%s", DayPeriod[MORNING]);
+        if ((CurrentTime.Hour >= FlashConfig1.GoldenAfternoonStart) && (CurrentTime.Hour < FlashConfig1.GoldenEveningStart))
+          win_printf(WIN_DATE, 202, 99, FONT_5x7, "%s", DayPeriod[AFTERNOON]);
+        if ((CurrentTime.Hour >= FlashConfig1.GoldenEveningStart)   && (CurrentTime.Hour < FlashConfig1.GoldenNightStart))
+          win_printf(WIN_DATE, 202, 99, FONT_5x7, "%s", DayPeriod[EVENING]);
+        if ((CurrentTime.Hour >= FlashConfig1.GoldenNightStart)     || (CurrentTime.Hour < FlashConfig1.GoldenMorningStart))
+          win_printf(WIN_DATE, 202, 99, FONT_5x7, "%s", DayPeriod[NIGHT]);
+      }
+      else
+      {
+        /* If we were in golden age mode and we revert to "normal" mode, let's reset current color. */
+        if (CurrentColor != 0) CurrentColor = 0;
 
+        /* Display date on WIN_DATE window while centering it on the lines. */
+        win_printf(WIN_DATE, 202, 99, FONT_5x7, "%2.2u-%3s-%4.4u", CurrentTime.DayOfMonth, ShortMonth[CurrentTime.Month], CurrentTime.Year);
+      }
 
+      CLK_LOW;
 
+      /// critical_section_exit(&ThreadLock);
 
-/* $PAGE */
-/* $TITLE=pwm_initialize() */
-/* ============================================================================================================================================================= *\
-                                                                            Initialize PWM:
-                                                                    For display matrix brightness.
-\* ============================================================================================================================================================= */
-void pwm_initialize(void)
-{
-  UCHAR String[128];
+      /* Restore original PWM level when done. */
+      ///// pwm_set_level(PWM_ID_BRIGHTNESS, PwmLevel);
+      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_ON);
+    }
+  }
 
-  UINT8 Loop1UInt8;
 
-  UINT32 SystemClock;
 
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+             Update Alarms indicators and Alarm target days indicators on unused top and bottom rows of WIN_DATE window.
+             NOTE: Even if we are scrolling text, alarm indicators and target alarm day indicators should not interfere.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  if (FlagLocalDebug) printf("%4u   Before updating alarm and day-of-week indicators\r", __LINE__);
+  if (WinTop == WIN_DATE)
+  {
+    /* Indicators are presented once all of them have been updated (see RGB_matrix_draw_begin()). */
+    RGB_matrix_draw_begin();
+
+    /* Find all days-of-week that are target days for all active alarms. */
+    TargetDays = 0;  // bitmask of all days that are target days in one or more alarms.
+    for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ALARMS; ++Loop1UInt16)
+    {
+      if (FlashConfig1.Alarm[Loop1UInt16].FlagStatus)
+        TargetDays |= FlashConfig1.Alarm[Loop1UInt16].DayMask;
+    }
 
-  if (DebugBitMask & DEBUG_PWM) printf("Entering pwm_initialize()\r");
+    /* --------------- Update active / inactive alarm indicators. --------------- */
+    if (FlashConfig1.FlagDisplayAlarms)
+    {
+      for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ALARMS; ++Loop1UInt16)
+      {
+        RGB_matrix_set_pixel(FrameBuffer, 0, (3 + (Loop1UInt16 * 7)), 0, (4 + (Loop1UInt16 * 7)));
+        if (FlashConfig1.Alarm[Loop1UInt16].FlagStatus)
+          RGB_matrix_set_color(0, (3 + (Loop1UInt16 * 7)), 0, (4 + (Loop1UInt16 * 7)), GREEN);  // active alarms have green indicators.
+        else
+          RGB_matrix_set_color(0, (3 + (Loop1UInt16 * 7)), 0, (4 + (Loop1UInt16 * 7)), RED);    // inactive alarms have red indicators.
+      }
+    }
 
-  /* Retrieve system clock (Pico is 125 MHz). */
-  SystemClock = clock_get_hz(clk_sys);
+    /* --------------- Update active / inactive target alarm days. --------------- */
+    if (FlashConfig1.FlagDisplayAlarmDays)
+    {
+      for (Loop1UInt16 = 0; Loop1UInt16 < 7; ++Loop1UInt16)
+      {
+        RGB_matrix_set_pixel(FrameBuffer, Window[WIN_DATE].EndRow, (Loop1UInt16 * 10), Window[WIN_DATE].EndRow, (3 + (Loop1UInt16 * 10)));
+        if (TargetDays & (1 << Loop1UInt16))
+          RGB_matrix_set_color(Window[WIN_DATE].EndRow, (Loop1UInt16 * 10), Window[WIN_DATE].EndRow, (3 + (Loop1UInt16 * 10)), GREEN);  // days-of-week that have an active alarm have a green indicator.
+        else
+          RGB_matrix_set_color(Window[WIN_DATE].EndRow, (Loop1UInt16 * 10), Window[WIN_DATE].EndRow, (3 + (Loop1UInt16 * 10)), RED);    // days-of-week that don't have any active alarm have a red indicator.
+      }
+    }
 
+    RGB_matrix_draw_end();
+  }
 
-  /* Initialize all GPIOs requiring PWM. */
-  for (Loop1UInt8 = PWM_ID_LO_LIMIT; Loop1UInt8 < PWM_ID_HI_LIMIT; ++Loop1UInt8)
+
+
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                          Update time on bottom half of RGB matrix LED display.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  if (FlagLocalDebug) printf("%u   Before updating time\r", __LINE__);
+  if (Window[WIN_TIME].FlagBotScroll == FLAG_OFF)
   {
-    /* Initialize the specified GPIO as a PWM output. */
-    gpio_init(Pwm[Loop1UInt8].Gpio);
-    gpio_set_function(Pwm[Loop1UInt8].Gpio, GPIO_FUNC_PWM);
+    /* Display time on WIN_TIME window. */
+    if (WinBot == WIN_TIME)
+    {
+      /* Update time only if WIN_TIME is the WinBot active window. */
+      ///// PwmLevel = Pwm[PWM_ID_BRIGHTNESS].Level;  // keep track of original PWM level on entry.
+      ///// pwm_set_level(PWM_ID_BRIGHTNESS, 2000);   // blank LED matrix before matrix update.
+      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_OFF);
+
+      /// critical_section_enter_blocking(&ThreadLock);
+
+      CLK_HIGH;
+
+      /* Update time. */
+      win_printf(WIN_TIME, 203, 99, FONT_8x10, "%2.2u:%2.2u:%2.2u", CurrentTime.Hour, CurrentTime.Minute, CurrentTime.Second);
 
-    /* Get PWM slice number for this PWM, depending on which GPIO it is connected to (for RGB Matrix, OE = GPIO 13 = Slice 6). */
-    Pwm[Loop1UInt8].Slice = pwm_gpio_to_slice_num(Pwm[Loop1UInt8].Gpio);
 
-    /* Get PWM channel number for this PWM, depending on which GPIO it is connected to (for RGB Matrix, OE = GPIO 13 = Channel 1). */
-    Pwm[Loop1UInt8].Channel = pwm_gpio_to_channel(Pwm[Loop1UInt8].Gpio);
+      /* win_part_cls() will erase all the WIN_TIME window, except the border. If we want the "endless loop" pilot
+         inside this window area, we need to proceed another way. */
+      // win_part_cls(WIN_TIME, 203, 203);
 
+      /* Update time while blinking the two double-dots. */
+      // if (CurrentTime.Second % 2)
+      //   win_printf(WIN_TIME, 203, 99, FONT_8x10, "%2.2u %2.2u %2.2u", CurrentTime.Hour, CurrentTime.Minute, CurrentTime.Second);
+      // else
+      //   win_printf(WIN_TIME, 203, 99, FONT_8x10, "%2.2u:%2.2u:%2.2u", CurrentTime.Hour, CurrentTime.Minute, CurrentTime.Second);
 
-    /* For passive buzzer, slow down the 125 MHz system clock to get a PWM clock that is more flexible to reach lower frequencies for audio sounds with the counter / wrap. */
-    Pwm[Loop1UInt8].ClockDivider = SystemClock / 100000000.0;  // ClockDivider will be 1.25000, ending up with a 100 MHz clock.
-    Pwm[Loop1UInt8].Clock        = (UINT32)(SystemClock / Pwm[Loop1UInt8].ClockDivider);  // keep track of resulting clock value.
-    pwm_set_clkdiv(Pwm[Loop1UInt8].Slice, Pwm[Loop1UInt8].ClockDivider);  // slow down the clock for this PWM slice.
+      /* If we are in golden age mode, set the color according to the period of the day (day or night) while leaving the WIN_TIME box,
+         alarm indicators and target days indicators in their original colors. */
+      if (FlashConfig1.FlagGoldenAge)
+      {
+        if ((CurrentTime.Hour >= FlashConfig1.GoldenMorningStart) && (CurrentTime.Hour < FlashConfig1.GoldenNightStart))
+        {
+          if (CurrentColor != YELLOW)
+          {
+            CurrentColor = YELLOW;
 
+            /* Set colors of WIN_TIME window without altering alarm indicators and alarm target day indicators. */
+            RGB_matrix_set_color(Window[WIN_DATE].StartRow + 1, Window[WIN_DATE].StartColumn, Window[WIN_DATE].EndRow - 1, Window[WIN_DATE].EndColumn, CurrentColor);
+            /// win_set_color(WIN_DATE, CurrentColor, Window[WIN_DATE].BoxColor);  // WIN_DATE, except outside box.
 
-    /* Complete initialization specific with each PWM. */
-    switch (Loop1UInt8)
-    {
-      case (PWM_ID_BRIGHTNESS):
-        /* Set current values in PWM structure. */
-        Pwm[Loop1UInt8].Frequency = 50000;
-        Pwm[Loop1UInt8].Wrap      = (UINT16)(Pwm[Loop1UInt8].Clock / (Pwm[Loop1UInt8].Frequency - 1));  // counter will wrap around to provide the wanted frequency.
-        Pwm[Loop1UInt8].DutyCycle = 0;  // set duty cycle at 0% (blank) on entry, during power-up sequence.
-        Pwm[Loop1UInt8].Level     = (UINT16)(Pwm[Loop1UInt8].Wrap * ((100 - Pwm[Loop1UInt8].DutyCycle) / 100.0));  // since OE is active low, reverse the duty cycle.
+            /* Set colors for WIN_TIME window without changing border color. */
+            RGB_matrix_set_color(Window[WIN_TIME].StartRow + 1, Window[WIN_TIME].StartColumn + 1, Window[WIN_TIME].EndRow - 1, Window[WIN_TIME].EndColumn - 1, CurrentColor);
+            /// win_set_color(WIN_TIME, CurrentColor, Window[WIN_TIME].BoxColor);
+          }
+        }
+        else
+        {
+          if (CurrentColor != BLUE)
+          {
+            CurrentColor = BLUE;
 
-        CLK_HIGH;
+            /* Set colors of WIN_TIME window without altering alarm indicators and alarm target day indicators. */
+            RGB_matrix_set_color(Window[WIN_DATE].StartRow + 1, Window[WIN_DATE].StartColumn, Window[WIN_DATE].EndRow - 1, Window[WIN_DATE].EndColumn, CurrentColor);
+            /// win_set_color(WIN_DATE, CurrentColor, Window[WIN_DATE].BoxColor);  // WIN_DATE, except outside box.
 
-        /* Set PWM frequency by setting a counter wrap value. */
-        pwm_set_wrap(Pwm[Loop1UInt8].Slice, Pwm[Loop1UInt8].Wrap);
+            /* Set colors for WIN_TIME window without changing border color. */
+            RGB_matrix_set_color(Window[WIN_TIME].StartRow + 1, Window[WIN_TIME].StartColumn + 1, Window[WIN_TIME].EndRow - 1, Window[WIN_TIME].EndColumn - 1, CurrentColor);
+            /// win_set_color(WIN_TIME, CurrentColor, Window[WIN_TIME].BoxColor);
+          }
+        }
 
-        /* Set PWM duty cycle given the Divider, Counter and Frequency current values. */
-        pwm_set_chan_level(Pwm[Loop1UInt8].Slice, Pwm[Loop1UInt8].Channel, Pwm[Loop1UInt8].Level);
+        /* Draw border for WIN_TIME window. */
+        /// RGB_matrix_box(Window[WIN_TIME].StartRow, Window[WIN_TIME].StartColumn, Window[WIN_TIME].EndRow, Window[WIN_TIME].EndColumn, RED, ACTION_DRAW);
+      }
 
-        /* Start PWM. */
-        pwm_set_enabled(Pwm[Loop1UInt8].Slice, TRUE);
+      CLK_LOW;
 
-        CLK_LOW;
-      break;
+      /// critical_section_exit(&ThreadLock);
+
+      /* Restore original PWM level when done. */
+      ///// pwm_set_level(PWM_ID_BRIGHTNESS, PwmLevel);
+      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_ON);
     }
   }
 
-  if (DebugBitMask & DEBUG_PWM) printf("Exiting pwm_initialize()\r");
+  if (FlagLocalDebug) printf("%4u   Exiting RGB_matrix_display_time()\r", __LINE__);
 
   return;
 }
@@ -9887,71 +12559,59 @@ void pwm_initialize(void)
 
 
 
+/* $TITLE=RGB_matrix_draw_begin() */
 /* $PAGE */
-/* $TITLE=pwm_on_off() */
 /* ============================================================================================================================================================= *\
-                                                       Turn On or Off the PWM signal specified in argument.
+                          Mark the beginning of a change to FrameBuffer / ColorPlane that must not be presented to the scan half-done.
+   NOTES:
+   1) RGB_matrix_present() runs on core 1 (scroll tick and 50 msec callback) and does not pack anything while a drawing function is in
+      progress on core 0, so that a string, a box or a window is never displayed partly drawn. Changes are presented on the next call.
+   2) Calls may be nested: the change is over when the outermost RGB_matrix_draw_end() is called. Every RGB_matrix_draw_begin() must
+      be matched by a RGB_matrix_draw_end().
+   3) If packing is in progress when a drawing function begins, it waits until packing is over (a few tens of microseconds at most).
+   4) Drawing functions called on core 1 run between two RGB_matrix_present() of the same core and need no protection.
 \* ============================================================================================================================================================= */
-void pwm_on_off(UINT8 PwmNumber, UINT8 FlagSwitch)
+void RGB_matrix_draw_begin(void)
 {
-  UCHAR String[256];
-
+  UINT32 InterruptMask;
 
-  if (DebugBitMask & DEBUG_FLOW) printf("Entering pwm_on_off()\r");
 
-  Pwm[PwmNumber].OnOff = FlagSwitch;
+  if (get_core_num() != 0) return;
 
-  if (Pwm[PwmNumber].OnOff == FLAG_ON)
-  {
-    /* Turn On PWM signal. */
-    /// uart_send(__LINE__, __func__, "Turning On  PWM signal %u  Slice: %u\r", PwmNumber, Pwm[PwmNumber].Slice);
-    pwm_set_enabled(Pwm[PwmNumber].Slice, TRUE);
-  }
-  else
+  while (1)
   {
-    /* Turn Off PWM signal. */
-    /// uart_send(__LINE__, __func__, "Turning Off PWM signal %u  Slice: %u\r", PwmNumber, Pwm[PwmNumber].Slice);
-    pwm_set_enabled(Pwm[PwmNumber].Slice, FALSE);
-  }
-
-  if (DebugBitMask & DEBUG_FLOW) printf("Exiting pwm_on_off()\r");
+    InterruptMask = spin_lock_blocking(DirtyLock);
+    if (FlagPacking == FLAG_OFF)
+    {
+      ++DrawNesting;
+      spin_unlock(DirtyLock, InterruptMask);
 
-  return;
+      return;
+    }
+    spin_unlock(DirtyLock, InterruptMask);
+  }
 }
 
 
 
 
 
+/* $TITLE=RGB_matrix_draw_end() */
 /* $PAGE */
-/* $TITLE=pwm_set_duty_cycle() */
 /* ============================================================================================================================================================= *\
-                                             Set the duty cycle for the PWM controlling the display matrix brightness.
-                            NOTES:
-                            Duty cycle is given as a percentage. For example, a value of "50" means 50% for duty cycle
-                            Since "Output Enable" (OE) is active low, a duty cycle of 75% means that PWM signal means that PWM line must be "Low@
-                            for 25% of its time. So, we have to reverse the value sent to the Pico.
+                                          Mark the end of a change begun with RGB_matrix_draw_begin() (see RGB_matrix_draw_begin()).
 \* ============================================================================================================================================================= */
-void pwm_set_duty_cycle(UINT8 DutyCycle)
+void RGB_matrix_draw_end(void)
 {
-  UINT8 Loop1UInt8;
-
-
-  /* Validate value specified for duty cycle. */
-  if (DutyCycle > 99) DutyCycle = 99;
-
-  /* Compute the PWM Level required to have the desired duty cycle. */
-  Pwm[PWM_ID_BRIGHTNESS].Level = (UINT16)(Pwm[PWM_ID_BRIGHTNESS].Wrap * ((100 - DutyCycle) / 100.0));
-
-  CLK_HIGH;
+  UINT32 InterruptMask;
 
-  /* Set PWM duty cycle given the Divider, Counter and Frequency current values. */
-  pwm_set_chan_level(Pwm[PWM_ID_BRIGHTNESS].Slice, Pwm[PWM_ID_BRIGHTNESS].Channel, Pwm[PWM_ID_BRIGHTNESS].Level);
 
-  /* Set new values in PWM structure. */
-  Pwm[PWM_ID_BRIGHTNESS].DutyCycle = DutyCycle;
+  if (get_core_num() != 0) return;
 
-  CLK_LOW;
+  /* Spin lock also makes sure the change is completely written before it may be packed. */
+  InterruptMask = spin_lock_blocking(DirtyLock);
+  if (DrawNesting) --DrawNesting;
+  spin_unlock(DirtyLock, InterruptMask);
 
   return;
 }
@@ -9960,326 +12620,325 @@ void pwm_set_duty_cycle(UINT8 DutyCycle)
 
 
 
+/* $TITLE=RGB_matrix_get_color() */
 /* $PAGE */
-/* $TITLE=pwm_set_frequency() */
 /* ============================================================================================================================================================= *\
-                                                          Set the frequency for the specified PWM.
+                                                         Return the color of the specified matrix pixel (BLACK to WHITE).
 \* ============================================================================================================================================================= */
-void pwm_set_frequency(UINT8 PwmNumber, UINT32 Frequency)
+UINT8 RGB_matrix_get_color(UINT8 RowNumber, UINT8 ColumnNumber)
 {
-  /* Indicate current PWM values. */
-  Pwm[PwmNumber].Frequency = Frequency;
-  Pwm[PwmNumber].Wrap      = (UINT16)(Pwm[PwmNumber].Clock / Pwm[PwmNumber].Frequency);
+  UINT8 Color;
 
-  /* Set PWM frequency by setting a counter wrap value. */
-  pwm_set_wrap(Pwm[PwmNumber].Slice, Pwm[PwmNumber].Wrap);
 
-  /* Since we change the frequency, adjust duty cycle accordingly. */
-  Pwm[PwmNumber].Level = (UINT16)(Pwm[PwmNumber].Wrap * (Pwm[PwmNumber].DutyCycle / 100.0));
+  Color = BLACK;
+  if ((RowNumber >= MAX_ROWS) || (ColumnNumber >= MAX_COLUMNS)) return Color;
 
-  /* Set PWM duty cycle given the Divider, Counter and Frequency current values. */
-  pwm_set_chan_level(Pwm[PwmNumber].Slice, Pwm[PwmNumber].Channel, Pwm[PwmNumber].Level);
+  if (ColorPlane[PLANE_RED][RowNumber]   & (0x01ll << ColumnNumber)) Color |= RED;
+  if (ColorPlane[PLANE_GREEN][RowNumber] & (0x01ll << ColumnNumber)) Color |= GREEN;
+  if (ColorPlane[PLANE_BLUE][RowNumber]  & (0x01ll << ColumnNumber)) Color |= BLUE;
 
-  return;
+  return Color;
 }
 
 
 
 
+
+/* $TITLE=RGB_matrix_get_nibbles() */
 /* $PAGE */
-/* $TITLE=pwm_set_level() */
 /* ============================================================================================================================================================= *\
-                                                          Set the PWM "Level" for the specified PWM.
+                          Return the colors of the specified scan row pixel pair in the legacy DisplayRGB format.
+                          NOTE: Adaptor for code still working with DisplayRGB nibbles: low nibble is the color of the pixel in top half
+                                of the matrix (RowNumber), high nibble is the color of the pixel in bottom half (RowNumber + HALF_ROWS).
 \* ============================================================================================================================================================= */
-void pwm_set_level(UINT8 PwmNumber, UINT16 Level)
+UCHAR RGB_matrix_get_nibbles(UINT8 RowNumber, UINT8 ColumnNumber)
 {
-  /* Validation of Level value given in argument. */
-  if (Level < PWM_LO_LIMIT) Level = PWM_LO_LIMIT;
-  if (Level > PWM_HI_LIMIT) Level = PWM_HI_LIMIT;
-
-  /* Indicate current PWM values. */
-  Pwm[PwmNumber].Level = Level;
-
-  /* Set PWM level. */
-  CLK_HIGH;
-  pwm_set_chan_level(Pwm[PwmNumber].Slice, Pwm[PwmNumber].Channel, Pwm[PwmNumber].Level);
-  CLK_LOW;
-
-  return;
+  return (RGB_matrix_get_color(RowNumber, ColumnNumber) | (RGB_matrix_get_color(RowNumber + HALF_ROWS, ColumnNumber) << 4));
 }
 
 
 
 
-/* $TITLE=queue_add_active() */
+
+/* $TITLE=RGB_matrix_glyph_blit() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-        Queue the given sound in the active buzzer sound queue. Use the queue algorithm where one slot is lost. This prevents the use of a lock mechanism.
+                              Merge the bitmap of a glyph in the specified buffer, beginning at StartRow / StartColumn (top left of glyph).
+                   NOTES:
+                   1) Glyph rows are defined with their leftmost pixel as the most significant of GlyphWidth bits (see font.h), while
+                      matrix column 0 is bit 0 of a matrix row. Each glyph row is mirrored once, then merged with one shift and mask.
+                   2) CharWidth (GlyphWidth or more) columns are written, columns past GlyphWidth being turned Off.
+                   3) Rows and columns falling outside of the matrix are clipped.
 \* ============================================================================================================================================================= */
-UINT16 queue_add_active(UINT16 MSeconds, UINT16 RepeatCount)
+void RGB_matrix_glyph_blit(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 StartColumn, const UINT8 *GlyphRow, UINT8 GlyphHeight, UINT8 GlyphWidth, UINT8 CharWidth)
 {
-  UCHAR String[256];
-
+  UINT8  Bits;
+  UINT8  RowNumber;
 
-  /* Trap circular buffer corruption. */
-  /***/
-  if ((QueueActiveSound.Head > MAX_ACTIVE_SOUND_QUEUE) || (QueueActiveSound.Tail > MAX_ACTIVE_SOUND_QUEUE))
-  {
-    if (DebugBitMask & DEBUG_SOUND_QUEUE)
-      uart_send(__LINE__, __func__, "- A-Corrupted:        %5u   %5u\r", QueueActiveSound.Head, QueueActiveSound.Tail);
+  UINT64 ColumnMask;
 
-    QueueActiveSound.Head = 0;
-    QueueActiveSound.Tail = 0;
 
-    return 0;
-  }
-  /***/
+  if ((StartRow >= MAX_ROWS) || (StartColumn >= MAX_COLUMNS) || (CharWidth == 0)) return;
+  if (GlyphWidth > 8) GlyphWidth = 8;
+  if ((StartRow + GlyphHeight) > MAX_ROWS) GlyphHeight = MAX_ROWS - StartRow;
 
+  ColumnMask = RGB_matrix_span_mask(StartColumn, StartColumn + CharWidth - 1);
 
-  /* Check if the active buzzer sound queue is full. */
-  if (((QueueActiveSound.Tail > 0) && (QueueActiveSound.Head == QueueActiveSound.Tail - 1)) || ((QueueActiveSound.Tail == 0) && (QueueActiveSound.Head == MAX_ACTIVE_SOUND_QUEUE - 1)))
+  for (RowNumber = 0; RowNumber < GlyphHeight; ++RowNumber)
   {
-    /* Sound queue is full, return error code. */
-    return MAX_ACTIVE_SOUND_QUEUE;
-  }
-
-  /* If there is at least one slot available in the queue, insert the sound to be played. */
-  QueueActiveSound.Element[QueueActiveSound.Head].MSec        = MSeconds;
-  QueueActiveSound.Element[QueueActiveSound.Head].RepeatCount = RepeatCount;
-  ++QueueActiveSound.Head;
-
-  if (DebugBitMask & DEBUG_SOUND_QUEUE)
-    uart_send(__LINE__, __func__, "- A-Queueing:            %5u   %5u\r", MSeconds, RepeatCount);
+    /* Mirror the 8 bits of this glyph row, then align its leftmost pixel on bit 0. */
+    Bits = GlyphRow[RowNumber];
+    Bits = ((Bits & 0xF0) >> 4) | ((Bits & 0x0F) << 4);
+    Bits = ((Bits & 0xCC) >> 2) | ((Bits & 0x33) << 2);
+    Bits = ((Bits & 0xAA) >> 1) | ((Bits & 0x55) << 1);
+    Bits >>= (8 - GlyphWidth);
 
+    DisplayBuffer[StartRow + RowNumber] = (DisplayBuffer[StartRow + RowNumber] & ~ColumnMask) | (((UINT64)Bits << StartColumn) & ColumnMask);
+  }
 
-  /* If reaching end of circular buffer, revert to beginning. */
-  if (QueueActiveSound.Head >= MAX_ACTIVE_SOUND_QUEUE) QueueActiveSound.Head = 0;
+  if (DisplayBuffer == FrameBuffer) RGB_matrix_dirty(StartRow, StartRow + GlyphHeight - 1);
 
-  return 0;
+  return;
 }
 
 
 
 
 
+/* $TITLE=RGB_matrix_integrity_check() */
 /* $PAGE */
-/* $TITLE=queue_free_active() */
 /* ============================================================================================================================================================= *\
-                                                    Return the number of free slots in active sound queue.
+                                                               LED matrix device integrity check
+                                Turn On and Off each line of the LED matrix and for each color and combination of colors.
+              NOTE: FlagTerminal indicates if caller is a terminal emulator or remote control. If remote control, the check is performed unattended.
 \* ============================================================================================================================================================= */
-UINT8 queue_free_active(void)
+void RGB_matrix_integrity_check(UINT8 FlagTerminal)
 {
-  UINT8 RemainingSlots;
+  UCHAR String[31];
 
+  UINT8 Color;
+  UINT8 ColumnNumber;
+  UINT8 PassNumber;
+  UINT8 RowNumber;
+  UINT8 SectorNumber;
 
-  if (QueueActiveSound.Head > QueueActiveSound.Tail)
-  {
-    RemainingSlots = MAX_ACTIVE_SOUND_QUEUE - QueueActiveSound.Head + QueueActiveSound.Tail - 1;
-    if (DebugBitMask & DEBUG_SOUND_QUEUE)
-      uart_send(__LINE__, __func__, "Active queue remaining space: %5u  Head: %3u  Tail: %3u\r", RemainingSlots, QueueActiveSound.Head, QueueActiveSound.Tail);
-  }
 
-  if (QueueActiveSound.Head == QueueActiveSound.Tail)
-  {
-    RemainingSlots = MAX_ACTIVE_SOUND_QUEUE - 1;
-    if (DebugBitMask & DEBUG_SOUND_QUEUE)
-      uart_send(__LINE__, __func__, "Active queue remaining space: %5u  Head: %3u  Tail: %3u\r", RemainingSlots, QueueActiveSound.Head, QueueActiveSound.Tail);
-  }
+  printf("\r\r\r");
+  if (FlagTerminal) uart_send(__LINE__, __func__, "%4u   Entering RGB Matrix device integrity check.\r", __LINE__);
 
-  if (QueueActiveSound.Head < QueueActiveSound.Tail)
+  if (FlagTerminal)
   {
-    RemainingSlots = QueueActiveSound.Tail - QueueActiveSound.Head - 1;
-    if (DebugBitMask & DEBUG_SOUND_QUEUE)
-      uart_send(__LINE__, __func__, "Active queue remaining space: %5u  Head: %3u  Tail: %3u\r", RemainingSlots, QueueActiveSound.Head, QueueActiveSound.Tail);
+    if (stdio_usb_connected())
+    {
+      uart_send(__LINE__, __func__, "Press <Enter> to erase LED matrix: ");
+      input_string(String);
+    }
   }
 
-  return RemainingSlots;
-}
-
-
-
-
-
-/* $PAGE */
-/* $TITLE=queue_remove_active() */
-/* ============================================================================================================================================================= *\
-                                                    Unqueue next sound from the active buzzer sound queue.
-\* ============================================================================================================================================================= */
-UINT8 queue_remove_active(UINT16 *MSeconds, UINT16 *RepeatCount)
-{
-  UINT16 Loop1UInt16;
-
-  UINT32 CurrentTail;
+  win_open(WIN_TEST, FLAG_OFF);
+  win_printf(WIN_TEST,  2, 99, FONT_5x7, "Device");
+  win_printf(WIN_TEST, 10, 99, FONT_5x7, "integrity");
+  win_printf(WIN_TEST, 18, 99, FONT_5x7, "check");
 
 
-  /* Trap circular buffer corruption. */
-  if ((QueueActiveSound.Head > MAX_ACTIVE_SOUND_QUEUE) || (QueueActiveSound.Tail > MAX_ACTIVE_SOUND_QUEUE))
+  /* -------------------- Top down test -------------------- */
+  /* Turn On every line of LED matrix and for each color combination (Red - Green - Blue - Yellow - Magenta - Cyan - White). */
+  if (FlagTerminal)
   {
-    if (DebugBitMask & DEBUG_SOUND_QUEUE)
+    if (stdio_usb_connected())
     {
-      uart_send(__LINE__, __func__, "- A-Corrupted:        %5u   %5u\r", QueueActiveSound.Head, QueueActiveSound.Tail);
-      uart_send(__LINE__, __func__, "MAX_ACTIVE_SOUND_QUEUE: (%u)   Head: %4u   Tail: %4u\r", MAX_ACTIVE_SOUND_QUEUE, QueueActiveSound.Head, QueueActiveSound.Tail);
-      uart_send(__LINE__, __func__, "          MSec    Repeat\r");
-
-      for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ACTIVE_SOUND_QUEUE; ++Loop1UInt16)
-        uart_send(__LINE__, __func__, " %4u-   %5u     %5u\r", Loop1UInt16, QueueActiveSound.Element[Loop1UInt16].MSec, QueueActiveSound.Element[Loop1UInt16].RepeatCount);
+      uart_send(__LINE__, __func__, "Press <Enter> to begin top-down integrity check: ");
+      input_string(String);
+      uart_send(__LINE__, __func__, "Running top-down integrity check.\r");
     }
-
-    QueueActiveSound.Head = 0;
-    QueueActiveSound.Tail = 0;
-
-    return 0xFF;
   }
+  else
+    sleep_ms(2000);
 
+  RGB_matrix_cls(FrameBuffer);
 
-  /* Check if active sound queue is empty. */
-  if (QueueActiveSound.Head == QueueActiveSound.Tail)
-  {
-    /* In case of empty queue or queue error, return 0 as milliseconds and repeat count. */
-    *MSeconds    = 0;
-    *RepeatCount = 0;
-
-    /***
-    if (DebugBitMask & DEBUG_SOUND_QUEUE)
-      uart_send(__LINE__, "- A-Empty:               %5u   %5u\r", QueueActiveSound.Head, QueueActiveSound.Tail);
-    ***/
 
-    return 0xFF;
-  }
-  else
+  /* Test all seven color combinations. */
+  for (PassNumber = 0; PassNumber < 7; ++PassNumber)
   {
-    /* Active sound queue is not empty. */
-    if (DebugBitMask & DEBUG_SOUND_QUEUE)
-      uart_send(__LINE__, __func__, "- A-NotEmpty:            %5u   %5u\r", QueueActiveSound.Head, QueueActiveSound.Tail);
-
-    /* Extract data for next sound to play. */
-    *MSeconds    = QueueActiveSound.Element[QueueActiveSound.Tail].MSec;
-    *RepeatCount = QueueActiveSound.Element[QueueActiveSound.Tail].RepeatCount;
+    if (FlagTerminal) uart_send(__LINE__, __func__, "Proceeding with top-down integrity check, pass number %u\r", PassNumber);
+    switch (PassNumber)
+    {
+      case (0):
+        Color = RED;
+      break;
 
+      case (1):
+        Color = GREEN;
+      break;
 
-    /* And reset this slot in the sound queue. */
-    QueueActiveSound.Element[QueueActiveSound.Tail].MSec        = 0;
-    QueueActiveSound.Element[QueueActiveSound.Tail].RepeatCount = 0;
+      case (2):
+        Color = BLUE;
+      break;
 
+      case (3):
+        Color = RED + GREEN;
+      break;
 
-    /***
-    if (DebugBitMask & DEBUG_SOUND_QUEUE)
-      uart_send(__LINE__, __func__, "- A-Unqueuing %3u:        %5u   %5u\r", QueueActiveSound.Tail, *MSeconds, *RepeatCount);
-    ***/
+      case (4):
+        Color = RED + BLUE;
+      break;
 
+      case (5):
+        Color = GREEN + BLUE;
+      break;
 
-    if ((*MSeconds != 0) && (*RepeatCount <= 100))
-    {
-      /* The sound found in this slot is valid. Point to next slot for next cycle. */
-      ++QueueActiveSound.Tail;
+      case (6):
+      default:
+        Color = RED + GREEN + BLUE;
+      break;
+    }
 
-      /* If reaching end of circular buffer, revert to beginning. */
-      if (QueueActiveSound.Tail >= MAX_ACTIVE_SOUND_QUEUE) QueueActiveSound.Tail = 0;
+    /* Test the LED matrix with all color compinations above. */
+    RGB_matrix_set_color(0, 0, 31, 63, Color);
 
-      return 0;
-    }
-    else
+    /* Sequentially turn On all 32 rows of 64 pixels. */
+    /* NOTE: Pixel color has already been set above. */
+    for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
     {
-      /* Sound in this slot was invalid. */
-      if (DebugBitMask & DEBUG_SOUND_QUEUE)
+      FrameBuffer[RowNumber] = 0xFFFFFFFFFFFFFFFFll;  // turn On all 64 pixels of this row.
+
+      if (RowNumber > 7)
       {
-        uart_send(__LINE__, __func__, "- A-Invalid slot: %3u\r", QueueActiveSound.Tail);
-        uart_send(__LINE__, __func__, "- MSec: %3u   RepeatCount: %3u\r", *MSeconds, *RepeatCount);
+        /* When reaching 8th row (or more), turn Off the "oldest" row of pixels so that electronic will not be overloaded.
+           This way, only 8 rows will be turned On at any single time. */
+        FrameBuffer[RowNumber - 8] = 0x00ll;
       }
+      RGB_matrix_dirty(0, RowNumber);
+      sleep_ms(100);  // make a quick pause after each line.
+    }
 
-      /* If this slot was corrupted, make some housekeeping. */
-      CurrentTail = QueueActiveSound.Tail; // keep track of starting position in the queue.
-
-      /* In case of empty queue or queue error, return 0 as milliseconds and repeat count. */
-      *MSeconds    = 0;
-      *RepeatCount = 0;
-
+    /* When the 32nd row has been turned On, complete turning Off last 8 rows (row 24 to 31). */
+    for (RowNumber = 24; RowNumber < MAX_ROWS; ++RowNumber)
+    {
+      FrameBuffer[RowNumber] = 0x00ll;
+      RGB_matrix_dirty(RowNumber, RowNumber);
+      sleep_ms(100);
+    }
 
-      /* Clean all active sound queue. */
-      do
+    if (FlagTerminal)
+    {
+      if (stdio_usb_connected())
       {
-        QueueActiveSound.Element[QueueActiveSound.Tail].MSec        = 0;
-        QueueActiveSound.Element[QueueActiveSound.Tail].RepeatCount = 0;
-
-
-        ++QueueActiveSound.Tail;
+        uart_send(__LINE__, __func__, "Press <Enter> to proceed with next pass or <ESC> to exit this test: ");
+        input_string(String);
+      }
+    }
+    else
+      sleep_ms(1000);
 
-        /* If reaching end of circular buffer, revert to beginning. */
-        if (QueueActiveSound.Tail >= MAX_ACTIVE_SOUND_QUEUE) QueueActiveSound.Tail = 0;
-      } while (QueueActiveSound.Tail != CurrentTail);  // if we come back to where we started from, sound queue has all been cleaned up.
+    RGB_matrix_cls(FrameBuffer);
+    if (String[0] == 27) break;  // user pressed <ESC>, get out of <for> loop and exit top-down integrity check.
+    if (IrBuffer[0] != BUTTON_NONE) break;  // user pressed a remote control button, get out of <for> loop and exit top-down integrity check.
+  }
+  if (FlagTerminal) printf("\r\r\r");
 
-      QueueActiveSound.Head = QueueActiveSound.Tail;
 
-      if (DebugBitMask & DEBUG_SOUND_QUEUE)
-        uart_send(__LINE__, __func__, "- A-Done:                %5u   %5u\r", QueueActiveSound.Head, QueueActiveSound.Tail);
 
-      return 0xFF;
+  /* ------------------ Left-to-right test ------------------ */
+  /* Turn On every column of LED matrix and for each color combination (Red - Green - Blue - Yellow - Magenta - Cyan - White). */
+  if (FlagTerminal)
+  {
+    if (stdio_usb_connected())
+    {
+      uart_send(__LINE__, __func__, "Press <Enter> to begin left-to-right integrity check: ");
+      input_string(String);
+      uart_send(__LINE__, __func__, "Running left-to-right integrity check.\r");
     }
   }
-}
-
-
-
-
+  else
+    sleep_ms(2000);
 
-/* $TITLE=reminder1_check() */
-/* $PAGE */
-/* ============================================================================================================================================================= *\
-                                                            Scan all reminders1 to find those that must be triggered.
-\* ============================================================================================================================================================= */
-void reminder1_check(void)
-{
-#ifdef RELEASE_VERSION
-  UINT8 FlagLocalDebug = FLAG_OFF;  // should be OFF all times
-#else  // RELEASE_VERSION
-  UINT8 FlagLocalDebug = FLAG_ON;
-#endif  // RELEASE_VERSION
+  /* Test all seven color combinations. */
+  for (PassNumber = 0; PassNumber < 7; ++PassNumber)
+  {
+    if (FlagTerminal) uart_send(__LINE__, __func__, "Proceeding with left-to-right check, pass number %u\r", PassNumber);
+    switch (PassNumber)
+    {
+      case (0):
+        Color = RED;
+      break;
 
-  UCHAR String[31];
+      case (1):
+        Color = GREEN;
+      break;
 
-  UINT8 TotalActiveReminders;
+      case (2):
+        Color = BLUE;
+      break;
 
-  UINT16 Loop1UInt16;
+      case (3):
+        Color = RED + GREEN;
+      break;
 
-  time_t UnixTime;
+      case (4):
+        Color = RED + BLUE;
+      break;
 
+      case (5):
+        Color = GREEN+ BLUE;
+      break;
 
-  /// if (FlagLocalDebug) printf("Entering reminder1_check()\r");
+      case (6):
+      default:
+        Color = RED + GREEN + BLUE;
+      break;
+    }
 
-  /* Initialize total number of active reminders. */
-  TotalActiveReminders = 0;
+    /* Test the matrix with all color compinations above. */
+    RGB_matrix_set_color(0, 0, 31, 63, Color);
 
+    /* Sequentially turn On each column of pixels. */
+    for (ColumnNumber = 0; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
+    {
+      for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
+      {
+        FrameBuffer[RowNumber] |= (0x01ll << ColumnNumber);
 
-  /* Find current Unix time. */
-  UnixTime = convert_human_to_unix(&CurrentTime, FLAG_ON);
+        /* When reaching 8th column, turn Off the oldest columns of pixels so that electronic is not overloaded. */
+        if (ColumnNumber > 7)
+        {
+          FrameBuffer[RowNumber] &= ~(0x01ll << (ColumnNumber - 8));
+        }
+      }
+      RGB_matrix_dirty(0, MAX_ROWS - 1);
+      sleep_ms(100);
+    }
 
-  /* Scan all reminders to find those matching current time and day-of-week. */
-  for (Loop1UInt16 = 0; Loop1UInt16 < MAX_REMINDERS1; ++Loop1UInt16)
-  {
-    if (FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime >= UnixTime)
+    /* Complete turning Off last pixel columns. */
+    for (ColumnNumber = 56; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
     {
-      if ((Reminder1BitMask & (0x01ll << Loop1UInt16)) == 0)
+      for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
       {
-        /* This reminder1 was inactive and becomes active. */
-        if (FlagLocalDebug) uart_send(__LINE__, __func__, "Reminder1 %u becomes active\r", Loop1UInt16 + 1);
-        Reminder1BitMask |= (0x01ll << Loop1UInt16);
-        continue;
+        FrameBuffer[RowNumber] &= ~(0x01ll << ColumnNumber);
       }
-      else
+      RGB_matrix_dirty(0, MAX_ROWS - 1);
+      sleep_ms(100);
+    }
+
+    if (FlagTerminal)
+    {
+      if (stdio_usb_connected())
       {
-        /* This reminder1 was already active. */
-        if (FlagLocalDebug) uart_send(__LINE__, __func__, "Reminder1 %u already active\r", Loop1UInt16 + 1);
+        uart_send(__LINE__, __func__, "Press <Enter> to proceed with next pass or <ESC> to exit this test: ");
+        input_string(String);
       }
     }
     else
-    {
-      /* Display reminder1 status for debug purpose. */
-      /// if (FlagLocalDebug) uart_send(__LINE__, __func__, "Reminder1 inactive\r", Loop1UInt16 + 1);
-    }
-  }
+      sleep_ms(1000);
 
+    RGB_matrix_cls(FrameBuffer);
+    if (String[0] == 27) break;  // user pressed <ESC> exit left-to-right integrity check.
+    if (IrBuffer[0] != BUTTON_NONE) break;  // user pressed a remote control button, exit left-to-right integrity check.
+  }
+  if (FlagTerminal) printf("\r\r\r");
 
-  /// if (FlagLocalDebug) printf("Exiting reminder1_check()\r");
+  win_close(WIN_TEST);
 
   return;
 }
@@ -10288,158 +12947,156 @@ void reminder1_check(void)
 
 
 
-/* $TITLE=reminder1_ring() */
+/* $TITLE=RGB_matrix_pack() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                     Feed reminder1 ringer for currently active ("triggered") reminders1.
+                     Regenerate, in the back buffer, the "wire format" of the scan rows whose FrameBuffer or ColorPlane content changed since last call.
+                               NOTE: Changed rows are those flagged in DirtyRowMask by RGB_matrix_dirty(). Matrix rows N and N + 16
+                                     share the same scan row.
+                               Return the number of scan rows that have been packed.
 \* ============================================================================================================================================================= */
-void reminder1_ring(void)
+UINT8 RGB_matrix_pack(void)
 {
-#ifdef RELEASE_VERSION
-  UINT8 FlagLocalDebug = FLAG_OFF;  // should be OFF all times
-#else  // RELEASE_VERSION
-  UINT8 FlagLocalDebug = FLAG_OFF;
-#endif  // RELEASE_VERSION
-
-  UINT16 Loop1UInt16;
-
-  UINT32 CurrentTimer;
+  UINT8 PackCount;
+  UINT8 RowNumber;
 
+  UINT32 InterruptMask;
+  UINT32 RowMask;
 
-  /// if (FlagLocalDebug) printf("Entering reminder1_ring()\r");
 
-  /* When a reminder1 becomes active, reminder_check() will raise its bit in Reminder1BitMask. */
-  if (Reminder1BitMask)
-  {
-    /* If some reminders are active, we'll need current timer to evaluate if it is time to feed ringer. */
-    CurrentTimer = time_us_32();
+  PackCount = 0;
 
-    /* Scan reminders1 to find those requiring ringer repeat. */
-    for (Loop1UInt16 = 0; Loop1UInt16 < MAX_REMINDERS1; ++Loop1UInt16)
-    {
-      /* Check if this reminder1 is active (global ring duration). */
-      if (ActiveReminder1[Loop1UInt16].CountDown > 0)
-      {
-        /* Display details for first active reminder1 number for debug purpose. */
-        if (FlagLocalDebug) uart_send(__LINE__, __func__, "0x%llX - %u - %3u - %3u - %9lu - %9lu - %4u\r", Reminder1BitMask, Loop1UInt16, FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime, ActiveReminder1[Loop1UInt16].CountDown, CurrentTimer, ActiveReminder1[Loop1UInt16].PreviousTimer, (UINT16)((CurrentTimer - ActiveReminder1[Loop1UInt16].PreviousTimer) / 1000000ll));
+  /* Take ownership of the rows flagged so far. Rows modified while packing will be flagged again for next call. */
+  InterruptMask = spin_lock_blocking(DirtyLock);
+  RowMask       = DirtyRowMask;
+  DirtyRowMask  = 0l;
+  spin_unlock(DirtyLock, InterruptMask);
 
-        if (((CurrentTimer - ActiveReminder1[Loop1UInt16].PreviousTimer) / 1000000ll) >= FlashConfig2.Reminder1[Loop1UInt16].RingRepeatTimeSeconds)
-        {
-          if (FlagLocalDebug) uart_send(__LINE__, __func__, "1) %4u - %3u", (UINT16)((CurrentTimer - ActiveReminder1[Loop1UInt16].PreviousTimer) / 1000000ll), FlashConfig2.Reminder1[Loop1UInt16].RingRepeatTimeSeconds);
-          /* It is time to feed this ringer and repeat the scroll. */
-          queue_add_active(150, 4);
-          queue_add_active(2000, SILENT);
-          win_scroll(WIN_DATE, 201, 201, 1, 1, FONT_5x7, "%s", FlashConfig2.Reminder1[Loop1UInt16].Message);
+  /* Fold bottom half matrix rows onto their scan row. */
+  RowMask = (RowMask | (RowMask >> HALF_ROWS)) & ((0x01 << HALF_ROWS) - 1);
 
 
-          if (FlashConfig2.Reminder1[Loop1UInt16].RingRepeatTimeSeconds > ActiveReminder1[Loop1UInt16].CountDown)
-          {
-            /* Next ring would be beyond the global ringing period, reset it after current ring above. */
-            ActiveReminder1[Loop1UInt16].CountDown     = 0;
-            ActiveReminder1[Loop1UInt16].PreviousTimer = 0l;
-            Reminder1BitMask &= ~(0x01ll << Loop1UInt16);  // turn Off this reminder1 number in the bitmask of active reminders1.
-          }
-          else
-          {
-            ActiveReminder1[Loop1UInt16].CountDown -= FlashConfig2.Reminder1[Loop1UInt16].RingRepeatTimeSeconds;  // "FlashConfig2.Reminder1[Loop1UInt16].RingRepeatTimeSecond" seconds have elapsed since last pass.
-            if (ActiveReminder1[Loop1UInt16].CountDown > 0)
-            {
-              /* There are more rings to come. */
-              ActiveReminder1[Loop1UInt16].PreviousTimer = CurrentTimer;
-            }
-            else
-            {
-              /* This alarm is over now. */
-              ActiveReminder1[Loop1UInt16].PreviousTimer = 0l;
-              Reminder1BitMask &= ~(0x01ll << Loop1UInt16);  // turn Off this reminder1 number in the bitmask of active reminders1.
-            }
-          }
-        }
-      }
+  for (RowNumber = 0; RowNumber < HALF_ROWS; ++RowNumber)
+  {
+    if (RowMask & (0x01 << RowNumber))
+    {
+      RGB_matrix_pack_row(RowNumber);
+      ++PackCount;
     }
   }
 
-  /// if (FlagLocalDebug) printf("Exiting reminder1_ring()\r");
-
-  return;
+  return PackCount;
 }
 
 
 
 
 
-/* $TITLE=reminder1_update() */
+/* $TITLE=RGB_matrix_pack_row() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                               Check / update reminders of type 1.
+                 Convert one scan row (top and bottom halves) of FrameBuffer and ColorPlane to its "wire format" in the back buffer of WireBuffer.
+                          Each byte is one column, bit 0 going to GPIO 2 (R1) and bit 7 going to GPIO 9 (B2).
+                          NOTE: With BCM_SUPPORT, the row is generated in each bitplane from the 24-bit PixelColor instead of ColorPlane.
+                                Bitplane 0 holds the least significant of the BCM_DEPTH most significant bits of each color channel.
 \* ============================================================================================================================================================= */
-void reminder1_update(void)
+void RGB_matrix_pack_row(UINT8 RowNumber)
 {
-  UCHAR String[65];
-
-  UINT16 Loop1UInt16;
+  UINT8 ColumnNumber;
+  UINT8 Data;
 
-  time_t UnixTime;
+  UINT64 BottomOverride;
+  UINT64 BottomPlane[3];
+  UINT64 BottomRow;
+  UINT64 TopOverride;
+  UINT64 TopPlane[3];
+  UINT64 TopRow;
 
-  struct human_time HumanTime;
-  struct tm TempTime;
+#ifdef BCM_SUPPORT
+  UINT8 BitNumber;
+  UINT8 Plane;
 
+  UINT32 BottomColor;
+  UINT32 TopColor;
+#else  // BCM_SUPPORT
+  UINT64 BottomBlue;
+  UINT64 BottomGreen;
+  UINT64 BottomRed;
+  UINT64 TopBlue;
+  UINT64 TopGreen;
+  UINT64 TopRed;
+#endif  // BCM_SUPPORT
 
-  ds3231_get_time(&HumanTime);
-  UnixTime = convert_human_to_unix(&HumanTime, FLAG_ON);
-  convert_unix_time(UnixTime, &TempTime, &HumanTime, FLAG_ON);
 
-  if (DebugBitMask & DEBUG_REMINDER)
-  {
-    display_human_time("Current human time used to update reminders: \r\r", &HumanTime);
-    printf("\r");
-    uart_send(__LINE__, __func__, "Current UnixTime: %12llu\r\r", UnixTime);
-  }
+  /* Pixels and colors as they must be displayed, which is FrameBuffer and ColorPlane content unless a window transition is in progress. */
+  TopRow    = transition_row(RowNumber,             TopPlane,    &TopOverride);
+  BottomRow = transition_row(RowNumber + HALF_ROWS, BottomPlane, &BottomOverride);
 
-  for (Loop1UInt16 = 0; Loop1UInt16 < MAX_REMINDERS1; ++Loop1UInt16)
+#ifdef BCM_SUPPORT
+  for (ColumnNumber = 0; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
   {
-    if (DebugBitMask & DEBUG_REMINDER)
-    {
-      uart_send(__LINE__, __func__, "Verifying Reminder number %2u     StartPeriod: %12llu   EndPeriod: %12llu\r",
-                Loop1UInt16 + 1, FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime, FlashConfig2.Reminder1[Loop1UInt16].EndPeriodUnixTime);
-      sleep_ms(50);  // prevent communication override.
-    }
+    TopColor    = (TopRow    & 0x01) ? PixelColor[RowNumber][ColumnNumber]             : 0;
+    BottomColor = (BottomRow & 0x01) ? PixelColor[RowNumber + HALF_ROWS][ColumnNumber] : 0;
 
+    /* Pixels whose color is given by a window transition are displayed with full intensity basic colors. */
+    if (TopRow & TopOverride & 0x01)
+      TopColor = ((TopPlane[PLANE_RED] & 0x01) ? 0xFF0000 : 0) | ((TopPlane[PLANE_GREEN] & 0x01) ? 0x00FF00 : 0) | ((TopPlane[PLANE_BLUE] & 0x01) ? 0x0000FF : 0);
+    if (BottomRow & BottomOverride & 0x01)
+      BottomColor = ((BottomPlane[PLANE_RED] & 0x01) ? 0xFF0000 : 0) | ((BottomPlane[PLANE_GREEN] & 0x01) ? 0x00FF00 : 0) | ((BottomPlane[PLANE_BLUE] & 0x01) ? 0x0000FF : 0);
 
-    /* Check if this reminder is initialized. */
-    if (FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime == 0ll)
+    for (Plane = 0; Plane < BCM_DEPTH; ++Plane)
     {
-      if (DebugBitMask & DEBUG_REMINDER) printf("\r");
-      continue;
-    }
+      BitNumber = (8 - BCM_DEPTH) + Plane;
+      Data      = 0;
 
-    /* Check if this reminder is over now. */
-    if (UnixTime > FlashConfig2.Reminder1[Loop1UInt16].EndPeriodUnixTime)
-    {
-      if (DebugBitMask & DEBUG_REMINDER) uart_send(__LINE__, __func__, "Reminder %2u is over, adding NextReminderDelaySeconds %12llu\r", Loop1UInt16 + 1, FlashConfig2.Reminder1[Loop1UInt16].NextReminderDelaySeconds);
-      FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime += FlashConfig2.Reminder1[Loop1UInt16].NextReminderDelaySeconds;
-      FlashConfig2.Reminder1[Loop1UInt16].EndPeriodUnixTime   += FlashConfig2.Reminder1[Loop1UInt16].NextReminderDelaySeconds;
-    }
+      if (TopColor    & (0x010000 << BitNumber)) Data |= 0x01;  // R1 (GPIO 2).
+      if (TopColor    & (0x000100 << BitNumber)) Data |= 0x02;  // G1 (GPIO 3).
+      if (TopColor    & (0x000001 << BitNumber)) Data |= 0x04;  // B1 (GPIO 4).
+      if (BottomColor & (0x010000 << BitNumber)) Data |= 0x08;  // R2 (GPIO 5).
+      if (BottomColor & (0x000100 << BitNumber)) Data |= 0x40;  // G2 (GPIO 8).
+      if (BottomColor & (0x000001 << BitNumber)) Data |= 0x80;  // B2 (GPIO 9).
 
-    /* Check if this reminder is valid. */
-    if ((UnixTime > FlashConfig2.Reminder1[Loop1UInt16].StartPeriodUnixTime) && (UnixTime < FlashConfig2.Reminder1[Loop1UInt16].EndPeriodUnixTime))
-    {
-      if (DebugBitMask & DEBUG_REMINDER) uart_send(__LINE__, __func__, "Reminder %2u is valid, set its corresponding bit in the bitmask          ************\r\r", Loop1UInt16 + 1);
-      Reminder1BitMask |= (0x01ll << Loop1UInt16);
+      WireBuffer[WireFront ^ 1][(Plane * HALF_ROWS) + RowNumber][ColumnNumber] = Data;
     }
-    else
+
+    TopRow         >>= 1;
+    TopOverride    >>= 1;
+    BottomRow      >>= 1;
+    BottomOverride >>= 1;
+    for (Plane = PLANE_RED; Plane <= PLANE_BLUE; ++Plane)
     {
-      if (DebugBitMask & DEBUG_REMINDER) uart_send(__LINE__, __func__, "Reminder %2u is not valid, reset its corresponding bit in the bitmask\r\r", Loop1UInt16 + 1);
-      Reminder1BitMask &= ~(0x01ll << Loop1UInt16);
+      TopPlane[Plane]    >>= 1;
+      BottomPlane[Plane] >>= 1;
     }
   }
+#else  // BCM_SUPPORT
+  /* Each color line is On where the LED is On and its color plane bit is set. */
+  TopRed      = TopRow    & TopPlane[PLANE_RED];
+  TopGreen    = TopRow    & TopPlane[PLANE_GREEN];
+  TopBlue     = TopRow    & TopPlane[PLANE_BLUE];
+  BottomRed   = BottomRow & BottomPlane[PLANE_RED];
+  BottomGreen = BottomRow & BottomPlane[PLANE_GREEN];
+  BottomBlue  = BottomRow & BottomPlane[PLANE_BLUE];
 
-  if (DebugBitMask & DEBUG_REMINDER)
+  for (ColumnNumber = 0; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
   {
-    util_uint64_to_binary_string(Reminder1BitMask, 40, String);
-    printf("\r");
-    uart_send(__LINE__, __func__, "Reminder1BitMask while exiting reminder1_update(): 0x%10.10llX [%s]\r\r\r", Reminder1BitMask, String);
+    Data = (UINT8)( (TopRed      & 0x01)          // R1 (GPIO 2).
+                  | ((TopGreen    & 0x01) << 1)    // G1 (GPIO 3).
+                  | ((TopBlue     & 0x01) << 2)    // B1 (GPIO 4).
+                  | ((BottomRed   & 0x01) << 3)    // R2 (GPIO 5).
+                  | ((BottomGreen & 0x01) << 6)    // G2 (GPIO 8).
+                  | ((BottomBlue  & 0x01) << 7));  // B2 (GPIO 9).
+
+    WireBuffer[WireFront ^ 1][RowNumber][ColumnNumber] = Data;
+
+    TopRed      >>= 1;
+    TopGreen    >>= 1;
+    TopBlue     >>= 1;
+    BottomRed   >>= 1;
+    BottomGreen >>= 1;
+    BottomBlue  >>= 1;
   }
+#endif  // BCM_SUPPORT
 
   return;
 }
@@ -10448,157 +13105,262 @@ void reminder1_update(void)
 
 
 
-/* $TITLE=remote_control_test() */
+#ifdef PIO_SCAN_SUPPORT
+/* $TITLE=RGB_matrix_pio_init() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                                      Test remote control.
+                                        Initialize PIO state machines and DMA channels in charge of the LED matrix scan.
+                      NOTES:
+                      1) A first DMA channel feeds the whole front WireBuffer (16 rows of 64 columns) to the data state machine. When done, it chains
+                         to a second DMA channel that writes PioPlaneAddress back to the first channel's read address trigger register,
+                         restarting it for the next frame (this is where RGB_matrix_present() swaps front and back buffers). The same pair of channels is used for the row control words.
+                      2) Once started, the matrix scan runs forever without any CPU involvement.
+                      3) With BCM_SUPPORT, all scan rows of each bitplane are sent in turn, the dwell time doubling from one bitplane to the next.
+                      4) OE is taken over by the row state machine, which blanks the matrix while selecting / latching each row. The brightness
+                         PWM slice keeps running but is not connected anymore; its level is used to split each dwell time in "on" / "off" time.
+                      5) Must be called after RGB_matrix_device_init() since PIO takes over the matrix GPIOs.
 \* ============================================================================================================================================================= */
-void remote_control_test(void)
+void RGB_matrix_pio_init(void)
 {
-  UINT8 FlagDone;
+  UINT DataOffset;
+  UINT RowOffset;
 
-  UINT16 SecondsLeft;
+  dma_channel_config DmaConfig;
 
 
-  printf("                 Remote control test.\r\r");
-  printf("Press a remote control button to display its decimal code and button name...\r");
-  printf("You can watch the RGB Matrix IR indicator to see if the infrared data stream is properly received.\r");
-  printf("Press a local button to exit test before the timeout period.\r\r");
+  if (DebugBitMask & DEBUG_MATRIX) uart_send(__LINE__, __func__, "Entering RGB_matrix_pio_init()\r");
 
-  FlagDone    = FLAG_OFF;
-  SecondsLeft = WATCHDOG_SECONDS - WatchdogMiss;
+  /* Build the control word of each scan row of each bitplane (row select lines, "on" and "off" time). */
+  RGB_matrix_pio_row_control();
 
-  while (SecondsLeft)
+
+  /* Load PIO programs and initialize both state machines. */
+  DataOffset = pio_add_program(PioScan, &rgb_matrix_data_program);
+  RowOffset  = pio_add_program(PioScan, &rgb_matrix_row_program);
+  PioDataSm  = pio_claim_unused_sm(PioScan, true);
+  PioRowSm   = pio_claim_unused_sm(PioScan, true);
+  rgb_matrix_data_program_init(PioScan, PioDataSm, DataOffset, PIO_CLOCK_DIVIDER);
+  rgb_matrix_row_program_init(PioScan, PioRowSm, RowOffset, PIO_CLOCK_DIVIDER);
+
+  /* Data state machine first expects the number of columns (minus one) in each row. */
+  pio_sm_put(PioScan, PioDataSm, MAX_COLUMNS - 1);
+
+
+  /* Claim DMA channels. */
+  DmaDataChannel = dma_claim_unused_channel(true);
+  DmaDataReload  = dma_claim_unused_channel(true);
+  DmaRowChannel  = dma_claim_unused_channel(true);
+  DmaRowReload   = dma_claim_unused_channel(true);
+
+
+  /* Data plane -> data state machine, then chain to reload channel. */
+  DmaConfig = dma_channel_get_default_config(DmaDataChannel);
+  channel_config_set_transfer_data_size(&DmaConfig, DMA_SIZE_32);
+  channel_config_set_read_increment(&DmaConfig, true);
+  channel_config_set_write_increment(&DmaConfig, false);
+  channel_config_set_dreq(&DmaConfig, pio_get_dreq(PioScan, PioDataSm, true));
+  channel_config_set_chain_to(&DmaConfig, DmaDataReload);
+  dma_channel_configure(DmaDataChannel, &DmaConfig, &PioScan->txf[PioDataSm], PioPlaneAddress, sizeof(WireBuffer[0]) / 4, false);
+
+  /* Plane address -> data channel read address trigger register. */
+  DmaConfig = dma_channel_get_default_config(DmaDataReload);
+  channel_config_set_transfer_data_size(&DmaConfig, DMA_SIZE_32);
+  channel_config_set_read_increment(&DmaConfig, false);
+  channel_config_set_write_increment(&DmaConfig, false);
+  dma_channel_configure(DmaDataReload, &DmaConfig, &dma_hw->ch[DmaDataChannel].al3_read_addr_trig, &PioPlaneAddress, 1, false);
+
+
+  /* Row control words -> row state machine, then chain to reload channel. */
+  DmaConfig = dma_channel_get_default_config(DmaRowChannel);
+  channel_config_set_transfer_data_size(&DmaConfig, DMA_SIZE_32);
+  channel_config_set_read_increment(&DmaConfig, true);
+  channel_config_set_write_increment(&DmaConfig, false);
+  channel_config_set_dreq(&DmaConfig, pio_get_dreq(PioScan, PioRowSm, true));
+  channel_config_set_chain_to(&DmaConfig, DmaRowReload);
+  dma_channel_configure(DmaRowChannel, &DmaConfig, &PioScan->txf[PioRowSm], PioRowAddress, WIRE_PLANES * HALF_ROWS, false);
+
+  /* Row control address -> row channel read address trigger register. */
+  DmaConfig = dma_channel_get_default_config(DmaRowReload);
+  channel_config_set_transfer_data_size(&DmaConfig, DMA_SIZE_32);
+  channel_config_set_read_increment(&DmaConfig, false);
+  channel_config_set_write_increment(&DmaConfig, false);
+  dma_channel_configure(DmaRowReload, &DmaConfig, &dma_hw->ch[DmaRowChannel].al3_read_addr_trig, &PioRowAddress, 1, false);
+
+
+  /* Start both state machines in sync, then trigger the reload channels which will start the data and row channels. */
+  pio_enable_sm_mask_in_sync(PioScan, (1u << PioDataSm) | (1u << PioRowSm));
+  dma_start_channel_mask((1u << DmaDataReload) | (1u << DmaRowReload));
+
+  if (DebugBitMask & DEBUG_MATRIX) uart_send(__LINE__, __func__, "PIO scan started (data SM: %u   row SM: %u)\r", PioDataSm, PioRowSm);
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=RGB_matrix_pio_row_control() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                       Build the control word of each scan row for the PIO scan engine, given current row dwell times (RowDwell[]) and brightness level.
+                             NOTES:
+                             1) Brightness level is the one of the brightness PWM (Pwm[PWM_ID_BRIGHTNESS].Level), which is never modified by the scan.
+                                Since OE is active low, Level / Wrap is the fraction of the dwell time during which the row is blanked.
+                             2) Each control word is written in a single 32-bit access, so that DMA may keep reading them while they are updated.
+\* ============================================================================================================================================================= */
+void RGB_matrix_pio_row_control(void)
+{
+  UINT8 Plane;
+  UINT8 RowNumber;
+
+  UINT32 DwellUnits;
+  UINT32 OffUnits;
+  UINT32 OnUnits;
+
+  float  UnitsPerUSec;
+
+
+  /* Brightness PWM not initialized yet. */
+  if (Pwm[PWM_ID_BRIGHTNESS].Wrap == 0) return;
+
+  UnitsPerUSec = (clock_get_hz(clk_sys) / PIO_CLOCK_DIVIDER) / PIO_DWELL_UNIT / 1000000.0;
+
+  for (Plane = 0; Plane < WIRE_PLANES; ++Plane)
   {
-    if (IrBuffer[0] == IR_LO_LIMIT)
+    for (RowNumber = 0; RowNumber < HALF_ROWS; ++RowNumber)
     {
-      sleep_ms(100);
-      SecondsLeft = WATCHDOG_SECONDS - WatchdogMiss;
-      if ((SecondsLeft % 5) == 0)
-      {
-        if (FlagDone == FLAG_OFF)
-        {
-          FlagDone = FLAG_ON;
-          printf("Time left: %4u seconds\r", SecondsLeft);
-        }
+      /* Dwell time of this row in this bitplane, in units of PIO_DWELL_UNIT state machine cycles. */
+#ifdef BCM_SUPPORT
+      /* Row dwell time is shared among bitplanes, the least significant one getting 1 / ((2 ^ BCM_DEPTH) - 1) of it. */
+      DwellUnits = (UINT32)(UnitsPerUSec * RowDwell[RowNumber] / ((1 << BCM_DEPTH) - 1));
+      if (DwellUnits < (UINT32)(UnitsPerUSec * BCM_LSB_DWELL_USEC)) DwellUnits = (UINT32)(UnitsPerUSec * BCM_LSB_DWELL_USEC);
+      DwellUnits <<= Plane;
+#else  // BCM_SUPPORT
+      DwellUnits = (UINT32)(UnitsPerUSec * RowDwell[RowNumber]);
+#endif  // BCM_SUPPORT
 
-        /* User may abort the test by pressing a local button on the RGB Matrix. */
-        if (ButtonBuffer[0] != BUTTON_NONE)
-        {
-          ButtonBuffer[0] = BUTTON_NONE;
-          return;
-        }
-      }
-      else
-      {
-        FlagDone = FLAG_OFF;
-      }
-      continue;
-    }
-    else
-    {
-      printf("User pressed remote control code %u, button name: <%s>\r\r", IrBuffer[0], ButtonName[IrBuffer[0]]);
-      IrBuffer[0] = BUTTON_NONE;
+      /* Split dwell time between "on" and "off" time according to brightness level. */
+      OnUnits = (DwellUnits * (Pwm[PWM_ID_BRIGHTNESS].Wrap - Pwm[PWM_ID_BRIGHTNESS].Level)) / Pwm[PWM_ID_BRIGHTNESS].Wrap;
+      if (OnUnits < 1) OnUnits = 1;
+      if (OnUnits > PIO_DWELL_MAX) OnUnits = PIO_DWELL_MAX;
+      OffUnits = (DwellUnits > OnUnits) ? (DwellUnits - OnUnits) : 1;
+      if (OffUnits > PIO_DWELL_MAX) OffUnits = PIO_DWELL_MAX;
+
+      PioRowControl[(Plane * HALF_ROWS) + RowNumber] = (RowNumber & 0x01)                // 'A' (GPIO 10).
+                                                     | (((RowNumber >> 1) & 0x01) << 1)  // 'B' (GPIO 16).
+                                                     | (((RowNumber >> 2) & 0x01) << 3)  // 'C' (GPIO 18).
+                                                     | (((RowNumber >> 3) & 0x01) << 5)  // 'D' (GPIO 20).
+                                                     | (((RowNumber >> 4) & 0x01) << 7)  // 'E' (GPIO 22).
+                                                     | ((OnUnits  - 1) << 8)
+                                                     | ((OffUnits - 1) << 20);
     }
   }
 
   return;
 }
+#endif  // PIO_SCAN_SUPPORT
 
 
 
 
 
-/* $TITLE=RGB_matrix_blink() */
+/* $TITLE=RGB_matrix_pixel_length() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                             Blink all blinking areas in active windows.
+                                          Calculate the length of the string supplied when using the font type specified.
+                                          NOTE: Lengths over 255 pixels are returned as 255 (see layout_measure()).
 \* ============================================================================================================================================================= */
-void RGB_matrix_blink()
+UINT8 RGB_matrix_pixel_length(UINT8 FontType, UCHAR *Format, ...)
 {
-  static UINT16 CycleNumber;
+  UCHAR String[256];
 
-  UINT16 ColumnNumber;
-  UINT16 RowNumber;
+  UINT16 TotalColumns;
 
+  va_list argp;
 
-  if (DebugBitMask & DEBUG_FLOW) printf("Entering RGB_matrix_blink()\r");
 
+  /* Transfer the text to display to local variable <String>. */
+  va_start(argp, Format);
+  vsnprintf(String, sizeof(String), Format, argp);
+  va_end(argp);
 
-  if ((Window[WinTop].FlagBlink == FLAG_OFF) && (Window[WinMid].FlagBlink == FLAG_OFF) && (Window[WinBot].FlagBlink == FLAG_OFF))
-  {
-    if (DebugBitMask & DEBUG_BLINK) uart_send(__LINE__, __func__, "Entering RGB_matrix_blink(FLAG_OFF)\r");
-    return;
-  }
+  TotalColumns = layout_measure(FontType, String);
 
+  return ((TotalColumns > 0xFF) ? 0xFF : TotalColumns);
+}
 
-  if (DebugBitMask & DEBUG_BLINK)
-  {
-    if (CycleNumber % 2)
-      uart_send(__LINE__, __func__, "Entering RGB_matrix_blink(blank)\r");
-    else
-      uart_send(__LINE__, __func__, "Entering RGB_matrix_blink(restore)\r");
-  }
 
 
-  if (CycleNumber % 2)
-  {
-    if (DebugBitMask & DEBUG_BLINK) printf("Cycle to blank blink area\r");
 
-    /* It is time to blank the blink area. */
-    for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
+
+/* $TITLE=RGB_matrix_present() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                   Pack FrameBuffer changes in the back buffer and request the scan to swap front and back buffers at the beginning of next frame.
+                   NOTES:
+                   1) Drawing functions only write to FrameBuffer / ColorPlane and never block the scan, which only reads the front buffer.
+                   2) If a previous swap is still pending, nothing is done and changes will be presented on next call.
+                      The same goes while a drawing function is in progress on core 0 (see RGB_matrix_draw_begin()).
+                   3) With PIO_SCAN_SUPPORT, the swap is done by the DMA reload channel reading PioPlaneAddress at the end of each frame.
+\* ============================================================================================================================================================= */
+void RGB_matrix_present(void)
+{
+  UINT8 PackCount;
+
+  UINT32 InterruptMask;
+#ifdef PIO_SCAN_SUPPORT
+  UINT32 ReadAddress;
+#endif  // PIO_SCAN_SUPPORT
+
+
+#ifdef PIO_SCAN_SUPPORT
+  /* Swap is done once the data DMA channel has begun reading the new front buffer. */
+  if (FlagWireSwap)
+  {
+    ReadAddress = dma_channel_hw_addr(DmaDataChannel)->read_addr;
+    if ((ReadAddress >= (UINT32)WireBuffer[WireFront ^ 1]) && (ReadAddress <= (UINT32)WireBuffer[WireFront ^ 1] + sizeof(WireBuffer[0])))
     {
-      if (CheckBuffer[RowNumber] != 0xFFFFFFFFFFFFFFFFll)
-      {
-        /// printf("Acting on Row: %2u - Cols: ", RowNumber);
-        /* There is an active blink area on this line. */
-        for (ColumnNumber = 0; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
-        {
-          if ((CheckBuffer[RowNumber] & (0x1ll << ColumnNumber)) == 0)
-          {
-            /// printf("%2u - ", ColumnNumber);
-            FrameBuffer[RowNumber] &= ~(0x1ll << ColumnNumber);
-          }
-        }
-        /// printf("\r");
-      }
+      WireFront   ^= 1;
+      FlagWireSwap = FLAG_OFF;
     }
-    if (Window[WinTop].FlagBlink == FLAG_ON) Window[WinTop].BlinkOnTimer = 0l;
-    if (Window[WinMid].FlagBlink == FLAG_ON) Window[WinMid].BlinkOnTimer = 0l;
-    if (Window[WinBot].FlagBlink == FLAG_ON) Window[WinBot].BlinkOnTimer = 0l;
   }
-  else
+#endif  // PIO_SCAN_SUPPORT
+
+  /* Back buffer has already been committed for next frame. */
+  if (FlagWireSwap) return;
+
+  /* Bring back buffer up to date with what is being displayed before packing the rows that changed. */
+  if (FlagWireStale)
   {
-    if (DebugBitMask & DEBUG_BLINK) printf("Cycle to restore blink area\r");
+    memcpy(WireBuffer[WireFront ^ 1], WireBuffer[WireFront], sizeof(WireBuffer[0]));
+    FlagWireStale = FLAG_OFF;
+  }
 
-    /* It is time to restore the blink area. */
-    for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
-    {
-      if (CheckBuffer[RowNumber] != 0xFFFFFFFFFFFFFFFFll)
-      {
-        /// printf("Acting on Row: %2u - Cols: ", RowNumber);
-        /* There is an active blink area on this line. */
-        for (ColumnNumber = 0; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
-        {
-          if ((CheckBuffer[RowNumber] & (0x1ll << ColumnNumber)) == 0)
-          {
-            if (BlinkBuffer[RowNumber] & (0x1ll << ColumnNumber))
-              FrameBuffer[RowNumber] |= (0x1ll << ColumnNumber);
-            else
-              FrameBuffer[RowNumber] &= ~(0x1ll << ColumnNumber);
-          }
-        }
-        /// printf("\r");
-      }
-    }
-    if (Window[WinTop].FlagBlink == FLAG_ON) Window[WinTop].BlinkOnTimer = time_us_32();
-    if (Window[WinMid].FlagBlink == FLAG_ON) Window[WinMid].BlinkOnTimer = time_us_32();
-    if (Window[WinBot].FlagBlink == FLAG_ON) Window[WinBot].BlinkOnTimer = time_us_32();
+  /* Do not pack a change being drawn by core 0. Drawing functions wait for the end of packing before they begin. */
+  InterruptMask = spin_lock_blocking(DirtyLock);
+  if (DrawNesting)
+  {
+    spin_unlock(DirtyLock, InterruptMask);
+
+    return;
   }
+  FlagPacking = FLAG_ON;
+  spin_unlock(DirtyLock, InterruptMask);
 
-  ++CycleNumber;
+  PackCount = RGB_matrix_pack();
 
-  if (DebugBitMask & DEBUG_FLOW) printf("Exiting RGB_matrix_blink()\r");
+  /* Back buffer must be completely packed before core 0 may draw again. */
+  __dmb();
+  FlagPacking = FLAG_OFF;
+
+  if (PackCount == 0) return;  // nothing changed since last call.
+
+#ifdef PIO_SCAN_SUPPORT
+  PioPlaneAddress = &WireBuffer[WireFront ^ 1][0][0];
+#endif  // PIO_SCAN_SUPPORT
+  FlagWireStale = FLAG_ON;
+  FlagWireSwap  = FLAG_ON;
 
   return;
 }
@@ -10607,71 +13369,163 @@ void RGB_matrix_blink()
 
 
 
-/* $TITLE=RGB_matrix_box() */
+/* $TITLE=RGB_matrix_printf() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                             Draw or erase a box with specified borders.
+                                          Display specified string, beginning at the specified pixel row and specified pixel column.
+                                          NOTE: This function uses 5x7 variable-width character set.
+                                          NOTE: If PixelColumn specified is 99, string will be centered on the line.
+                                          NOTE: A centered string that does not fit on the line is cut and ends with LAYOUT_ELLIPSIS_TEXT.
+                                                Otherwise, only the characters that fit completely on the line are displayed.
 \* ============================================================================================================================================================= */
-void RGB_matrix_box(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn, UINT8 Color, UINT8 Action)
+UINT8 RGB_matrix_printf(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 FontType, UCHAR *Format, ...)
 {
-  UINT8  Loop1UInt8;
-  UINT8  RowNumber;
+  UCHAR String[256];
+
+  va_list argp;
+
+  struct layout Layout;
+
+
+  /* Transfer the text to display to local variable <String>. */
+  va_start(argp, Format);
+  vsnprintf(String, sizeof(String), Format, argp);
+  va_end(argp);
+
+
+  if (StartColumn != 99)
+  {
+    /* No request to center text on the line... Start column will be as specified. */
+    layout_text(FontType, String, StartColumn, MAX_COLUMNS - 1, LAYOUT_LEFT, &Layout);
+  }
+  else
+  {
+    /* Center the text on matrix display. */
+    layout_text(FontType, String, 0, MAX_COLUMNS - 1, LAYOUT_CENTER | LAYOUT_ELLIPSIS, &Layout);
+  }
+
+  return layout_print(DisplayBuffer, StartRow, FontType, String, &Layout);
+}
+
 
 
-  /* Validate provided coordinates. */
-  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
 
 
-  /* Set color for top border. */
-  RGB_matrix_set_color(StartRow, StartColumn, StartRow, EndColumn, Color);
+/* $TITLE=RGB_matrix_scroll() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                       Scroll the specified rows one pixel to the left and manage the scroll glyph strip.
+   NOTES:
+   1) win_scroll() only appends text to the text ring of the scroll (see scroll_text_put()). Each character is rendered to pixel columns
+      here, in the glyph strip, when the last pixel column of the previous character has been scrolled in (see scroll_strip_glyph()).
+      Every other tick is a single pixel column fetch from the glyph strip, shifted in the rightmost column of the scroll region.
+   2) Only the pixels of the scroll region (rows and columns clipped to the owner window by win_scroll()) are moved.
+\* ============================================================================================================================================================= */
+void RGB_matrix_scroll(UINT8 ScrollNumber)
+{
+  UINT8 AsciiValue;
+  UINT8 FlagColumn;
+  UINT8 GlyphBit;
+  UINT8 NextChar;
+  UINT8 RowNumber;
+
+  UINT16 Column;
+  UINT16 Head;
+  UINT16 Tail;
+
+  UINT64 ColumnMask;
+  UINT64 Pixels;
+
+
+  /* Make sure ActiveScroll pointer is valid. */
+  if (ActiveScroll[ScrollNumber] == 0x00l)
+  {
+    printf("************************************************************* Invalid ActiveScroll pointer: 0x%p\r", ActiveScroll[ScrollNumber]);
+    return;
+  }
+
 
-  /* Turn On or Off pixels for the top box border. */
-  for (Loop1UInt8 = StartColumn; Loop1UInt8 < EndColumn; ++Loop1UInt8)
+  /* win_scroll_cancel() asked to drop the text pending in the text ring and in the glyph strip (and any repeat cycle). */
+  if (ActiveScroll[ScrollNumber]->FlagFlush)
   {
-    if (Action == ACTION_DRAW)
-      FrameBuffer[StartRow] |=  (0x01ll << Loop1UInt8);
-    else
-      FrameBuffer[StartRow] &= ~(0x01ll << Loop1UInt8);
+    __dmb();
+    ActiveScroll[ScrollNumber]->ScrollTimes = 0;
+    ActiveScroll[ScrollNumber]->TextTail    = ActiveScroll[ScrollNumber]->TextFlush;
+    ActiveScroll[ScrollNumber]->TextStart   = ActiveScroll[ScrollNumber]->TextFlush;
+    ActiveScroll[ScrollNumber]->StripColumn = ActiveScroll[ScrollNumber]->StripWidth;
+    ActiveScroll[ScrollNumber]->FlagFlush   = FLAG_OFF;
   }
 
 
+  /* All pixel columns of the glyph strip have been scrolled in, render the next character of the text ring, if there is one. */
+  Head = ActiveScroll[ScrollNumber]->TextHead;
+  Tail = ActiveScroll[ScrollNumber]->TextTail;
+  while ((ActiveScroll[ScrollNumber]->StripColumn >= ActiveScroll[ScrollNumber]->StripWidth) && (Head != Tail))
+  {
+    /* Character must not be read before TextHead has been seen updated by win_scroll(). */
+    __dmb();
+    AsciiValue = ActiveScroll[ScrollNumber]->Text[Tail & (MAX_SCROLL_TEXT - 1)];
+    NextChar   = ((UINT16)(Tail + 1) != Head) ? ActiveScroll[ScrollNumber]->Text[(Tail + 1) & (MAX_SCROLL_TEXT - 1)] : 0x00;
+    ActiveScroll[ScrollNumber]->StripWidth  = scroll_strip_glyph(AsciiValue, ActiveScroll[ScrollNumber]->FontType, NextChar, ActiveScroll[ScrollNumber]->Strip);
+    ActiveScroll[ScrollNumber]->StripColumn = 0;
+    ActiveScroll[ScrollNumber]->TextTail    = ++Tail;
+
+    /* When no repeat cycle is pending, the character just rendered is not needed anymore, give its space back to win_scroll(). */
+    if (ActiveScroll[ScrollNumber]->ScrollTimes == 0)
+    {
+      __dmb();
+      ActiveScroll[ScrollNumber]->TextStart = Tail;
+    }
+  }
 
-  /* Set color for bottom border. */
-  RGB_matrix_set_color(EndRow, StartColumn, EndRow, EndColumn, Color);
 
-  /* Turn On or Off pixels for the bottom box border. */
-  for (Loop1UInt8 = StartColumn; Loop1UInt8 < EndColumn; ++Loop1UInt8)
+  /* Fetch next pixel column to scroll in, if there is one. */
+  if (ActiveScroll[ScrollNumber]->StripColumn < ActiveScroll[ScrollNumber]->StripWidth)
   {
-    if (Action == ACTION_DRAW)
-      FrameBuffer[EndRow] |= (0x01ll << Loop1UInt8);
-    else
-      FrameBuffer[EndRow] &= ~(0x01ll << Loop1UInt8);
+    Column     = ActiveScroll[ScrollNumber]->Strip[ActiveScroll[ScrollNumber]->StripColumn++];
+    FlagColumn = FLAG_ON;
+
+    /* Recharge the count of pixels remaining to be scrolled on the LED matrix (width of the scroll region). */
+    ActiveScroll[ScrollNumber]->PixelCountCurrent = ActiveScroll[ScrollNumber]->EndColumn - ActiveScroll[ScrollNumber]->StartColumn + 1;
   }
+  else
+  {
+    /* No more text to scroll in, remaining scrolls of the actual FrameBuffer is then decremented by one. */
+    Column     = 0x0000;
+    FlagColumn = FLAG_OFF;
+    --ActiveScroll[ScrollNumber]->PixelCountCurrent;
 
+    /* Check if more than one cycle have been requested. If so, go back to the first character kept to trigger another cycle. */
+    if (ActiveScroll[ScrollNumber]->ScrollTimes > 0)
+    {
+      --ActiveScroll[ScrollNumber]->ScrollTimes;
+      ActiveScroll[ScrollNumber]->TextTail = ActiveScroll[ScrollNumber]->TextStart;
+      FlagColumn = FLAG_ON;
+    }
+  }
 
 
-  /* Turn On or Off pixels for the left box border. */
-  for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
+  /* Scroll one pixel to the left inside the scroll region and shift the pixel column in on its right edge.
+     Pixels outside ColumnMask (other windows, box border if there is one persistent on this window) are left untouched. */
+  ColumnMask = ActiveScroll[ScrollNumber]->ColumnMask;
+  for (RowNumber = ActiveScroll[ScrollNumber]->StartRow; RowNumber <= ActiveScroll[ScrollNumber]->EndRow; ++RowNumber)
   {
-    /* Set color for left border. */
-    RGB_matrix_set_color(RowNumber, StartColumn, RowNumber, StartColumn, Color);
+    Pixels = ((FrameBuffer[RowNumber] & ColumnMask) >> 1) & ColumnMask;
 
-    if (Action == ACTION_DRAW)
-      FrameBuffer[RowNumber] |= (0x01ll << StartColumn);
-    else
-      FrameBuffer[RowNumber] &= ~(0x01ll << StartColumn);
+    GlyphBit = RowNumber - ActiveScroll[ScrollNumber]->GlyphRow;
+    if ((GlyphBit < STRIP_ROWS) && (Column & (0x01 << GlyphBit)))
+      Pixels |= (0x01ll << ActiveScroll[ScrollNumber]->EndColumn);
+
+    FrameBuffer[RowNumber] = (FrameBuffer[RowNumber] & ~ColumnMask) | Pixels;
   }
+  RGB_matrix_dirty(ActiveScroll[ScrollNumber]->StartRow, ActiveScroll[ScrollNumber]->EndRow);
 
-  /* Turn On pixels for the right box border. */
-  for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
-  {
-    /* Set color for right border. */
-    RGB_matrix_set_color(RowNumber, EndColumn, RowNumber, EndColumn, Color);
 
-    if (Action == ACTION_DRAW)
-      FrameBuffer[RowNumber] |= (0x01ll << EndColumn);
-    else
-      FrameBuffer[RowNumber] &= ~(0x01ll << EndColumn);
+  /* Turning Off current scroll when done (no more pixel column to scroll and last one has left the LED matrix). */
+  if ((FlagColumn == FLAG_OFF) && (ActiveScroll[ScrollNumber]->PixelCountCurrent == 0))
+  {
+    /// if (DebugBitMask & DEBUG_SCROLL) printf("Free up scroll memory.\r");
+    win_scroll_off(ScrollNumber);
   }
 
   return;
@@ -10681,51 +13535,55 @@ void RGB_matrix_box(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndCo
 
 
 
-/* $TITLE=RGB_matrix_check_coord() */
+/* $TITLE=RGB_matrix_set_color() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                          Check order of coordinates (start and end Row and Column and re-order if required.
+                                                          Set matrix display color for the specified area.
+                                          NOTE: Each color plane of each row is updated with a single mask operation.
 \* ============================================================================================================================================================= */
-void RGB_matrix_check_coord(UINT8 *StartRow, UINT8 *StartColumn, UINT8 *EndRow, UINT8 *EndColumn)
+void RGB_matrix_set_color(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn, UINT8 Color)
 {
-  UINT8 TempValue;
+  UINT8 RowNumber;
 
+  UINT64 BlueMask;
+  UINT64 ColumnMask;
+  UINT64 GreenMask;
+  UINT64 RedMask;
 
-  /* Extract / filter requests for standard window lines. */
-  switch (*StartRow)
-  {
-    case (201):
-      *StartRow = 1;
-      *EndRow   = 7;
-    break;
+#ifdef BCM_SUPPORT
+  UINT8 ColumnNumber;
+#endif  // BCM_SUPPORT
 
-    case (202):
-      *StartRow =  9;
-      *EndRow   = 15;
-    break;
 
-    case (203):
-      *StartRow = 20;
-      *EndRow   = 29;
-    break;
-  }
+  /* Validate provided coordinates. */
+  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
+  if (EndRow >= MAX_ROWS) EndRow = MAX_ROWS - 1;
 
+  ColumnMask = RGB_matrix_span_mask(StartColumn, EndColumn);
+  RedMask    = (Color & RED)   ? ColumnMask : 0ll;
+  GreenMask  = (Color & GREEN) ? ColumnMask : 0ll;
+  BlueMask   = (Color & BLUE)  ? ColumnMask : 0ll;
 
-  /* Re-order start and end points if required. */
-  if (*EndRow < *StartRow)
-  {
-    TempValue  = *StartRow;
-    *StartRow  = *EndRow;
-    *EndRow    = TempValue;
-  }
+  /* Red, green and blue planes are presented together (see RGB_matrix_draw_begin()). */
+  RGB_matrix_draw_begin();
 
-  if ((*StartColumn != 99) && (*EndColumn < *StartColumn))
+  for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
   {
-    TempValue    = *StartColumn;
-    *StartColumn = *EndColumn;
-    *EndColumn   = TempValue;
+    ColorPlane[PLANE_RED][RowNumber]   = (ColorPlane[PLANE_RED][RowNumber]   & ~ColumnMask) | RedMask;
+    ColorPlane[PLANE_GREEN][RowNumber] = (ColorPlane[PLANE_GREEN][RowNumber] & ~ColumnMask) | GreenMask;
+    ColorPlane[PLANE_BLUE][RowNumber]  = (ColorPlane[PLANE_BLUE][RowNumber]  & ~ColumnMask) | BlueMask;
+
+#ifdef BCM_SUPPORT
+    /* Keep 24-bit color in sync, using full intensity for each color channel. */
+    for (ColumnNumber = StartColumn; (ColumnNumber <= EndColumn) && (ColumnNumber < MAX_COLUMNS); ++ColumnNumber)
+      PixelColor[RowNumber][ColumnNumber] = ((Color & RED) ? 0xFF0000 : 0) | ((Color & GREEN) ? 0x00FF00 : 0) | ((Color & BLUE) ? 0x0000FF : 0);
+#endif  // BCM_SUPPORT
   }
 
+  RGB_matrix_dirty(StartRow, EndRow);
+
+  RGB_matrix_draw_end();
+
   return;
 }
 
@@ -10733,47 +13591,64 @@ void RGB_matrix_check_coord(UINT8 *StartRow, UINT8 *StartColumn, UINT8 *EndRow,
 
 
 
-/* $TITLE=RGB_matrix_clear_pixel() */
+#ifdef BCM_SUPPORT
+/* $TITLE=RGB_matrix_set_color_rgb() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                          Turn Off the pixels in the specified matrix area.
+                                            Set 24-bit matrix display color (0x00RRGGBB) for the specified area.
+                          NOTE: Only the BCM_DEPTH most significant bits of each color channel are displayed. ColorPlane is set to the
+                                nearest of the 8 basic colors, so that code relying on it remains consistent.
 \* ============================================================================================================================================================= */
-void RGB_matrix_clear_pixel(UINT64 *BufferPointer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn)
+void RGB_matrix_set_color_rgb(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn, UINT32 Color)
 {
-  UINT8  ColumnNumber;
-  UINT8  RowNumber;
+  UINT8 BasicColor;
+  UINT8 ColumnNumber;
+  UINT8 RowNumber;
 
 
   /* Validate provided coordinates. */
   RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
+  if (EndRow    >= MAX_ROWS)    EndRow    = MAX_ROWS - 1;
+  if (EndColumn >= MAX_COLUMNS) EndColumn = MAX_COLUMNS - 1;
+
+  /* Basic color and 24-bit color are presented together (see RGB_matrix_draw_begin()). */
+  RGB_matrix_draw_begin();
+
+  /* Nearest basic color (each channel turned On when at half intensity or more). */
+  BasicColor = ((Color & 0x800000) ? RED : 0) | ((Color & 0x008000) ? GREEN : 0) | ((Color & 0x000080) ? BLUE : 0);
+  RGB_matrix_set_color(StartRow, StartColumn, EndRow, EndColumn, BasicColor);
 
-  /* Turn Off pixels in the specified matrix buffer area. */
   for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
-	{
+  {
     for (ColumnNumber = StartColumn; ColumnNumber <= EndColumn; ++ColumnNumber)
-    {
-      BufferPointer[RowNumber] &= (~(0x01ll << ColumnNumber));
-    }
+      PixelColor[RowNumber][ColumnNumber] = (Color & 0x00FFFFFF);
   }
 
+  RGB_matrix_dirty(StartRow, EndRow);
+
+  RGB_matrix_draw_end();
+
   return;
 }
+#endif  // BCM_SUPPORT
 
 
 
 
 
-/* $TITLE=RGB_matrix_cls() */
+/* $TITLE=RGB_matrix_set_nibbles() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                                        Clear LED matrix.
-        NOTE: If there is an opened window with an "ACTION_DRAW" border, RGB_matrix_cls() will erase that border and it will have to be manuelly refreshed.
-              Turning Off the brightness with PWM Level may be a better solution to consider in some cases.
+                              Set the colors of the specified scan row pixel pair from the legacy DisplayRGB format.
+                              NOTE: Adaptor for code still working with DisplayRGB nibbles: low nibble is the color of the pixel in top half
+                                    of the matrix (RowNumber), high nibble is the color of the pixel in bottom half (RowNumber + HALF_ROWS).
 \* ============================================================================================================================================================= */
-void RGB_matrix_cls(UINT64 *FrameBuffer)
+void RGB_matrix_set_nibbles(UINT8 RowNumber, UINT8 ColumnNumber, UCHAR Nibbles)
 {
-  /* Clear LED display matrix. */
-  memset(FrameBuffer, 0x00, (MAX_ROWS * MAX_COLUMNS / 8));
+  if (RowNumber >= HALF_ROWS) return;
+
+  RGB_matrix_set_color(RowNumber,             ColumnNumber, RowNumber,             ColumnNumber, (Nibbles & 0x07));
+  RGB_matrix_set_color(RowNumber + HALF_ROWS, ColumnNumber, RowNumber + HALF_ROWS, ColumnNumber, ((Nibbles >> 4) & 0x07));
 
   return;
 }
@@ -10782,878 +13657,812 @@ void RGB_matrix_cls(UINT64 *FrameBuffer)
 
 
 
-/* $TITLE=RGB_matrix_device_init() */
+/* $TITLE=RGB_matrix_set_pixel() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                      Initialize GPIO for most devices used in RGB matrix.
-                                               NOTE: PWM for matrix brightness is initialized in its own routine.
+                                                Turn On the pixels in the specified matrix area of the specified buffer.
 \* ============================================================================================================================================================= */
-void RGB_matrix_device_init(void)
+void RGB_matrix_set_pixel(UINT64 *BufferPointer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn)
 {
-  /* Initialize RGB matrix button devices and GPIOs. */
-  gpio_init(BUTTON_SET_GPIO);
-  gpio_init(BUTTON_DOWN_GPIO);
-  gpio_init(BUTTON_UP_GPIO);
+  UINT8  RowNumber;
 
-  gpio_set_dir(BUTTON_SET_GPIO,  GPIO_IN);
-  gpio_set_dir(BUTTON_DOWN_GPIO, GPIO_IN);
-  gpio_set_dir(BUTTON_UP_GPIO,   GPIO_IN);
+  UINT64 ColumnMask;
 
-  gpio_pull_up(BUTTON_SET_GPIO);
-  gpio_pull_up(BUTTON_DOWN_GPIO);
-  gpio_pull_up(BUTTON_UP_GPIO);
 
+  /* Validate provided coordinates. */
+  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
 
-  /* Initialize on-board Pico LED gpio. */
-  gpio_init(PICO_LED);
-  gpio_set_dir(PICO_LED, GPIO_OUT);
-  gpio_put(PICO_LED, 0);
+  /* Turn On pixels in the specified matrix buffer area, one whole row span at a time. */
+  ColumnMask = RGB_matrix_span_mask(StartColumn, EndColumn);
+  for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
+    BufferPointer[RowNumber] |= ColumnMask;
 
+  if (BufferPointer == FrameBuffer) RGB_matrix_dirty(StartRow, EndRow);
 
-  /* Initialize RGB matrix integrated active buzzer. */
-#ifndef NO_SOUND
-  gpio_init(BUZZER);
-  gpio_set_dir(BUZZER, GPIO_OUT);
-  gpio_put(BUZZER, 0);
-#endif  // NO_SOUND
+  return;
+}
 
 
-#ifdef REMOTE_SUPPORT
-  /* Initialize infrared sensor gpio. */
-  gpio_init(IR_RX);
 
-  /* IR sensor will receive IR command from remote control. */
-  gpio_set_dir(IR_RX, GPIO_IN);
 
-  /* Line will remain at High level until a signal is received. */
-  gpio_pull_up(IR_RX);
-#endif  // REMOTE_SUPPORT
 
+/* $TITLE=RGB_matrix_set_scan_rate() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                   Apply scan rate and per-row on-time trim from flash configuration to the matrix scan.
+                         NOTES:
+                         1) Invalid values (flash configuration not read yet or saved by a previous firmware version) are replaced by defaults.
+                         2) Per-row trim compensates for brightness differences between scan rows of the 1/16 multiplexed matrix.
+                         3) Bit-banged scan reschedules its callback after each row according to RowDwell[]. With PIO_SCAN_SUPPORT,
+                            row control words are rebuilt.
+\* ============================================================================================================================================================= */
+void RGB_matrix_set_scan_rate(void)
+{
+  UINT8 RowNumber;
 
 
-  /* Initialize Pico's UART0 used to send information to a terminal emulator for terminal menu and / or debugging purposes. */
-  gpio_init(UART_TX_PIN);
-  gpio_init(UART_RX_PIN);
-  gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
-  gpio_set_function(UART_RX_PIN, GPIO_FUNC_UART);
-  uart_init(uart0, 921600);
-  uart_set_format(uart0, 8, 1, UART_PARITY_NONE);
+  /* Validate scan rate. Since previous firmware versions kept zero in this variable, also reset per-row trims in this case. */
+  if ((FlashConfig1.RowDwellUSec < ROW_DWELL_MIN) || (FlashConfig1.RowDwellUSec > ROW_DWELL_MAX))
+  {
+    FlashConfig1.RowDwellUSec = ROW_DWELL_DEFAULT;
+    for (RowNumber = 0; RowNumber < HALF_ROWS; ++RowNumber)
+      FlashConfig1.RowTrim[RowNumber] = 0;
+  }
 
+  for (RowNumber = 0; RowNumber < HALF_ROWS; ++RowNumber)
+  {
+    if (FlashConfig1.RowTrim[RowNumber] < -ROW_TRIM_MAX) FlashConfig1.RowTrim[RowNumber] = -ROW_TRIM_MAX;
+    if (FlashConfig1.RowTrim[RowNumber] >  ROW_TRIM_MAX) FlashConfig1.RowTrim[RowNumber] =  ROW_TRIM_MAX;
 
+    RowDwell[RowNumber] = (UINT16)((FlashConfig1.RowDwellUSec * (100 + FlashConfig1.RowTrim[RowNumber])) / 100);
+  }
 
-  /* LEDs matrix related devices and GPIOs. */
-  gpio_init(R1);
-  gpio_init(G1);
-  gpio_init(B1);
-  gpio_init(R2);
-  gpio_init(G2);
-  gpio_init(B2);
+#ifdef PIO_SCAN_SUPPORT
+  RGB_matrix_pio_row_control();
+#endif  // PIO_SCAN_SUPPORT
 
-  gpio_init(A);
-  gpio_init(B);
-  gpio_init(C);
-  gpio_init(D);
-  gpio_init(E);
+  if (DebugBitMask & DEBUG_MATRIX) uart_send(__LINE__, __func__, "Matrix scan row dwell time: %u usec (%u Hz full frame refresh)\r", FlashConfig1.RowDwellUSec, 1000000 / (FlashConfig1.RowDwellUSec * HALF_ROWS));
 
-  gpio_init(CLK);
+  return;
+}
 
-  gpio_init(STB);
 
 
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                          Initialize PWM for clock display brightness.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-  /* Set GPIO for RGB matrix brightness ("Output Enable"). */
-  Pwm[PWM_ID_BRIGHTNESS].Gpio = OE;
 
-  /* Initialize pulse-width-modulation (PWM) signals. */
-  pwm_initialize();
 
-  gpio_set_dir(R1,  GPIO_OUT);
-  gpio_set_dir(G1,  GPIO_OUT);
-  gpio_set_dir(B1,  GPIO_OUT);
-  gpio_set_dir(R2,  GPIO_OUT);
-  gpio_set_dir(G2,  GPIO_OUT);
-  gpio_set_dir(B2,  GPIO_OUT);
+/* $TITLE=RGB_matrix_span_mask() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                           Return the bitmask of the columns StartColumn to EndColumn (inclusively) in a FrameBuffer-like matrix row.
+                           NOTE: EndColumn is clipped to the last matrix column. An empty mask is returned if StartColumn > EndColumn.
+\* ============================================================================================================================================================= */
+UINT64 RGB_matrix_span_mask(UINT8 StartColumn, UINT8 EndColumn)
+{
+  if (EndColumn >= MAX_COLUMNS) EndColumn = MAX_COLUMNS - 1;
+  if (StartColumn > EndColumn) return 0ll;
 
-  gpio_set_dir(A,   GPIO_OUT);
-  gpio_set_dir(B,   GPIO_OUT);
-  gpio_set_dir(C,   GPIO_OUT);
-  gpio_set_dir(D,   GPIO_OUT);
-  gpio_set_dir(E,   GPIO_OUT);
-  gpio_set_dir(CLK, GPIO_OUT);
-  gpio_set_dir(STB, GPIO_OUT);
-  STB_LOW;
-  CLK_LOW;
+  return (0xFFFFFFFFFFFFFFFFll >> (63 - (EndColumn - StartColumn))) << StartColumn;
+}
 
-  int MaxLed = 64;
 
-  int C12[16] = {0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
-  int C13[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0};
 
-  for (int l = 0; l < MaxLed; l++)
-  {
-    int y = l % 16;
 
-    R1_LOW;
-    G1_LOW;
-    B1_LOW;
-    R2_LOW;
-    G2_LOW;
-    B2_LOW;
 
-    if (C12[y] == 1)
-    {
-      R1_HIGH;
-      G1_HIGH;
-      B1_HIGH;
-      R2_HIGH;
-      G2_HIGH;
-      B2_HIGH;
-    }
+/* $TITLE=RGB_matrix_toggle_pixel() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                              Toggle the pixels in the specified matrix area of the specified buffer.
+\* ============================================================================================================================================================= */
+void RGB_matrix_toggle_pixel(UINT64 *BufferPointer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn)
+{
+  UINT8  RowNumber;
 
-    if (l > MaxLed - 12)
-    {
-      STB_HIGH;
-    }
-    else
-    {
-      STB_LOW;
-    }
+  UINT64 ColumnMask;
 
-    CLK_HIGH;
-    sleep_us(2);
-    CLK_LOW;
-  }
-  STB_LOW;
-  CLK_LOW;
 
-  /* Send Data to control register 12. */
-  for (int l = 0; l < MaxLed; l++)
+  /* Validate provided coordinates. */
+  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
+
+  /* Toggle pixels in the specified matrix buffer area, one whole row span at a time. */
+  ColumnMask = RGB_matrix_span_mask(StartColumn, EndColumn);
+  for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
+    BufferPointer[RowNumber] ^= ColumnMask;
+
+  if (BufferPointer == FrameBuffer) RGB_matrix_dirty(StartRow, EndRow);
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=RGB_matrix_update() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+
+\* ============================================================================================================================================================= */
+void RGB_matrix_update(UINT64 *FrameBuffer)
+{
+  /* Simultaneously scan first 16 rows (top half) and next 16 rows (bottom half) and then, start again (RowScan goes from 0 to 15 and then, start over again). */
+  ++RowScan;
+  if (RowScan >= HALF_ROWS)
   {
-    int y = l % 16;
-
-    R1_LOW;
-    G1_LOW;
-    B1_LOW;
-    R2_LOW;
-    G2_LOW;
-    B2_LOW;
+    RowScan = 0;
 
-    if (C13[y] == 1)
+    /* Beginning of a new frame, swap front and back buffers if RGB_matrix_present() requested it. */
+    if (FlagWireSwap)
     {
-      R1_HIGH;
-      G1_HIGH;
-      B1_HIGH;
-      R2_HIGH;
-      G2_HIGH;
-      B2_HIGH;
+      WireFront   ^= 1;
+      FlagWireSwap = FLAG_OFF;
     }
+  }
 
-    if (l > MaxLed - 13)
-    {
-      STB_HIGH;
-    }
-    else
-    {
-      STB_LOW;
-    }
+	FlagFrameBufferBusy = FLAG_ON;  // flag indicating that the FrameBuffer is currently being updated.
 
-    CLK_HIGH;
-    sleep_us(2);
-    CLK_LOW;
-  }
+  /// critical_section_enter_blocking(&ThreadLock);
+
+
+
+  /* Scan all columns of the LED matrix (WireBuffer has been packed beforehand by RGB_matrix_pack()). */
+  RGB_matrix_write_data(RowScan);
+
+
+  /* Blank LED matrix while changing row and latching data (user's brightness level in Pwm[] remains untouched). */
+  OE_BLANK;
+
+
+  /* Successively scan all rows of the LED matrix. */
+  if (RowScan & 0x01) A_HIGH; else A_LOW;
+  if (RowScan & 0x02) B_HIGH; else B_LOW;
+  if (RowScan & 0x04) C_HIGH; else C_LOW;
+  if (RowScan & 0x08) D_HIGH; else D_LOW;
+  if (RowScan & 0x10) E_HIGH; else E_LOW;
+
+
+  /* Latch this value. */
+  STB_HIGH;
+  NOP;
   STB_LOW;
-  CLK_LOW;
 
 
-  /* Initialize analog-to-digital converter to read ambient light relative value and power supply info. */
-  adc_init();
+  /// critical_section_exit(&ThreadLock);
 
-  adc_gpio_init(ADC_LIGHT_SENSOR);  // RGB-Matrix ambient light detector.
-  adc_gpio_init(ADC_VCC);           // power supply voltage.
 
-  adc_select_input(0);
 
-  return;
-}
+  FlagFrameBufferBusy = FLAG_OFF;  // we're done with FrameBuffer update.
 
 
+  /* Give OE back to brightness PWM. */
+  OE_UNBLANK;
 
+  return;
 
 
-/* $TITLE=RGB_matrix_display() */
-/* $PAGE */
-/* ============================================================================================================================================================= *\
-                   Display specified ASCII character, beginning at specified matrix location (pixel row and pixel column), using the specified font type.
 
-                                  WARNING - WARNING - WARNING - WARNING - WARNING - WARNING - WARNING - WARNING - WARNING - WARNING
-                                  - Debugging must be done only outside of callback functions, otherwise the firmware will crash.
-                                    If required, disable the callback updating date and time and use this function from a test area.
 
-                     NOTES:
-                            1) Rows (in pixels) are numbered from 0 to MAX_ROWS and columns (in pixels) are numbered from 0 to MAX_COLUMNS.
-                            2) StartRow and StartColumn correspond to the top-left position of the character to be displayed.
-                            3) ASCII positions below 0x20 are used to generate special foreign language character bitmaps that do not exist
-                               in the English language.
-                            4) If FlagMore is != 0, it means that more characters are to be displayed to the right of current character...
-                               in such a case, we make sure the next column to the right of current character is blank.
-                            5) This function returns the start column for an eventual next character.
-\* ============================================================================================================================================================= */
-UINT8 RGB_matrix_display(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 AsciiValue, UINT8 FontType, UINT8 FlagMore)
+#if 0
+void RGBMatrixDeviceFlush(uint8_t *buf)
 {
-  UCHAR String[64];
+  uint8_t i;
 
-  UINT8  CharHeight;
-  UINT8  CharWidth;
-  UINT8  ColumnNumber;
-  UINT8  RowNumber;
+  CS_cnt ++;
+  if (CS_cnt > (Matrix_ROWS_SHOW - 1))
+  {
+    CS_cnt = 0;
+  }
 
+  UpdateVideoMemory = 1;
 
-  /* Initializations. */
-  switch (FontType)
+  OE_HIGH;
+
+  for (i = 0; i < (Matrix_COLS_BYTE); ++i)
   {
-    case (FONT_4x7):
-      CharWidth = Font4x7[AsciiValue].Width;
-      CharHeight = 7;
-      if (AsciiValue > 0x7F) AsciiValue = 0;  // only first 128 ASCII characters are defined for 4x7 font.
-    break;
+    RGBMatrixWriteData(buf[CS_cnt * Matrix_COLS_BYTE + i], buf[(CS_cnt + Matrix_ROWS_SHOW) * Matrix_COLS_BYTE + i], i);
+  }
 
-    case (FONT_5x7):
-      CharWidth = Font5x7[AsciiValue].Width;
-      CharHeight = 7;
-    break;
 
-    case (FONT_8x10):
-      CharWidth = Font8x10[AsciiValue].Width;
-      CharHeight = 10;
-      if (AsciiValue > 0x7F) AsciiValue = 0;  // only first 128 ASCII characters are defined for 8x10 font.
-    break;
-  }
+  if (CS_cnt & 0x01) A_HIGH; else A_LOW;
+  if (CS_cnt & 0x02) B_HIGH; else B_LOW;
+  if (CS_cnt & 0x04) C_HIGH; else C_LOW;
+  if (CS_cnt & 0x08) D_HIGH; else D_LOW;
+  if (CS_cnt & 0x10) E_HIGH; else E_LOW;
+
 
+  STB_HIGH;
+  // sleep_us(1);
 
+  STB_LOW;
 
-  if (DebugBitMask & DEBUG_MATRIX)
+  UpdateVideoMemory = 0;
+
+  OE_LOW;
+
+#ifndef TRUE
+  if (FlagAutoBrightness != FLAG_OFF)
   {
-    uart_send(__LINE__, __func__, "AsciiValue: 0x%2.2X (%3u) ", AsciiValue, AsciiValue);
+    FlagAutoBrightness = FLAG_ON;
+  }
+  else
+  {
+    OE_LOW;
+  }
+#endif
+}
+#endif  // 0
+}
 
-    /* If this is a printable ASCII character, display it to log file. */
-    if (AsciiValue >= 0x20) uart_send(__LINE__, __func__, "- <%c> ", AsciiValue);
 
-    uart_send(__LINE__, __func__, "- FlagMore: %2.2X (%u) (will be <0> or <!= 0> - not necessarily <1>)\r", FlagMore, FlagMore);
-    uart_send(__LINE__, __func__, "Character StartRow: %2u     Character StartColumn: %2u\r", StartRow, StartColumn);
 
-    /* Display bitmap for each character row. */
-    for (RowNumber = 0; RowNumber < CharHeight; ++RowNumber)
-    {
-      switch (FontType)
-      {
-        case (FONT_4x7):
-          if (RowNumber == 0) uart_send(__LINE__, __func__, "Character width: %u\r", Font4x7[AsciiValue].Width);
-          util_uint64_to_binary_string((UINT64)Font4x7[AsciiValue].Row[RowNumber],   Font4x7[AsciiValue].Width, String);
-          uart_send(__LINE__, __func__, "Row[%u]: 0x%2.2X   <%s>\r", RowNumber,      Font4x7[AsciiValue].Row[RowNumber], String);
-        break;
 
-        case (FONT_5x7):
-          if (RowNumber == 0) uart_send(__LINE__, __func__, "Character width: %u\r", Font5x7[AsciiValue].Width);
-          util_uint64_to_binary_string((UINT64)Font5x7[AsciiValue].Row[RowNumber],   Font5x7[AsciiValue].Width, String);
-          uart_send(__LINE__, __func__, "Row[%u]: 0x%2.2X   <%s>\r", RowNumber,      Font5x7[AsciiValue].Row[RowNumber], String);
-        break;
 
-        case (FONT_8x10):
-          if (RowNumber == 0) uart_send(__LINE__, __func__, "Character width: %u\r", Font8x10[AsciiValue].Width);
-          util_uint64_to_binary_string((UINT64)Font8x10[AsciiValue].Row[RowNumber],  Font8x10[AsciiValue].Width, String);
-          uart_send(__LINE__, __func__, "Row[%2u]: 0x%2.2X   <%s>\r", RowNumber,     Font8x10[AsciiValue].Row[RowNumber], String);
-        break;
-      }
-    }
+/* $TITLE=RGB_matrix_write_data() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                           Shift out the "wire format" of the specified scan row to the LED matrix.
+\* ============================================================================================================================================================= */
+void RGB_matrix_write_data(UINT8 RowNumber)
+{
+  UINT8 ColumnNumber;
+  UINT8 *WireData;
+
+
+  WireData = WireBuffer[WireFront][RowNumber];
+
+  for (ColumnNumber = 0; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
+  {
+    CLK_LOW;
+    gpio_put_masked(WIRE_DATA_MASK, (UINT32)WireData[ColumnNumber] << WIRE_DATA_SHIFT);
+    CLK_HIGH;
   }
 
+  return;
+}
 
-  /* Check if we need to blank an extra column to the right of the character (because more characters will be displayed to the right).
-     If there are more characters to come, simulate that the character is one more column than it actually is. */
-  if (FlagMore) ++CharWidth;
-  if (DebugBitMask & DEBUG_MATRIX) uart_send(__LINE__, __func__, "Adjusted character Width: %u\r", CharWidth);
 
 
-  /* Set pixels in the target display buffer to match the bitmap of this ASCII character. */
-  for (RowNumber = 0; RowNumber < CharHeight; ++RowNumber)
-	{
-    /// if (DebugBitMask & DEBUG_MATRIX) uart_send(__LINE__, __func__, "Row[%u] value: 0x%2.2X\r\r", RowNumber, Font5x7[AsciiValue].Row[RowNumber]);  /// font 5x7 hard-coded.
 
-    for (ColumnNumber = 0; ColumnNumber < CharWidth; ++ColumnNumber)
-    {
-      if (DebugBitMask & DEBUG_MATRIX)
-        uart_send(__LINE__, __func__, "StartColumn:  %3u     CharColumn:   %2u\r", StartColumn, ColumnNumber);
 
+/* $TITLE=scroll_compose() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                  Scroll compositor: advance every active scroll region whose owner window is currently displayed.
+                                                          Return the number of pixels scrolled (all regions).
+   NOTES:
+   1) Each scroll region is clipped to its own window (see scroll_region()), so that regions of different windows, or different lines
+      of the same window, scroll concurrently without overwriting each other.
+   2) A region is advanced only when its owner is the window currently displayed in the matrix band where the region lies (WinTop,
+      WinMid or WinBot). The scroll of a window hidden behind another one is put on hold until that window is restored.
+\* ============================================================================================================================================================= */
+UINT8 scroll_compose(void)
+{
+  UINT8 BandOwner;
+  UINT8 Loop1UInt8;
+  UINT8 Owner;
+  UINT8 PixelCount;
 
-      switch (FontType)
-      {
-        case (FONT_4x7):
-          if (Font4x7[AsciiValue].Row[RowNumber] & (0x01 << (Font4x7[AsciiValue].Width) - ColumnNumber - 1))
-          {
-            /* This pixel must be turned On. */
-            DisplayBuffer[StartRow + RowNumber] |= (0x01ll << (StartColumn + ColumnNumber));
-            if (DebugBitMask & DEBUG_MATRIX)
-            {
-              uart_send(__LINE__, __func__, "RowNumber: %2u     ColumnNumber: %2u   Pixel must be turned On\r", StartRow + RowNumber, StartColumn + ColumnNumber);
-              uart_send(__LINE__, __func__, "Press <Enter> to continuer: ");
-              input_string(String);
-            }
-          }
-          else
-          {
-            /* This pixel must be turned Off. */
-            DisplayBuffer[StartRow + RowNumber] &= ~(0x01ll << (StartColumn + ColumnNumber));
-            if (DebugBitMask & DEBUG_MATRIX)
-            {
-              uart_send(__LINE__, __func__, "RowNumber: %2u     ColumnNumber: %2u   Pixel must be turned Off\r", StartRow + RowNumber, StartColumn + ColumnNumber);
-              uart_send(__LINE__, __func__, "Press <Enter> to continuer: ");
-              input_string(String);
-            }
-          }
-        break;
 
-        case (FONT_5x7):
-          if (Font5x7[AsciiValue].Row[RowNumber] & (0x01 << (Font5x7[AsciiValue].Width) - ColumnNumber - 1))
-          {
-            /* This pixel must be turned On. */
-            DisplayBuffer[StartRow + RowNumber] |= (0x01ll << (StartColumn + ColumnNumber));
-            if (DebugBitMask & DEBUG_MATRIX)
-            {
-              uart_send(__LINE__, __func__, "RowNumber: %2u     ColumnNumber: %2u   Pixel must be turned On\r", StartRow + RowNumber, StartColumn + ColumnNumber);
-              uart_send(__LINE__, __func__, "Press <Enter> to continuer: ");
-              input_string(String);
-            }
-          }
-          else
-          {
-            /* This pixel must be turned Off. */
-            DisplayBuffer[StartRow + RowNumber] &= ~(0x01ll << (StartColumn + ColumnNumber));
-            if (DebugBitMask & DEBUG_MATRIX)
-            {
-              uart_send(__LINE__, __func__, "RowNumber: %2u     ColumnNumber: %2u   Pixel must be turned Off\r", StartRow + RowNumber, StartColumn + ColumnNumber);
-              uart_send(__LINE__, __func__, "Press <Enter> to continuer: ");
-              input_string(String);
-            }
-          }
-        break;
+  PixelCount = 0;
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ACTIVE_SCROLL; ++Loop1UInt8)
+  {
+    if (ActiveScroll[Loop1UInt8] == 0x00l) continue;
 
-        case (FONT_8x10):
-          if (Font8x10[AsciiValue].Row[RowNumber] & (0x01 << (Font8x10[AsciiValue].Width) - ColumnNumber - 1))
-          {
-            /* This pixel must be turned On. */
-            DisplayBuffer[StartRow + RowNumber] |= (0x01ll << (StartColumn + ColumnNumber));
-            if (DebugBitMask & DEBUG_MATRIX)
-            {
-              uart_send(__LINE__, __func__, "RowNumber: %2u     ColumnNumber: %2u   Pixel must be turned On\r", StartRow + RowNumber, StartColumn + ColumnNumber);
-              uart_send(__LINE__, __func__, "Press <Enter> to continuer: ");
-              input_string(String);
-            }
-          }
-          else
-          {
-            /* This pixel must be turned Off. */
-            DisplayBuffer[StartRow + RowNumber] &= ~(0x01ll << (StartColumn + ColumnNumber));
-            if (DebugBitMask & DEBUG_MATRIX)
-            {
-              uart_send(__LINE__, __func__, "RowNumber: %2u     ColumnNumber: %2u   Pixel must be turned Off\r", StartRow + RowNumber, StartColumn + ColumnNumber);
-              uart_send(__LINE__, __func__, "Press <Enter> to continuer: ");
-              input_string(String);
-            }
-          }
-        break;
-      }
-    }
+    /* Slot being set up by win_scroll(). */
+    Owner = ActiveScroll[Loop1UInt8]->Owner;
+    if (Owner == SCROLL_OWNER_NONE) continue;
+
+    /* Owner must not be read before all other parameters have been seen set by win_scroll(). */
+    __dmb();
+
+    /* Find which window is currently displayed in the band of this scroll region (same bands as FlagTopScroll, FlagMidScroll and FlagBotScroll). */
+    if (ActiveScroll[Loop1UInt8]->StartRow <= 8)
+      BandOwner = WinTop;
+    else if (ActiveScroll[Loop1UInt8]->StartRow <= 17)
+      BandOwner = WinMid;
+    else
+      BandOwner = WinBot;
+
+    if (BandOwner == Owner) PixelCount += scroll_step(Loop1UInt8);
   }
 
-  return StartColumn + ColumnNumber;
+  return PixelCount;
 }
 
 
 
 
 
-/* $TITLE=RGB_matrix_display_time() */
+/* $TITLE=scroll_pool_acquire() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                               Display data and time on LED matrix (usual matrix display).
-                                    NOTE: Matrix scanning will be stopped while data is sent through CDC USB
-                                          It's Ok to do it for debugging purposes for short periods of time but it should
-                                          not be done continuously because LEDs are then overbright (overvoltage).
-                                          This will shorten the life span of the LEDs.
+                                 Take a free slot from the static scroll pool. Return the scroll number, or MAX_ACTIVE_SCROLL if all slots are in use.
+   NOTES:
+   1) The slot is cleared (as calloc() used to do) and ActiveScroll[] points to it on return. Its owner is SCROLL_OWNER_NONE until
+      the caller has set it up, so that the scroll engine running on core 1 does not pick it up too early.
+   2) Slots may be released from both cores (see scroll_pool_release()), so the free slot stack is protected by a hardware spin lock.
 \* ============================================================================================================================================================= */
-void RGB_matrix_display_time(void)
+UINT8 scroll_pool_acquire(void)
 {
-  static UINT8 CurrentColor;
+  UINT8 ScrollNumber;
 
-  UINT8 FlagLocalDebug = FLAG_OFF;
+  UINT32 InterruptMask;
 
-  UINT16 Loop1UInt16;
-  UINT16 PwmLevel;
-  UINT16 TargetDays;
 
-  struct tm TempTime;
+  InterruptMask = spin_lock_blocking(ScrollPoolLock);
 
+  if (ScrollPool.FreeCount == 0)
+  {
+    ++ScrollPool.ExhaustedCount;
+    spin_unlock(ScrollPoolLock, InterruptMask);
 
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                              Read time from real-time clock IC (DS3231).
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-  if (FlagLocalDebug) printf("%u   Before ds3231_get_time()\r", __LINE__);
-  ds3231_get_time(&CurrentTime);
+    return MAX_ACTIVE_SCROLL;
+  }
+
+  ScrollNumber = ScrollPool.FreeSlot[--ScrollPool.FreeCount];
+
+  ++ScrollPool.AcquireCount;
+  ++ScrollPool.InUse;
+  if (ScrollPool.InUse > ScrollPool.HighWater) ScrollPool.HighWater = ScrollPool.InUse;
+
+  spin_unlock(ScrollPoolLock, InterruptMask);
+
+
+  memset(&ScrollPool.Slot[ScrollNumber], 0x00, sizeof(ScrollPool.Slot[ScrollNumber]));
+  ScrollPool.Slot[ScrollNumber].Owner = SCROLL_OWNER_NONE;
+
+  /* Slot must be cleared before it becomes visible to the scroll engine. */
+  __dmb();
+  ActiveScroll[ScrollNumber] = &ScrollPool.Slot[ScrollNumber];
+
+  return ScrollNumber;
+}
 
 
 
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                             Update day-of-week on first line of WIN_DATE.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-  /* Update date only if WIN_DATE is the WinTop active window and if no scrolling is active. */
-  if (FlagLocalDebug) printf("%4u   Before updating day-of-week\r", __LINE__);
-  if (Window[WIN_DATE].FlagTopScroll == FLAG_OFF)
-  {
-    if (WinTop == WIN_DATE)
-    {
-      /* Update day-of-week only if WIN_DATE is the WinTop active window. */
-      ///// PwmLevel = Pwm[PWM_ID_BRIGHTNESS].Level;  // keep track of original PWM level on entry.
-      ///// pwm_set_level(PWM_ID_BRIGHTNESS, 2000);   // blank LED matrix before matrix update.
-      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_OFF);
 
-      /// critical_section_enter_blocking(&ThreadLock);
 
-      CLK_HIGH;
+/* $TITLE=scroll_pool_init() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                        Initialize the static scroll pool with all slots free.
+\* ============================================================================================================================================================= */
+void scroll_pool_init(void)
+{
+  UINT8 Loop1UInt8;
 
-      ///// win_part_cls(WIN_DATE, 201, 201);
-      win_printf(WIN_DATE, 201, 99, FONT_5x7, "%s", DayName[CurrentTime.DayOfWeek]);
 
-      CLK_LOW;
+  if (ScrollPoolLock == NULL) ScrollPoolLock = spin_lock_init(spin_lock_claim_unused(true));
+  if (ScrollTextLock == NULL) ScrollTextLock = spin_lock_init(spin_lock_claim_unused(true));
 
-      /// critical_section_exit(&ThreadLock);
+  ScrollPool.FreeCount      = 0;
+  ScrollPool.InUse          = 0;
+  ScrollPool.HighWater      = 0;
+  ScrollPool.AcquireCount   = 0;
+  ScrollPool.ExhaustedCount = 0;
 
-      /* Restore original PWM level when done. */
-      ///// pwm_set_level(PWM_ID_BRIGHTNESS, PwmLevel);
-      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_ON);
-    }
+  /* Push slots in reverse order, so that they are handed out from slot 0 up, as before. */
+  for (Loop1UInt8 = MAX_ACTIVE_SCROLL; Loop1UInt8 > 0; --Loop1UInt8)
+  {
+    ActiveScroll[Loop1UInt8 - 1] = 0x00l;
+    ScrollPool.FreeSlot[ScrollPool.FreeCount++] = Loop1UInt8 - 1;
   }
 
+  return;
+}
 
 
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                               Update date on second line of WIN_DATE.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-  if (FlagLocalDebug) printf("%4u   Before updating date\r", __LINE__);
-  if (Window[WIN_DATE].FlagMidScroll == FLAG_OFF)
-  {
-    if (WinMid == WIN_DATE)
-    {
-      /* Update date only if WIN_DATE is the WinMid active window. */
-      ///// PwmLevel = Pwm[PWM_ID_BRIGHTNESS].Level;  // keep track of original PWM level on entry.
-      ///// pwm_set_level(PWM_ID_BRIGHTNESS, 2000);   // blank LED matrix before matrix update.
-      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_OFF);
 
-      /// critical_section_enter_blocking(&ThreadLock);
 
-      CLK_HIGH;
 
-      ///// win_part_cls(WIN_DATE, 202, 202);
+/* $TITLE=scroll_pool_release() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                Give back a slot to the static scroll pool. ActiveScroll[ScrollNumber] becomes a NULL pointer.
+\* ============================================================================================================================================================= */
+void scroll_pool_release(UINT8 ScrollNumber)
+{
+  UINT32 InterruptMask;
 
-      /* If golden age mode is On, alternate between date and period of the day. */
-      if ((FlashConfig1.FlagGoldenAge) && ((CurrentTime.Second % 10) < 5))
-      {
-        /* Display period of the day. */
-        if ((CurrentTime.Hour >= FlashConfig1.GoldenMorningStart)   && (CurrentTime.Hour < FlashConfig1.GoldenAfternoonStart))
-          win_printf(WIN_DATE, 202, 99, FONT_5x7, "%s", DayPeriod[MORNING]);
-        if ((CurrentTime.Hour >= FlashConfig1.GoldenAfternoonStart) && (CurrentTime.Hour < FlashConfig1.GoldenEveningStart))
-          win_printf(WIN_DATE, 202, 99, FONT_5x7, "%s", DayPeriod[AFTERNOON]);
-        if ((CurrentTime.Hour >= FlashConfig1.GoldenEveningStart)   && (CurrentTime.Hour < FlashConfig1.GoldenNightStart))
-          win_printf(WIN_DATE, 202, 99, FONT_5x7, "%s", DayPeriod[EVENING]);
-        if ((CurrentTime.Hour >= FlashConfig1.GoldenNightStart)     || (CurrentTime.Hour < FlashConfig1.GoldenMorningStart))
-          win_printf(WIN_DATE, 202, 99, FONT_5x7, "%s", DayPeriod[NIGHT]);
-      }
-      else
-      {
-        /* If we were in golden age mode and we revert to "normal" mode, let's reset current color. */
-        if (CurrentColor != 0) CurrentColor = 0;
 
-        /* Display date on WIN_DATE window while centering it on the lines. */
-        win_printf(WIN_DATE, 202, 99, FONT_5x7, "%2.2u-%3s-%4.4u", CurrentTime.DayOfMonth, ShortMonth[CurrentTime.Month], CurrentTime.Year);
-      }
+  if (ScrollNumber >= MAX_ACTIVE_SCROLL) return;
 
-      CLK_LOW;
+  /* Check under the lock, so that a slot released from both cores at the same time is not pushed twice on the free slot stack. */
+  InterruptMask = spin_lock_blocking(ScrollPoolLock);
 
-      /// critical_section_exit(&ThreadLock);
+  if (ActiveScroll[ScrollNumber] != 0x00l)
+  {
+    ActiveScroll[ScrollNumber] = 0x00l;
 
-      /* Restore original PWM level when done. */
-      ///// pwm_set_level(PWM_ID_BRIGHTNESS, PwmLevel);
-      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_ON);
-    }
+    /* Scroll engine must see the NULL pointer before the slot may be handed out again. */
+    __dmb();
+    ScrollPool.FreeSlot[ScrollPool.FreeCount++] = ScrollNumber;
+    --ScrollPool.InUse;
   }
 
+  spin_unlock(ScrollPoolLock, InterruptMask);
 
+  return;
+}
 
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-             Update Alarms indicators and Alarm target days indicators on unused top and bottom rows of WIN_DATE window.
-             NOTE: Even if we are scrolling text, alarm indicators and target alarm day indicators should not interfere.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-  if (FlagLocalDebug) printf("%4u   Before updating alarm and day-of-week indicators\r", __LINE__);
-  if (WinTop == WIN_DATE)
-  {
-    /* Find all days-of-week that are target days for all active alarms. */
-    TargetDays = 0;  // bitmask of all days that are target days in one or more alarms.
-    for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ALARMS; ++Loop1UInt16)
-    {
-      if (FlashConfig1.Alarm[Loop1UInt16].FlagStatus)
-        TargetDays |= FlashConfig1.Alarm[Loop1UInt16].DayMask;
-    }
 
-    /* --------------- Update active / inactive alarm indicators. --------------- */
-    if (FlashConfig1.FlagDisplayAlarms)
-    {
-      for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ALARMS; ++Loop1UInt16)
-      {
-        RGB_matrix_set_pixel(FrameBuffer, 0, (3 + (Loop1UInt16 * 7)), 0, (4 + (Loop1UInt16 * 7)));
-        if (FlashConfig1.Alarm[Loop1UInt16].FlagStatus)
-          RGB_matrix_set_color(0, (3 + (Loop1UInt16 * 7)), 0, (4 + (Loop1UInt16 * 7)), GREEN);  // active alarms have green indicators.
-        else
-          RGB_matrix_set_color(0, (3 + (Loop1UInt16 * 7)), 0, (4 + (Loop1UInt16 * 7)), RED);    // inactive alarms have red indicators.
-      }
-    }
 
-    /* --------------- Update active / inactive target alarm days. --------------- */
-    if (FlashConfig1.FlagDisplayAlarmDays)
-    {
-      for (Loop1UInt16 = 0; Loop1UInt16 < 7; ++Loop1UInt16)
-      {
-        RGB_matrix_set_pixel(FrameBuffer, Window[WIN_DATE].EndRow, (Loop1UInt16 * 10), Window[WIN_DATE].EndRow, (3 + (Loop1UInt16 * 10)));
-        if (TargetDays & (1 << Loop1UInt16))
-          RGB_matrix_set_color(Window[WIN_DATE].EndRow, (Loop1UInt16 * 10), Window[WIN_DATE].EndRow, (3 + (Loop1UInt16 * 10)), GREEN);  // days-of-week that have an active alarm have a green indicator.
-        else
-          RGB_matrix_set_color(Window[WIN_DATE].EndRow, (Loop1UInt16 * 10), Window[WIN_DATE].EndRow, (3 + (Loop1UInt16 * 10)), RED);    // days-of-week that don't have any active alarm have a red indicator.
-      }
-    }
-  }
 
 
+/* $TITLE=scroll_region() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                               Clip a scroll region to the specified window (inside its box border if the border is kept on the matrix).
+                                                 Return FLAG_ON if some part of the region remains, FLAG_OFF otherwise.
+   NOTES:
+   1) StartRow and EndRow must already have been validated by RGB_matrix_check_coord(). StartColumn and EndColumn are returned
+      as the columns of the window, since a scroll always spans the whole width of its window.
+   2) When the last box of the window remains On (LastBoxState == ACTION_DRAW), the box border is excluded from the region,
+      so that scrolling never moves it (same as win_cls()).
+   3) A window that has not been defined spans the whole matrix.
+\* ============================================================================================================================================================= */
+UINT8 scroll_region(UINT8 WindowNumber, UINT8 *StartRow, UINT8 *EndRow, UINT8 *StartColumn, UINT8 *EndColumn)
+{
+  UINT8 BottomRow;
+  UINT8 LeftColumn;
+  UINT8 RightColumn;
+  UINT8 TopRow;
 
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                          Update time on bottom half of RGB matrix LED display.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-  if (FlagLocalDebug) printf("%u   Before updating time\r", __LINE__);
-  if (Window[WIN_TIME].FlagBotScroll == FLAG_OFF)
-  {
-    /* Display time on WIN_TIME window. */
-    if (WinBot == WIN_TIME)
-    {
-      /* Update time only if WIN_TIME is the WinBot active window. */
-      ///// PwmLevel = Pwm[PWM_ID_BRIGHTNESS].Level;  // keep track of original PWM level on entry.
-      ///// pwm_set_level(PWM_ID_BRIGHTNESS, 2000);   // blank LED matrix before matrix update.
-      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_OFF);
 
-      /// critical_section_enter_blocking(&ThreadLock);
+  if ((WindowNumber >= MAX_WINDOWS) || (Window[WindowNumber].WinStatus == WINDOW_UNUSED))
+  {
+    TopRow      = 0;
+    BottomRow   = MAX_ROWS - 1;
+    LeftColumn  = 0;
+    RightColumn = MAX_COLUMNS - 1;
+  }
+  else
+  {
+    TopRow      = Window[WindowNumber].StartRow;
+    BottomRow   = Window[WindowNumber].EndRow;
+    LeftColumn  = Window[WindowNumber].StartColumn;
+    RightColumn = Window[WindowNumber].EndColumn;
 
-      CLK_HIGH;
+    /* Keep box border out of the scroll region (win_open() makes sure a window is at least three pixels high and wide). */
+    if ((Window[WindowNumber].LastBoxState == ACTION_DRAW) && ((BottomRow - TopRow) >= 2) && ((RightColumn - LeftColumn) >= 2))
+    {
+      ++TopRow;
+      --BottomRow;
+      ++LeftColumn;
+      --RightColumn;
+    }
+  }
 
-      /* Update time. */
-      win_printf(WIN_TIME, 203, 99, FONT_8x10, "%2.2u:%2.2u:%2.2u", CurrentTime.Hour, CurrentTime.Minute, CurrentTime.Second);
+  if (*StartRow < TopRow)                  *StartRow = TopRow;
+  if (*EndRow   > BottomRow)               *EndRow   = BottomRow;
+  if (RightColumn > (MAX_COLUMNS - 1))     RightColumn = MAX_COLUMNS - 1;
+  *StartColumn = LeftColumn;
+  *EndColumn   = RightColumn;
 
+  if ((*StartRow > *EndRow) || (*StartColumn > *EndColumn)) return FLAG_OFF;
 
-      /* win_part_cls() will erase all the WIN_TIME window, except the border. If we want the "endless loop" pilot
-         inside this window area, we need to proceed another way. */
-      // win_part_cls(WIN_TIME, 203, 203);
+  return FLAG_ON;
+}
 
-      /* Update time while blinking the two double-dots. */
-      // if (CurrentTime.Second % 2)
-      //   win_printf(WIN_TIME, 203, 99, FONT_8x10, "%2.2u %2.2u %2.2u", CurrentTime.Hour, CurrentTime.Minute, CurrentTime.Second);
-      // else
-      //   win_printf(WIN_TIME, 203, 99, FONT_8x10, "%2.2u:%2.2u:%2.2u", CurrentTime.Hour, CurrentTime.Minute, CurrentTime.Second);
 
-      /* If we are in golden age mode, set the color according to the period of the day (day or night) while leaving the WIN_TIME box,
-         alarm indicators and target days indicators in their original colors. */
-      if (FlashConfig1.FlagGoldenAge)
-      {
-        if ((CurrentTime.Hour >= FlashConfig1.GoldenMorningStart) && (CurrentTime.Hour < FlashConfig1.GoldenNightStart))
-        {
-          if (CurrentColor != YELLOW)
-          {
-            CurrentColor = YELLOW;
 
-            /* Set colors of WIN_TIME window without altering alarm indicators and alarm target day indicators. */
-            RGB_matrix_set_color(Window[WIN_DATE].StartRow + 1, Window[WIN_DATE].StartColumn, Window[WIN_DATE].EndRow - 1, Window[WIN_DATE].EndColumn, CurrentColor);
-            /// win_set_color(WIN_DATE, CurrentColor, Window[WIN_DATE].BoxColor);  // WIN_DATE, except outside box.
 
-            /* Set colors for WIN_TIME window without changing border color. */
-            RGB_matrix_set_color(Window[WIN_TIME].StartRow + 1, Window[WIN_TIME].StartColumn + 1, Window[WIN_TIME].EndRow - 1, Window[WIN_TIME].EndColumn - 1, CurrentColor);
-            /// win_set_color(WIN_TIME, CurrentColor, Window[WIN_TIME].BoxColor);
-          }
-        }
-        else
-        {
-          if (CurrentColor != BLUE)
-          {
-            CurrentColor = BLUE;
 
-            /* Set colors of WIN_TIME window without altering alarm indicators and alarm target day indicators. */
-            RGB_matrix_set_color(Window[WIN_DATE].StartRow + 1, Window[WIN_DATE].StartColumn, Window[WIN_DATE].EndRow - 1, Window[WIN_DATE].EndColumn, CurrentColor);
-            /// win_set_color(WIN_DATE, CurrentColor, Window[WIN_DATE].BoxColor);  // WIN_DATE, except outside box.
+/* $TITLE=scroll_step() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                              Advance the specified active scroll by the number of pixels due at its speed for one scroll tick. Return the number of pixels scrolled.
+   NOTES:
+   1) ScrollSpeed is given in pixels per second. At each tick, ScrollSpeed / SCROLL_TICK_HZ pixel is added to a fixed-point accumulator
+      (counting in 1 / SCROLL_TICK_HZ pixel units) and whole pixels are scrolled. The fraction is kept exactly, so that the average
+      speed never drifts, without any floating point or division in the callback.
+\* ============================================================================================================================================================= */
+UINT8 scroll_step(UINT8 ScrollNumber)
+{
+  UINT8 Owner;
+  UINT8 PixelCount;
 
-            /* Set colors for WIN_TIME window without changing border color. */
-            RGB_matrix_set_color(Window[WIN_TIME].StartRow + 1, Window[WIN_TIME].StartColumn + 1, Window[WIN_TIME].EndRow - 1, Window[WIN_TIME].EndColumn - 1, CurrentColor);
-            /// win_set_color(WIN_TIME, CurrentColor, Window[WIN_TIME].BoxColor);
-          }
-        }
 
-        /* Draw border for WIN_TIME window. */
-        /// RGB_matrix_box(Window[WIN_TIME].StartRow, Window[WIN_TIME].StartColumn, Window[WIN_TIME].EndRow, Window[WIN_TIME].EndColumn, RED, ACTION_DRAW);
-      }
+  if ((ScrollNumber >= MAX_ACTIVE_SCROLL) || (ActiveScroll[ScrollNumber] == 0x00l)) return 0;
 
-      CLK_LOW;
+  Owner = ActiveScroll[ScrollNumber]->Owner;
+  ActiveScroll[ScrollNumber]->SpeedAccumulator += ActiveScroll[ScrollNumber]->ScrollSpeed;
 
-      /// critical_section_exit(&ThreadLock);
+  PixelCount = 0;
+  while (ActiveScroll[ScrollNumber]->SpeedAccumulator >= SCROLL_TICK_HZ)
+  {
+    ActiveScroll[ScrollNumber]->SpeedAccumulator -= SCROLL_TICK_HZ;
+    RGB_matrix_scroll(ScrollNumber);
+    ++PixelCount;
 
-      /* Restore original PWM level when done. */
-      ///// pwm_set_level(PWM_ID_BRIGHTNESS, PwmLevel);
-      /// pwm_on_off(PWM_ID_BRIGHTNESS, FLAG_ON);
-    }
+    /* Stop if the scroll has completed and its slot has been given back to the pool (and maybe handed out again). */
+    if ((ActiveScroll[ScrollNumber] == 0x00l) || (ActiveScroll[ScrollNumber]->Owner != Owner)) break;
   }
 
-  if (FlagLocalDebug) printf("%4u   Exiting RGB_matrix_display_time()\r", __LINE__);
-
-  return;
+  return PixelCount;
 }
 
 
 
 
 
-/* $TITLE=RGB_matrix_integrity_check() */
+/* $TITLE=scroll_strip_glyph() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                               LED matrix device integrity check
-                                Turn On and Off each line of the LED matrix and for each color and combination of colors.
-              NOTE: FlagTerminal indicates if caller is a terminal emulator or remote control. If remote control, the check is performed unattended.
+                         Render one character of the specified font type to pixel columns. Return the number of pixel columns of the character.
+   NOTES:
+   1) Same glyph and width as RGB_matrix_display(), including the extra blank column (kerned) when FlagMore is set (next character).
+   2) Bit 0 of each pixel column is the top row of the character. When Column is NULL, only the width is returned.
+   3) The scroll engine supports FONT_5x7 and FONT_8x10 only. Any other font type is rendered with FONT_5x7.
+   4) Called by the scroll engine (see RGB_matrix_scroll()) for each character, when it is about to enter the matrix.
 \* ============================================================================================================================================================= */
-void RGB_matrix_integrity_check(UINT8 FlagTerminal)
+UINT8 scroll_strip_glyph(UINT8 AsciiValue, UINT8 FontType, UINT8 FlagMore, UINT16 *Column)
 {
-  UCHAR String[31];
-
-  UINT8 Color;
+  UINT8 CharHeight;
+  UINT8 CharWidth;
   UINT8 ColumnNumber;
-  UINT8 PassNumber;
+  UINT8 GlyphWidth;
   UINT8 RowNumber;
-  UINT8 SectorNumber;
 
+  const UINT8 *GlyphRow;
 
-  printf("\r\r\r");
-  if (FlagTerminal) uart_send(__LINE__, __func__, "%4u   Entering RGB Matrix device integrity check.\r", __LINE__);
 
-  if (FlagTerminal)
+  if (FontType != FONT_8x10) FontType = FONT_5x7;  // only font types supported by the scroll engine.
+
+  if (FontType == FONT_8x10)
   {
-    if (stdio_usb_connected())
-    {
-      uart_send(__LINE__, __func__, "Press <Enter> to erase LED matrix: ");
-      input_string(String);
-    }
+    if (AsciiValue > 0x7F) AsciiValue = 0;  // only first 128 ASCII characters are defined for 8x10 font.
+    GlyphRow   = Font8x10[AsciiValue].Row;
+    GlyphWidth = Font8x10[AsciiValue].Width;
+    CharHeight = 10;
+  }
+  else
+  {
+    GlyphRow   = Font5x7[AsciiValue].Row;
+    GlyphWidth = Font5x7[AsciiValue].Width;
+    CharHeight = 7;
   }
 
-  win_open(WIN_TEST, FLAG_OFF);
-  win_printf(WIN_TEST,  2, 99, FONT_5x7, "Device");
-  win_printf(WIN_TEST, 10, 99, FONT_5x7, "integrity");
-  win_printf(WIN_TEST, 18, 99, FONT_5x7, "check");
+  CharWidth = GlyphWidth;
+  if (FlagMore) CharWidth += 1 + layout_kerning(FontType, AsciiValue, FlagMore);
 
+  if (Column == NULL) return CharWidth;
 
-  /* -------------------- Top down test -------------------- */
-  /* Turn On every line of LED matrix and for each color combination (Red - Green - Blue - Yellow - Magenta - Cyan - White). */
-  if (FlagTerminal)
+  for (ColumnNumber = 0; ColumnNumber < CharWidth; ++ColumnNumber)
   {
-    if (stdio_usb_connected())
-    {
-      uart_send(__LINE__, __func__, "Press <Enter> to begin top-down integrity check: ");
-      input_string(String);
-      uart_send(__LINE__, __func__, "Running top-down integrity check.\r");
-    }
+    Column[ColumnNumber] = 0x0000;
+
+    /* Extra column (if any) is left blank. */
+    if (ColumnNumber >= GlyphWidth) continue;
+
+    for (RowNumber = 0; RowNumber < CharHeight; ++RowNumber)
+      if (GlyphRow[RowNumber] & (0x01 << (GlyphWidth - ColumnNumber - 1))) Column[ColumnNumber] |= (0x01 << RowNumber);
   }
-  else
-    sleep_ms(2000);
 
-  RGB_matrix_cls(FrameBuffer);
+  return CharWidth;
+}
+
+
+
+
+
+/* $TITLE=scroll_text_free() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                            Return the number of free characters in the text ring of the specified active scroll.
+   NOTES:
+   1) Characters already rendered are reclaimed by the scroll engine as soon as they are no longer needed for a repeat cycle
+      (see RGB_matrix_scroll()), so a caller feeding a long message stream may wait for this number to grow and append more text.
+\* ============================================================================================================================================================= */
+UINT16 scroll_text_free(UINT8 ScrollNumber)
+{
+  if ((ScrollNumber >= MAX_ACTIVE_SCROLL) || (ActiveScroll[ScrollNumber] == 0x00l)) return 0;
+
+  return (MAX_SCROLL_TEXT - (UINT16)(ActiveScroll[ScrollNumber]->TextHead - ActiveScroll[ScrollNumber]->TextStart));
+}
+
+
+
+
+
+/* $TITLE=scroll_text_put() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                            Append a string to the text ring of the specified active scroll. Return FLAG_OFF (and count an overflow) if it does not fit.
+   NOTES:
+   1) The string is only copied here. The scroll engine renders it one character at a time, just before the character enters the
+      matrix (see RGB_matrix_scroll()), so that a text of up to MAX_SCROLL_TEXT characters needs MAX_SCROLL_TEXT bytes only.
+   2) The string is appended as a whole or not at all, so that a partial text never gets scrolled.
+   3) win_scroll() may be called from the main endless loop and from core 0 callbacks, so ScrollTextLock serializes producers. As with
+      ring_put(), the memory barrier makes sure the characters are completely written before the scroll engine may see the new TextHead.
+\* ============================================================================================================================================================= */
+UINT8 scroll_text_put(UINT8 ScrollNumber, UCHAR *String)
+{
+  UINT16 Head;
+  UINT16 Length;
+  UINT16 Loop1UInt16;
+
+  UINT32 InterruptMask;
+
 
+  if ((ScrollNumber >= MAX_ACTIVE_SCROLL) || (ActiveScroll[ScrollNumber] == 0x00l)) return FLAG_OFF;
 
-  /* Test all seven color combinations. */
-  for (PassNumber = 0; PassNumber < 7; ++PassNumber)
-  {
-    if (FlagTerminal) uart_send(__LINE__, __func__, "Proceeding with top-down integrity check, pass number %u\r", PassNumber);
-    switch (PassNumber)
-    {
-      case (0):
-        Color = RED;
-      break;
+  Length = strlen(String);
 
-      case (1):
-        Color = GREEN;
-      break;
+  InterruptMask = spin_lock_blocking(ScrollTextLock);
 
-      case (2):
-        Color = BLUE;
-      break;
+  if (Length > scroll_text_free(ScrollNumber))
+  {
+    ++ActiveScroll[ScrollNumber]->TextOverflow;
+    spin_unlock(ScrollTextLock, InterruptMask);
 
-      case (3):
-        Color = RED + GREEN;
-      break;
+    return FLAG_OFF;
+  }
 
-      case (4):
-        Color = RED + BLUE;
-      break;
+  /* Ring space must not be overwritten before TextStart has been seen updated by the scroll engine. */
+  __dmb();
+  Head = ActiveScroll[ScrollNumber]->TextHead;
+  for (Loop1UInt16 = 0; Loop1UInt16 < Length; ++Loop1UInt16)
+    ActiveScroll[ScrollNumber]->Text[Head++ & (MAX_SCROLL_TEXT - 1)] = String[Loop1UInt16];
 
-      case (5):
-        Color = GREEN + BLUE;
-      break;
+  /* Characters must be completely written before the scroll engine may see the new TextHead. */
+  __dmb();
+  ActiveScroll[ScrollNumber]->TextHead = Head;
 
-      case (6):
-      default:
-        Color = RED + GREEN + BLUE;
-      break;
-    }
+  spin_unlock(ScrollTextLock, InterruptMask);
 
-    /* Test the LED matrix with all color compinations above. */
-    RGB_matrix_set_color(0, 0, 31, 63, Color);
+  return FLAG_ON;
+}
 
-    /* Sequentially turn On all 32 rows of 64 pixels. */
-    /* NOTE: Pixel color has already been set above. */
-    for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
-    {
-      FrameBuffer[RowNumber] = 0xFFFFFFFFFFFFFFFFll;  // turn On all 64 pixels of this row.
 
-      if (RowNumber > 7)
-      {
-        /* When reaching 8th row (or more), turn Off the "oldest" row of pixels so that electronic will not be overloaded.
-           This way, only 8 rows will be turned On at any single time. */
-        FrameBuffer[RowNumber - 8] = 0x00ll;
-      }
-      sleep_ms(100);  // make a quick pause after each line.
-    }
 
-    /* When the 32nd row has been turned On, complete turning Off last 8 rows (row 24 to 31). */
-    for (RowNumber = 24; RowNumber < MAX_ROWS; ++RowNumber)
-    {
-      FrameBuffer[RowNumber] = 0x00ll;
-      sleep_ms(100);
-    }
 
-    if (FlagTerminal)
-    {
-      if (stdio_usb_connected())
-      {
-        uart_send(__LINE__, __func__, "Press <Enter> to proceed with next pass or <ESC> to exit this test: ");
-        input_string(String);
-      }
-    }
-    else
-      sleep_ms(1000);
 
-    RGB_matrix_cls(FrameBuffer);
-    if (String[0] == 27) break;  // user pressed <ESC>, get out of <for> loop and exit top-down integrity check.
-    if (IrBuffer[0] != BUTTON_NONE) break;  // user pressed a remote control button, get out of <for> loop and exit top-down integrity check.
-  }
-  if (FlagTerminal) printf("\r\r\r");
+/* $TITLE=set_auto_brightness() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                         Manage ambient light history for automatic brightness.
+\* ============================================================================================================================================================= */
+void set_auto_brightness(void)
+{
+  static UINT16 Counter;
+  UINT16 CurrentLightValue;
+  UINT16 LightRange;
+  UINT16 Loop1UInt16;
+  UINT16 PwmHiLimit;
+  UINT16 PwmLoLimit;
+  UINT16 PwmLevel;
 
+  UINT64 TotalValues;
 
+  float  PwmRange;
 
-  /* ------------------ Left-to-right test ------------------ */
-  /* Turn On every column of LED matrix and for each color combination (Red - Green - Blue - Yellow - Magenta - Cyan - White). */
-  if (FlagTerminal)
-  {
-    if (stdio_usb_connected())
-    {
-      uart_send(__LINE__, __func__, "Press <Enter> to begin left-to-right integrity check: ");
-      input_string(String);
-      uart_send(__LINE__, __func__, "Running left-to-right integrity check.\r");
-    }
-  }
-  else
-    sleep_ms(2000);
 
-  /* Test all seven color combinations. */
-  for (PassNumber = 0; PassNumber < 7; ++PassNumber)
-  {
-    if (FlagTerminal) uart_send(__LINE__, __func__, "Proceeding with left-to-right check, pass number %u\r", PassNumber);
-    switch (PassNumber)
-    {
-      case (0):
-        Color = RED;
-      break;
+  CurrentLightValue     = get_light_value();
+  AmbientLight[Counter] = CurrentLightValue;  // keep history of ambient light for hysteresis.
 
-      case (1):
-        Color = GREEN;
-      break;
+  if ((Counter % 5) == 0)
+  {
+    /* Every 'BRIGHTNESS_HYSTERESIS_SECONDS', compute average ambient light value for the last hysteresis period. */
+    TotalValues = 0ll;
+    for (Loop1UInt16 = 0; Loop1UInt16 < BRIGHTNESS_HYSTERESIS_SECONDS; ++Loop1UInt16)
+      TotalValues += AmbientLight[Loop1UInt16];
 
-      case (2):
-        Color = BLUE;
-      break;
+    AverageAmbientLight = (TotalValues / BRIGHTNESS_HYSTERESIS_SECONDS);
+  }
 
-      case (3):
-        Color = RED + GREEN;
-      break;
+  ++Counter;
+  if (Counter >= BRIGHTNESS_HYSTERESIS_SECONDS) Counter = 0;
 
-      case (4):
-        Color = RED + BLUE;
-      break;
 
-      case (5):
-        Color = GREEN+ BLUE;
-      break;
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                           Manage LED matrix auto brightness when PWM brightness control option is turned On.
 
-      case (6):
-      default:
-        Color = RED + GREEN + BLUE;
-      break;
-    }
+                    NOTES: Ambient light will usually go from 300 (almost no light) to 3500 (very bright light).
+                           This gives a range of about 3200 levels (3500 - 300) to cover the whole range of
+                           light intensities ("PWM_LOWEST_LEVEL" to "PWM_HIGHEST_LEVEL").
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  while ((CurrentTime.Second % 5) == 0)
+  {
+    /* Compute PWM lo and hi limits based on user preference for lowest and highest brightness limits set in device configuration. */
+    /* Default brightness limits are from 1 to 1000 (range of 999) in device configuration and default PWM levels are from 1999 to 1300 (range of 699). */
+    /* So, for each brightness degree that we change, PWM level will be changed by 0.7 (699 / 999). */
+    PwmHiLimit = (PWM_HI_LIMIT - ((UINT16)(FlashConfig1.BrightnessLoLimit * 0.7)));  // removed <+0.5> at the end
+    PwmLoLimit = (PWM_LO_LIMIT + ((UINT16)((1000 - FlashConfig1.BrightnessHiLimit) * 0.7)));
 
-    /* Test the matrix with all color compinations above. */
-    RGB_matrix_set_color(0, 0, 31, 63, Color);
+    LightRange = LIGHT_HI_LIMIT - LIGHT_LO_LIMIT;
 
-    /* Sequentially turn On each column of pixels. */
-    for (ColumnNumber = 0; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
+    if (AverageAmbientLight <= LIGHT_LO_LIMIT)
     {
-      for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
+      /* If average ambient light is lower than the lowest limit, brightness is automatically set to its lowest limit (= highest PWM level). */
+      pwm_set_level(PWM_ID_BRIGHTNESS, PwmHiLimit);
+      if (DebugBitMask & DEBUG_BRIGHTNESS)
       {
-        FrameBuffer[RowNumber] |= (0x01ll << ColumnNumber);
-
-        /* When reaching 8th column, turn Off the oldest columns of pixels so that electronic is not overloaded. */
-        if (ColumnNumber > 7)
-        {
-          FrameBuffer[RowNumber] &= ~(0x01ll << (ColumnNumber - 8));
-        }
+        uart_send(__LINE__, __func__, "\r");
+        /// uart_send(__LINE__, __func__, "Ambient light is lower that low limit - Instantaneous ambient light value: %4u   AverageAmbientLight: %4u   Level: %3u\r", CurrentLightValue, AverageAmbientLight, PwmHiLimit);
+        uart_send(__LINE__, __func__, "PWM Level: %4u\r", PwmHiLimit);
       }
-      sleep_ms(100);
+      break;
     }
 
-    /* Complete turning Off last pixel columns. */
-    for (ColumnNumber = 56; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
+    if (AverageAmbientLight >= LIGHT_HI_LIMIT)
     {
-      for (RowNumber = 0; RowNumber < MAX_ROWS; ++RowNumber)
+      /* If average ambient light is higher than the highest limit, brightness is automatically set to its highest limit (= lowest PWM level). */
+      pwm_set_level(PWM_ID_BRIGHTNESS, PwmLoLimit);
+      if (DebugBitMask & DEBUG_BRIGHTNESS)
       {
-        FrameBuffer[RowNumber] &= ~(0x01ll << ColumnNumber);
+        uart_send(__LINE__, __func__, "\r");
+        /// uart_send(__LINE__, __func__, "Ambient light is higher than high limit - Instantaneous ambient light value: %4u   AverageAmbientLight: %4u   Level: %3u\r", CurrentLightValue, AverageAmbientLight, PwmLoLimit);
+        uart_send(__LINE__, __func__, "PWM Level: %4u\r", PwmLoLimit);
       }
-      sleep_ms(100);
+      break;
     }
 
-    if (FlagTerminal)
+    if ((AverageAmbientLight > LIGHT_LO_LIMIT) && (AverageAmbientLight < LIGHT_HI_LIMIT))
     {
-      if (stdio_usb_connected())
-      {
-        uart_send(__LINE__, __func__, "Press <Enter> to proceed with next pass or <ESC> to exit this test: ");
-        input_string(String);
-      }
+      /* If average ambient light is between the lowest and highest limits set by developer, brightness is automatically adjusted proportionally. */
+      PwmRange = PwmHiLimit - PwmLoLimit;
+      PwmLevel = PwmHiLimit - (UINT16)((AverageAmbientLight - LIGHT_LO_LIMIT) * (PwmRange / LIGHT_RANGE));
+      pwm_set_level(PWM_ID_BRIGHTNESS, PwmLevel);
+      break;
     }
-    else
-      sleep_ms(1000);
-
-    RGB_matrix_cls(FrameBuffer);
-    if (String[0] == 27) break;  // user pressed <ESC> exit left-to-right integrity check.
-    if (IrBuffer[0] != BUTTON_NONE) break;  // user pressed a remote control button, exit left-to-right integrity check.
   }
-  if (FlagTerminal) printf("\r\r\r");
 
-  win_close(WIN_TEST);
+  return;
+}
+
+
+
+
+
+/* $TITLE=software_reset() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                        Restart the RGB Matrix Firmware by software reset.
+\* ============================================================================================================================================================= */
+void software_reset(void)
+{
+  UINT32 Loop1UInt32;
+
+
+  /* Log the restart. */
+  printf("\r\r\r\r\r");
+  printf("%2.2u-%s-%4.4u - %2.2u:%2.2u:%2.2u - RGB Matrix restarted by watchdog...\r\r\r\r\r", CurrentTime.DayOfMonth, ShortMonth[CurrentTime.Month], CurrentTime.Year, CurrentTime.Hour, CurrentTime.Minute, CurrentTime.Second);
+
+  /* Cancel 1-second callback that is calling the watchdog. */
+  /* (cancelling the 1-second timer while we are executing from this thread would crash the Firmware). */
+  cancel_repeating_timer(&Handle1000MSecTimer);
+
+  /* Open a test window to prevent clock refresh on LED matrix
+  /// win_open(WIN_TEST, FLAG_OFF);
+
+  /* Clear LED display since matrix scan will stop during reboot. */
+  RGB_matrix_cls(FrameBuffer);
+  pwm_set_level(PWM_ID_BRIGHTNESS, 2000);
+
+  /* Keep track of interrupt mask and disable interrupts during flash writing. */
+  /// InterruptMask = save_and_disable_interrupts();
+
+  /* Indicate that restart has been triggered by watchdog. */
+  /// FlashConfig1.WatchdogFlag = FLAG_ON;
+  /// ++FlashConfig1.WatchdogCounter;
+
+  /* Make sure these values are saved to flash. */
+  /// flash_write(FLASH_CONFIG1_OFFSET, (UINT8 *)FlashConfig1.Version, sizeof(FlashConfig1));
+  /// flash_check_config(1);
+
+  /* Restore original interrupt mask when done. */
+  /// restore_interrupts(InterruptMask);
+
+  /* Add a small delay - without using sleep_ms() - to make sure PWM has enough time to adjust the proper level. */
+  for (Loop1UInt32 = 0; Loop1UInt32 < 100000; ++Loop1UInt32);
+
+  /// watchdog_reboot(0, SRAM_END, 0);
+  /// watchdog_reboot(0, 0x20042000, 0);
+  /// while (1);
+
+  /// AIRCR_Register = 0x5FA0004;  // this one can't be used for the Pico-RGB-Matrix since it doesn't reset core 1.
+
+  watchdog_enable(1, 1);
 
   return;
 }
@@ -11662,251 +14471,178 @@ void RGB_matrix_integrity_check(UINT8 FlagTerminal)
 
 
 
-/* $TITLE=RGB_matrix_pixel_length() */
+/* $TITLE=task_auto_scroll() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                          Calculate the length of the string supplied when using the font type specified.
+                                         Periodic task: execute the auto-scrolls flagged by the one-second callback.
 \* ============================================================================================================================================================= */
-UINT8 RGB_matrix_pixel_length(UINT8 FontType, UCHAR *Format, ...)
+void task_auto_scroll(void)
 {
-  UCHAR String[256];
-
-  UINT8 Loop1UInt8;
-  UINT8 TotalColumns;
-
-  va_list argp;
-
+  UCHAR String[128];
 
-  /* Transfer the text to display to local variable <String>. */
-  va_start(argp, Format);
-  vsnprintf(String, sizeof(String), Format, argp);
-  va_end(argp);
+  UINT16 FunctionNumber;
+  UINT16 Loop1UInt16;
+  UINT16 Loop2UInt16;
 
 
-  /* Compute total number of pixels width for the whole string, adding one blank pixel column after each character. */
-  TotalColumns = 0;
-  for (Loop1UInt8 = 0; String[Loop1UInt8]; ++Loop1UInt8)
+  for (Loop1UInt16 = 0; Loop1UInt16 < MAX_AUTO_SCROLLS; ++Loop1UInt16)
   {
-    switch (FontType)
+    /// uart_send(__LINE__, __func__, "Checking auto-scroll number %u\r", Loop1UInt16);
+    if (AutoScrollBitMask & (0x01 << Loop1UInt16))
     {
-      case (FONT_4x7):
-        TotalColumns += Font4x7[String[Loop1UInt8]].Width + 1;
-      break;
-
-      default:
-      case (FONT_5x7):
-        TotalColumns += Font5x7[String[Loop1UInt8]].Width + 1;
-      break;
-
-      case (FONT_8x10):
-        TotalColumns += Font8x10[String[Loop1UInt8]].Width + 1;
-      break;
+      /// uart_send(__LINE__, __func__, "Auto-scroll number %u flagged to be executed...\r", Loop1UInt16);
+      /* It is time to execute this auto-scroll. */
+      for (Loop2UInt16 = 0; Loop2UInt16 < MAX_ITEMS; ++Loop2UInt16)
+      {
+        /// uart_send(__LINE__, __func__, "Validating item %2u   FunctionId: %3u\r", Loop2UInt16, FlashConfig1.AutoScroll[Loop1UInt16].FunctionId[Loop2UInt16]);
+        if (FlashConfig1.AutoScroll[Loop1UInt16].FunctionId[Loop2UInt16] != 0)
+        {
+          /* This function ID is a valid one in this auto-scroll, execute it. */
+          FunctionNumber = get_function_number(FlashConfig1.AutoScroll[Loop1UInt16].FunctionId[Loop2UInt16], String);
+          if (FunctionNumber != MAX_FUNCTIONS)
+          {
+            /// if (DebugBitMask & DEBUG_SCROLL)
+            ///   uart_send(__LINE__, __func__, "Executing item  %2u   Function ID: %3u   Function number: %3u   FunctionName: %s   pointer: %p\r", Loop2UInt16, FlashConfig1.AutoScroll[Loop1UInt16].FunctionId[Loop2UInt16], FunctionNumber, Function[FunctionNumber].Name, Function[FunctionNumber].Pointer);
+            Function[FunctionNumber].Pointer();
+          }
+        }
+      }
     }
+    /* Reset this function in the bitmask once this cycle is over. */
+    AutoScrollBitMask &= ~(0x01 << Loop1UInt16);
   }
 
-  return (TotalColumns - 1);  // no need for a blank pixel column after last character.
+  return;
 }
 
 
 
 
 
-/* $TITLE=RGB_matrix_printf() */
+#ifdef DEVELOPER_VERSION
+/* $TITLE=task_debug_10sec() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                          Display specified string, beginning at the specified pixel row and specified pixel column.
-                                          NOTE: This function uses 5x7 variable-width character set.
-                                          NOTE: If PixelColumn specified is 99, string will be centered on the line.
+                                            Periodic task: 10-seconds debug information (developer version only).
 \* ============================================================================================================================================================= */
-UINT8 RGB_matrix_printf(UINT64 *DisplayBuffer, UINT8 StartRow, UINT8 StartColumn, UINT8 FontType, UCHAR *Format, ...)
+void task_debug_10sec(void)
 {
-  UCHAR String[256];
+  UCHAR String[128];
 
-  UINT8 CurrentColumn;
-  UINT8 Loop1UInt8;
-  UINT8 TotalColumns;
+  UINT8 Dum1UInt8;
 
-  va_list argp;
 
+  if (stdio_usb_connected())
+  {
+    /// uart_send(__LINE__, __func__, "10-seconds heartbeat... Absolute time reference: %6llu   WatchdogCheck: %4u\r", (time_us_64() / 1000000ll), WatchdogCheck);
 
-  /* Transfer the text to display to local variable <String>. */
-  va_start(argp, Format);
-  vsnprintf(String, sizeof(String), Format, argp);
-  va_end(argp);
+    if (DebugBitMask & DEBUG_REMINDER)
+    {
+      util_uint64_to_binary_string(Reminder1BitMask, MAX_REMINDERS1, String);
+      uart_send(__LINE__, __func__, "Reminder1BitMask:       0x%10.10llX   [%s]\r", Reminder1BitMask, String);
+    }
 
 
-  if (StartColumn != 99)
-  {
-    /* No request to center text on the line... Start column will be as specified. */
-    CurrentColumn = StartColumn;
-  }
-  else
-  {
-    /* Compute total pixel length of the string to be displayed in order to center the text on matrix display. */
-    TotalColumns = RGB_matrix_pixel_length(FontType, String);
 
-    /* Find start column depending on string length. */
-    if (TotalColumns > MAX_COLUMNS)
+    if (DebugBitMask & DEBUG_SCROLL)
     {
-      /* The string exceeds the width of the display matrix. */
-      CurrentColumn = 0;  // the string is too long, display what we can...
-      TotalColumns  = 0;  // shorten the string so that it fits inside the RGB matrix.
-      for (Loop1UInt8 = 0; String[Loop1UInt8]; ++Loop1UInt8)
+      Dum1UInt8 = get_scroll_number();
+      // uart_send(__LINE__, __func__, "Received %u from get_scroll_number)\r", Dum1UInt8);
+      if (Dum1UInt8 != MAX_ACTIVE_SCROLL)
       {
-        /// TotalColumns +=
+        uart_send(__LINE__, __func__, "Total length of scrolling message: %4u characters (active scroll number: %u     window: %s)\r", (UINT16)(ActiveScroll[Dum1UInt8]->TextHead - ActiveScroll[Dum1UInt8]->TextStart), Dum1UInt8, Window[ActiveScroll[Dum1UInt8]->Owner].Name);
+        sleep_ms(20);  // prevent communication override.
+        uart_send(__LINE__, __func__, "Current tail in text ring:         %4u (remaining characters to be scrolled: %u)\r\r\r", ActiveScroll[Dum1UInt8]->TextTail, (UINT16)(ActiveScroll[Dum1UInt8]->TextHead - ActiveScroll[Dum1UInt8]->TextTail));
+        sleep_ms(20);  // prevent communication override.
       }
     }
-    else
-      CurrentColumn = (64 - TotalColumns) / 2;
-  }
 
 
-  /* Display string. */
-  for (Loop1UInt8 = 0; String[Loop1UInt8]; ++Loop1UInt8)
-  {
-    CurrentColumn = RGB_matrix_display(DisplayBuffer, StartRow, CurrentColumn, String[Loop1UInt8], FontType, String[Loop1UInt8 + 1]);
+
+    /***
+    if (DebugBitMask & DEBUG_NTP)
+    {
+      uart_send(__LINE__, __func__, "=========================================================\r");
+      uart_send(__LINE__, __func__, "               NTP info in the endless loop\r");
+      display_ntp_info();
+    }
+    ***/
   }
 
-  return CurrentColumn;
+  return;
 }
+#endif  // DEVELOPER_VERSION
 
 
 
 
 
-/* $TITLE=RGB_matrix_scroll() */
+/* $TITLE=task_debug_30sec() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                       Scroll the specified rows one pixel to the left and manage the scroll ASCII buffer.
+                                           Periodic task: 30-seconds alarms and calendar events debug information.
 \* ============================================================================================================================================================= */
-void RGB_matrix_scroll(UINT8 ScrollNumber)
+void task_debug_30sec(void)
 {
-  static UINT8 CharWidth;
-
-  UINT8 FlagLocalDebug = FLAG_OFF;
-  UINT8 Loop1UInt8;
-  UINT8 RowNumber;
-
+  UCHAR String[128];
 
-  /* Make sure ActiveScroll pointer is valid. */
-  if (ActiveScroll[ScrollNumber] == 0x00l)
-  {
-    printf("************************************************************* Invalid ActiveScroll pointer: 0x%p\r", ActiveScroll[Loop1UInt8]);
-    return;
-  }
+  UINT16 Loop1UInt16;
 
 
-  /* Scroll one pixel to the left on the LED matrix. */
-  for (RowNumber = ActiveScroll[ScrollNumber]->StartRow; RowNumber <= ActiveScroll[ScrollNumber]->EndRow; ++RowNumber)
+  if (DebugBitMask & DEBUG_ALARM)
   {
-    ///// if (FlagLocalDebug) printf("1) %u, %u to %u\r", ScrollNumber, ActiveScroll[ScrollNumber]->StartRow, ActiveScroll[ScrollNumber]->EndRow);
+    // Display alarms bitmask.
+    util_uint64_to_binary_string((UINT64)AlarmBitMask, MAX_ALARMS, String);
+    uart_send(__LINE__, __func__, "AlarmBitMask: [%s] (0x%4.4X)\r", String, AlarmBitMask);
 
-    FrameBuffer[RowNumber] >>= 1;
-
-    /* Handle box border if there is one persistent on this window (ACTION_DRAW). */
-    /*** to be completed ***/
-    /// if (Window[WindowNumber].LastBoxState == ACTION_DRAW)
-    /// {
-    ///   FrameBuffer[RowNumber] |=  (0x1ll);                       // redraw left box border.
-    ///   FrameBuffer[RowNumber] &= ~(0x1ll << (MAX_COLUMNS - 2));  // erase the right border that has just been scrolled.
-    /// }
-
-
-    /* We just scrolled one pixel left on LED matrix...
-       if there are more pixels to be scrolled in the intermediate bitmap scroll buffer, transfer next pixel column. */
-    if (ActiveScroll[ScrollNumber]->PixelCountBuffer)
+    /* Display alarm current count-down value for every alarm. */
+    for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ALARMS; ++Loop1UInt16)
     {
-      /* Display message below only once. */
-      /// if (RowNumber == ActiveScroll[ScrollNumber]->StartRow) printf("1) More to scroll: %u\r", ActiveScroll[ScrollNumber]->PixelCountBuffer);
+      uart_send(__LINE__, __func__, "ActiveAlarm[%u].CountDown: %4u\r", Loop1UInt16, ActiveAlarm[Loop1UInt16].CountDown);
+    }
+  }
 
-      /* No matter how many "current" pixels were remaining to be scrolled before in the FrameBuffer,
-         if we recharged the Bitmap Scroll Buffer, also recharge the count of current pixel scrolls. */
-      ActiveScroll[ScrollNumber]->PixelCountCurrent = MAX_COLUMNS;
 
-      ///// if (ActiveScroll[ScrollNumber]->BitmapBuffer[RowNumber] & (0x01ll << (CharWidth - ActiveScroll[ScrollNumber]->PixelCountBuffer)))
-      if (ActiveScroll[ScrollNumber]->BitmapBuffer[RowNumber] & (0x01ll << (CharWidth - ActiveScroll[ScrollNumber]->PixelCountBuffer)))
-      {
-        FrameBuffer[RowNumber] |= (0x01ll << (MAX_COLUMNS - 1));
-        /// printf("1a) %2u 0x%2.2llX %u %u Adding <1>\r", RowNumber, ActiveScroll[ScrollNumber]->BitmapBuffer[RowNumber], CharWidth, ActiveScroll[ScrollNumber]->PixelCountBuffer);
-      }
-      else
-      {
-        FrameBuffer[RowNumber] &= ~(0x01ll << (MAX_COLUMNS - 1));
-        /// printf("1b) %2u 0x%2.2llX %u %u Adding <0>\r", RowNumber, ActiveScroll[ScrollNumber]->BitmapBuffer[RowNumber], CharWidth, ActiveScroll[ScrollNumber]->PixelCountBuffer);
-      }
+  if (DebugBitMask & DEBUG_EVENT)
+  {
+    /* Display triggered events bitmask. */
+    util_uint64_to_binary_string((UINT64)EventBitMask, MAX_EVENTS, String);
+    uart_send(__LINE__, __func__, "EventBitMask: [%s] (0x%16.16X)\r", String, EventBitMask);
 
-      /* When reaching the last row, one whole column of the Bitmap scroll buffer has been transferred to the FrameBuffer. */
-      if (RowNumber == ActiveScroll[ScrollNumber]->EndRow)
-      {
-        --ActiveScroll[ScrollNumber]->PixelCountBuffer;
-        /// printf("3) PixelCount low to %u\r", ActiveScroll[ScrollNumber]->PixelCountBuffer);
-      }
-    }
-    else
+    /* Display Event data for triggered events. */
+    for (Loop1UInt16 = 0; Loop1UInt16 < MAX_EVENTS; ++Loop1UInt16)
     {
-      /* No more data in the Bitmap scroll buffer, remaining scrolls of the actual FrameBuffer is then decremented by one. */
-      if (RowNumber == ActiveScroll[ScrollNumber]->EndRow)
+      if (Loop1UInt16 & (1 << Loop1UInt16))
       {
-        --ActiveScroll[ScrollNumber]->PixelCountCurrent;
-        /// printf("2) NO more pixel %u\r", ActiveScroll[ScrollNumber]->PixelCountBuffer);
+        uart_send(__LINE__, __func__, "Triggered event Number %u\r", Loop1UInt16);
+        uart_send(__LINE__, __func__, "Event day:    %u\r",    FlashConfig1.Event[Loop1UInt16].Day);
+        uart_send(__LINE__, __func__, "Event month:  %u\r",    FlashConfig1.Event[Loop1UInt16].Month);
+        uart_send(__LINE__, __func__, "Event jingle: %u\r",    FlashConfig1.Event[Loop1UInt16].Jingle);
+        uart_send(__LINE__, __func__, "Event message: <%s>\r", FlashConfig1.Event[Loop1UInt16].Message);
       }
     }
   }
 
+  return;
+}
 
-  /// printf("10) Count current %u\r", ActiveScroll[ScrollNumber]->PixelCountCurrent);
-
-
-
-  if (ActiveScroll[ScrollNumber]->PixelCountBuffer == 0)
-  {
-    /* If there are no more pixel to scroll in the bitmask scroll buffer, check if there are more characters in the ASCII scroll buffer. */
-    /// printf("4) Buffer count zero: %u\r", ActiveScroll[ScrollNumber]->PixelCountBuffer);
-    if (strlen(&ActiveScroll[ScrollNumber]->Message[ActiveScroll[ScrollNumber]->AsciiBufferPointer]) != 0)
-    {
-      /* There are more ASCII characters to scroll in the ASCII scroll buffer, convert the next one from ASCII to bitmask in the bitmask scroll buffer. */
-      /// printf("5) More ASCII %u\r", strlen(&ActiveScroll[ScrollNumber]->Message[ActiveScroll[ScrollNumber]->AsciiBufferPointer]));
-
-      /* Fill-up the Bitmask Scroll Buffer with next ASCII characters to scroll. */
-      if (FlagLocalDebug) printf("6) Txfr %c\r", ActiveScroll[ScrollNumber]->Message[ActiveScroll[ScrollNumber]->AsciiBufferPointer]);
 
-      if (ActiveScroll[ScrollNumber]->FontType == FONT_8x10)
-        CharWidth = RGB_matrix_display(ActiveScroll[ScrollNumber]->BitmapBuffer, ActiveScroll[ScrollNumber]->StartRow, 0, ActiveScroll[ScrollNumber]->Message[ActiveScroll[ScrollNumber]->AsciiBufferPointer], FONT_8x10, ActiveScroll[ScrollNumber]->Message[ActiveScroll[ScrollNumber]->AsciiBufferPointer + 1]);
-      else
-        CharWidth = RGB_matrix_display(ActiveScroll[ScrollNumber]->BitmapBuffer, ActiveScroll[ScrollNumber]->StartRow, 0, ActiveScroll[ScrollNumber]->Message[ActiveScroll[ScrollNumber]->AsciiBufferPointer], FONT_5x7, ActiveScroll[ScrollNumber]->Message[ActiveScroll[ScrollNumber]->AsciiBufferPointer + 1]);
 
-      ActiveScroll[ScrollNumber]->PixelCountBuffer = CharWidth;  // more pixels to be scrolled in bitmap scroll buffer.
-      ++ActiveScroll[ScrollNumber]->AsciiBufferPointer;          // point to next character in ASCII scroll buffer.
 
-      /// printf("7) Ascii ptr %u PixelCount %u after txfr\r", ActiveScroll[ScrollNumber]->AsciiBufferPointer, ActiveScroll[ScrollNumber]->PixelCountBuffer);
 
-      /***
-      for (RowNumber = ActiveScroll[ScrollNumber]->StartRow; RowNumber <= ActiveScroll[ScrollNumber]->EndRow; ++RowNumber)
-        printf("8) [%u]: 0x%2.2X\r", RowNumber, ActiveScroll[ScrollNumber]->BitmapBuffer[RowNumber]);
-      ***/
-    }
-    else
-    {
-      /// printf("9) No more ASCII %u\r", strlen(&ActiveScroll[ScrollNumber]->Message[ActiveScroll[ScrollNumber]->AsciiBufferPointer]));
-      /* No more character in the ASCII scroll buffer... Check if more than one cycle have been requested. */
-      if (ActiveScroll[ScrollNumber]->ScrollTimes > 0)
-      {
-        /// printf("9) Remain scrolls %u\r", ActiveScroll[ScrollNumber]->ScrollTimes);
-        /* More than one cycle have been requested and count is not down to zero. Trigger another cycle. */
-        --ActiveScroll[ScrollNumber]->ScrollTimes;
-        ActiveScroll[ScrollNumber]->AsciiBufferPointer = 0;  // reset ASCII buffer pointer to zero to trigger a new cycle.
-      }
-      else
-      {
-        /// printf("9)No more scrolls %u\r", ActiveScroll[ScrollNumber]->ScrollTimes);
-        /* Turning Off current scroll when done. */
-        if (ActiveScroll[ScrollNumber]->PixelCountCurrent == 0)
-        {
-          /// if (DebugBitMask & DEBUG_SCROLL) printf("Free up scroll memory.\r");
-          win_scroll_off(ScrollNumber);
-        }
-      }
-    }
+/* $TITLE=task_flash_check() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                               Periodic task: save flash configuration if it has been changed.
+\* ============================================================================================================================================================= */
+void task_flash_check(void)
+{
+  /* Check if RGB Matrix flash configuration has been changed, more or less 30 seconds after exiting from terminal menu. */
+  if ((TermModeTimer != 0ll) && ((time_us_64() - TermModeTimer) > 30000000ll))
+  {
+    flash_check_config(1);  // configuration 1 (main configuration data).
+    flash_check_config(2);  // configuration 2 (calendar events and reminders).
+    TermModeTimer = 0ll;
   }
 
   return;
@@ -11916,31 +14652,44 @@ void RGB_matrix_scroll(UINT8 ScrollNumber)
 
 
 
-/* $TITLE=RGB_matrix_set_color() */
+/* $TITLE=task_heartbeat() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                          Set matrix display color for the specified area.
+                                                    Periodic task: one-minute housekeeping and heartbeat.
 \* ============================================================================================================================================================= */
-void RGB_matrix_set_color(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn, UINT8 Color)
+void task_heartbeat(void)
 {
-  UINT8 ColumnNumber;
-  UINT8 RowNumber;
+  UCHAR String[128];
 
 
-  /* Validate provided coordinates. */
-  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
+  /* Reset Row 31 original border color in case we used DEBUG_STARTUP which uses the last row as a startup sequence progress indicator. */
+  RGB_matrix_set_color(31, 0, 31, 63, Window[WIN_TIME].BorderColor);  /////
 
-  for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
+#ifdef DEVELOPER_VERSION
+  if (stdio_usb_connected())
   {
-    for (ColumnNumber = StartColumn; ColumnNumber <= EndColumn; ++ColumnNumber)
+    uart_send(__LINE__, __func__, "1-minute heartbeat... Absolute time reference: %6llu\r", time_us_64() / 1000000ll);
+
+
+    if (DebugBitMask & DEBUG_REMINDER)
     {
-      /// uart_send(__LINE__, __func__, "RowNumber: %2u   ColumnNumber: %2u\r", RowNumber, ColumnNumber);
-      if (RowNumber < 16)
-        DisplayRGB[RowNumber][ColumnNumber] = ((DisplayRGB[RowNumber][ColumnNumber] & 0xF0) | Color);
-      else
-        DisplayRGB[RowNumber - 16][ColumnNumber] = ((DisplayRGB[RowNumber - 16][ColumnNumber] & 0x0F) | (Color << 4));
+      util_uint64_to_binary_string(Reminder1BitMask, MAX_REMINDERS1, String);
+      uart_send(__LINE__, __func__, "Reminder1BitMask:                    0x%10.10llX   [%s]\r", Reminder1BitMask, String);
+    }
+
+
+#ifdef NTP_SUPPORT
+    /***
+    if (DebugBitMask & DEBUG_NTP)
+    {
+      uart_send(__LINE__, __func__, "=========================================================\r");
+      uart_send(__LINE__, __func__, "               NTP info in the endless loop\r");
+      display_ntp_info();
     }
+    ***/
+#endif  // NTP_SUPPORT
   }
+#endif  // DEVELOPER_VERSION
 
   return;
 }
@@ -11949,28 +14698,35 @@ void RGB_matrix_set_color(UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8
 
 
 
-/* $TITLE=RGB_matrix_set_pixel() */
+/* $TITLE=task_init() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                Turn On the pixels in the specified matrix area of the specified buffer.
+                                                   Register the periodic tasks run by the main endless loop scheduler.
+                         NOTES:
+                         1) Period and budget are given in microseconds. Budget is the execution time expected for the task. Tasks running
+                            longer than their budget are counted (and reported when DEBUG_TASK is On), but never interrupted.
+                         2) Put here functions that must be executed periodically from the main endless loop.
 \* ============================================================================================================================================================= */
-void RGB_matrix_set_pixel(UINT64 *BufferPointer, UINT8 StartRow, UINT8 StartColumn, UINT8 EndRow, UINT8 EndColumn)
+void task_init(void)
 {
-  UINT8  ColumnNumber;
-  UINT8  RowNumber;
-
+  TaskCount = 0;
 
-  /* Validate provided coordinates. */
-  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
-
-  /* Turn On pixels in the specified matrix buffer area. */
-  for (RowNumber = StartRow; RowNumber <= EndRow; ++RowNumber)
-	{
-    for (ColumnNumber = StartColumn; ColumnNumber <= EndColumn; ++ColumnNumber)
-    {
-      BufferPointer[RowNumber] |= (0x01ll << ColumnNumber);
-    }
-  }
+#ifdef WATCHDOG_SUPPORT
+  /* NOTE: Watchdog task has been set slightly faster than one second. This is to make sure that the WatchdogCheck variable
+           will have been incremented when the callback tests its value and prevent a miss. */
+  task_register("Watchdog", task_watchdog,         999900l, TASK_PRIORITY_HIGH,       100l);
+#endif  // WATCHDOG_SUPPORT
+  task_register("Pilot",    task_pilot,           1000000l, TASK_PRIORITY_HIGH,      2000l);
+  task_register("AutoScrl", task_auto_scroll,     1000000l, TASK_PRIORITY_NORMAL,  100000l);
+#ifdef NTP_SUPPORT
+  task_register("NTP",      task_ntp,             1000000l, TASK_PRIORITY_NORMAL, 2000000l);
+#endif  // NTP_SUPPORT
+  task_register("Flash",    task_flash_check,     5000000l, TASK_PRIORITY_LOW,     200000l);
+#ifdef DEVELOPER_VERSION
+  task_register("Debug10",  task_debug_10sec,    10000000l, TASK_PRIORITY_LOW,     200000l);
+#endif  // DEVELOPER_VERSION
+  task_register("Debug30",  task_debug_30sec,    30000000l, TASK_PRIORITY_LOW,     200000l);
+  task_register("Heartbt",  task_heartbeat,      60000000l, TASK_PRIORITY_LOW,      50000l);
 
   return;
 }
@@ -11979,340 +14735,369 @@ void RGB_matrix_set_pixel(UINT64 *BufferPointer, UINT8 StartRow, UINT8 StartColu
 
 
 
-/* $TITLE=RGB_matrix_update() */
+/* $TITLE=task_next_deadline() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-
+                                                     Return the earliest deadline among the registered periodic tasks.
 \* ============================================================================================================================================================= */
-void RGB_matrix_update(UINT64 *FrameBuffer)
+UINT64 task_next_deadline(void)
 {
-  /// UINT8  ColumnNumber;
-  uint_fast32_t ColumnNumber;
-  UINT8 *Framebuffer;  ///
+  UINT8 Loop1UInt8;
 
-  UINT16 PwmLevel;
+  UINT64 Deadline;
 
 
-  Framebuffer = (UINT8 *)FrameBuffer;  ///
+  /* Wake up at least once per second, even if no task has been registered. */
+  Deadline = time_us_64() + 1000000ll;
 
-  /* Simultaneously scan first 16 rows (top half) and next 16 rows (bottom half) and then, start again (RowScan goes from 0 to 15 and then, start over again). */
-  ++RowScan;
-  if (RowScan >= HALF_ROWS) RowScan = 0;
+  for (Loop1UInt8 = 0; Loop1UInt8 < TaskCount; ++Loop1UInt8)
+    if (Task[Loop1UInt8].Deadline < Deadline) Deadline = Task[Loop1UInt8].Deadline;
 
-	FlagFrameBufferBusy = FLAG_ON;  // flag indicating that the FrameBuffer is currently being updated.
+  return Deadline;
+}
 
-  /* Blank LED matrix before updating. */
-  PwmLevel = Pwm[PWM_ID_BRIGHTNESS].Level;  // keep track of original PWM level on entry.
-  pwm_set_level(PWM_ID_BRIGHTNESS, 2000);
 
 
 
-  /// critical_section_enter_blocking(&ThreadLock);
 
+#ifdef NTP_SUPPORT
+/* $TITLE=task_ntp() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                      Periodic task: handle network time protocol (NTP) synchronization when it is due.
+\* ============================================================================================================================================================= */
+void task_ntp(void)
+{
+  INT64 DeltaTime;
 
+  UINT8 Loop1UInt8;
 
-  /* Scan all columns of the LED matrix. */
-  for (ColumnNumber = 0; ColumnNumber < Matrix_COLS_BYTE; ++ColumnNumber)
-  {
-    /// printf("%3u   %3u   %2u\r", RowScan, (RowScan + HALF_ROWS), ColumnNumber % 8);  /// should go with the for loop in next paragraph.
-    /// printf("%3u   %3u   %2u\r", RowScan * Matrix_COLS_BYTE + ColumnNumber, (RowScan + HALF_ROWS) * Matrix_COLS_BYTE + ColumnNumber, ColumnNumber);
-    RGB_matrix_write_data(Framebuffer[RowScan * Matrix_COLS_BYTE + ColumnNumber], Framebuffer[(RowScan + HALF_ROWS) * Matrix_COLS_BYTE + ColumnNumber], ColumnNumber);
-  }
+  time_t UnixTime;
 
+  struct human_time HumanTime;
+  struct tm TempTime;
 
-  /* Scan all columns of the LED matrix. */
-  /// for (ColumnNumber = 0; ColumnNumber < MAX_COLUMNS; ++ColumnNumber)
-  //// {
-  ////   printf("%3u   %3u   %2u\r", RowScan, (RowScan + HALF_ROWS), ColumnNumber % 8);
-  ////   RGB_matrix_write_data(FrameBuffer[RowScan], Framebuffer[RowScan + HALF_ROWS], ColumnNumber % 8);
-  //// }
 
+  /* Handle network time protocol (NTP) synchronization. */
+  DeltaTime = (absolute_time_diff_us(get_absolute_time(), NTPData.NTPUpdateTime) / 1000000ll);
+  if ((DeltaTime <= 0) || (is_nil_time(NTPData.NTPUpdateTime)))
+  {
+    if (DebugBitMask & DEBUG_NTP)
+    {
+      uart_send(__LINE__, __func__, "=========================================================\r");
+      uart_send(__LINE__, __func__, "            Network Time Protocol cycle start\r");
+      display_ntp_info();
+    }
 
-  /* Successively scan all rows of the LED matrix. */
-  if (RowScan & 0x01) A_HIGH; else A_LOW;
-  if (RowScan & 0x02) B_HIGH; else B_LOW;
-  if (RowScan & 0x04) C_HIGH; else C_LOW;
-  if (RowScan & 0x08) D_HIGH; else D_LOW;
-  if (RowScan & 0x10) E_HIGH; else E_LOW;
 
+    if (NTPData.FlagNTPInit == FLAG_OFF)
+    {
+      if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, __func__, "Trying to initialize Wi-Fi connection...\r");
+      if (ntp_init(FlashConfig1.SSID, FlashConfig1.Password) == false)
+      {
+        uart_send(__LINE__, __func__, "=========================================================\r");
+        uart_send(__LINE__, __func__, "    ntp_init(): Failed to establish a Wi-Fi connection\r");
+        NTPData.FlagNTPInit = FLAG_OFF;  // request a new ntp_init();
+        display_ntp_info();
+      }
+    }
+    else
+    {
+      if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, __func__, "Requesting RGB Matrix synchronization through NTP.\r\r");
+
+      /* Initialize with invalid value on entry. */
+      NTPData.FlagNTPSuccess = 0xFF;
+      
+      /* Retrieve UTC time from Network Time Protocol server. */
+      ntp_get_time();
 
-  /* Latch this value. */
-  STB_HIGH;
-  NOP;
-  STB_LOW;
+      /* Wait for NTP to return result. */
+      for (Loop1UInt8 = 0; Loop1UInt8 < MAX_NTP_CHECKS; ++Loop1UInt8)
+      {
+        if (NTPData.FlagNTPSuccess == FLAG_POLL)
+        {
+          if (DebugBitMask & DEBUG_NTP)
+          {
+            uart_send(__LINE__, __func__, "\r\r\r\r");
+            uart_send(__LINE__, __func__, "=========================================================\r");
+            uart_send(__LINE__, __func__, "           Variables after successful NTP poll\r");
+            display_ntp_info();
+          }
+          break;  // get out of "for" loop.
+        }
 
 
-  /// critical_section_exit(&ThreadLock);
+        if (NTPData.FlagNTPSuccess == FLAG_ON)
+        {
+          NTPData.FlagNTPHistory = NTPData.FlagNTPSuccess;
+
+          /* Convert UnixTime received from NTP server. */
+          convert_unix_time(NTPData.UnixTime, &TempTime, &HumanTime, FLAG_ON);
 
+          if (DebugBitMask & DEBUG_NTP)
+          {
+            uart_send(__LINE__, __func__, "\r\r\r\r");
+            uart_send(__LINE__, __func__, "=========================================================\r");
+            uart_send(__LINE__, __func__, "           Variables after successful NTP read\r");
+            display_ntp_info();
+            uart_send(__LINE__, __func__, "NTP synchronization succeeded (after %u retries)\r", Loop1UInt8);
 
+            UnixTime = convert_human_to_unix(&CurrentTime, FLAG_ON);
 
-  FlagFrameBufferBusy = FLAG_OFF;  // we're done with FrameBuffer update.
+            uart_send(__LINE__, __func__, "Current RGB-Matrix UnixTime:       %12llu\r", UnixTime);
+            uart_send(__LINE__, __func__, "UnixTime returned from NTP:        %12llu\r", NTPData.UnixTime);
+            uart_send(__LINE__, __func__, "Delta seconds between DS3231 and NTP server: %lld\r", NTPData.UnixTime - UnixTime);
 
+            display_human_time("RGB Matrix time before resync:        ", &CurrentTime);
+            display_human_time("HumanTime as decoded from NTP server: ", &HumanTime);
+          }
 
-  /* Restore original PWM level when done. */
-  pwm_set_level(PWM_ID_BRIGHTNESS, PwmLevel);
 
-  return;
+          if (HumanTime.Second < 59)
+          {
+            /* Set time in the real-time clock IC while accounting for Internet latency. */
+            sleep_ms(1000 - (NTPData.NTPLatency / 1000));
+            ++HumanTime.Second;
+          }
+          ds3231_set_time(&HumanTime);
 
+          NTPData.FlagNTPResync = FLAG_OFF;
+          break;  // get out of "for" loop.
+        }
 
+        sleep_ms(500);
+      }
 
 
-#if 0
-void RGBMatrixDeviceFlush(uint8_t *buf)
-{
-  uint8_t i;
+      /* If current NTP update request failed. */
+      if (Loop1UInt8 >= MAX_NTP_CHECKS)
+      {
+        NTPData.FlagNTPResync  = FLAG_OFF;  // NTP resync error... postpone re-sync.
+        NTPData.FlagNTPHistory = NTPData.FlagNTPSuccess;
+        ++NTPData.NTPErrors;
+        if (DebugBitMask & DEBUG_NTP)
+        {
+          uart_send(__LINE__, __func__, "\r\r\r\r");
+          uart_send(__LINE__, __func__, "=========================================================\r");
+          uart_send(__LINE__, __func__, "           After failed NTP sync (%u retries)\r", Loop1UInt8);
+          display_ntp_info();
+        }
 
-  CS_cnt ++;
-  if (CS_cnt > (Matrix_ROWS_SHOW - 1))
-  {
-    CS_cnt = 0;
+        /* If ntp_get_time() didn't work, try to re-initialize ntp in case the SSID and / or password has been updated lately,
+           or in case network was down and is is back Up later. */
+        NTPData.FlagNTPInit   = FLAG_OFF;  // request a new ntp_init();
+        NTPData.NTPUpdateTime = delayed_by_ms(NTPData.NTPUpdateTime, ((UINT32)(NTP_REFRESH * 1000)));
+      }
+    }
   }
 
-  UpdateVideoMemory = 1;
-
-  OE_HIGH;
+  return;
+}
+#endif  // NTP_SUPPORT
 
-  for (i = 0; i < (Matrix_COLS_BYTE); ++i)
-  {
-    RGBMatrixWriteData(buf[CS_cnt * Matrix_COLS_BYTE + i], buf[(CS_cnt + Matrix_ROWS_SHOW) * Matrix_COLS_BYTE + i], i);
-  }
 
 
-  if (CS_cnt & 0x01) A_HIGH; else A_LOW;
-  if (CS_cnt & 0x02) B_HIGH; else B_LOW;
-  if (CS_cnt & 0x04) C_HIGH; else C_LOW;
-  if (CS_cnt & 0x08) D_HIGH; else D_LOW;
-  if (CS_cnt & 0x10) E_HIGH; else E_LOW;
 
 
-  STB_HIGH;
-  // sleep_us(1);
+/* $TITLE=task_pilot() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                               Periodic task: blink endless loop pilot and keep track of time spent in the one-second callback.
+\* ============================================================================================================================================================= */
+void task_pilot(void)
+{
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                              Manage endless loop pixel indicators pilot.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  /* Blinking pixels to indicate that endless loop is still running. */
+  pilot_set_color(CYAN);
+  pilot_toggle();
 
-  STB_LOW;
 
-  UpdateVideoMemory = 0;
+#ifdef NTP_SUPPORT
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                          Manage color of the two "double-dots time separator" to indicate network health.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  /* Indicate Wi-Fi network health with double dots time separator color. */
+  if (NTPData.FlagNTPHistory == FLAG_ON)  double_dots_set_color(GREEN);
+  if (NTPData.FlagNTPHistory == FLAG_OFF) double_dots_set_color(RED);
+#endif  // NTP_SUPPORT
 
-  OE_LOW;
 
-#ifndef TRUE
-  if (FlagAutoBrightness != FLAG_OFF)
-  {
-    FlagAutoBrightness = FLAG_ON;
-  }
-  else
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                    Keep track of time spent in the one-second callback routine.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  if (is_nil_time(AbsoluteExitTime) == false)
   {
-    OE_LOW;
+    Dum1Int64 = absolute_time_diff_us(AbsoluteEntryTime, AbsoluteExitTime);
+    OneSecondInterval[OneSecondPointer] = Dum1Int64;
+    ++OneSecondPointer;
+    if (OneSecondPointer >= MAX_ONE_SECOND_INTERVALS) OneSecondPointer = 0;
+    AbsoluteEntryTime = nil_time;
+    AbsoluteExitTime  = nil_time;
   }
-#endif
-}
-#endif  // 0
+
+  return;
 }
 
 
 
 
 
-//* $TITLE=RGB_matrix_write_data() */
+/* $TITLE=task_register() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-
+                                  Register a periodic task. Return the task number, or MAX_TASKS if the task table is full.
 \* ============================================================================================================================================================= */
-void RGB_matrix_write_data(UINT8 MatrixTop, UINT8 MatrixBottom, UCHAR DisplayRGBCount)
+UINT8 task_register(UCHAR *Name, void (*Pointer)(void), UINT32 PeriodUSec, UINT8 Priority, UINT32 BudgetUSec)
 {
-  UINT8  j;
-	UINT8 rgb;
+  UINT8 TaskNumber;
 
 
-  for (j = 0; j < 8; ++j)
+  if (TaskCount >= MAX_TASKS)
   {
-		rgb = DisplayRGB[RowScan][(8 * DisplayRGBCount) + j];
-    /// printf("%u - %u\r", RowScan, (8 * DisplayRGBCount) + j);
-    CLK_LOW;
-
-    R1_LOW;
-    G1_LOW;
-    B1_LOW;
-
-    R2_LOW;
-    G2_LOW;
-    B2_LOW;
-
-    if (MatrixTop & 0x01)
-    {
-			if (rgb & 0x04) R1_HIGH;
-      if (rgb & 0x02) G1_HIGH;
-      if (rgb & 0x01) B1_HIGH;
-    }
-
-    if (MatrixBottom & 0x01)
-    {
-      if (rgb & 0x40) R2_HIGH;
-      if (rgb & 0x20) G2_HIGH;
-      if (rgb & 0x10) B2_HIGH;
-    }
+    uart_send(__LINE__, __func__, "Task table is full, task <%s> has not been registered.\r", Name);
+    return MAX_TASKS;
+  }
 
-    MatrixTop    >>= 1;
-    MatrixBottom >>= 1;
+  TaskNumber = TaskCount;
+  ++TaskCount;
 
-    CLK_HIGH;
-  }
+  memset(&Task[TaskNumber], 0x00, sizeof(Task[TaskNumber]));
+  strncpy(Task[TaskNumber].Name, Name, sizeof(Task[TaskNumber].Name) - 1);
+  Task[TaskNumber].Pointer    = Pointer;
+  Task[TaskNumber].PeriodUSec = PeriodUSec;
+  Task[TaskNumber].Priority   = Priority;
+  Task[TaskNumber].BudgetUSec = BudgetUSec;
+  Task[TaskNumber].Deadline   = time_us_64() + PeriodUSec;
 
-  return;
+  return TaskNumber;
 }
 
 
 
 
 
-/* $TITLE=set_auto_brightness() */
+/* $TITLE=task_run_next() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                         Manage ambient light history for automatic brightness.
+                                Run the most urgent periodic task whose deadline has been reached. Return FLAG_OFF if no task was due.
+                         NOTES:
+                         1) The most urgent task is the one with the highest priority (lowest value) and, for equal priorities, the earliest deadline.
+                         2) Only one task is run per call, so that the main endless loop may handle events between two tasks.
+                         3) Next deadline is one period after the previous one, to keep the task cadence. If the task is late by more than one
+                            period, the missed executions are skipped.
 \* ============================================================================================================================================================= */
-void set_auto_brightness(void)
+UINT8 task_run_next(void)
 {
-  static UINT16 Counter;
-  UINT16 CurrentLightValue;
-  UINT16 LightRange;
-  UINT16 Loop1UInt16;
-  UINT16 PwmHiLimit;
-  UINT16 PwmLoLimit;
-  UINT16 PwmLevel;
+  UINT8 Loop1UInt8;
+  UINT8 TaskNumber;
 
-  UINT64 TotalValues;
+  UINT32 Duration;
+  UINT32 Lateness;
 
-  float  PwmRange;
+  UINT64 CurrentTimer;
+  UINT64 TaskStart;
 
 
-  CurrentLightValue     = get_light_value();
-  AmbientLight[Counter] = CurrentLightValue;  // keep history of ambient light for hysteresis.
+  CurrentTimer = time_us_64();
 
-  if ((Counter % 5) == 0)
+  /* Find the most urgent task that is due. */
+  TaskNumber = MAX_TASKS;
+  for (Loop1UInt8 = 0; Loop1UInt8 < TaskCount; ++Loop1UInt8)
   {
-    /* Every 'BRIGHTNESS_HYSTERESIS_SECONDS', compute average ambient light value for the last hysteresis period. */
-    TotalValues = 0ll;
-    for (Loop1UInt16 = 0; Loop1UInt16 < BRIGHTNESS_HYSTERESIS_SECONDS; ++Loop1UInt16)
-      TotalValues += AmbientLight[Loop1UInt16];
+    if (Task[Loop1UInt8].Deadline > CurrentTimer) continue;
 
-    AverageAmbientLight = (TotalValues / BRIGHTNESS_HYSTERESIS_SECONDS);
+    if ((TaskNumber == MAX_TASKS) || (Task[Loop1UInt8].Priority < Task[TaskNumber].Priority) ||
+        ((Task[Loop1UInt8].Priority == Task[TaskNumber].Priority) && (Task[Loop1UInt8].Deadline < Task[TaskNumber].Deadline)))
+      TaskNumber = Loop1UInt8;
   }
+  if (TaskNumber == MAX_TASKS) return FLAG_OFF;
 
-  ++Counter;
-  if (Counter >= BRIGHTNESS_HYSTERESIS_SECONDS) Counter = 0;
-
-
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                           Manage LED matrix auto brightness when PWM brightness control option is turned On.
 
-                    NOTES: Ambient light will usually go from 300 (almost no light) to 3500 (very bright light).
-                           This gives a range of about 3200 levels (3500 - 300) to cover the whole range of
-                           light intensities ("PWM_LOWEST_LEVEL" to "PWM_HIGHEST_LEVEL").
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-  while ((CurrentTime.Second % 5) == 0)
+  /* Keep track of tasks starting late. */
+  Lateness = (UINT32)(CurrentTimer - Task[TaskNumber].Deadline);
+  if (Lateness > Task[TaskNumber].MaxLateUSec) Task[TaskNumber].MaxLateUSec = Lateness;
+  if (Lateness > TASK_LATE_USEC)
   {
-    /* Compute PWM lo and hi limits based on user preference for lowest and highest brightness limits set in device configuration. */
-    /* Default brightness limits are from 1 to 1000 (range of 999) in device configuration and default PWM levels are from 1999 to 1300 (range of 699). */
-    /* So, for each brightness degree that we change, PWM level will be changed by 0.7 (699 / 999). */
-    PwmHiLimit = (PWM_HI_LIMIT - ((UINT16)(FlashConfig1.BrightnessLoLimit * 0.7)));  // removed <+0.5> at the end
-    PwmLoLimit = (PWM_LO_LIMIT + ((UINT16)((1000 - FlashConfig1.BrightnessHiLimit) * 0.7)));
+    ++Task[TaskNumber].LateCount;
+    if (DebugBitMask & DEBUG_TASK) uart_send(__LINE__, __func__, "Task <%s> started %lu usec late.\r", Task[TaskNumber].Name, Lateness);
+  }
 
-    LightRange = LIGHT_HI_LIMIT - LIGHT_LO_LIMIT;
 
-    if (AverageAmbientLight <= LIGHT_LO_LIMIT)
-    {
-      /* If average ambient light is lower than the lowest limit, brightness is automatically set to its lowest limit (= highest PWM level). */
-      pwm_set_level(PWM_ID_BRIGHTNESS, PwmHiLimit);
-      if (DebugBitMask & DEBUG_BRIGHTNESS)
-      {
-        uart_send(__LINE__, __func__, "\r");
-        /// uart_send(__LINE__, __func__, "Ambient light is lower that low limit - Instantaneous ambient light value: %4u   AverageAmbientLight: %4u   Level: %3u\r", CurrentLightValue, AverageAmbientLight, PwmHiLimit);
-        uart_send(__LINE__, __func__, "PWM Level: %4u\r", PwmHiLimit);
-      }
-      break;
-    }
+  /* Run the task. */
+  TaskStart = time_us_64();
+  Task[TaskNumber].Pointer();
+  Duration = (UINT32)(time_us_64() - TaskStart);
 
-    if (AverageAmbientLight >= LIGHT_HI_LIMIT)
-    {
-      /* If average ambient light is higher than the highest limit, brightness is automatically set to its highest limit (= lowest PWM level). */
-      pwm_set_level(PWM_ID_BRIGHTNESS, PwmLoLimit);
-      if (DebugBitMask & DEBUG_BRIGHTNESS)
-      {
-        uart_send(__LINE__, __func__, "\r");
-        /// uart_send(__LINE__, __func__, "Ambient light is higher than high limit - Instantaneous ambient light value: %4u   AverageAmbientLight: %4u   Level: %3u\r", CurrentLightValue, AverageAmbientLight, PwmLoLimit);
-        uart_send(__LINE__, __func__, "PWM Level: %4u\r", PwmLoLimit);
-      }
-      break;
-    }
 
-    if ((AverageAmbientLight > LIGHT_LO_LIMIT) && (AverageAmbientLight < LIGHT_HI_LIMIT))
-    {
-      /* If average ambient light is between the lowest and highest limits set by developer, brightness is automatically adjusted proportionally. */
-      PwmRange = PwmHiLimit - PwmLoLimit;
-      PwmLevel = PwmHiLimit - (UINT16)((AverageAmbientLight - LIGHT_LO_LIMIT) * (PwmRange / LIGHT_RANGE));
-      pwm_set_level(PWM_ID_BRIGHTNESS, PwmLevel);
-      break;
-    }
+  /* Update runtime statistics. */
+  Task[TaskNumber].LastUSec = Duration;
+  if (Duration > Task[TaskNumber].MaxUSec) Task[TaskNumber].MaxUSec = Duration;
+  Task[TaskNumber].TotalUSec += Duration;
+  ++Task[TaskNumber].Count;
+  if (Duration > Task[TaskNumber].BudgetUSec)
+  {
+    ++Task[TaskNumber].OverBudgetCount;
+    if (DebugBitMask & DEBUG_TASK) uart_send(__LINE__, __func__, "Task <%s> ran for %lu usec (budget: %lu usec).\r", Task[TaskNumber].Name, Duration, Task[TaskNumber].BudgetUSec);
   }
 
-  return;
+
+  /* Schedule next execution. */
+  Task[TaskNumber].Deadline += Task[TaskNumber].PeriodUSec;
+  if (Task[TaskNumber].Deadline <= time_us_64()) Task[TaskNumber].Deadline = time_us_64() + Task[TaskNumber].PeriodUSec;
+
+  return FLAG_ON;
 }
 
 
 
 
 
-/* $TITLE=software_reset() */
+/* $TITLE=task_stats_reset() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
-                                                        Restart the RGB Matrix Firmware by software reset.
+                                                        Reset runtime statistics of all registered periodic tasks.
 \* ============================================================================================================================================================= */
-void software_reset(void)
+void task_stats_reset(void)
 {
-  UINT32 Loop1UInt32;
-
-
-  /* Log the restart. */
-  printf("\r\r\r\r\r");
-  printf("%2.2u-%s-%4.4u - %2.2u:%2.2u:%2.2u - RGB Matrix restarted by watchdog...\r\r\r\r\r", CurrentTime.DayOfMonth, ShortMonth[CurrentTime.Month], CurrentTime.Year, CurrentTime.Hour, CurrentTime.Minute, CurrentTime.Second);
-
-  /* Cancel 1-second callback that is calling the watchdog. */
-  /* (cancelling the 1-second timer while we are executing from this thread would crash the Firmware). */
-  cancel_repeating_timer(&Handle1000MSecTimer);
-
-  /* Open a test window to prevent clock refresh on LED matrix
-  /// win_open(WIN_TEST, FLAG_OFF);
-
-  /* Clear LED display since matrix scan will stop during reboot. */
-  RGB_matrix_cls(FrameBuffer);
-  pwm_set_level(PWM_ID_BRIGHTNESS, 2000);
+  UINT8 Loop1UInt8;
 
-  /* Keep track of interrupt mask and disable interrupts during flash writing. */
-  /// InterruptMask = save_and_disable_interrupts();
 
-  /* Indicate that restart has been triggered by watchdog. */
-  /// FlashConfig1.WatchdogFlag = FLAG_ON;
-  /// ++FlashConfig1.WatchdogCounter;
+  for (Loop1UInt8 = 0; Loop1UInt8 < TaskCount; ++Loop1UInt8)
+  {
+    Task[Loop1UInt8].Count           = 0l;
+    Task[Loop1UInt8].LateCount       = 0l;
+    Task[Loop1UInt8].MaxLateUSec     = 0l;
+    Task[Loop1UInt8].OverBudgetCount = 0l;
+    Task[Loop1UInt8].LastUSec        = 0l;
+    Task[Loop1UInt8].MaxUSec         = 0l;
+    Task[Loop1UInt8].TotalUSec       = 0ll;
+  }
 
-  /* Make sure these values are saved to flash. */
-  /// flash_write(FLASH_CONFIG1_OFFSET, (UINT8 *)FlashConfig1.Version, sizeof(FlashConfig1));
-  /// flash_check_config(1);
+  return;
+}
 
-  /* Restore original interrupt mask when done. */
-  /// restore_interrupts(InterruptMask);
 
-  /* Add a small delay - without using sleep_ms() - to make sure PWM has enough time to adjust the proper level. */
-  for (Loop1UInt32 = 0; Loop1UInt32 < 100000; ++Loop1UInt32);
 
-  /// watchdog_reboot(0, SRAM_END, 0);
-  /// watchdog_reboot(0, 0x20042000, 0);
-  /// while (1);
 
-  /// AIRCR_Register = 0x5FA0004;  // this one can't be used for the Pico-RGB-Matrix since it doesn't reset core 1.
 
-  watchdog_enable(1, 1);
+#ifdef WATCHDOG_SUPPORT
+/* $TITLE=task_watchdog() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                            Periodic task: tell the 1000 msec callback that the main endless loop is still alive.
+                         NOTE: One miss is not really important and everything would return to normal within the next few cycles. The idea of
+                               making the task period a little faster than one second is to prevent a yellow LED that would turn On for a few
+                               seconds on the display if there is a miss.
+\* ============================================================================================================================================================= */
+void task_watchdog(void)
+{
+  ++WatchdogCheck;
 
   return;
 }
+#endif  // WATCHDOG_SUPPORT
 
 
 
@@ -13359,6 +16144,13 @@ void term_debug(void)
             uart_send(__LINE__, __func__, "%2u - DEBUG_SUMMER_TIME is Off.\r", Loop1UInt16);
         break;
 
+        case DEBUG_TASK:
+          if (DebugBitMask & (0x01 << Loop1UInt16))
+            uart_send(__LINE__, __func__, "%2u - DEBUG_TASK        is On     *****\r", Loop1UInt16);
+          else
+            uart_send(__LINE__, __func__, "%2u - DEBUG_TASK        is Off.\r", Loop1UInt16);
+        break;
+
         case DEBUG_TEST:
           if (DebugBitMask & (0x01 << Loop1UInt16))
             uart_send(__LINE__, __func__, "%2u - DEBUG_TEST        is On     *****\r", Loop1UInt16);
@@ -14150,6 +16942,7 @@ void term_info(void)
     printf("              19) - Display available functions.\r");
     printf("              20) - Display current display buffers.\r");
     printf("              21) - Display total RGB Matrix Up time.\r");
+    printf("              22) - Callbacks CPU budget (duration statistics and overruns).\r");
     printf("             ESC) - Return to previous menu.\r\r");
 
     printf("                    Enter your choice: ");
@@ -14499,10 +17292,11 @@ void term_info(void)
       case (12):
         /* Idle Time Monitor info. */
         printf("\r\r");
-        printf("Idle Time Monitor info - To be implemented...\r");
-        printf("=============================================\r\r");
-        printf("Press <Enter> to continue: ");
+        printf(" ========================= Idle Time Monitor info =========================\r\r");
+        display_loop_stats();
+        printf("Press <R> to reset statistics or <Enter> to continue: ");
         input_string(String);
+        if ((String[0] == 'R') || (String[0] == 'r')) loop_stats_reset();
         printf("\r\r");
       break;
 
@@ -14524,6 +17318,10 @@ void term_info(void)
         /* Display first free memory chunk in the heap. */
         printf("\r\r");
         printf("First free memory area in the heap: 0x%p\r\r", Dum1Ptr8);
+
+        /* Active scrolls do not use the heap. */
+        printf("Scroll pool slots in use: %u / %u   high-water mark: %u   acquired: %" PRIu32 "   exhausted: %" PRIu32 "\r\r",
+               ScrollPool.InUse, MAX_ACTIVE_SCROLL, ScrollPool.HighWater, ScrollPool.AcquireCount, ScrollPool.ExhaustedCount);
         printf("Press <Enter> to continue: ");
         input_string(String);
         printf("\r\r");
@@ -14611,11 +17409,13 @@ void term_info(void)
       break;
 
       case (22):
-        /*  */
+        /* Callbacks CPU budget. */
         printf("\r\r");
-        printf("To be implemented...\r\r");
-        printf("Press <Enter> to continue: ");
+        printf(" ========================= Callbacks CPU budget =========================\r\r");
+        display_callback_stats();
+        printf("Press <R> to reset statistics or <Enter> to continue: ");
         input_string(String);
+        if ((String[0] == 'R') || (String[0] == 'r')) callback_stats_reset();
         printf("\r\r");
       break;
 
@@ -14975,7 +17775,7 @@ void term_network_setup(void)
 
 
 #ifndef NTP_SUPPORT
-  win_scroll(WinTop, 201, 201, 1, 1, FONT_5x7, "Network not supported in this version of Firmware");
+  win_scroll(WinTop, 201, 201, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "Network not supported in this version of Firmware");
 #else  // NTP_SUPPORT
   /* User may change and validate credentials, so trigger a new NTP cycle. */
   NTPData.NTPUpdateTime = make_timeout_time_ms(NTPData.NTPRefresh * 1000);
@@ -15358,6 +18158,91 @@ void term_reminder1_setup(void)
 
 
 
+/* $TITLE=term_scan_rate_setup() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                            Terminal submenu for matrix scan rate setup.
+\* ============================================================================================================================================================= */
+void term_scan_rate_setup(void)
+{
+  UCHAR String[31];
+  UCHAR *Separator;
+
+  INT16 Trim;
+
+  UINT8 Loop1UInt8;
+  UINT8 RowNumber;
+
+
+  printf("\r\r\r\r");
+  printf("      Matrix scan rate setup\r\r");
+
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                          Row dwell time.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  while (1)
+  {
+    printf("Scan row dwell time is: %u usec (%u Hz full frame refresh)\r", FlashConfig1.RowDwellUSec, 1000000 / (FlashConfig1.RowDwellUSec * HALF_ROWS));
+    printf("Enter new value to change this setting (%u to %u)\r", ROW_DWELL_MIN, ROW_DWELL_MAX);
+    printf("<Enter> to keep it this way\r");
+    printf("<ESC> to exit scan rate setup: ");
+
+    input_string(String);
+    if (String[0] == 0x0D) break;
+    if (String[0] == 27)   return;
+    FlashConfig1.RowDwellUSec = atoi(String);
+    if (FlashConfig1.RowDwellUSec < ROW_DWELL_MIN) FlashConfig1.RowDwellUSec = ROW_DWELL_MIN;
+    if (FlashConfig1.RowDwellUSec > ROW_DWELL_MAX) FlashConfig1.RowDwellUSec = ROW_DWELL_MAX;
+    RGB_matrix_set_scan_rate();
+  }
+  printf("\r\r");
+
+
+
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                       Per-row on-time trim.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+  while (1)
+  {
+    printf("Scan row on-time trim (in percent of dwell time):\r");
+    for (Loop1UInt8 = 0; Loop1UInt8 < HALF_ROWS; ++Loop1UInt8)
+      printf("Row %2u (matrix rows %2u and %2u): %3d %%   (%3u usec)\r", Loop1UInt8, Loop1UInt8, Loop1UInt8 + HALF_ROWS, FlashConfig1.RowTrim[Loop1UInt8], RowDwell[Loop1UInt8]);
+    printf("Enter <row>,<trim> to change a setting (row 0 to %u, trim -%u to %u)\r", HALF_ROWS - 1, ROW_TRIM_MAX, ROW_TRIM_MAX);
+    printf("<Enter> to keep it this way\r");
+    printf("<ESC> to exit scan rate setup: ");
+
+    input_string(String);
+    if (String[0] == 0x0D) break;
+    if (String[0] == 27)   return;
+
+    Separator = strchr(String, ',');
+    if (Separator == NULL)
+    {
+      printf("\rInvalid entry, please re-enter...\r\r");
+      continue;
+    }
+    RowNumber = atoi(String);
+    if (RowNumber >= HALF_ROWS)
+    {
+      printf("\rInvalid row number, please re-enter...\r\r");
+      continue;
+    }
+    Trim = atoi(Separator + 1);
+    if (Trim < -ROW_TRIM_MAX) Trim = -ROW_TRIM_MAX;
+    if (Trim >  ROW_TRIM_MAX) Trim =  ROW_TRIM_MAX;
+    FlashConfig1.RowTrim[RowNumber] = (INT8)Trim;
+    RGB_matrix_set_scan_rate();
+    printf("\r");
+  }
+  printf("\r\r");
+
+  return;
+}
+
+
+
+
+
 /* $TITLE=term_setup()) */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
@@ -15388,6 +18273,7 @@ void term_setup(void)
     printf("              12) - Auto-scroll setup.\r");
     printf("              13) - Calendar events setup.\r");
     printf("              14) - Reminders of type 1 setup.\r");
+    printf("              15) - Matrix scan rate setup.\r");
     printf("             ESC) - Return to main terminal menu.\r\r");
 
     printf("                    Enter your choice: ");
@@ -15504,10 +18390,9 @@ void term_setup(void)
       break;
 
       case (15):
-        /*  */
+        /* Matrix scan rate setup. */
         printf("\r\r");
-        printf("To be implemented...\r");
-        sleep_ms(3000);
+        term_scan_rate_setup();
         printf("\r\r");
       break;
 
@@ -15839,6 +18724,7 @@ void term_tools(void)
     printf("               9) - Falling snow animation.\r");
     printf("              10) - Random pixels twingling.\r");
     printf("              11) - Full RGB Matrix demo.\r");
+    printf("              12) - Benchmark of scan and drawing functions (CSV output).\r");
     printf("             ESC) - Return to previous menu.\r\r");
 
     printf("                    Enter your choice: ");
@@ -15952,6 +18838,13 @@ void term_tools(void)
         printf("\r\r");
       break;
 
+      case (12):
+        /* Benchmark of scan and drawing functions. */
+        printf("\r\r");
+        benchmark_run();
+        printf("\r\r");
+      break;
+
       default:
         printf("\r\r");
         printf("                    Invalid choice... please re-enter [%s]  [%u]\r\r\r\r\r", String, Menu);
@@ -16154,6 +19047,7 @@ Test1:
   input_string(String);
   if (String[0] == 27) return;
   memset(FrameBuffer, 0xFF, 256);  // turn On all LEDs on entry.
+  RGB_matrix_dirty(0, MAX_ROWS - 1);
 
   for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ROWS; ++Loop1UInt8)
   {
@@ -16200,6 +19094,7 @@ Test1:
     {
       uart_send(__LINE__, __func__, "Turn On pixel - Row: %2u   Column: %2u   ", RowNumber, ColumnNumber);
       FrameBuffer[RowNumber] |= (0x01ll << ColumnNumber);
+      RGB_matrix_dirty(RowNumber, RowNumber);
       uart_send(__LINE__, __func__, "- Press <Enter> to turn On next pixel or <ESC> to exit test: ");
       sleep_ms(100);  // to prevent communication override if user keep pressing <Enter>.
       input_string(String);
@@ -16234,6 +19129,7 @@ Test1:
 
   /* Turn On all LEDs on entry. */
   memset(FrameBuffer, 0xFF, 256);
+  RGB_matrix_dirty(0, MAX_ROWS - 1);
 
   /* Turn Off pixels in the specified matrix area, row by row and column by column. */
   uart_send(__LINE__, __func__, "LED matrix area defined to be turned Off: StartRow:  %2u     StartColumn:  %2u     EndRow:  %2u     EndColumn:  %2u\r\r", StartRow, StartColumn, EndRow, EndColumn);
@@ -16244,6 +19140,7 @@ Test1:
     {
       uart_send(__LINE__, __func__, "Turn Off pixel - Row: %2u   Column: %2u   ", RowNumber, ColumnNumber);
       FrameBuffer[RowNumber] &= ~(0x01ll << ColumnNumber);
+      RGB_matrix_dirty(RowNumber, RowNumber);
       uart_send(__LINE__, __func__, "- Press <Enter> to turn Off next pixel or <ESC> to exit test: ");
       sleep_ms(100);  // to prevent communication override if user keep pressing <Enter>.
       input_string(String);
@@ -16871,6 +19768,7 @@ Test3:
         input_string(String);
         if (String[0] == 27) break;
         memset(FrameBuffer, 0xFF, 256);
+        RGB_matrix_dirty(0, MAX_ROWS - 1);
       break;
     }
   }
@@ -16932,7 +19830,7 @@ Test4:
   /* Scroll text on a non-standard line (Rows 4 to 10). */
   RGB_matrix_cls(FrameBuffer);  /// erase LED matrix for now to erase box border... to be tested after box border support has been added.
   /// win_part_cls(WIN_TEST, 1, 30);
-  ScrollNumber = win_scroll(WIN_TEST, 4, 10, 1, 1, FONT_5x7, "Test number 1: scrolling text once on rows 4 to 10 on the Pico-RGB-Matrix (non-standard rows)");
+  ScrollNumber = win_scroll(WIN_TEST, 4, 10, 1, SCROLL_SPEED_DEFAULT, FONT_5x7, "Test number 1: scrolling text once on rows 4 to 10 on the Pico-RGB-Matrix (non-standard rows)");
   uart_send(__LINE__, __func__, "Wait for scrolling to stop");
   while(ActiveScroll[ScrollNumber])
   {
@@ -16950,7 +19848,7 @@ Test4:
   /* Scroll text on standard Top line (Rows 1 to 7). */
   RGB_matrix_cls(FrameBuffer);  /// erase LED matrix for now to erase box border... to be tested after box border support has been added.
   /// win_part_cls(WIN_TEST, 1, 30);
-  ScrollNumber = win_scroll(WIN_TEST, 201, 201, 2, 1, FONT_5x7, "Test number 2: scrolling text twice on rows 1 to 7 (standard Line 1 of the Pico-RGB-Matrix)");
+  ScrollNumber = win_scroll(WIN_TEST, 201, 201, 2, SCROLL_SPEED_DEFAULT, FONT_5x7, "Test number 2: scrolling text twice on rows 1 to 7 (standard Line 1 of the Pico-RGB-Matrix)");
   uart_send(__LINE__, __func__, "Wait for scrolling to stop");
   while(ActiveScroll[ScrollNumber])
   {
@@ -16968,7 +19866,7 @@ Test4:
   /* Scroll text on standard Mid Line (Rows 9 to 15). */
   RGB_matrix_cls(FrameBuffer);  /// erase LED matrix for now to erase box border... to be tested after box border support has been added.
   /// win_part_cls(WIN_TEST, 1, 30);
-  ScrollNumber = win_scroll(WIN_TEST, 202, 202, 3, 1, FONT_5x7, "Test number 3: scrolling text three times on rows 9 to 15 (standard Line 2 of the Pico-RGB-Matrix)");
+  ScrollNumber = win_scroll(WIN_TEST, 202, 202, 3, SCROLL_SPEED_DEFAULT, FONT_5x7, "Test number 3: scrolling text three times on rows 9 to 15 (standard Line 2 of the Pico-RGB-Matrix)");
   uart_send(__LINE__, __func__, "Wait for scrolling to stop");
   while(ActiveScroll[ScrollNumber])
   {
@@ -16989,7 +19887,7 @@ Test4:
   printf("\r\r\r");
   uart_send(__LINE__, __func__, "This test will scroll numbers 1 to 10 four times in 8x10 font\r");
   uart_send(__LINE__, __func__, "since only numbers have been defined in this character set for now...\r");
-  ScrollNumber = win_scroll(WIN_TEST, 203, 203, 4, 1, FONT_8x10, "1234567890");
+  ScrollNumber = win_scroll(WIN_TEST, 203, 203, 4, SCROLL_SPEED_DEFAULT, FONT_8x10, "1234567890");
   uart_send(__LINE__, __func__, "Wait for scrolling to stop");
   while(ActiveScroll[ScrollNumber])
   {
@@ -17604,7 +20502,7 @@ Test10:
     queue_add_active(Length, RepeatCount);
 
     /* Wait till we are done with current sound sequence. */
-    while (queue_free_active() != (MAX_ACTIVE_SOUND_QUEUE - 1))
+    while (queue_free_active() != MAX_ACTIVE_SOUND_QUEUE)
     {
       sleep_ms(50);
     };
@@ -17666,111 +20564,560 @@ Test12:
 
 
 
-  /* $TITLE=Test13 */
-  /* $PAGE */
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                            Test number 13.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-Test13:
-  // Nothing for now...
-  return;
+  /* $TITLE=Test13 */
+  /* $PAGE */
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                            Test number 13.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+Test13:
+  // Nothing for now...
+  return;
+
+
+
+
+
+  /* $TITLE=Test14 */
+  /* $PAGE */
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                            Test number 14.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+Test14:
+  // Nothing for now...
+  return;
+
+
+
+
+
+  /* $TITLE=Test15 */
+  /* $PAGE */
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                            Test number 15.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+Test15:
+  // Nothing for now...
+  return;
+
+
+
+
+
+  /* $TITLE=Test16 */
+  /* $PAGE */
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                            Test number 16.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+Test16:
+  // Nothing for now...
+  return;
+
+
+
+
+
+  /* $TITLE=Test17 */
+  /* $PAGE */
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                            Test number 17.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+Test17:
+  // Nothing for now...
+  return;
+
+
+
+
+
+  /* $TITLE=Test18 */
+  /* $PAGE */
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                            Test number 18.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+Test18:
+  // Nothing for now...
+  return;
+
+
+
+
+
+  /* $TITLE=Test19 */
+  /* $PAGE */
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                            Test number 19.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+Test19:
+  // Nothing for now...
+  return;
+
+
+
+
+
+
+  /* $TITLE=Test20 */
+  /* $PAGE */
+  /* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                            Test number 20.
+  \* --------------------------------------------------------------------------------------------------------------------------- */
+Test20:
+  // Nothing for now...
+  return;
+}
+
+
+
+
+
+/* $TITLE=transition_compose() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                         Compose the pixels and the color planes of the specified matrix row as they must be displayed, given the transitions in progress.
+   NOTES:
+   1) Must be called with TransitionLock held (see transition_row()).
+   2) Plane[] receives the red, green and blue color planes of the row (see PLANE_RED). OverrideMask receives the pixels whose color
+      does not come from ColorPlane of this row (previous window content, "exploding" box or slid content), for BCM_SUPPORT.
+\* ============================================================================================================================================================= */
+UINT64 transition_compose(UINT8 RowNumber, UINT64 *Plane, UINT64 *OverrideMask)
+{
+  UINT8 Loop1UInt8;
+  UINT8 SourceRow;
+  UINT8 TargetRow;
+
+  UINT64 Pixels;
+
+  struct transition *Slot;
+
+
+  Pixels             = FrameBuffer[RowNumber];
+  Plane[PLANE_RED]   = ColorPlane[PLANE_RED][RowNumber];
+  Plane[PLANE_GREEN] = ColorPlane[PLANE_GREEN][RowNumber];
+  Plane[PLANE_BLUE]  = ColorPlane[PLANE_BLUE][RowNumber];
+  *OverrideMask      = 0ll;
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_TRANSITIONS; ++Loop1UInt8)
+  {
+    Slot = &Transition[Loop1UInt8];
+    if ((Slot->Effect == TRANSITION_NONE) || (RowNumber < Slot->StartRow) || (RowNumber > Slot->EndRow)) continue;
+
+    SourceRow = Slot->SourceRow[RowNumber];
+    TargetRow = Slot->TargetRow[RowNumber];
+
+    /* Final content is taken live from FrameBuffer, previous content from the snapshot taken when the transition started,
+       and the "exploding" box is drawn in the border color of the window. */
+    Pixels = (Pixels & ~Slot->WindowMask)
+           | (FrameBuffer[TargetRow]     & Slot->TargetMask[RowNumber])
+           | (Slot->Source[SourceRow]    & Slot->SourceMask[RowNumber])
+           | Slot->Overlay[RowNumber];
+
+    Plane[PLANE_RED]   = (Plane[PLANE_RED]   & ~Slot->WindowMask) | (ColorPlane[PLANE_RED][TargetRow]   & Slot->TargetMask[RowNumber])
+                       | (Slot->SourceColor[PLANE_RED][SourceRow]   & Slot->SourceMask[RowNumber]) | ((Slot->BorderColor & RED)   ? Slot->Overlay[RowNumber] : 0ll);
+    Plane[PLANE_GREEN] = (Plane[PLANE_GREEN] & ~Slot->WindowMask) | (ColorPlane[PLANE_GREEN][TargetRow] & Slot->TargetMask[RowNumber])
+                       | (Slot->SourceColor[PLANE_GREEN][SourceRow] & Slot->SourceMask[RowNumber]) | ((Slot->BorderColor & GREEN) ? Slot->Overlay[RowNumber] : 0ll);
+    Plane[PLANE_BLUE]  = (Plane[PLANE_BLUE]  & ~Slot->WindowMask) | (ColorPlane[PLANE_BLUE][TargetRow]  & Slot->TargetMask[RowNumber])
+                       | (Slot->SourceColor[PLANE_BLUE][SourceRow]  & Slot->SourceMask[RowNumber]) | ((Slot->BorderColor & BLUE)  ? Slot->Overlay[RowNumber] : 0ll);
+
+    *OverrideMask |= Slot->SourceMask[RowNumber] | Slot->Overlay[RowNumber] | ((TargetRow != RowNumber) ? Slot->TargetMask[RowNumber] : 0ll);
+  }
+
+  return Pixels;
+}
+
+
+
+
+
+/* $TITLE=transition_init() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                                Initialize the window transition engine.
+\* ============================================================================================================================================================= */
+void transition_init(void)
+{
+  UINT8 Loop1UInt8;
+
+
+  if (TransitionLock == NULL) TransitionLock = spin_lock_init(spin_lock_claim_unused(true));
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_TRANSITIONS; ++Loop1UInt8)
+    Transition[Loop1UInt8].Effect = TRANSITION_NONE;
+  TransitionRowMask = 0l;
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=transition_keyframe() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                  Compute the masks of the current keyframe of the specified transition in progress.
+   NOTES:
+   1) Must be called with TransitionLock held.
+   2) Each matrix row of the window shows a row of the final content (TargetRow / TargetMask), a row of the previous content
+      (SourceRow / SourceMask), and Overlay pixels turned On over both. Keyframe number <Frame> + 1 is the number of rows or columns
+      of the final content already displayed by slides and wipe.
+\* ============================================================================================================================================================= */
+void transition_keyframe(struct transition *Slot)
+{
+  UINT8 BottomRow;
+  UINT8 ColumnNumber;
+  UINT8 Height;
+  UINT8 LeftColumn;
+  UINT8 Offset;
+  UINT8 RightColumn;
+  UINT8 RowNumber;
+  UINT8 TopRow;
+
+  UINT16 Threshold;
+
+  UINT64 BoxMask;
+
+
+  Height    = Slot->EndRow - Slot->StartRow + 1;
+  Offset    = Slot->Frame + 1;
+  Threshold = (Offset * 256) / Slot->FrameCount;
+
+  for (RowNumber = Slot->StartRow; RowNumber <= Slot->EndRow; ++RowNumber)
+  {
+    /* By default, the row shows the previous window content. */
+    Slot->TargetRow[RowNumber]  = RowNumber;
+    Slot->SourceRow[RowNumber]  = RowNumber;
+    Slot->TargetMask[RowNumber] = 0ll;
+    Slot->SourceMask[RowNumber] = Slot->WindowMask;
+    Slot->Overlay[RowNumber]    = 0ll;
+
+    switch (Slot->Effect)
+    {
+      case (TRANSITION_EXPLODE):
+        /* Last keyframe when the last box must be erased: final content only. */
+        if (Slot->Frame >= Slot->BoxCount)
+        {
+          Slot->TargetMask[RowNumber] = Slot->WindowMask;
+          Slot->SourceMask[RowNumber] = 0ll;
+          break;
+        }
+
+        /* Box border is turned On, the inside of the box shows the final content and the outside the previous one. */
+        TopRow      = Slot->Box[Slot->Frame][0];
+        LeftColumn  = Slot->Box[Slot->Frame][1];
+        BottomRow   = Slot->Box[Slot->Frame][2];
+        RightColumn = Slot->Box[Slot->Frame][3];
+        if ((RowNumber < TopRow) || (RowNumber > BottomRow)) break;
+
+        BoxMask = RGB_matrix_span_mask(LeftColumn, RightColumn) & Slot->WindowMask;
+        Slot->SourceMask[RowNumber] = Slot->WindowMask & ~BoxMask;
+        if ((RowNumber == TopRow) || (RowNumber == BottomRow))
+        {
+          Slot->Overlay[RowNumber] = BoxMask;
+        }
+        else
+        {
+          Slot->Overlay[RowNumber]    = (RGB_matrix_span_mask(LeftColumn, LeftColumn) | RGB_matrix_span_mask(RightColumn, RightColumn)) & Slot->WindowMask;
+          Slot->TargetMask[RowNumber] = BoxMask & ~Slot->Overlay[RowNumber];
+        }
+      break;
+
+      case (TRANSITION_SLIDE_UP):
+        /* Previous content moves up, final content comes in from the bottom. */
+        if ((RowNumber - Slot->StartRow) < (Height - Offset))
+        {
+          Slot->SourceRow[RowNumber] = RowNumber + Offset;
+        }
+        else
+        {
+          Slot->TargetRow[RowNumber]  = RowNumber - (Height - Offset);
+          Slot->TargetMask[RowNumber] = Slot->WindowMask;
+          Slot->SourceMask[RowNumber] = 0ll;
+        }
+      break;
+
+      case (TRANSITION_SLIDE_DOWN):
+        /* Previous content moves down, final content comes in from the top. */
+        if ((RowNumber - Slot->StartRow) < Offset)
+        {
+          Slot->TargetRow[RowNumber]  = RowNumber + (Height - Offset);
+          Slot->TargetMask[RowNumber] = Slot->WindowMask;
+          Slot->SourceMask[RowNumber] = 0ll;
+        }
+        else
+        {
+          Slot->SourceRow[RowNumber] = RowNumber - Offset;
+        }
+      break;
+
+      case (TRANSITION_WIPE):
+        Slot->TargetMask[RowNumber] = RGB_matrix_span_mask(Slot->StartColumn, Slot->StartColumn + Offset - 1);
+        Slot->SourceMask[RowNumber] = Slot->WindowMask & ~Slot->TargetMask[RowNumber];
+      break;
+
+      case (TRANSITION_DISSOLVE):
+        /* Each pixel has a fixed pseudo-random rank (multiplicative hash of its position), pixels are revealed by increasing rank. */
+        for (ColumnNumber = Slot->StartColumn; ColumnNumber <= Slot->EndColumn; ++ColumnNumber)
+        {
+          if (((((UINT32)RowNumber * MAX_COLUMNS) + ColumnNumber) * 2654435761u) >> 24 < Threshold)
+            Slot->TargetMask[RowNumber] |= (0x01ll << ColumnNumber);
+        }
+        Slot->SourceMask[RowNumber] = Slot->WindowMask & ~Slot->TargetMask[RowNumber];
+      break;
+    }
+  }
+
+  return;
+}
+
+
+
+
+
+/* $TITLE=transition_row() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                      Return the pixels of the specified matrix row as they must be displayed, given the transitions in progress, and their color planes.
+   NOTES:
+   1) Called by RGB_matrix_pack_row() for each row to be sent to the scan. When no transition covers the row, this is FrameBuffer
+      and ColorPlane as is.
+   2) Final content is always taken live from FrameBuffer, so that whatever is printed in the window during the transition is displayed too.
+   3) See transition_compose() for Plane[] and OverrideMask.
+\* ============================================================================================================================================================= */
+UINT64 transition_row(UINT8 RowNumber, UINT64 *Plane, UINT64 *OverrideMask)
+{
+  UINT32 InterruptMask;
+
+  UINT64 Pixels;
+
+
+  if ((TransitionRowMask & (0x01ul << RowNumber)) == 0)
+  {
+    Plane[PLANE_RED]   = ColorPlane[PLANE_RED][RowNumber];
+    Plane[PLANE_GREEN] = ColorPlane[PLANE_GREEN][RowNumber];
+    Plane[PLANE_BLUE]  = ColorPlane[PLANE_BLUE][RowNumber];
+    *OverrideMask      = 0ll;
+
+    return FrameBuffer[RowNumber];
+  }
+
+  InterruptMask = spin_lock_blocking(TransitionLock);
+  Pixels = transition_compose(RowNumber, Plane, OverrideMask);
+  spin_unlock(TransitionLock, InterruptMask);
+
+  return Pixels;
+}
+
+
+
+
+
+/* $TITLE=transition_start() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                                              Start the transition of the specified window.
+   NOTES:
+   1) Called by win_open() before it sets the final state of the window in FrameBuffer and ColorPlane. The window content currently
+      displayed, with its colors, is kept as the previous content, and the first keyframe is displayed right away.
+   2) Up to MAX_TRANSITIONS windows are animated at the same time (for instance, the back-linked windows restored by win_close()).
+      Transitions in progress over an area overlapping the new window are replaced by the new one, which starts from what they
+      were displaying.
+   3) Box[] gives the "exploding" boxes of TRANSITION_EXPLODE from the center of the window outward (see win_open()).
+\* ============================================================================================================================================================= */
+void transition_start(UINT8 WindowNumber, UINT8 Effect, UINT8 Box[][4], UINT8 BoxCount)
+{
+  UINT8 Loop1UInt8;
+  UINT8 RowNumber;
+
+  UINT32 InterruptMask;
+
+  UINT64 OverrideMask;
+  UINT64 Plane[3];
+
+  struct transition *Slot;
+
+
+  InterruptMask = spin_lock_blocking(TransitionLock);
 
+  /* Use a free slot. If all of them are in use, the oldest transition (first slot) is completed at once. */
+  Slot = &Transition[0];
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_TRANSITIONS; ++Loop1UInt8)
+  {
+    if (Transition[Loop1UInt8].Effect == TRANSITION_NONE)
+    {
+      Slot = &Transition[Loop1UInt8];
+      break;
+    }
+  }
+  Slot->Effect = TRANSITION_NONE;
 
+  Slot->WindowNumber = WindowNumber;
+  Slot->StartRow     = Window[WindowNumber].StartRow;
+  Slot->StartColumn  = Window[WindowNumber].StartColumn;
+  Slot->EndRow       = Window[WindowNumber].EndRow;
+  Slot->EndColumn    = Window[WindowNumber].EndColumn;
+  Slot->BorderColor  = Window[WindowNumber].BorderColor;
+  Slot->WindowMask   = RGB_matrix_span_mask(Slot->StartColumn, Slot->EndColumn);
+  Slot->Frame        = 0;
+  Slot->TickCount    = 0;
 
+  /* Window content and colors as they are currently displayed (maybe through other transitions still in progress). */
+  for (RowNumber = Slot->StartRow; RowNumber <= Slot->EndRow; ++RowNumber)
+  {
+    Slot->Source[RowNumber] = transition_compose(RowNumber, Plane, &OverrideMask) & Slot->WindowMask;
+    Slot->SourceColor[PLANE_RED][RowNumber]   = Plane[PLANE_RED];
+    Slot->SourceColor[PLANE_GREEN][RowNumber] = Plane[PLANE_GREEN];
+    Slot->SourceColor[PLANE_BLUE][RowNumber]  = Plane[PLANE_BLUE];
+  }
 
+  /* Transitions in progress over the same area are replaced by this one. */
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_TRANSITIONS; ++Loop1UInt8)
+  {
+    if ((Transition[Loop1UInt8].Effect != TRANSITION_NONE) && (Transition[Loop1UInt8].StartRow <= Slot->EndRow) && (Transition[Loop1UInt8].EndRow >= Slot->StartRow)
+        && (Transition[Loop1UInt8].StartColumn <= Slot->EndColumn) && (Transition[Loop1UInt8].EndColumn >= Slot->StartColumn))
+      Transition[Loop1UInt8].Effect = TRANSITION_NONE;
+  }
 
-  /* $TITLE=Test14 */
-  /* $PAGE */
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                            Test number 14.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-Test14:
-  // Nothing for now...
-  return;
+  /* Keep "exploding" boxes inside the window (box coordinates may have wrapped around for the outermost boxes). */
+  Slot->BoxCount = BoxCount;
+  for (Loop1UInt8 = 0; Loop1UInt8 < BoxCount; ++Loop1UInt8)
+  {
+    Slot->Box[Loop1UInt8][0] = ((Box[Loop1UInt8][0] < Slot->StartRow)    || (Box[Loop1UInt8][0] > Slot->EndRow))    ? Slot->StartRow    : Box[Loop1UInt8][0];
+    Slot->Box[Loop1UInt8][1] = ((Box[Loop1UInt8][1] < Slot->StartColumn) || (Box[Loop1UInt8][1] > Slot->EndColumn)) ? Slot->StartColumn : Box[Loop1UInt8][1];
+    Slot->Box[Loop1UInt8][2] = (Box[Loop1UInt8][2] > Slot->EndRow)    ? Slot->EndRow    : Box[Loop1UInt8][2];
+    Slot->Box[Loop1UInt8][3] = (Box[Loop1UInt8][3] > Slot->EndColumn) ? Slot->EndColumn : Box[Loop1UInt8][3];
+  }
 
+  switch (Effect)
+  {
+    case (TRANSITION_EXPLODE):
+      /* One more keyframe to erase the last box when it must not remain On. */
+      Slot->FrameCount    = BoxCount + ((Window[WindowNumber].LastBoxState == ACTION_ERASE) ? 1 : 0);
+      Slot->TicksPerFrame = TRANSITION_EXPLODE_USEC / SCROLL_TICK_USEC;
+    break;
 
+    case (TRANSITION_SLIDE_UP):
+    case (TRANSITION_SLIDE_DOWN):
+      Slot->FrameCount    = Slot->EndRow - Slot->StartRow + 1;
+      Slot->TicksPerFrame = TRANSITION_SLIDE_USEC / SCROLL_TICK_USEC;
+    break;
 
+    case (TRANSITION_WIPE):
+      Slot->FrameCount    = Slot->EndColumn - Slot->StartColumn + 1;
+      Slot->TicksPerFrame = TRANSITION_WIPE_USEC / SCROLL_TICK_USEC;
+    break;
 
+    case (TRANSITION_DISSOLVE):
+      Slot->FrameCount    = TRANSITION_DISSOLVE_FRAMES;
+      Slot->TicksPerFrame = TRANSITION_DISSOLVE_USEC / SCROLL_TICK_USEC;
+    break;
 
-  /* $TITLE=Test15 */
-  /* $PAGE */
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                            Test number 15.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-Test15:
-  // Nothing for now...
-  return;
+    default:
+      Slot->FrameCount    = 0;
+      Slot->TicksPerFrame = 1;
+    break;
+  }
+  if (Slot->TicksPerFrame == 0) Slot->TicksPerFrame = 1;
 
+  /* Without animation, final window content is displayed at once. */
+  if (Slot->FrameCount != 0)
+  {
+    Slot->Effect = Effect;
+    transition_keyframe(Slot);
+  }
+  transition_update_mask();
+  __dmb();
 
+  spin_unlock(TransitionLock, InterruptMask);
 
+  RGB_matrix_dirty(Window[WindowNumber].StartRow, Window[WindowNumber].EndRow);
 
+  if (DebugBitMask & DEBUG_WINDOW) uart_send(__LINE__, __func__, "Transition %u started for window %s (%u keyframes)\r", Effect, Window[WindowNumber].Name, Slot->FrameCount);
 
-  /* $TITLE=Test16 */
-  /* $PAGE */
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                            Test number 16.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-Test16:
-  // Nothing for now...
   return;
+}
 
 
 
 
 
-  /* $TITLE=Test17 */
-  /* $PAGE */
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                            Test number 17.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-Test17:
-  // Nothing for now...
-  return;
+/* $TITLE=transition_tick() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                  Move each transition in progress to its next keyframe when it is due. Return FLAG_ON if the matrix must be updated.
+   NOTES:
+   1) Called at each scroll tick by callback_scroll_timer() (core 1). When the last keyframe of a transition has been displayed,
+      the transition is over and FrameBuffer is displayed as is over its window.
+\* ============================================================================================================================================================= */
+UINT8 transition_tick(void)
+{
+  UINT8 FlagChanged;
+  UINT8 Loop1UInt8;
 
+  UINT32 InterruptMask;
 
+  struct transition *Slot;
 
 
+  if (TransitionRowMask == 0l) return FLAG_OFF;
 
-  /* $TITLE=Test18 */
-  /* $PAGE */
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                            Test number 18.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-Test18:
-  // Nothing for now...
-  return;
+  FlagChanged = FLAG_OFF;
 
+  InterruptMask = spin_lock_blocking(TransitionLock);
 
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_TRANSITIONS; ++Loop1UInt8)
+  {
+    Slot = &Transition[Loop1UInt8];
+    if ((Slot->Effect == TRANSITION_NONE) || (++Slot->TickCount < Slot->TicksPerFrame)) continue;
 
+    Slot->TickCount = 0;
+    if (++Slot->Frame >= Slot->FrameCount)
+      Slot->Effect = TRANSITION_NONE;
+    else
+      transition_keyframe(Slot);
 
+    RGB_matrix_dirty(Slot->StartRow, Slot->EndRow);
+    FlagChanged = FLAG_ON;
+  }
+  if (FlagChanged) transition_update_mask();
 
-  /* $TITLE=Test19 */
-  /* $PAGE */
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                            Test number 19.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-Test19:
-  // Nothing for now...
-  return;
+  spin_unlock(TransitionLock, InterruptMask);
 
+  return FlagChanged;
+}
 
 
 
 
 
-  /* $TITLE=Test20 */
-  /* $PAGE */
-  /* --------------------------------------------------------------------------------------------------------------------------- *\
-                                                            Test number 20.
-  \* --------------------------------------------------------------------------------------------------------------------------- */
-Test20:
-  // Nothing for now...
+/* $TITLE=transition_update_mask() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                          Update TransitionRowMask with the matrix rows covered by the transitions in progress.
+   NOTES:
+   1) Must be called with TransitionLock held, whenever a transition is started or completed.
+\* ============================================================================================================================================================= */
+void transition_update_mask(void)
+{
+  UINT8 Loop1UInt8;
+
+  UINT32 RowMask;
+
+
+  RowMask = 0l;
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_TRANSITIONS; ++Loop1UInt8)
+  {
+    if (Transition[Loop1UInt8].Effect == TRANSITION_NONE) continue;
+    RowMask |= (MATRIX_ALL_ROWS >> (31 - (Transition[Loop1UInt8].EndRow - Transition[Loop1UInt8].StartRow))) << Transition[Loop1UInt8].StartRow;
+  }
+  TransitionRowMask = RowMask;
+
   return;
 }
 
 
 
 
+
 /* $TITLE=uart_send() */
 /* $PAGE */
 /* ============================================================================================================================================================= *\
@@ -18257,7 +21604,7 @@ void win_close(UINT8 WindowNumber)
   for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ACTIVE_SCROLL; ++Loop1UInt8)
   {
     /* Scan all active scrolls to check if some owners are the current closing window. */
-    if (ActiveScroll[Loop1UInt8]->Owner == Loop1UInt8) win_scroll_off(Loop1UInt8);
+    if ((ActiveScroll[Loop1UInt8] != NULL) && (ActiveScroll[Loop1UInt8]->Owner == WindowNumber)) win_scroll_off(Loop1UInt8);
   }
 
 
@@ -18313,6 +21660,8 @@ void win_close(UINT8 WindowNumber)
 \* ============================================================================================================================================================= */
 void win_cls(UINT8 WindowNumber)
 {
+  RGB_matrix_draw_begin();
+
   /* If the last drawn box border remains turned On, clear the area inside the box. Otherwise clear including the box border. */
   if (Window[WindowNumber].LastBoxState == ACTION_DRAW)
   {
@@ -18323,6 +21672,8 @@ void win_cls(UINT8 WindowNumber)
   else
     RGB_matrix_clear_pixel(FrameBuffer, Window[WindowNumber].StartRow, Window[WindowNumber].StartColumn, Window[WindowNumber].EndRow, Window[WindowNumber].EndColumn);
 
+  RGB_matrix_draw_end();
+
   return;
 }
 
@@ -18345,6 +21696,12 @@ void win_init()
   WinMid = MAX_WINDOWS;
   WinBot = MAX_WINDOWS;
 
+  /* All scroll slots are free on entry. */
+  scroll_pool_init();
+
+  /* No window transition is in progress on entry. */
+  transition_init();
+
   /* Generic windows initialization. */
   for (Loop1UInt16 = 0; Loop1UInt16 < MAX_WINDOWS; ++Loop1UInt16)
   {
@@ -18366,6 +21723,7 @@ void win_init()
     Window[Loop1UInt16].FlagTopScroll = FLAG_OFF;
     Window[Loop1UInt16].FlagMidScroll = FLAG_OFF;
     Window[Loop1UInt16].FlagBotScroll = FLAG_OFF;
+    Window[Loop1UInt16].Transition    = TRANSITION_EXPLODE;
   }
 
   /* Initialize specific parameters for WIN_DATE window. */
@@ -18472,6 +21830,7 @@ void win_init()
 /* ============================================================================================================================================================= *\
                                                                      Draw the specified window.
                                     NOTE: If we are "restoring" a previously suspended window, do not update the backlinks,
+                                 The opening animation (Window[].Transition) runs on core 1 and win_open() returns at once.
 \* ============================================================================================================================================================= */
 void win_open(UINT8 WindowNumber, UINT8 FlagRestore)
 {
@@ -18479,20 +21838,17 @@ void win_open(UINT8 WindowNumber, UINT8 FlagRestore)
 
   INT8 Remainder;
 
+  UINT8 Box[TRANSITION_MAX_FRAMES][4];
+  UINT8 BoxCount;
   UINT8 CurrentBottomRow;
   UINT8 CurrentTopRow;
   UINT8 CurrentRightColumn;
   UINT8 CurrentLeftColumn;
   UINT8 Increment;
-  UINT8 Iteration;
   UINT8 Loop1UInt8;
   UINT8 Loop2UInt8;
   UINT8 NbRows;
   UINT8 NbColumns;
-  UINT8 OldBR;
-  UINT8 OldLC;
-  UINT8 OldRC;
-  UINT8 OldTR;
   UINT8 StartLength;
 
 
@@ -18524,7 +21880,7 @@ void win_open(UINT8 WindowNumber, UINT8 FlagRestore)
 
 
 
-  Iteration = 0;  // number of "exploding" boxes already drawn.
+  BoxCount  = 0;  // number of "exploding" boxes recorded.
   NbRows    = Window[WindowNumber].EndRow    - Window[WindowNumber].StartRow    + 1;
   NbColumns = Window[WindowNumber].EndColumn - Window[WindowNumber].StartColumn + 1;
 
@@ -18677,70 +22033,21 @@ void win_open(UINT8 WindowNumber, UINT8 FlagRestore)
 
 
 
-    /* Explode opening window. */
-    while (CurrentBottomRow <= Window[WindowNumber].EndRow)
+    /* Record the "exploding" boxes, they are animated by the transition engine (see transition_tick()). */
+    while ((CurrentBottomRow <= Window[WindowNumber].EndRow) && (BoxCount < TRANSITION_MAX_FRAMES))
     {
-      /* Draw new box. */
-      RGB_matrix_box(CurrentTopRow, CurrentLeftColumn, CurrentBottomRow, CurrentRightColumn, Window[WindowNumber].BorderColor, ACTION_DRAW);
-      /***
-      if (DebugBitMask & DEBUG_WINDOW)
-      {
-        uart_send(__LINE__, __func__, "Drawing (%2u, %2u)   (%2u, %2u)\r", CurrentTopRow, CurrentLeftColumn, CurrentBottomRow, CurrentRightColumn);
-        uart_send(__LINE__, __func__, "Press <Enter> to continue: ");
-        input_string(String);
-      }
-      ***/
-
-      /* If it is not first iteration, erase previous box. */
-      if (Iteration != 0)
-      {
-        RGB_matrix_clear_pixel(FrameBuffer, CurrentTopRow + 1, CurrentLeftColumn + 1, CurrentBottomRow - 1, CurrentRightColumn - 1);
-        /***
-        if (DebugBitMask & DEBUG_WINDOW)
-        {
-          uart_send(__LINE__, __func__, "Erasing (%2u, %2u)   (%2u, %2u)\r", CurrentTopRow + 1, CurrentLeftColumn + 1, CurrentBottomRow - 1, CurrentRightColumn - 1);
-          /// RGB_matrix_box(OldTR, OldLC, OldBR, OldRC, 0, ACTION_ERASE);
-          /// uart_send(__LINE__, __func__, "Erasing (%2u, %2u)   (%2u, %2u)\r", OldTR, OldLC, OldBR, OldRC);
-          uart_send(__LINE__, __func__, "Press <Enter> to continue: ");
-          input_string(String);
-        }
-        ***/
-      }
-
-      ++Iteration;
-
-      /* Keep track of the box just drawn to erase it on next pass. */
-      OldTR = CurrentTopRow;
-      OldBR = CurrentBottomRow;
-      OldLC = CurrentLeftColumn;
-      OldRC = CurrentRightColumn;
+      Box[BoxCount][0] = CurrentTopRow;
+      Box[BoxCount][1] = CurrentLeftColumn;
+      Box[BoxCount][2] = CurrentBottomRow;
+      Box[BoxCount][3] = CurrentRightColumn;
+      ++BoxCount;
 
       /* Find coordinates of the next box to draw. */
       --CurrentTopRow;
       ++CurrentBottomRow;
       CurrentLeftColumn  -= Increment;
       CurrentRightColumn += Increment;
-
-      sleep_ms(50);  // slow down animation a bit.
-    }
-
-    /* Check if last box must be erased. */
-    if (Window[WindowNumber].LastBoxState == ACTION_ERASE)
-    {
-      sleep_ms(50);  // keep same animation pace than previous ones.
-      RGB_matrix_box(OldTR, OldLC, OldBR, OldRC, 0, ACTION_ERASE);
-      /***
-      if (DebugBitMask & DEBUG_WINDOW)
-      {
-        uart_send(__LINE__, __func__, "Erasing last (%2u, %2u)   (%2u, %2u)\r", OldTR, OldLC, OldBR, OldRC);
-        uart_send(__LINE__, __func__, "Press <Enter> to continue: ");
-        input_string(String);
-      }
-      ***/
     }
-
-    /* When done, set inbox final color. */
-    RGB_matrix_set_color(Window[WindowNumber].StartRow + 1, Window[WindowNumber].StartColumn + 1, Window[WindowNumber].EndRow - 1, Window[WindowNumber].EndColumn - 1, Window[WindowNumber].InsideColor);
   }
   else
   {
@@ -18812,69 +22119,37 @@ void win_open(UINT8 WindowNumber, UINT8 FlagRestore)
 
 
 
-    /* Explode window. */
-    while (CurrentLeftColumn <= Window[WindowNumber].EndColumn)
+    /* Record the "exploding" boxes, they are animated by the transition engine (see transition_tick()). */
+    while ((CurrentLeftColumn <= Window[WindowNumber].EndColumn) && (BoxCount < TRANSITION_MAX_FRAMES))
     {
-      /* Draw new box. */
-      RGB_matrix_box(CurrentTopRow, CurrentLeftColumn, CurrentBottomRow, CurrentRightColumn, Window[WindowNumber].BorderColor, ACTION_DRAW);
-      /***
-      if (DebugBitMask & DEBUG_WINDOW)
-      {
-        uart_send(__LINE__, __func__, "Drawing (%2u, %2u)   (%2u, %2u)\r", CurrentTopRow, CurrentLeftColumn, CurrentBottomRow, CurrentRightColumn);
-        uart_send(__LINE__, __func__, "Press <Enter> to continue: ");
-        input_string(String);
-      }
-      ***/
-
-      /* If it is not first iteration, erase previous box. */
-      if (Iteration != 0)
-      {
-        RGB_matrix_clear_pixel(FrameBuffer, CurrentTopRow + 1, CurrentLeftColumn + 1, CurrentBottomRow - 1, CurrentRightColumn - 1);
-        /***
-        if (DebugBitMask & DEBUG_WINDOW)
-        {
-          uart_send(__LINE__, __func__, "Erasing (%2u, %2u)   (%2u, %2u)\r", CurrentTopRow + 1, CurrentLeftColumn + 1, CurrentBottomRow - 1, CurrentRightColumn - 1);
-          uart_send(__LINE__, __func__, "Press <Enter> to continue: ");
-          input_string(String);
-        }
-        ***/
-      }
-
-      ++Iteration;
-
-      /* Keep track of the box just drawn to erase it on next pass. */
-      OldTR = CurrentTopRow;
-      OldBR = CurrentBottomRow;
-      OldLC = CurrentLeftColumn;
-      OldRC = CurrentRightColumn;
+      Box[BoxCount][0] = CurrentTopRow;
+      Box[BoxCount][1] = CurrentLeftColumn;
+      Box[BoxCount][2] = CurrentBottomRow;
+      Box[BoxCount][3] = CurrentRightColumn;
+      ++BoxCount;
 
       /* Find coordinates of the next box to draw. */
       --CurrentLeftColumn;
       ++CurrentRightColumn;
       CurrentTopRow    -= Increment;
       CurrentBottomRow += Increment;
-
-      sleep_ms(50);  // slow down animation a bit.
     }
+  }
 
-    /* Check if last box must be erased. */
-    if (Window[WindowNumber].LastBoxState == ACTION_ERASE)
-    {
-      sleep_ms(50);  // keep same animation pace than previous ones.
-      RGB_matrix_box(OldTR, OldLC, OldBR, OldRC, 0, ACTION_ERASE);
-      /***
-      if (DebugBitMask & DEBUG_WINDOW)
-      {
-        uart_send(__LINE__, __func__, "Erasing last (%2u, %2u)   (%2u, %2u)\r", OldTR, OldLC, OldBR, OldRC);
-        uart_send(__LINE__, __func__, "Press <Enter> to continue: ");
-        input_string(String);
-      }
-      ***/
-    }
 
-    /* When done, set inbox final color. */
-    RGB_matrix_set_color(Window[WindowNumber].StartRow + 1, Window[WindowNumber].StartColumn + 1, Window[WindowNumber].EndRow - 1, Window[WindowNumber].EndColumn - 1, Window[WindowNumber].InsideColor);
-  }
+  /* Start the transition: it shows the previous window content, and progressively the new one, while the caller goes on. */
+  transition_start(WindowNumber, Window[WindowNumber].Transition, Box, BoxCount);
+
+  /* FrameBuffer receives right away the final state of the window (empty, with its box border if it remains On), so that the caller may
+     print in the window at once. Window colors are also set to their final state. */
+  RGB_matrix_draw_begin();
+  RGB_matrix_clear_pixel(FrameBuffer, Window[WindowNumber].StartRow, Window[WindowNumber].StartColumn, Window[WindowNumber].EndRow, Window[WindowNumber].EndColumn);
+  if (Window[WindowNumber].LastBoxState == ACTION_DRAW)
+    RGB_matrix_box(Window[WindowNumber].StartRow, Window[WindowNumber].StartColumn, Window[WindowNumber].EndRow, Window[WindowNumber].EndColumn, Window[WindowNumber].BorderColor, ACTION_DRAW);
+  else
+    RGB_matrix_box(Window[WindowNumber].StartRow, Window[WindowNumber].StartColumn, Window[WindowNumber].EndRow, Window[WindowNumber].EndColumn, 0, ACTION_ERASE);
+  RGB_matrix_set_color(Window[WindowNumber].StartRow + 1, Window[WindowNumber].StartColumn + 1, Window[WindowNumber].EndRow - 1, Window[WindowNumber].EndColumn - 1, Window[WindowNumber].InsideColor);
+  RGB_matrix_draw_end();
 
 
   /* Make this window active. */
@@ -18934,6 +22209,7 @@ void win_part_cls(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow)
 
 
   /* Clear the window's specified area. */
+  RGB_matrix_draw_begin();
   for (RowNumber = MatrixStartRow; RowNumber <= MatrixEndRow; ++RowNumber)
   {
     if (Window[WindowNumber].LastBoxState == ACTION_ERASE)
@@ -18947,6 +22223,8 @@ void win_part_cls(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow)
         FrameBuffer[RowNumber] = 0x8000000000000001ll;  // intermediate rows.
     }
   }
+  RGB_matrix_dirty(MatrixStartRow, MatrixEndRow);
+  RGB_matrix_draw_end();
 
   return;
 }
@@ -18959,6 +22237,8 @@ void win_part_cls(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow)
 /* $PAGE */
 /* ============================================================================================================================================================= *\
                                                                 Display text in the specified window.
+                                   NOTE: If StartColumn is 99, text is centered within the window columns (see win_printf_layout()).
+                                         On standard window lines (201 to 203), text that does not fit is then scrolled instead.
 \* ============================================================================================================================================================= */
 UINT8 win_printf(UINT8 WindowNumber, UINT8 StartRow, UINT8 StartColumn, UINT8 FontType, UCHAR *Format, ...)
 {
@@ -18978,6 +22258,8 @@ UINT8 win_printf(UINT8 WindowNumber, UINT8 StartRow, UINT8 StartColumn, UINT8 Fo
   vsnprintf(String, sizeof(String), Format, argp);
   va_end(argp);
 
+  if (StartColumn == 99) return win_printf_layout(WindowNumber, StartRow, LAYOUT_CENTER | ((StartRow > 200) ? LAYOUT_SCROLL : LAYOUT_ELLIPSIS), FontType, "%s", String);
+
 
   // uart_send(__LINE__, __func__, "On entry - StartRow: %2u   StartColumn: %2u   MatrixStartRow: %2u   MatrixStartColumn: %u\r", StartRow, StartColumn, MatrixStartRow, MatrixStartColumn);
 
@@ -19010,15 +22292,97 @@ UINT8 win_printf(UINT8 WindowNumber, UINT8 StartRow, UINT8 StartColumn, UINT8 Fo
 
 
 
+/* $TITLE=win_printf_layout() */
+/* $PAGE */
+/* ============================================================================================================================================================= *\
+                                        Display text aligned within the columns of the specified window, according to layout flags.
+   NOTES:
+   1) Text is laid out between the window columns, inside the window border if there is one (see scroll_region() and layout_text()).
+   2) With LAYOUT_SCROLL on a standard window line (201 to 203), text that does not fit is handed over to the scroll engine, unless
+      that line is already scrolling. Other lines fall back to LAYOUT_ELLIPSIS. Return the column following the last character displayed.
+\* ============================================================================================================================================================= */
+UINT8 win_printf_layout(UINT8 WindowNumber, UINT8 StartRow, UINT8 Flags, UINT8 FontType, UCHAR *Format, ...)
+{
+  UCHAR String[256];
+
+  UINT8 EndColumn;
+  UINT8 EndRow;
+  UINT8 GlyphRow;
+  UINT8 Loop1UInt8;
+  UINT8 MatrixStartRow;
+  UINT8 StartColumn;
+
+  va_list argp;
+
+  struct layout Layout;
+
+
+  /* Transfer the text to print to variable <String>. */
+  va_start(argp, Format);
+  vsnprintf(String, sizeof(String), Format, argp);
+  va_end(argp);
+
+
+  /* Matrix rows and window columns where the text is laid out. */
+  StartColumn = 0;
+  EndColumn   = MAX_COLUMNS - 1;
+  if (StartRow > 200)
+  {
+    MatrixStartRow = StartRow;
+    EndRow         = StartRow;
+    RGB_matrix_check_coord(&MatrixStartRow, &StartColumn, &EndRow, &EndColumn);
+  }
+  else
+  {
+    MatrixStartRow = Window[WindowNumber].StartRow + StartRow;
+    EndRow         = MatrixStartRow;
+    Flags          = (Flags & LAYOUT_SCROLL) ? ((Flags & ~LAYOUT_SCROLL) | LAYOUT_ELLIPSIS) : Flags;
+  }
+  GlyphRow = MatrixStartRow;
+  if (scroll_region(WindowNumber, &MatrixStartRow, &EndRow, &StartColumn, &EndColumn) == FLAG_OFF)
+  {
+    /* Not inside the window, lay out on the whole matrix width, as RGB_matrix_printf() does. */
+    StartColumn = 0;
+    EndColumn   = MAX_COLUMNS - 1;
+  }
+
+  layout_text(FontType, String, StartColumn, EndColumn, Flags, &Layout);
+
+
+  /* Text does not fit in the window, scroll it (only once, even if it is displayed again while still scrolling). */
+  if ((Layout.FlagOverflow) && (Flags & LAYOUT_SCROLL))
+  {
+    for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ACTIVE_SCROLL; ++Loop1UInt8)
+      if ((ActiveScroll[Loop1UInt8] != 0x00l) && (ActiveScroll[Loop1UInt8]->Owner == WindowNumber) && (ActiveScroll[Loop1UInt8]->GlyphRow == GlyphRow)) break;
+
+    if (Loop1UInt8 == MAX_ACTIVE_SCROLL)
+    {
+      if (DebugBitMask & DEBUG_SCROLL) uart_send(__LINE__, __func__, "Text <%s> does not fit in window %u (%s) (%u pixels), scrolling it\r", String, WindowNumber, Window[WindowNumber].Name, Layout.PixelLength);
+      win_scroll(WindowNumber, StartRow, StartRow, 1, SCROLL_SPEED_DEFAULT, FontType, "%s", String);
+    }
+
+    return EndColumn + 1;
+  }
+
+  return layout_print(FrameBuffer, GlyphRow, FontType, String, &Layout);
+}
+
+
+
+
+
 /* ============================================================================================================================================================ *\
                                                   Scroll the text in the specified window, on the specified line.
                                               Return the number of the ScrollNumber structure that has been assigned.
+                              Return MAX_ACTIVE_SCROLL if no scroll slot is free or if the message ring of the scroll is full.
+                            ScrollSpeed is given in pixels per second (0 selects SCROLL_SPEED_DEFAULT). See callback_scroll_timer().
+                     Each line of a window is a separate scroll region, clipped to the window and moving concurrently with the others (see scroll_compose()).
 \* ============================================================================================================================================================ */
 UINT8 win_scroll(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow, UINT16 ScrollTimes, UINT8 ScrollSpeed, UINT8 FontType, UCHAR *Format, ...)
 {
-  UCHAR ScrollString[1024];
+  UCHAR ScrollString[MAX_SCROLL_TEXT];
 
-  UINT8 FirstFree;
+  UINT8 GlyphRow;
   UINT8 Loop1UInt8;
   UINT8 ScrollNumber;
   UINT8 StartColumn;
@@ -19027,17 +22391,31 @@ UINT8 win_scroll(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow, UINT16 Scroll
   va_list argp;
 
 
-  /* Check if there is already an active scroll for target window and target line, and also keep track of first free structure in case it is required below. */
+  /* Validate provided coordinates. */
+  StartColumn =  0;  // dummy
+  EndColumn   = 63;  // dummy
+  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
+  GlyphRow = StartRow;
+
+  /* Clip the scroll region to the target window. */
+  if (scroll_region(WindowNumber, &StartRow, &EndRow, &StartColumn, &EndColumn) == FLAG_OFF)
+  {
+    if (DebugBitMask & DEBUG_SCROLL) uart_send(__LINE__, __func__, "Scroll region is outside of window %u (%s), scroll request dropped\r", WindowNumber, Window[WindowNumber].Name);
+
+    return MAX_ACTIVE_SCROLL;
+  }
+
+
+  /* Check if there is already an active scroll for target window and target line. */
   /* NOTE: If we append more text to a currently active scrolling, font type can't be change from what it was on the first call. */
-  FirstFree    = MAX_ACTIVE_SCROLL;  // assign invalid value on entry.
   ScrollNumber = MAX_ACTIVE_SCROLL;  // assign invalid value on entry.
 
   for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ACTIVE_SCROLL; ++Loop1UInt8)
   {
     if (ActiveScroll[Loop1UInt8] != 0x00l)
     {
-      /* This scroll structure has been allocated, check who's the owner. */
-      if (ActiveScroll[Loop1UInt8]->Owner == WindowNumber)
+      /* This scroll structure has been allocated, check who's the owner (and which region of the window it scrolls). */
+      if ((ActiveScroll[Loop1UInt8]->Owner == WindowNumber) && (ActiveScroll[Loop1UInt8]->GlyphRow == GlyphRow))
       {
         /* This scroll structure is already allocated to the target window. */
         ScrollNumber = Loop1UInt8;
@@ -19046,71 +22424,73 @@ UINT8 win_scroll(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow, UINT16 Scroll
         break;
       }
     }
-    else
-    {
-      /* This active scroll structure has not already been assigned.
-         Keep track of first free active scroll structure in case no active scroll has already been assigned to the target window. */
-      if (FirstFree == MAX_ACTIVE_SCROLL) FirstFree = Loop1UInt8;
-    }
   }
 
 
 
-  /* If no active scroll has been already assigned to this window, use first free active scroll structure found. */
+  /* If no active scroll has been already assigned to this window, take a free slot from the scroll pool. */
   if (ScrollNumber == MAX_ACTIVE_SCROLL)
   {
     /* This is the first scroll request for this target window. */
-    ScrollNumber = FirstFree;
-    ActiveScroll[ScrollNumber] = (struct active_scroll *)calloc(1, sizeof(struct active_scroll));
+    ScrollNumber = scroll_pool_acquire();
+    if (ScrollNumber == MAX_ACTIVE_SCROLL)
+    {
+      if (DebugBitMask & DEBUG_SCROLL) uart_send(__LINE__, __func__, "No free scroll slot for window %u (%s), scroll request dropped\r", WindowNumber, Window[WindowNumber].Name);
+
+      return MAX_ACTIVE_SCROLL;
+    }
 
     if (DebugBitMask & DEBUG_SCROLL)
     {
       uart_send(__LINE__, __func__, "After scanning active scroll structures, ScrollNumber: %u has been assigned to window %u (%s) for this scroll\r", ScrollNumber, WindowNumber, Window[WindowNumber].Name);
-      uart_send(__LINE__, __func__, "Memory allocation returned pointer: 0x%p   size of active_scroll structure: %u (0x%4.4X)\r", ActiveScroll[ScrollNumber], sizeof(struct active_scroll), sizeof(struct active_scroll));
+      uart_send(__LINE__, __func__, "Scroll pool slot: 0x%p   size of active_scroll structure: %u (0x%4.4X)\r", ActiveScroll[ScrollNumber], sizeof(struct active_scroll), sizeof(struct active_scroll));
     }
   }
 
 
   /* Transfer the text to print to variable <ScrollString>. */
   va_start(argp, Format);
-  vsnprintf(ScrollString, sizeof(ScrollString), Format, argp);
+  vsnprintf(ScrollString, sizeof(ScrollString) - SCROLL_TRAILER, Format, argp);
   va_end(argp);
 
+  /* Add spaces at the end of current text in case some more text is added later,
+     or in case we asked for more than one cycle (to split apart repeat cycles and make it more readable). */
+  strcat(ScrollString, "        ");
+
   if (DebugBitMask & DEBUG_SCROLL)
   {
-    uart_send(__LINE__, __func__, "Length of new string being added to scroll:     %3u\r", strlen(ScrollString));
-    uart_send(__LINE__, __func__, "Length of currently scrolling string:           %3u (before adding new string)\r", strlen(ActiveScroll[ScrollNumber]->Message));
+    uart_send(__LINE__, __func__, "Length of new string being added to scroll:     %3u (including 8 trailing spaces)\r", strlen(ScrollString));
+    uart_send(__LINE__, __func__, "Length of currently scrolling text:              %3u (before adding new string)\r", (UINT16)(ActiveScroll[ScrollNumber]->TextHead - ActiveScroll[ScrollNumber]->TextStart));
   }
 
 
-  /* Validate provided coordinates. */
-  StartColumn =  0;  // dummy
-  EndColumn   = 63;  // dummy
-  RGB_matrix_check_coord(&StartRow, &StartColumn, &EndRow, &EndColumn);
+  /* Append current text at the end of any eventual text currently scrolling (in the text ring). The scroll engine renders it to pixel columns.
+     Back-pressure: if the text ring has not enough free space left for this text, it is refused as a whole. The caller may try
+     again later, once the scroll engine has reclaimed the characters already scrolled (see scroll_text_free()). */
+  if (scroll_text_put(ScrollNumber, ScrollString) == FLAG_OFF)
+  {
+    if (DebugBitMask & DEBUG_SCROLL) uart_send(__LINE__, __func__, "Text ring of scroll %u is full (%u characters free), text dropped\r", ScrollNumber, scroll_text_free(ScrollNumber));
+
+    /* Give back a slot that has just been acquired for this text (its owner has not been set yet). */
+    if (ActiveScroll[ScrollNumber]->Owner == SCROLL_OWNER_NONE) scroll_pool_release(ScrollNumber);
+
+    return MAX_ACTIVE_SCROLL;
+  }
 
 
+  ActiveScroll[ScrollNumber]->GlyphRow           = GlyphRow;
   ActiveScroll[ScrollNumber]->StartRow           = StartRow;
   ActiveScroll[ScrollNumber]->EndRow             = EndRow;
+  ActiveScroll[ScrollNumber]->StartColumn        = StartColumn;
+  ActiveScroll[ScrollNumber]->EndColumn          = EndColumn;
+  ActiveScroll[ScrollNumber]->ColumnMask         = RGB_matrix_span_mask(StartColumn, EndColumn);
   ActiveScroll[ScrollNumber]->FontType           = FontType;
   ActiveScroll[ScrollNumber]->ScrollTimes        = ScrollTimes - 1;  // first scroll is automatic and not accounted for in the total.
-  ActiveScroll[ScrollNumber]->ScrollSpeed        = ScrollSpeed;
-  ActiveScroll[ScrollNumber]->PixelCountCurrent  = MAX_COLUMNS;      // number of pixels remaining to scroll on LED matrix.
-  ActiveScroll[ScrollNumber]->PixelCountBuffer   = 0;                // number of pixels remaining to scroll in bitmap buffer.
-  ActiveScroll[ScrollNumber]->AsciiBufferPointer = 0;                // pointer to next character to be scrolled in ASCII buffer.
-
-
-  /* Add current text to be scrolled at the end of any eventual message currently scrolling (in ASCII scroll buffer). */
-  strcat(ActiveScroll[ScrollNumber]->Message, ScrollString);
-
-  /* Add spaces at the end of current text in case some more text is added later,
-     or in case we asked for more than one cycle (to split apart repeat cycles and make it more readable). */
-  strcat(ActiveScroll[ScrollNumber]->Message, "        ");
+  ActiveScroll[ScrollNumber]->ScrollSpeed        = (ScrollSpeed == 0) ? SCROLL_SPEED_DEFAULT : ScrollSpeed;  // pixels per second.
+  ActiveScroll[ScrollNumber]->PixelCountCurrent  = EndColumn - StartColumn + 1;  // number of pixels remaining to scroll on LED matrix.
 
   if (DebugBitMask & DEBUG_SCROLL)
-  {
-    uart_send(__LINE__, __func__, "ActiveScroll[%u]->Message: (length: %u   including 8 trailing spaces)\r\r\r", ScrollNumber, strlen(ActiveScroll[ScrollNumber]->Message));
-    /// uart_send(__LINE__, __func__, "ActiveScroll[%u]->Message: <%s>\r\r\r",     ScrollNumber, ActiveScroll[ScrollNumber]->Message);
-  }
+    uart_send(__LINE__, __func__, "ActiveScroll[%u]->Text: (length: %u characters   including 8 trailing spaces)\r\r\r", ScrollNumber, (UINT16)(ActiveScroll[ScrollNumber]->TextHead - ActiveScroll[ScrollNumber]->TextStart));
 
   /// display_scroll();  // should not be used in a callback context.
 
@@ -19119,7 +22499,9 @@ UINT8 win_scroll(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow, UINT16 Scroll
   if ((StartRow >= 18) && (EndRow <= 31)) Window[WindowNumber].FlagBotScroll = FLAG_ON;
 
   /* IMPORTANT: Owner assignation must be done at the end since this is what triggers RGB_matrix_scroll() and
-                we want to make sure that all other parameters have already been properly setup before doing so.*/
+                we want to make sure that all other parameters have already been properly setup before doing so.
+                Scrolling runs on core 1, so the memory barrier makes all the above visible to core 1 before Owner. */
+  __dmb();
   ActiveScroll[ScrollNumber]->Owner = WindowNumber;  // owner of this active scroll.
 
   return ScrollNumber;
@@ -19159,7 +22541,7 @@ void win_scroll_cancel(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow)
       /* This scroll structure has been allocated, check who's the owner. */
       if (ActiveScroll[Loop1UInt8]->Owner == WindowNumber)
       {
-        if (ActiveScroll[Loop1UInt8]->StartRow == StartRow)
+        if (ActiveScroll[Loop1UInt8]->GlyphRow == StartRow)
         {
           /* This scroll structure is allocated to the target window. */
           ScrollNumber = Loop1UInt8;
@@ -19182,8 +22564,12 @@ void win_scroll_cancel(UINT8 WindowNumber, UINT8 StartRow, UINT8 EndRow)
   /* If there is no active scroll for this window... */
   if (Loop1UInt8 == MAX_ACTIVE_SCROLL) return;
 
-  /* Overwrite current remaining string in the scroll buffer by a few spaces in preparation for an eventual new message to come. */
-  sprintf(ActiveScroll[ScrollNumber]->Message, "    ");
+  /* Ask the scroll engine to drop the text remaining in the text ring, and add a few spaces in preparation for an eventual new message to come.
+     The text pending is dropped by the scroll engine itself, since it is the only one allowed to move TextTail. */
+  ActiveScroll[ScrollNumber]->TextFlush = ActiveScroll[ScrollNumber]->TextHead;
+  __dmb();
+  ActiveScroll[ScrollNumber]->FlagFlush = FLAG_ON;
+  scroll_text_put(ScrollNumber, "    ");
 
   return;
 }
@@ -19206,10 +22592,9 @@ void win_scroll_off(UINT8 ScrollNumber)
 
   if (ActiveScroll[ScrollNumber])
   {
-    /* Release memory used for specified scroll number. */
-    if (DebugBitMask & DEBUG_SCROLL) uart_send(__LINE__, __func__, "Releasing memory at 0x%p used for ScrollNumber: %u (%s)\r", ActiveScroll[ScrollNumber], ScrollNumber, Window[ActiveScroll[ScrollNumber]->Owner].Name);
-    free(ActiveScroll[ScrollNumber]);
-    ActiveScroll[ScrollNumber] = 0x00;  // assign a NULL pointer now that memory has been released.
+    /* Give back the scroll pool slot used for specified scroll number. */
+    if (DebugBitMask & DEBUG_SCROLL) uart_send(__LINE__, __func__, "Releasing scroll slot 0x%p used for ScrollNumber: %u (%s)\r", ActiveScroll[ScrollNumber], ScrollNumber, Window[ActiveScroll[ScrollNumber]->Owner].Name);
+    scroll_pool_release(ScrollNumber);  // ActiveScroll[ScrollNumber] becomes a NULL pointer.
   }
   else
   {
@@ -52,6 +52,11 @@ typedef uint64_t      UINT64;
 #define TYPE_PICOW                0x02      // microcontroller is a Pico W
 
 #define AIRCR_Register (*((volatile UINT32 *)(PPB_BASE + 0x0ED0C)))
+
+/* RGB matrix dimensions (also used to size some of the flash configuration data below). */
+#define MAX_COLUMNS         64  // total number of pixel columns on RGB matrix.
+#define MAX_ROWS            32  // total number of pixel rows    on RGB matrix.
+#define HALF_ROWS        (MAX_ROWS / 2)     // for color setting, RGB matrix is splitted in two sections (Top part: rows 0 to 15 and Bottom part: rows 16 to 31).
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                                    End of general definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
@@ -91,7 +96,7 @@ typedef uint64_t      UINT64;
 #define DEBUG_WATCHDOG    0x0000000000400000  // debug watchdog behavior.
 #define DEBUG_WIFI        0x0000000000800000  // debug WiFi communications.
 #define DEBUG_WINDOW      0x0000000001000000  // debug window algorithm.
-// #define DEBUG_ 0x0000000002000000  //
+#define DEBUG_TASK        0x0000000002000000  // debug main loop periodic tasks (late or over budget).
 // #define DEBUG_ 0x0000000004000000  //
 // #define DEBUG_ 0x0000000008000000  //
 // #define DEBUG_ 0x0000000010000000  //
@@ -138,6 +143,26 @@ typedef uint64_t      UINT64;
 
 
 
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                     Benchmark related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+#define BENCHMARK_ITERATIONS           1000  // number of calls timed for each benchmarked function.
+#define BENCHMARK_WIN_OPEN_ITERATIONS    50  // number of window transitions timed, from win_open() to their last keyframe.
+
+/* Benchmark time base in nanoseconds: microsecond timer on target, monotonic wall clock on host since sleep_ms() is simulated there. */
+#ifdef HOST_SIMULATOR
+#define BENCHMARK_NSEC()  host_time_nsec()
+#else  // HOST_SIMULATOR
+#define BENCHMARK_NSEC()  (time_us_64() * 1000ll)
+#endif  // HOST_SIMULATOR
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                 End of benchmark related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+
+
+
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                                Brightness control related definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
@@ -179,6 +204,35 @@ struct pwm
 
 
 
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                    Single-producer / single-consumer ring buffer related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+/* Generic lock-free ring buffer used by all queues shared between interrupt contexts and / or cores (see ring_put()).
+   Head and Tail are free-running indices: the ring is empty when they are equal and full when they are "Size" elements apart,
+   so that no slot is lost. The number of elements must be a power of two so that indices wrap with a simple mask. */
+struct ring
+{
+  volatile UINT16 Head;                       // free-running write index, only written by the producer.
+  volatile UINT16 Tail;                       // free-running read index, only written by the consumer.
+  volatile UINT16 Overflow;                   // elements dropped because the ring was full (only written by the producer).
+  UINT16 Mask;                                // number of elements minus one.
+  UINT16 ElementSize;                         // size of one element, in bytes.
+  UINT8  *Element;                            // storage provided by the owner of the ring.
+};
+
+/* Static initializer of a ring buffer over the given storage array. */
+#define RING_INITIALIZER(Storage, Count)  {0, 0, 0, (Count) - 1, sizeof((Storage)[0]), (UINT8 *)(Storage)}
+
+/* Ring buffer sizes must be a power of two. */
+#define RING_SIZE_INVALID(Count)  (((Count) == 0) || ((Count) > 0x8000) || ((Count) & ((Count) - 1)))
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                 End of single-producer / single-consumer ring buffer related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+
+
+
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                                   Button specific definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
@@ -196,6 +250,10 @@ struct pwm
 #define BUTTON_UP_LONG     0x06
 
 #define BUTTON_BUFFER_SIZE   10
+#define BUTTON_RING_SIZE      8  // button presses waiting for ButtonBuffer[0] to be free (must be a power of two).
+#if RING_SIZE_INVALID(BUTTON_RING_SIZE)
+#error BUTTON_RING_SIZE must be a power of two.
+#endif
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                                End of button specific definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
@@ -204,6 +262,38 @@ struct pwm
 
 
 
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                              Callback statistics related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+#define CALLBACK_SCAN          0  // matrix scan callback (one call per scan row).
+#define CALLBACK_50MSEC        1  // infrared, scroll and buzzer callback.
+#define CALLBACK_1000MSEC      2  // date and time, brightness and chimes callback.
+#define CALLBACK_SCROLL        3  // scroll tick callback.
+#define MAX_CALLBACK_STATS     4
+
+#define CALLBACK_BUCKETS      20  // duration histogram: bucket n counts durations from 2^(n-1) to (2^n) - 1 usec (bucket 0 is under 1 usec).
+#define CALLBACK_LATE_PERCENT 25  // a callback starting later than this percentage of its period is counted as late.
+
+struct callback_stat
+{
+  UINT32 Count;                        // number of calls since last reset.
+  UINT32 LateCount;                    // number of calls that started later than expected.
+  UINT32 OverrunCount;                 // number of calls that lasted longer than their period.
+  UINT32 MinUSec;                      // shortest duration.
+  UINT32 MaxUSec;                      // longest duration.
+  UINT32 PeriodUSec;                   // period expected before next call.
+  UINT64 TotalUSec;                    // cumulative duration (for average).
+  UINT64 LastStart;                    // start time of last call.
+  UINT32 Histogram[CALLBACK_BUCKETS];  // power-of-two duration histogram (for percentiles).
+};
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                           End of callback statistics related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+
+
+
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                                        Color definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
@@ -215,6 +305,14 @@ struct pwm
 #define MAGENTA    0x05
 #define YELLOW     0x06
 #define WHITE      0x07
+
+/* Index of each color bit-plane in ColorPlane[]. */
+#define PLANE_RED     0
+#define PLANE_GREEN   1
+#define PLANE_BLUE    2
+
+/* 24-bit color (0x00RRGGBB) used by RGB_matrix_set_color_rgb() when built with BCM_SUPPORT. */
+#define RGB_COLOR(Red, Green, Blue)  (((UINT32)(Red) << 16) | ((UINT32)(Green) << 8) | (UINT32)(Blue))
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                                     End of color definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
@@ -511,7 +609,7 @@ struct flash_config1
   UINT16 Variable16FuturUse4;      // placeholder 16-bits variable reserved for future use.
   UINT16 Variable16FuturUse3;      // placeholder 16-bits variable reserved for future use.
   UINT16 Variable16FuturUse2;      // placeholder 16-bits variable reserved for future use.
-  UINT16 Variable16FuturUse1;      // placeholder 16-bits variable reserved for future use.
+  UINT16 RowDwellUSec;             // matrix scan row dwell time in microseconds (ROW_DWELL_MIN to ROW_DWELL_MAX).
   UINT32 Variable32FuturUse2;      // placeholder 32-bits variable reserved for future use.
   UINT32 Variable32FuturUse1;      // placeholder 32-bits variable reserved for future use.
   UCHAR  SSID[40];                 // SSID for Wi-Fi network. Note: SSID begins at position 5 of the variable string, so that a "footprint" can be confirmed prior to writing to flash.
@@ -520,7 +618,8 @@ struct flash_config1
   UINT8  FlagDisplayAlarmDays;     // flag indicating that we want to show days with an active alarms on LED matrix.
   struct alarm Alarm[MAX_ALARMS];  // Alarm 0 to 8 parameters (numbered 1 to 9 for clock users).
   struct auto_scroll AutoScroll[MAX_AUTO_SCROLLS];  // items to scroll automatically and periodically on the RGB-Matrix.
-  UINT8  Reserved[145];            // reserve the rest of this flash sector space for future use.
+  INT8   RowTrim[HALF_ROWS];       // per scan row on-time trim, in percent of row dwell time (-ROW_TRIM_MAX to +ROW_TRIM_MAX).
+  UINT8  Reserved[129];            // reserve the rest of this flash sector space for future use.
   struct event Event[MAX_EVENTS];  // calendar events.
   UINT16 Crc16;                    // crc16 of all data above to validate configuration.
 }FlashConfig1;
@@ -624,6 +723,105 @@ struct function
 
 
 
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                         Main loop events and load related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+#define LOOP_WINDOW_USEC 1000000  // busy / idle times are sampled over this window to update the load averages.
+
+#define LOOP_EVENT_NONE        0  // no event pending.
+#define LOOP_EVENT_BUTTON      1  // local button press handed over to ButtonBuffer[0].
+#define LOOP_EVENT_IR          2  // remote control button decoded and handed over to IrBuffer[0].
+#define LOOP_EVENT_TERMINAL    3  // character(s) received from external terminal.
+#define MAX_LOOP_EVENTS       16  // size of the event ring buffer (must be a power of two).
+#if RING_SIZE_INVALID(MAX_LOOP_EVENTS)
+#error MAX_LOOP_EVENTS must be a power of two.
+#endif
+
+struct loop_event
+{
+  UINT8 Type;                                 // source of the wakeup (LOOP_EVENT_BUTTON, LOOP_EVENT_IR or LOOP_EVENT_TERMINAL).
+};
+
+struct loop_stat
+{
+  UINT32 WindowBusyUSec;                      // busy time accumulated in current sampling window.
+  UINT32 WindowIdleUSec;                      // idle time accumulated in current sampling window.
+  UINT32 Iterations;                          // number of loop iterations since last reset.
+  UINT32 MaxIterationUSec;                    // longest busy time of a single loop iteration.
+  UINT32 MissedSeconds;                       // number of seconds missed by the 1-second timestep (iteration busy for more than one second).
+  UINT64 TotalBusyUSec;                       // cumulative busy time since last reset.
+  UINT64 TotalIdleUSec;                       // cumulative idle time since last reset.
+  float  LoadLast;                            // load (percent busy) over last sampling window.
+  float  Load1Min;                            // exponentially decayed load averages (percent busy).
+  float  Load5Min;
+  float  Load15Min;
+};
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                      End of main loop events and load related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                              Core-to-core channel related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+/* Startup steps sent from core 0 to core 1 through the SIO FIFO. */
+#define CORE1_START_50MSEC     1  // core 1 may start the 50 msec callback (infrared, sound queue) and the scroll tick callback.
+#define CORE1_START_INPUTS     2  // core 1 may enable IR sensor and local buttons interrupts.
+
+/* Commands sent from core 0 to core 1 through the shared memory channel. */
+#define CORE_CMD_NONE          0  // no command pending.
+#define CORE_CMD_SOUND         1  // queue a sound in the active buzzer sound queue (Param1 = msec, Param2 = repeat count).
+#define MAX_CORE_CHANNEL      32  // size of the core 0 to core 1 ring buffer (must be a power of two).
+#if RING_SIZE_INVALID(MAX_CORE_CHANNEL)
+#error MAX_CORE_CHANNEL must be a power of two.
+#endif
+
+struct core_message
+{
+  UINT8  Command;
+  UINT16 Param1;
+  UINT16 Param2;
+};
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                               End of core-to-core channel related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                           Main loop periodic tasks scheduler related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+#define MAX_TASKS             12  // maximum number of periodic tasks that may be registered.
+
+#define TASK_PRIORITY_HIGH     0  // tasks keeping the system healthy (watchdog, pilot).
+#define TASK_PRIORITY_NORMAL   1  // user-visible tasks (auto-scrolls, NTP).
+#define TASK_PRIORITY_LOW      2  // housekeeping and debug tasks.
+
+#define TASK_LATE_USEC    100000  // a task starting later than this after its deadline is counted as late.
+
+struct task
+{
+  UCHAR  Name[10];
+  void   (*Pointer)(void);                    // function to execute.
+  UINT8  Priority;                            // TASK_PRIORITY_HIGH to TASK_PRIORITY_LOW.
+  UINT32 PeriodUSec;                          // period between two executions.
+  UINT32 BudgetUSec;                          // expected maximum execution time.
+  UINT64 Deadline;                            // time of next execution.
+  UINT32 Count;                               // number of executions since last reset.
+  UINT32 LateCount;                           // number of executions that started later than TASK_LATE_USEC.
+  UINT32 MaxLateUSec;                         // worst start delay.
+  UINT32 OverBudgetCount;                     // number of executions that lasted longer than the budget.
+  UINT32 LastUSec;                            // execution time of last execution.
+  UINT32 MaxUSec;                             // longest execution time.
+  UINT64 TotalUSec;                           // cumulative execution time (for average).
+};
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                      End of main loop periodic tasks scheduler related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                            Queues (circular buffers) related definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
@@ -646,6 +844,10 @@ struct function
 /* List or commands available with remote control. */
 #define MAX_IR_READINGS           500  // maximum number of "logic level changes" while receiving data from IR remote control.
 #define IR_BUFFER_SIZE             10  // buffer size for commands received from remote control.
+#define IR_RING_SIZE                8  // remote control buttons waiting for IrBuffer[0] to be free (must be a power of two).
+#if RING_SIZE_INVALID(IR_RING_SIZE)
+#error IR_RING_SIZE must be a power of two.
+#endif
 #define IR_INDICATOR_START_ROW     18  // infrared burst reception indicator on RGB matrix.
 #define IR_INDICATOR_END_ROW       19  // infrared burst reception indicator on RGB matrix.
 #define IR_INDICATOR_START_COLUMN  29  // infrared burst reception indicator on RGB matrix.
@@ -686,15 +888,45 @@ struct function
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                                   RGB matrix specific definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
-#define HALF_ROWS        (MAX_ROWS / 2)     // for color setting, RGB matrix is splitted in two sections (Top part: rows 0 to 15 and Bottom part: rows 16 to 31).
 #define Matrix_COLS_BYTE (MAX_COLUMNS / 8)  // total number of "sectors" per row.
 #define SECTORS_PER_ROW      8  // number of sectors (8 bits representing 8 pixels) per row.
 
-#define MAX_COLUMNS         64  // total number of pixel columns on RGB matrix.
-#define MAX_ROWS            32  // total number of pixel rows    on RGB matrix.
+#define MATRIX_ALL_ROWS     0xFFFFFFFF  // row bitmask flagging all matrix rows (bit 0 = row 0).
 
 #define FRAMEBUFFER_SIZE   256  // bitmap corresponding to bits that are turned on on RGB matrix (color is managed independantly.)
 
+/* "Wire format" of one column: bit 0 drives GPIO 2 (R1) up to bit 7 driving GPIO 9 (B2). GPIO 6 and 7 (I2C) are never driven. */
+#define WIRE_DATA_MASK   ((1 << R1) | (1 << G1) | (1 << B1) | (1 << R2) | (1 << G2) | (1 << B2))
+#define WIRE_DATA_SHIFT  R1
+
+/* PIO / DMA matrix scan engine (when built with PIO_SCAN_SUPPORT). */
+#define PIO_CLOCK_DIVIDER  5.0  // PIO state machines run at 25 MHz (125 MHz / 5), giving a 12.5 MHz matrix clock.
+#define PIO_DWELL_UNIT       8  // number of state machine cycles per unit of "on" / "off" time in row control words.
+#define PIO_DWELL_MAX     4096  // maximum number of units for "on" / "off" time (12 bits).
+
+/* Matrix scan rate. Full frame refresh period is HALF_ROWS x row dwell time (16 x 250 usec = 4 msec, or 250 Hz). */
+#define ROW_DWELL_DEFAULT  250  // default number of microseconds each scan row is displayed.
+#define ROW_DWELL_MIN      100  // shortest row dwell time (bit-banged scan takes a good part of it).
+#define ROW_DWELL_MAX      500  // longest  row dwell time (125 Hz full frame refresh).
+#define ROW_TRIM_MAX        50  // per-row on-time trim limit, in percent of row dwell time (-50 to +50).
+
+/* Binary-coded modulation (when built with BCM_SUPPORT). Each color channel bit is displayed as a bitplane whose dwell time
+   is twice the one of the previous bitplane. Row dwell time is shared among bitplanes, so that refresh rate remains the same. */
+#define BCM_DEPTH            5  // number of bits per color channel (4 to 6).
+#define BCM_LSB_DWELL_USEC   8  // shortest dwell time of the least significant bitplane (must not be shorter than the 6 usec needed to shift a row).
+
+#ifdef BCM_SUPPORT
+#define WIRE_PLANES  BCM_DEPTH  // number of bitplanes in WireBuffer.
+#if ((BCM_DEPTH < 4) || (BCM_DEPTH > 6))
+#error BCM_DEPTH must be between 4 and 6.
+#endif
+#if ((MAX_ROWS / 2) * ((1 << BCM_DEPTH) - 1) * BCM_LSB_DWELL_USEC) > 10000
+#error BCM_DEPTH and BCM_LSB_DWELL_USEC would bring matrix refresh rate below 100 Hz.
+#endif
+#else  // BCM_SUPPORT
+#define WIRE_PLANES  1
+#endif  // BCM_SUPPORT
+
 #define BUTTON_BUFFER_SIZE  10
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                                End of RGB matrix specific definitions.
@@ -706,21 +938,56 @@ struct function
                                            Scroll buffer queue related definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
 #define MAX_ACTIVE_SCROLL      10  // maximum number of simulataneous active scrolls.
-#define MAX_MESSAGE_LENGTH   1024  // total length of all ASCII messages queued for scrolling.
+#define MAX_SCROLL_TEXT      1024  // size of the text ring of each active scroll, in characters (must be a power of two). Also the longest text win_scroll() accepts.
+#define SCROLL_OWNER_NONE    0xFF  // owner of a scroll slot that has just been acquired and is not set up yet.
+#define SCROLL_TRAILER          8  // number of spaces added after each text to split apart consecutive texts and repeat cycles.
+
+#define SCROLL_TICK_USEC     5000  // period of the scroll tick callback (independent of the 50 msec callback).
+#define SCROLL_TICK_HZ       (1000000 / SCROLL_TICK_USEC)
+#define SCROLL_SPEED_DEFAULT   20  // default scroll speed in pixels per second (speed of the 50 msec callback that used to drive scrolling).
+#define SCROLL_SPEED_FAST      40  // scroll speed in pixels per second for long texts that must be read quickly (alarms).
+#if RING_SIZE_INVALID(MAX_SCROLL_TEXT)
+#error MAX_SCROLL_TEXT must be a power of two.
+#endif
+
+#define STRIP_GLYPH_COLUMNS    16  // maximum number of pixel columns of one character in the glyph strip.
+#define STRIP_ROWS             16  // maximum number of rows of a scroll that may receive glyph pixels (bits of a strip column).
 
 struct active_scroll
 {
   UINT8  Owner;                 // window ID of the owner of this active scroll.
-  UINT8  StartRow;              // start row to be scrolled (0 - 31).
-  UINT8  EndRow;                // end row to be scrolled (0 - 31).
+  UINT8  GlyphRow;              // matrix row of the top of the glyphs, as requested by win_scroll() (identifies the scroll region in its window).
+  UINT8  StartRow;              // start row to be scrolled (0 - 31), clipped to the owner window.
+  UINT8  EndRow;                // end row to be scrolled (0 - 31), clipped to the owner window.
+  UINT8  StartColumn;           // start column to be scrolled (0 - 63), clipped to the owner window.
+  UINT8  EndColumn;             // end column to be scrolled (0 - 63), where pixel columns are shifted in.
+  UINT64 ColumnMask;            // bitmask of the columns to be scrolled (pixels outside, like box borders, are left untouched).
   UINT8  FontType;              // font type to be scrolled.
   UINT8  ScrollTimes;           // number of times to scroll the text message.
-  UINT8  ScrollSpeed;           // relative scroll speed to slide pixels left.
+  UINT8  ScrollSpeed;           // scroll speed in pixels per second.
+  UINT16 SpeedAccumulator;      // fraction of pixel accumulated at each scroll tick (in 1 / SCROLL_TICK_HZ pixel units).
   INT16  PixelCountCurrent;     // number of pixels remaining to scroll on LED matrix.
-  UINT16 PixelCountBuffer;      // number of pixels remaining to scroll in bitmap buffer.
-  UINT16 AsciiBufferPointer;    // pointer to next character to be scrolled in ASCII buffer.
-  UINT64 BitmapBuffer[MAX_ROWS];       // temporary bitmap buffer between "Message" text and actual bitmap FrameBuffer.
-  UCHAR  Message[MAX_MESSAGE_LENGTH];  // message text to be scrolled.
+  volatile UINT16 TextHead;     // free-running index where next text is appended in Text ring (written by win_scroll() only).
+  volatile UINT16 TextTail;     // free-running index of next character to be rendered in Text ring (written by scroll engine only).
+  volatile UINT16 TextStart;    // free-running index of first character kept for repeat cycles. Space before it is reclaimed.
+  volatile UINT16 TextFlush;    // value of TextHead when win_scroll_cancel() has been called.
+  volatile UINT8  FlagFlush;    // flag set by win_scroll_cancel() to ask the scroll engine to drop pending text.
+  UINT16 TextOverflow;          // number of texts refused because the Text ring was full.
+  UINT8  StripColumn;           // next pixel column of Strip to be scrolled in (scroll engine only).
+  UINT8  StripWidth;            // number of pixel columns in Strip.
+  UINT16 Strip[STRIP_GLYPH_COLUMNS];  // pixel columns of the character being scrolled in, rendered by the scroll engine (bit 0 is GlyphRow).
+  UCHAR  Text[MAX_SCROLL_TEXT];       // ring of text to be scrolled.
+};
+
+struct scroll_pool
+{
+  UINT8  FreeCount;                            // number of free slots on the FreeSlot stack.
+  UINT8  FreeSlot[MAX_ACTIVE_SCROLL];          // stack of free slot numbers.
+  UINT8  InUse;                                // number of slots currently in use.
+  UINT8  HighWater;                            // maximum number of slots used at the same time.
+  UINT32 AcquireCount;                         // number of slots acquired since power-up.
+  UINT32 ExhaustedCount;                       // number of scroll requests refused because all slots were in use.
+  struct active_scroll Slot[MAX_ACTIVE_SCROLL];
 };
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                          End of scroll buffer queue related definitions.
@@ -728,25 +995,61 @@ struct active_scroll
 
 
 
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                               Text layout related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+#define LAYOUT_LEFT          0x00  // text begins on the start column of the layout range.
+#define LAYOUT_CENTER        0x01  // text is centered in the layout range.
+#define LAYOUT_RIGHT         0x02  // text ends on the end column of the layout range.
+#define LAYOUT_ALIGN         0x03  // bitmask of the alignment in layout flags.
+#define LAYOUT_ELLIPSIS      0x10  // text that does not fit is cut after the last character that fits, followed by LAYOUT_ELLIPSIS_TEXT.
+#define LAYOUT_SCROLL        0x20  // text that does not fit is scrolled instead (standard window lines 201 to 203 only, see win_printf_layout()).
+
+#define LAYOUT_CACHE_ENTRIES    8  // number of layout results kept in the layout cache.
+#define LAYOUT_CACHE_TEXT      48  // longest text whose layout may be kept in the layout cache.
+#define LAYOUT_ELLIPSIS_TEXT  ".."  // appended to text cut by LAYOUT_ELLIPSIS (two dots only, matrix columns are precious).
+
+struct layout
+{
+  UINT8  Column;                               // matrix column of the first character.
+  UINT8  Length;                               // number of characters of the text that fit in the layout range (break point).
+  UINT8  FlagEllipsis;                         // flag indicating that LAYOUT_ELLIPSIS_TEXT must be displayed after the first <Length> characters.
+  UINT8  FlagOverflow;                         // flag indicating that the whole text does not fit in the layout range.
+  UINT16 PixelLength;                          // pixel width of the whole text.
+};
+
+struct layout_cache
+{
+  UINT32 Hash;                                 // hash of Text, to quickly skip entries that do not match.
+  UINT32 LastUse;                              // value of LayoutCacheClock when this entry has been used for the last time (0 when this entry is free).
+  UINT8  FontType;                             // font type used to measure Text.
+  UINT8  StartColumn;                          // start column of the layout range.
+  UINT8  EndColumn;                            // end column of the layout range.
+  UINT8  Flags;                                // layout flags (alignment and overflow handling).
+  UCHAR  Text[LAYOUT_CACHE_TEXT];              // text that has been laid out.
+  struct layout Layout;                        // layout result.
+};
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                            End of text layout related definitions.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                               Active sound queue related definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
 #define SILENT  0
 
-#define MAX_ACTIVE_SOUND_QUEUE  100       // maximum number of "sounds" in the active buzzer sound queue.
+#define MAX_ACTIVE_SOUND_QUEUE  128       // maximum number of "sounds" in the active buzzer sound queue (must be a power of two).
+#if RING_SIZE_INVALID(MAX_ACTIVE_SOUND_QUEUE)
+#error MAX_ACTIVE_SOUND_QUEUE must be a power of two.
+#endif
 
 struct queue_active_sound_element
 {
   UINT16 MSec;
   UINT16 RepeatCount;
 };
-
-struct queue_active_sound
-{
-  volatile UINT8 Head;
-  volatile UINT8 Tail;
-  struct queue_active_sound_element Element[MAX_ACTIVE_SOUND_QUEUE];
-};
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                           End of active sound queue related definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
@@ -797,6 +1100,9 @@ struct queue_active_sound
 
 #define OE_HIGH   gpio_put(OE, 1)
 #define OE_LOW    gpio_put(OE, 0)
+
+#define OE_BLANK    gpio_set_outover(OE, GPIO_OVERRIDE_HIGH)    // force OE High (matrix blanked) while brightness PWM keeps running.
+#define OE_UNBLANK  gpio_set_outover(OE, GPIO_OVERRIDE_NORMAL)  // give OE back to brightness PWM.
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                End of RGB matrix scanning and color latching related definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
@@ -828,6 +1134,22 @@ struct queue_active_sound
 #define ACTION_ERASE 0
 #define ACTION_DRAW  1
 
+/* Transition effects when opening a window (animated by the scroll tick, see transition_tick()). */
+#define TRANSITION_NONE        0  // window content appears at once.
+#define TRANSITION_EXPLODE     1  // box "exploding" from the center of the window (original win_open() animation).
+#define TRANSITION_SLIDE_UP    2  // new content pushes previous content up, one pixel row at a time.
+#define TRANSITION_SLIDE_DOWN  3  // new content pushes previous content down, one pixel row at a time.
+#define TRANSITION_WIPE        4  // new content replaces previous content from left to right, one pixel column at a time.
+#define TRANSITION_DISSOLVE    5  // new content replaces previous content pixel by pixel, in pseudo-random order.
+
+#define MAX_TRANSITIONS             4     // maximum number of window transitions animated at the same time.
+#define TRANSITION_MAX_FRAMES      64     // maximum number of "exploding" boxes recorded for TRANSITION_EXPLODE.
+#define TRANSITION_DISSOLVE_FRAMES 16     // number of keyframes of TRANSITION_DISSOLVE.
+#define TRANSITION_EXPLODE_USEC    50000  // duration of each keyframe of TRANSITION_EXPLODE (same pace as the original animation).
+#define TRANSITION_SLIDE_USEC      20000  // duration of each keyframe of TRANSITION_SLIDE_UP and TRANSITION_SLIDE_DOWN.
+#define TRANSITION_WIPE_USEC        5000  // duration of each keyframe of TRANSITION_WIPE.
+#define TRANSITION_DISSOLVE_USEC   40000  // duration of each keyframe of TRANSITION_DISSOLVE.
+
 
 /* Window structure definition. */
 struct window
@@ -849,8 +1171,36 @@ struct window
   UINT8  FlagTopScroll;        // Flag indicating that the Top row is currently scrolling text..
   UINT8  FlagMidScroll;        // Flag indicating that the Mid row is currently scrolling text..
   UINT8  FlagBotScroll;        // Flag indicating that the Bot row is currently scrolling text..
+  UINT8  Transition;           // transition effect when opening this window (TRANSITION_xxx).
   UCHAR  Name[22];             // window name may have 21 characters maximum.
 };
+
+/* Window transition in progress. FrameBuffer and ColorPlane always hold the final content of the window, each keyframe only tells
+   which part of it is shown, and where, over the window content as it was before the transition (see transition_compose()). */
+struct transition
+{
+  volatile UINT8 Effect;                       // effect in progress (TRANSITION_NONE when no transition is in progress).
+  UINT8  WindowNumber;                         // window being opened.
+  UINT8  StartRow;                             // window area covered by the transition.
+  UINT8  StartColumn;
+  UINT8  EndRow;
+  UINT8  EndColumn;
+  UINT8  Frame;                                // current keyframe.
+  UINT8  FrameCount;                           // total number of keyframes.
+  UINT8  TickCount;                            // number of scroll ticks the current keyframe has been displayed.
+  UINT8  TicksPerFrame;                        // number of scroll ticks each keyframe is displayed.
+  UINT8  BoxCount;                             // number of "exploding" boxes (TRANSITION_EXPLODE).
+  UINT8  BorderColor;                          // color of the "exploding" boxes (Overlay pixels).
+  UINT8  Box[TRANSITION_MAX_FRAMES][4];        // top row, left column, bottom row and right column of each "exploding" box.
+  UINT8  SourceRow[MAX_ROWS];                  // for current keyframe, row of Source shown on each matrix row.
+  UINT8  TargetRow[MAX_ROWS];                  // for current keyframe, row of FrameBuffer shown on each matrix row.
+  UINT64 WindowMask;                           // columns of the window.
+  UINT64 SourceMask[MAX_ROWS];                 // for current keyframe, pixels of each matrix row showing previous window content.
+  UINT64 TargetMask[MAX_ROWS];                 // for current keyframe, pixels of each matrix row showing final window content.
+  UINT64 Overlay[MAX_ROWS];                    // for current keyframe, pixels turned On over both ("exploding" box).
+  UINT64 Source[MAX_ROWS];                     // window content displayed when the transition started.
+  UINT64 SourceColor[3][MAX_ROWS];             // color planes of the window content displayed when the transition started (see PLANE_RED).
+};
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                               End of Windows and Box related definitions.
 \* --------------------------------------------------------------------------------------------------------------------------- */
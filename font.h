@@ -34,6 +34,26 @@ struct font8x10
 };
 
 
+/* Kerning pair: spacing adjustment between two consecutive characters (see RGB_matrix_display() and layout_kerning()). */
+struct kerning
+{
+  UINT8  Left;    // character on the left.
+  UINT8  Right;   // character on the right.
+  int8_t Adjust;  // pixel columns added to the blank column between both characters (-1 removes it, characters then touch each other).
+};
+
+
+
+/* Character sets are defined in Pico-RGB-Matrix.c. Other source files (host simulator) only need their declarations. */
+#ifdef FONT_DECLARATIONS_ONLY
+extern const struct font4x7  Font4x7[128];
+extern const struct font5x7  Font5x7[256];
+extern const struct font8x10 Font8x10[128];
+extern const struct kerning  Kerning5x7[];
+extern const struct kerning  Kerning8x10[];
+#else  // FONT_DECLARATIONS_ONLY
+
+
 
 /* --------------------------------------------------------------------------------------------------------------------------- *\
                                                4 X 7 variable-width character set.
@@ -608,6 +628,55 @@ const struct font8x10 Font8x10[128] =
 
 
 
+/* --------------------------------------------------------------------------------------------------------------------------- *\
+                                                    Kerning tables (optional).
+   NOTE: Pairs are sorted by left character, then by right character, and each table ends with a null pair.
+         Only pairs whose facing sides never have pixels on the same row are tightened, so that characters never merge.
+         Digits are never kerned, so that the time keeps the same width (and position) from one second to the next.
+         There is no kerning table for the 4x7 character set.
+\* --------------------------------------------------------------------------------------------------------------------------- */
+const struct kerning Kerning5x7[] =
+{
+  {'F', ',', -1},
+  {'F', '.', -1},
+  {'L', 'T', -1},
+  {'L', 'V', -1},
+  {'L', 'Y', -1},
+  {'P', ',', -1},
+  {'P', '.', -1},
+  {'T', ',', -1},
+  {'T', '.', -1},
+  {'T', 'a', -1},
+  {'T', 'c', -1},
+  {'T', 'e', -1},
+  {'T', 'o', -1},
+  {'T', 's', -1},
+  {'T', 'u', -1},
+  {'V', '.', -1},
+  {'Y', '.', -1},
+  {0x00, 0x00, 0}
+};
+
+
+const struct kerning Kerning8x10[] =
+{
+  {'F', ',', -1},
+  {'F', '.', -1},
+  {'L', 'T', -1},
+  {'L', 'V', -1},
+  {'L', 'Y', -1},
+  {'P', ',', -1},
+  {'P', '.', -1},
+  {'T', ',', -1},
+  {'T', '.', -1},
+  {'V', '.', -1},
+  {'Y', '.', -1},
+  {0x00, 0x00, 0}
+};
+#endif  // FONT_DECLARATIONS_ONLY
+
+
+
 
 
 
@@ -103,6 +103,7 @@
 #define $FREE_HEAP           "Free Heap pointer"
 #define $AUTO_SCROLL         "Active auto-scrolls"
 #define $UP_TIME             "Up time"
+#define $CALLBACK_STATS      "Callback load"
 
 /* Function names - Operation. */
 #define $POLICE           "Police"
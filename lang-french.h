@@ -110,6 +110,7 @@
 #define $FREE_HEAP           "Pointeur memoire Heap"
 #define $AUTO_SCROLL         "Auto-defilements"
 #define $UP_TIME             "Temps de fonctionnement"
+#define $CALLBACK_STATS      "Charge des callbacks"
 
 /* Noms de fonction - Operation. */
 #define $POLICE           "Police"